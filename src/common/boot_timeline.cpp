@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "common/boot_timeline.h"
+#include "common/io_file.h"
+#include "common/logging/log.h"
+#include "common/native_clock.h"
+#include "common/path_util.h"
+#include "common/rdtsc.h"
+#include "common/thread.h"
+#include "common/uint128.h"
+
+namespace Common::BootTimeline {
+
+namespace {
+
+struct Phase {
+    std::string name;
+    u64 begin;
+    u64 end;
+    u32 thread;
+    u32 depth;
+};
+
+constexpr size_t NotRecorded = ~size_t{0};
+
+std::mutex timeline_mutex;
+std::vector<Phase> phases;
+std::vector<std::string> thread_names;
+std::atomic_bool recording{true};
+// Stamped during static initialization, which is as close to process start as we get.
+const u64 origin_ticks = FencedRDTSC();
+
+struct ThreadState {
+    u32 id = ~0U;
+    std::vector<size_t> open;
+};
+thread_local ThreadState thread_state;
+
+} // Anonymous namespace
+
+void Begin(std::string_view name) {
+    auto& state = thread_state;
+    if (!recording.load(std::memory_order_relaxed)) {
+        state.open.push_back(NotRecorded);
+        return;
+    }
+    const u64 now = FencedRDTSC();
+    std::scoped_lock lk{timeline_mutex};
+    if (state.id == ~0U) {
+        state.id = static_cast<u32>(thread_names.size());
+        thread_names.push_back(GetCurrentThreadName());
+    }
+    state.open.push_back(phases.size());
+    phases.push_back({
+        .name = std::string{name},
+        .begin = now,
+        .end = 0,
+        .thread = state.id,
+        .depth = static_cast<u32>(state.open.size() - 1),
+    });
+}
+
+void End() {
+    auto& state = thread_state;
+    if (state.open.empty()) {
+        return;
+    }
+    const size_t index = state.open.back();
+    state.open.pop_back();
+    if (index == NotRecorded) {
+        return;
+    }
+    const u64 now = FencedRDTSC();
+    std::scoped_lock lk{timeline_mutex};
+    phases[index].end = now;
+}
+
+bool IsRecording() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+namespace {
+
+void WriteSummary(std::vector<Phase> phases, std::vector<std::string> thread_names, u64 end_ticks,
+                  u64 frequency) {
+    const auto to_us = [frequency](u64 ticks) {
+        return static_cast<double>(MultiplyAndDivide64(ticks, 1'000'000'000, frequency)) / 1000.0;
+    };
+
+    nlohmann::json events = nlohmann::json::array();
+    for (u32 id = 0; const auto& name : thread_names) {
+        events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", 1},
+                          {"tid", id++},
+                          {"args", {{"name", name}}}});
+    }
+
+    LOG_INFO(Loader, "Boot took {:.1f} ms until the first frame",
+             to_us(end_ticks - origin_ticks) / 1000.0);
+    LOG_INFO(Loader, "{:>10} {:>10}  phase", "start ms", "ms");
+    for (const auto& phase : phases) {
+        const double begin_us = to_us(phase.begin - origin_ticks);
+        const double duration_us = to_us(phase.end - phase.begin);
+        events.push_back({{"name", phase.name},
+                          {"cat", "boot"},
+                          {"ph", "X"},
+                          {"pid", 1},
+                          {"tid", phase.thread},
+                          {"ts", begin_us},
+                          {"dur", duration_us}});
+        LOG_INFO(Loader, "{:>10.1f} {:>10.1f}  {:{}}{} [{}]", begin_us / 1000.0,
+                 duration_us / 1000.0, "", phase.depth * 2, phase.name,
+                 thread_names[phase.thread]);
+    }
+
+    const nlohmann::json root = {{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+    const auto path = FS::GetUserPath(FS::PathType::LogDir) / "boot_trace.json";
+    const auto file = FS::IOFile{path, FS::FileAccessMode::Create, FS::FileType::TextFile};
+    if (!file.IsOpen() || file.WriteString(root.dump()) == 0) {
+        LOG_ERROR(Loader, "Failed to write boot trace to {}", path.string());
+    }
+}
+
+} // Anonymous namespace
+
+void Finish(const NativeClock& clock) {
+    if (!recording.exchange(false)) {
+        return;
+    }
+    const u64 end_ticks = FencedRDTSC();
+    std::vector<Phase> finished;
+    std::vector<std::string> names;
+    {
+        std::scoped_lock lk{timeline_mutex};
+        finished = phases;
+        names = thread_names;
+    }
+    for (auto& phase : finished) {
+        if (phase.end == 0) {
+            phase.end = end_ticks;
+        }
+    }
+    // Finish runs on the presenting thread, so the summary is written in the background to not
+    // delay the first frame.
+    std::thread([finished = std::move(finished), names = std::move(names), end_ticks,
+                 frequency = clock.GetTscFrequency()]() mutable {
+        SetCurrentThreadName("shadPS4:BootTimeline");
+        WriteSummary(std::move(finished), std::move(names), end_ticks, frequency);
+    }).detach();
+}
+
+} // namespace Common::BootTimeline
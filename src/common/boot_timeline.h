@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string_view>
+
+#include "common/types.h"
+
+namespace Common {
+class NativeClock;
+}
+
+/**
+ * Records the nested phases of booting a title, from any thread, until the first frame is
+ * presented. Phases are stamped with raw TSC ticks and converted when the timeline finishes, so
+ * recording is cheap and works before the kernel clock is calibrated.
+ */
+namespace Common::BootTimeline {
+
+/// Opens a phase on the calling thread. Phases nest and are closed in reverse order.
+void Begin(std::string_view name);
+
+/// Closes the innermost open phase of the calling thread.
+void End();
+
+/// Ends the timeline, logs a summary and writes a Chrome trace (chrome://tracing, Perfetto) to
+/// boot_trace.json in the log directory, both from a background thread. Phases still open end
+/// here. Only the first call has an effect and later phases are not recorded.
+void Finish(const NativeClock& clock);
+
+/// Returns whether phases are still being recorded.
+bool IsRecording();
+
+/// Records a phase for the lifetime of the object.
+class Scope {
+public:
+    explicit Scope(std::string_view name) {
+        Begin(name);
+    }
+    ~Scope() {
+        End();
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+} // namespace Common::BootTimeline
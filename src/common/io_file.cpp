@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "common/alignment.h"
@@ -17,6 +19,9 @@
 #include <share.h>
 #include <windows.h>
 #else
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 
@@ -164,6 +169,10 @@ IOFile::IOFile(IOFile&& other) noexcept {
     std::swap(file_access_mode, other.file_access_mode);
     std::swap(file_type, other.file_type);
     std::swap(file, other.file);
+    has_pending_writes = other.has_pending_writes.exchange(false);
+#ifdef _WIN32
+    std::swap(read_handle, other.read_handle);
+#endif
 }
 
 IOFile& IOFile::operator=(IOFile&& other) noexcept {
@@ -171,6 +180,10 @@ IOFile& IOFile::operator=(IOFile&& other) noexcept {
     std::swap(file_access_mode, other.file_access_mode);
     std::swap(file_type, other.file_type);
     std::swap(file, other.file);
+    other.has_pending_writes = has_pending_writes.exchange(other.has_pending_writes);
+#ifdef _WIN32
+    std::swap(read_handle, other.read_handle);
+#endif
     return *this;
 }
 
@@ -202,6 +215,17 @@ int IOFile::Open(const fs::path& path, FileAccessMode mode, FileType type, FileS
                   PathToUTF8String(file_path), ec.message());
     }
 
+#ifdef _WIN32
+    if (IsOpen()) {
+        // Reads with an offset still move the file pointer of a synchronous handle, so they get
+        // a handle of their own. If reopening fails, ReadAt falls back to the stream handle.
+        const auto hfile = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+        const HANDLE handle = ReOpenFile(hfile, GENERIC_READ,
+                                         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0);
+        read_handle = handle == INVALID_HANDLE_VALUE ? nullptr : handle;
+    }
+#endif
+
     return result;
 }
 
@@ -221,6 +245,14 @@ void IOFile::Close() {
     }
 
     file = nullptr;
+    has_pending_writes = false;
+
+#ifdef _WIN32
+    if (read_handle) {
+        CloseHandle(read_handle);
+        read_handle = nullptr;
+    }
+#endif
 
 #ifdef _WIN64
     if (file_mapping && file_access_mode == FileAccessMode::ReadWrite) {
@@ -312,6 +344,13 @@ bool IOFile::Flush() const {
     return flush_result;
 }
 
+void IOFile::FlushPendingWrites() const {
+    // Positional reads go around the stream, so data it still buffers would be missed
+    if (has_pending_writes.load(std::memory_order_relaxed) && has_pending_writes.exchange(false)) {
+        std::fflush(file);
+    }
+}
+
 bool IOFile::Commit() const {
     if (!IsOpen()) {
         return false;
@@ -406,6 +445,165 @@ s64 IOFile::Tell() const {
     return ftello(file);
 }
 
+#ifdef _WIN32
+
+static s64 TransferAt(HANDLE handle, void* data, size_t size, s64 offset, bool write) {
+    size_t total = 0;
+    while (total < size) {
+        OVERLAPPED overlapped{};
+        const u64 position = static_cast<u64>(offset) + total;
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - total, 1ULL << 30));
+        DWORD transferred = 0;
+        const BOOL result =
+            write ? WriteFile(handle, static_cast<const u8*>(data) + total, chunk, &transferred,
+                              &overlapped)
+                  : ReadFile(handle, static_cast<u8*>(data) + total, chunk, &transferred,
+                             &overlapped);
+        if (!result) {
+            if (!write && GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            errno = EIO;
+            return -1;
+        }
+        if (transferred == 0) {
+            break;
+        }
+        total += transferred;
+    }
+    return static_cast<s64>(total);
+}
+
+s64 IOFile::ReadAt(void* data, size_t size, s64 offset) const {
+    const auto buffer = IoVec{data, size};
+    return ReadAtv(std::span{&buffer, 1}, offset);
+}
+
+s64 IOFile::ReadAtv(std::span<const IoVec> buffers, s64 offset) const {
+    if (!IsOpen()) {
+        errno = EBADF;
+        return -1;
+    }
+    FlushPendingWrites();
+    const auto handle =
+        read_handle ? read_handle : reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+    s64 total = 0;
+    for (const auto& buffer : buffers) {
+        const s64 result = TransferAt(handle, buffer.base, buffer.size, offset + total, false);
+        if (result < 0) {
+            return -1;
+        }
+        total += result;
+        if (static_cast<size_t>(result) != buffer.size) {
+            break;
+        }
+    }
+    return total;
+}
+
+s64 IOFile::WriteAt(const void* data, size_t size, s64 offset) const {
+    const auto buffer = IoVec{const_cast<void*>(data), size};
+    return WriteAtv(std::span{&buffer, 1}, offset);
+}
+
+s64 IOFile::WriteAtv(std::span<const IoVec> buffers, s64 offset) const {
+    if (!IsOpen()) {
+        errno = EBADF;
+        return -1;
+    }
+    const s64 pos = Tell();
+    std::fflush(file);
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+    s64 total = 0;
+    for (const auto& buffer : buffers) {
+        const s64 result = TransferAt(handle, buffer.base, buffer.size, offset + total, true);
+        if (result < 0) {
+            total = -1;
+            break;
+        }
+        total += result;
+    }
+    Seek(pos);
+    return total;
+}
+
+#else
+
+// Keeps issuing the call until every buffer is transferred, as preadv/pwritev may stop short.
+template <bool Write>
+static s64 TransferAtv(int fd, std::span<const IoVec> buffers, s64 offset) {
+    static_assert(sizeof(IoVec) == sizeof(iovec));
+    std::vector<iovec> iov(buffers.size());
+    std::memcpy(iov.data(), buffers.data(), buffers.size_bytes());
+
+    s64 total = 0;
+    size_t first = 0;
+    while (first < iov.size()) {
+        const int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+        ssize_t result;
+        if constexpr (Write) {
+            result = pwritev(fd, iov.data() + first, count, offset + total);
+        } else {
+            result = preadv(fd, iov.data() + first, count, offset + total);
+        }
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (result == 0) {
+            // End of file, or nothing left to transfer
+            break;
+        }
+        total += result;
+
+        size_t remaining = static_cast<size_t>(result);
+        while (first < iov.size() && remaining >= iov[first].iov_len) {
+            remaining -= iov[first].iov_len;
+            ++first;
+        }
+        if (remaining != 0) {
+            iov[first].iov_base = static_cast<u8*>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+    return total;
+}
+
+s64 IOFile::ReadAt(void* data, size_t size, s64 offset) const {
+    const auto buffer = IoVec{data, size};
+    return ReadAtv(std::span{&buffer, 1}, offset);
+}
+
+s64 IOFile::ReadAtv(std::span<const IoVec> buffers, s64 offset) const {
+    if (!IsOpen()) {
+        errno = EBADF;
+        return -1;
+    }
+    FlushPendingWrites();
+    return TransferAtv<false>(fileno(file), buffers, offset);
+}
+
+s64 IOFile::WriteAt(const void* data, size_t size, s64 offset) const {
+    const auto buffer = IoVec{const_cast<void*>(data), size};
+    return WriteAtv(std::span{&buffer, 1}, offset);
+}
+
+s64 IOFile::WriteAtv(std::span<const IoVec> buffers, s64 offset) const {
+    if (!IsOpen()) {
+        errno = EBADF;
+        return -1;
+    }
+    // Also drops read-ahead data, which could otherwise go stale
+    std::fflush(file);
+    return TransferAtv<true>(fileno(file), buffers, offset);
+}
+
+#endif
+
 u64 GetDirectorySize(const std::filesystem::path& path) {
     if (!fs::exists(path)) {
         return 0;
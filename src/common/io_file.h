@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdio>
 #include <filesystem>
 #include <span>
@@ -68,6 +69,12 @@ enum class SeekOrigin : u32 {
     End,             // Seeks from the end of the file.
 };
 
+/// Buffer descriptor for vectored reads and writes, laid out like the POSIX iovec.
+struct IoVec {
+    void* base;
+    size_t size;
+};
+
 class IOFile final {
 public:
     IOFile();
@@ -130,6 +137,24 @@ public:
     bool Seek(s64 offset, SeekOrigin origin = SeekOrigin::SetOrigin) const;
     s64 Tell() const;
 
+    /**
+     * Positional reads. They bypass the stream and never use or move the file position. Writes
+     * left in the stream buffer by WriteSpan or WriteObject are flushed first so they are visible
+     * to the read. Return the number of bytes read, which is short only at the end of the file,
+     * or -1 on failure with errno set.
+     */
+    s64 ReadAt(void* data, size_t size, s64 offset) const;
+    s64 ReadAtv(std::span<const IoVec> buffers, s64 offset) const;
+
+    /**
+     * Positional writes. Buffered stream data is flushed first so sequential reads don't return
+     * stale data afterwards. Return the number of bytes written or -1 on failure with errno set.
+     * On Windows they go through the stream handle and restore its position afterwards, so
+     * there they must not race with other users of the stream.
+     */
+    s64 WriteAt(const void* data, size_t size, s64 offset) const;
+    s64 WriteAtv(std::span<const IoVec> buffers, s64 offset) const;
+
     template <typename T>
     size_t Read(T& data) const {
         if constexpr (IsContiguousContainer<T>) {
@@ -179,6 +204,7 @@ public:
             return 0;
         }
 
+        has_pending_writes.store(true, std::memory_order_relaxed);
         return std::fwrite(data.data(), sizeof(T), data.size(), file);
     }
 
@@ -210,6 +236,7 @@ public:
             return false;
         }
 
+        has_pending_writes.store(true, std::memory_order_relaxed);
         return std::fwrite(&object, sizeof(T), 1, file) == 1;
     }
 
@@ -226,11 +253,17 @@ public:
     std::FILE* file = nullptr;
 
 private:
+    void FlushPendingWrites() const;
+
     std::filesystem::path file_path;
     FileAccessMode file_access_mode{};
     FileType file_type{};
 
     uintptr_t file_mapping = 0;
+    mutable std::atomic_bool has_pending_writes{};
+#ifdef _WIN32
+    void* read_handle = nullptr; // Independent handle, so positional reads keep the stream intact
+#endif
 };
 
 u64 GetDirectorySize(const std::filesystem::path& path);
@@ -4,10 +4,11 @@
 #pragma once
 
 #include <array>
+#include <string_view>
 
 namespace Common::Log::Class {
 // clang-format off
-/// Listing all log classes, if you add here, dont forget ALL_LOGGERS
+/// Listing all log classes, if you add here, dont forget ALL_CLASSES
 constexpr auto Common = "Common";                                   ///< Library routines
 constexpr auto Common_Filesystem = "Common.Filesystem";             ///< Filesystem interface library
 constexpr auto Common_Memory = "Common.Memory";                     ///< Memory mapping and management functions
@@ -112,4 +113,122 @@ constexpr auto Render_Recompiler = "Render.Recompiler";             ///< Shader
 constexpr auto Render_Vulkan = "Render.Vulkan";                     ///< Vulkan backend
 constexpr auto Tty = "Tty";                                         ///< Debug output from emu
 // clang-format on
+
+/// All log classes, the position of a class is its index into ALL_LOGGERS
+constexpr std::array ALL_CLASSES{
+    Common,
+    Common_Filesystem,
+    Common_Memory,
+    Config,
+    Core,
+    Core_Devices,
+    Core_Linker,
+    Debug,
+    Frontend,
+    IPC,
+    ImGui,
+    Input,
+    Kernel,
+    Kernel_Event,
+    Kernel_Fs,
+    Kernel_Pthread,
+    Kernel_Sce,
+    Kernel_Vmm,
+    KeyManager,
+    Lib,
+    Lib_Ajm,
+    Lib_AppContent,
+    Lib_Audio3d,
+    Lib_AudioIn,
+    Lib_AudioOut,
+    Lib_AvPlayer,
+    Lib_Camera,
+    Lib_CommonDlg,
+    Lib_CompanionHttpd,
+    Lib_CompanionUtil,
+    Lib_ContentExport,
+    Lib_DiscMap,
+    Lib_ErrorDialog,
+    Lib_Fiber,
+    Lib_Font,
+    Lib_FontFt,
+    Lib_GameLiveStreaming,
+    Lib_GnmDriver,
+    Lib_Hmd,
+    Lib_HmdSetupDialog,
+    Lib_Http,
+    Lib_Http2,
+    Lib_Ime,
+    Lib_ImeDialog,
+    Lib_Jpeg,
+    Lib_Kernel,
+    Lib_LibcInternal,
+    Lib_Mouse,
+    Lib_Move,
+    Lib_MsgDlg,
+    Lib_Net,
+    Lib_NetCtl,
+    Lib_Ngs2,
+    Lib_NpAuth,
+    Lib_NpCommerce,
+    Lib_NpCommon,
+    Lib_NpManager,
+    Lib_NpMatching2,
+    Lib_NpSignaling,
+    Lib_NpPartner,
+    Lib_NpParty,
+    Lib_NpProfileDialog,
+    Lib_NpScore,
+    Lib_NpSnsFacebookDialog,
+    Lib_NpTrophy,
+    Lib_NpTus,
+    Lib_NpWebApi,
+    Lib_NpWebApi2,
+    Lib_Pad,
+    Lib_PlayGo,
+    Lib_PlayGoDialog,
+    Lib_Png,
+    Lib_Random,
+    Lib_RazorCpu,
+    Lib_Remoteplay,
+    Lib_Rtc,
+    Lib_Rudp,
+    Lib_SaveData,
+    Lib_SaveDataDialog,
+    Lib_Screenshot,
+    Lib_SharePlay,
+    Lib_SigninDialog,
+    Lib_Ssl,
+    Lib_Ssl2,
+    Lib_SysModule,
+    Lib_SystemGesture,
+    Lib_SystemService,
+    Lib_Usbd,
+    Lib_UserService,
+    Lib_Vdec2,
+    Lib_VideoOut,
+    Lib_Videodec,
+    Lib_VideoRecording,
+    Lib_Voice,
+    Lib_VrTracker,
+    Lib_WebBrowserDialog,
+    Lib_Zlib,
+    Loader,
+    Log,
+    Render,
+    Render_Recompiler,
+    Render_Vulkan,
+    Tty,
+};
+
+/// Returns the index of a log class, or ALL_CLASSES.size() for an unknown one.
+constexpr size_t ClassIndex(std::string_view log_class) {
+    for (size_t i = 0; i < ALL_CLASSES.size(); ++i) {
+        if (ALL_CLASSES[i] == log_class) {
+            return i;
+        }
+    }
+    return ALL_CLASSES.size();
+}
+
 } // namespace Common::Log::Class
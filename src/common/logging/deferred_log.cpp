@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/alignment.h"
+#include "common/logging/deferred_log.h"
+#include "common/logging/log.h"
+#include "common/polyfill_thread.h"
+
+namespace Common::Log::Deferred {
+
+namespace {
+
+constexpr size_t BufferSize = 1_MB;
+constexpr auto DrainInterval = std::chrono::milliseconds{5};
+
+struct RecordHeader {
+    const LogSite* site; // Null for padding up to the end of the buffer
+    DecodeFunc decode;
+    s64 timestamp;
+    u32 size;
+    spdlog::level level;
+};
+
+/// Single producer, single consumer ring of records. Positions only ever grow.
+struct ThreadBuffer {
+    std::string thread_name;
+    std::unique_ptr<u8[]> data{new u8[BufferSize]};
+    std::atomic<u64> write_pos{};
+    std::atomic<u64> read_pos{};
+    std::atomic<u64> num_dropped{};
+    std::atomic_bool orphaned{};
+    u64 pending_pos{};
+};
+
+std::mutex buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+std::mutex drain_mutex;
+std::jthread log_thread;
+
+struct ThreadBufferOwner {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~ThreadBufferOwner() {
+        if (buffer) {
+            buffer->orphaned = true;
+        }
+    }
+};
+
+ThreadBuffer& GetThreadBuffer() {
+    thread_local ThreadBufferOwner owner;
+    if (!owner.buffer) {
+        // The name is taken when the thread first logs, threads are named before that
+        owner.buffer = std::make_shared<ThreadBuffer>();
+        owner.buffer->thread_name = Common::GetCurrentThreadName();
+        std::scoped_lock lk{buffers_mutex};
+        buffers.push_back(owner.buffer);
+    }
+    return *owner.buffer;
+}
+
+std::string DecodeText(std::string_view, const u8* data) {
+    return std::string{DecodeArg<std::string_view>(data)};
+}
+
+struct DecodedRecord {
+    s64 timestamp;
+    const LogSite* site;
+    spdlog::level level;
+    const std::string* thread_name;
+    std::string text;
+};
+
+void Emit(const DecodedRecord& record) {
+    const auto& site = *record.site;
+    const auto& logger = ALL_LOGGERS[site.class_index];
+    if (!logger) {
+        return;
+    }
+    const std::string_view function{site.function};
+    logger->log(record.level, "[{}] <{}> ({}) {}:{} {}: {}", Class::ALL_CLASSES[site.class_index],
+                to_string_view(record.level), *record.thread_name,
+                spdlog::source_loc::basename(site.file), site.line,
+                function == "operator()" ? "lambda" : function, record.text);
+}
+
+void LogThread(std::stop_token stoken) {
+    Common::SetCurrentThreadName("shadPS4:Log");
+    std::mutex mutex;
+    std::condition_variable_any cv;
+    while (!stoken.stop_requested()) {
+        {
+            std::unique_lock lk{mutex};
+            cv.wait_for(lk, stoken, DrainInterval, [] { return false; });
+        }
+        Drain();
+    }
+}
+
+} // Anonymous namespace
+
+u8* BeginRecord(const LogSite& site, spdlog::level level, DecodeFunc decode, size_t args_size) {
+    auto& buffer = GetThreadBuffer();
+    const u64 size = Common::AlignUp(sizeof(RecordHeader) + args_size, alignof(RecordHeader));
+    const u64 write_pos = buffer.write_pos.load(std::memory_order_relaxed);
+    const u64 offset = write_pos % BufferSize;
+
+    // Records are contiguous, so one that doesn't fit before the end is preceded by padding. A
+    // tail too short to hold a padding header is skipped by the reader without one.
+    const u64 padding = offset + size > BufferSize ? BufferSize - offset : 0;
+    const u64 used = write_pos - buffer.read_pos.load(std::memory_order_acquire);
+    if (size > BufferSize / 2 || used + padding + size > BufferSize) {
+        buffer.num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    u8* base = buffer.data.get();
+    if (padding >= sizeof(RecordHeader)) {
+        const RecordHeader pad = {.size = static_cast<u32>(padding)};
+        std::memcpy(base + offset, &pad, sizeof(pad));
+    }
+    const RecordHeader header = {
+        .site = &site,
+        .decode = decode,
+        .timestamp = std::chrono::steady_clock::now().time_since_epoch().count(),
+        .size = static_cast<u32>(size),
+        .level = level,
+    };
+    u8* record = base + (write_pos + padding) % BufferSize;
+    std::memcpy(record, &header, sizeof(header));
+    buffer.pending_pos = write_pos + padding + size;
+    return record + sizeof(RecordHeader);
+}
+
+void EndRecord() {
+    auto& buffer = GetThreadBuffer();
+    buffer.write_pos.store(buffer.pending_pos, std::memory_order_release);
+}
+
+void PushText(const LogSite& site, spdlog::level level, std::string_view text) {
+    u8* out = BeginRecord(site, level, &DecodeText, ArgSize(text));
+    if (out) {
+        EncodeArg(out, text);
+        EndRecord();
+    }
+}
+
+void Start() {
+    if (!log_thread.joinable()) {
+        log_thread = std::jthread{LogThread};
+    }
+}
+
+void Stop() {
+    if (log_thread.joinable()) {
+        log_thread.request_stop();
+        log_thread.join();
+    }
+    Drain();
+}
+
+void Drain() {
+    std::scoped_lock lk{drain_mutex};
+
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    {
+        std::scoped_lock buffers_lk{buffers_mutex};
+        snapshot = buffers;
+    }
+
+    std::vector<DecodedRecord> records;
+    for (const auto& buffer : snapshot) {
+        const u8* base = buffer->data.get();
+        const u64 write_pos = buffer->write_pos.load(std::memory_order_acquire);
+        u64 read_pos = buffer->read_pos.load(std::memory_order_relaxed);
+        while (read_pos < write_pos) {
+            const u64 tail = BufferSize - read_pos % BufferSize;
+            if (tail < sizeof(RecordHeader)) {
+                read_pos += tail;
+                continue;
+            }
+            RecordHeader header;
+            std::memcpy(&header, base + read_pos % BufferSize, sizeof(header));
+            if (header.site) {
+                records.push_back({
+                    .timestamp = header.timestamp,
+                    .site = header.site,
+                    .level = header.level,
+                    .thread_name = &buffer->thread_name,
+                    .text = header.decode(header.site->format,
+                                          base + read_pos % BufferSize + sizeof(header)),
+                });
+            }
+            read_pos += header.size;
+        }
+        buffer->read_pos.store(read_pos, std::memory_order_release);
+
+        if (const u64 num_dropped = buffer->num_dropped.exchange(0); num_dropped != 0) {
+            static constexpr LogSite DropSite = {
+                .class_index = Class::ClassIndex(Class::Log),
+                .file = __FILE__,
+                .line = __LINE__,
+                .function = "Drain",
+                .format = "Dropped {} records, the buffer of this thread was full",
+            };
+            records.push_back({
+                .timestamp = std::chrono::steady_clock::now().time_since_epoch().count(),
+                .site = &DropSite,
+                .level = spdlog::level::warn,
+                .thread_name = &buffer->thread_name,
+                .text = fmt::format(fmt::runtime(DropSite.format), num_dropped),
+            });
+        }
+    }
+
+    std::ranges::stable_sort(records, {}, &DecodedRecord::timestamp);
+    for (const auto& record : records) {
+        Emit(record);
+    }
+
+    // Buffers of exited threads are released once they're empty
+    std::scoped_lock buffers_lk{buffers_mutex};
+    std::erase_if(buffers, [](const auto& buffer) {
+        return buffer->orphaned && buffer->read_pos == buffer->write_pos;
+    });
+}
+
+} // namespace Common::Log::Deferred
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <fmt/format.h>
+#include <spdlog/common.h>
+
+#include "common/types.h"
+
+namespace Common::Log {
+
+/// Static description of a log statement, shared by every record it emits.
+struct LogSite {
+    size_t class_index;
+    const char* file;
+    u32 line;
+    const char* function;
+    std::string_view format;
+};
+
+/**
+ * Deferred logging. Instead of being formatted and written out by the calling thread, messages
+ * are recorded into a ring buffer owned by that thread: a pointer to their LogSite, a timestamp
+ * and the raw argument bytes. The log thread drains all buffers, orders the records by timestamp
+ * and formats them. Arguments that could reference short-lived data, anything besides numbers,
+ * enums, pointers and strings, make the message get formatted right away, but it still takes the
+ * deferred path. A full buffer drops records, which is reported once the log thread catches up.
+ */
+namespace Deferred {
+
+using DecodeFunc = std::string (*)(std::string_view format, const u8* args);
+
+template <typename T>
+concept TextArg = std::is_convertible_v<const T&, std::string_view>;
+
+template <typename T>
+concept RawArg =
+    !TextArg<T> && (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>);
+
+template <typename T>
+using DecodedType = std::conditional_t<TextArg<T>, std::string_view, T>;
+
+template <typename T>
+size_t ArgSize(const T& arg) {
+    if constexpr (TextArg<T>) {
+        return sizeof(u32) + std::string_view{arg}.size();
+    } else {
+        return sizeof(T);
+    }
+}
+
+template <typename T>
+u8* EncodeArg(u8* out, const T& arg) {
+    if constexpr (TextArg<T>) {
+        const std::string_view text{arg};
+        const u32 size = static_cast<u32>(text.size());
+        std::memcpy(out, &size, sizeof(size));
+        std::memcpy(out + sizeof(size), text.data(), size);
+        return out + sizeof(size) + size;
+    } else {
+        std::memcpy(out, &arg, sizeof(T));
+        return out + sizeof(T);
+    }
+}
+
+template <typename T>
+DecodedType<T> DecodeArg(const u8*& in) {
+    if constexpr (TextArg<T>) {
+        u32 size;
+        std::memcpy(&size, in, sizeof(size));
+        const std::string_view text{reinterpret_cast<const char*>(in + sizeof(size)), size};
+        in += sizeof(size) + size;
+        return text;
+    } else {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+}
+
+template <typename... Args>
+std::string Decode(std::string_view format, const u8* data) {
+    // Braced initialization evaluates the arguments in order
+    const std::tuple<DecodedType<Args>...> args{DecodeArg<Args>(data)...};
+    return std::apply(
+        [&](const auto&... values) {
+            return fmt::vformat(format, fmt::make_format_args(values...));
+        },
+        args);
+}
+
+/// Reserves room for a record with the given argument size in the calling thread's buffer.
+/// Returns where the arguments go, or null if the buffer is full.
+u8* BeginRecord(const LogSite& site, spdlog::level level, DecodeFunc decode, size_t args_size);
+
+/// Publishes the record reserved by the last BeginRecord call.
+void EndRecord();
+
+void PushText(const LogSite& site, spdlog::level level, std::string_view text);
+
+template <typename... Args>
+void PushRecord(const LogSite& site, spdlog::level level, const Args&... args) {
+    if constexpr ((... && (TextArg<Args> || RawArg<Args>))) {
+        const size_t args_size = (size_t{0} + ... + ArgSize(args));
+        u8* out = BeginRecord(site, level, &Decode<std::remove_cvref_t<Args>...>, args_size);
+        if (out) {
+            ((out = EncodeArg(out, args)), ...);
+            EndRecord();
+        }
+    } else {
+        PushText(site, level, fmt::vformat(site.format, fmt::make_format_args(args...)));
+    }
+}
+
+void Start();
+void Stop();
+
+/// Formats and writes out everything recorded so far.
+void Drain();
+
+} // namespace Deferred
+
+} // namespace Common::Log
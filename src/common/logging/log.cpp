@@ -27,115 +27,12 @@ enum class ShadPs4ReturnCode : u32 {
 
 namespace Common::Log {
 bool g_should_append = false;
+std::atomic<bool> g_deferred_logging{false};
 
 static std::shared_ptr<spdlog_stdout> g_console_sink;
 static std::shared_ptr<LogFileSink> g_shad_file_sink;
 
-std::unordered_map<std::string_view, std::shared_ptr<spdlog::logger>> ALL_LOGGERS{
-    {Class::Common, nullptr},
-    {Class::Common_Filesystem, nullptr},
-    {Class::Common_Memory, nullptr},
-    {Class::Config, nullptr},
-    {Class::Core, nullptr},
-    {Class::Core_Devices, nullptr},
-    {Class::Core_Linker, nullptr},
-    {Class::Debug, nullptr},
-    {Class::Frontend, nullptr},
-    {Class::IPC, nullptr},
-    {Class::ImGui, nullptr},
-    {Class::Input, nullptr},
-    {Class::Kernel, nullptr},
-    {Class::Kernel_Event, nullptr},
-    {Class::Kernel_Fs, nullptr},
-    {Class::Kernel_Pthread, nullptr},
-    {Class::Kernel_Sce, nullptr},
-    {Class::Kernel_Vmm, nullptr},
-    {Class::KeyManager, nullptr},
-    {Class::Lib, nullptr},
-    {Class::Lib_Ajm, nullptr},
-    {Class::Lib_AppContent, nullptr},
-    {Class::Lib_Audio3d, nullptr},
-    {Class::Lib_AudioIn, nullptr},
-    {Class::Lib_AudioOut, nullptr},
-    {Class::Lib_AvPlayer, nullptr},
-    {Class::Lib_Camera, nullptr},
-    {Class::Lib_CommonDlg, nullptr},
-    {Class::Lib_CompanionHttpd, nullptr},
-    {Class::Lib_CompanionUtil, nullptr},
-    {Class::Lib_ContentExport, nullptr},
-    {Class::Lib_DiscMap, nullptr},
-    {Class::Lib_ErrorDialog, nullptr},
-    {Class::Lib_Fiber, nullptr},
-    {Class::Lib_Font, nullptr},
-    {Class::Lib_FontFt, nullptr},
-    {Class::Lib_GameLiveStreaming, nullptr},
-    {Class::Lib_GnmDriver, nullptr},
-    {Class::Lib_Hmd, nullptr},
-    {Class::Lib_HmdSetupDialog, nullptr},
-    {Class::Lib_Http, nullptr},
-    {Class::Lib_Http2, nullptr},
-    {Class::Lib_Ime, nullptr},
-    {Class::Lib_ImeDialog, nullptr},
-    {Class::Lib_Jpeg, nullptr},
-    {Class::Lib_Kernel, nullptr},
-    {Class::Lib_LibcInternal, nullptr},
-    {Class::Lib_Mouse, nullptr},
-    {Class::Lib_Move, nullptr},
-    {Class::Lib_MsgDlg, nullptr},
-    {Class::Lib_Net, nullptr},
-    {Class::Lib_NetCtl, nullptr},
-    {Class::Lib_Ngs2, nullptr},
-    {Class::Lib_NpAuth, nullptr},
-    {Class::Lib_NpCommerce, nullptr},
-    {Class::Lib_NpCommon, nullptr},
-    {Class::Lib_NpManager, nullptr},
-    {Class::Lib_NpMatching2, nullptr},
-    {Class::Lib_NpSignaling, nullptr},
-    {Class::Lib_NpPartner, nullptr},
-    {Class::Lib_NpParty, nullptr},
-    {Class::Lib_NpProfileDialog, nullptr},
-    {Class::Lib_NpScore, nullptr},
-    {Class::Lib_NpSnsFacebookDialog, nullptr},
-    {Class::Lib_NpTrophy, nullptr},
-    {Class::Lib_NpTus, nullptr},
-    {Class::Lib_NpWebApi, nullptr},
-    {Class::Lib_NpWebApi2, nullptr},
-    {Class::Lib_Pad, nullptr},
-    {Class::Lib_PlayGo, nullptr},
-    {Class::Lib_PlayGoDialog, nullptr},
-    {Class::Lib_Png, nullptr},
-    {Class::Lib_Random, nullptr},
-    {Class::Lib_RazorCpu, nullptr},
-    {Class::Lib_Remoteplay, nullptr},
-    {Class::Lib_Rtc, nullptr},
-    {Class::Lib_Rudp, nullptr},
-    {Class::Lib_SaveData, nullptr},
-    {Class::Lib_SaveDataDialog, nullptr},
-    {Class::Lib_Screenshot, nullptr},
-    {Class::Lib_SharePlay, nullptr},
-    {Class::Lib_SigninDialog, nullptr},
-    {Class::Lib_Ssl, nullptr},
-    {Class::Lib_Ssl2, nullptr},
-    {Class::Lib_SysModule, nullptr},
-    {Class::Lib_SystemGesture, nullptr},
-    {Class::Lib_SystemService, nullptr},
-    {Class::Lib_Usbd, nullptr},
-    {Class::Lib_UserService, nullptr},
-    {Class::Lib_Vdec2, nullptr},
-    {Class::Lib_VideoOut, nullptr},
-    {Class::Lib_Videodec, nullptr},
-    {Class::Lib_VideoRecording, nullptr},
-    {Class::Lib_Voice, nullptr},
-    {Class::Lib_VrTracker, nullptr},
-    {Class::Lib_WebBrowserDialog, nullptr},
-    {Class::Lib_Zlib, nullptr},
-    {Class::Loader, nullptr},
-    {Class::Log, nullptr},
-    {Class::Render, nullptr},
-    {Class::Render_Recompiler, nullptr},
-    {Class::Render_Vulkan, nullptr},
-    {Class::Tty, nullptr},
-};
+std::array<std::shared_ptr<spdlog::logger>, Class::ALL_CLASSES.size()> ALL_LOGGERS{};
 
 template <typename T>
 static auto UpdateColorLevels(T sink) {
@@ -182,8 +79,8 @@ void Setup(std::string_view shadps4_filename) {
         std::set_terminate(Terminate);
     });
 
-    for (auto& [name, logger] : ALL_LOGGERS) {
-        logger = std::make_shared<spdlog::logger>(std::string(name));
+    for (size_t i = 0; i < ALL_LOGGERS.size(); ++i) {
+        ALL_LOGGERS[i] = std::make_shared<spdlog::logger>(std::string(Class::ALL_CLASSES[i]));
     }
 
     // Setup console
@@ -210,11 +107,16 @@ void Setup(std::string_view shadps4_filename) {
 
     UpdateSinks();
     UpdateLogLevels(EmulatorSettings.GetLogFilter());
+    UpdateDeferred();
 }
 
 void Switch(std::string_view game_filename) {
+    // Records queued so far belong to the previous log file
+    Deferred::Drain();
+
     UpdateSinks();
     UpdateLogLevels(EmulatorSettings.GetLogFilter());
+    UpdateDeferred();
 
     g_shad_file_sink->_size_limit = EmulatorSettings.GetLogSizeLimit();
     g_shad_file_sink->session_file_helper_.open(
@@ -222,7 +124,10 @@ void Switch(std::string_view game_filename) {
 }
 
 void Shutdown() {
-    for (auto& logger : ALL_LOGGERS | std::views::values) {
+    g_deferred_logging.store(false);
+    Deferred::Stop();
+
+    for (auto& logger : ALL_LOGGERS) {
         logger.reset();
     }
 
@@ -231,6 +136,8 @@ void Shutdown() {
 }
 
 void Flush() {
+    Deferred::Drain();
+
     if (g_shad_file_sink != nullptr) {
         g_shad_file_sink->flush();
     }
@@ -271,13 +178,22 @@ void UpdateSinks() {
             std::chrono::milliseconds(EmulatorSettings.GetLogMaxSkipDuration()),
             EmulatorSettings.IsLogSync() ? sinks : async_sink)};
 
-    for (auto& [name, logger] : ALL_LOGGERS) {
+    for (auto& logger : ALL_LOGGERS) {
         logger->sinks() = EmulatorSettings.IsLogSkipDuplicate()
                               ? dup_filter
                               : (EmulatorSettings.IsLogSync() ? sinks : async_sink);
     }
 }
 
+void UpdateDeferred() {
+    // The log thread is kept around once started, records may still be queued
+    const bool deferred = EmulatorSettings.IsLogDeferred();
+    if (deferred) {
+        Deferred::Start();
+    }
+    g_deferred_logging.store(deferred);
+}
+
 void UpdateLogLevels(std::string_view log_filter) {
     spdlog::level default_log_level = spdlog::level::info;
     std::unordered_map<std::string, spdlog::level> log_level_per_class;
@@ -303,9 +219,10 @@ void UpdateLogLevels(std::string_view log_filter) {
         }
     }
 
-    for (auto& [name, logger] : ALL_LOGGERS) {
+    for (size_t i = 0; i < ALL_LOGGERS.size(); ++i) {
+        auto& logger = ALL_LOGGERS[i];
         if (EmulatorSettings.IsLogEnable()) {
-            const auto level_it = log_level_per_class.find(std::string(name));
+            const auto level_it = log_level_per_class.find(std::string(Class::ALL_CLASSES[i]));
 
             logger->set_level(level_it != log_level_per_class.end() ? level_it->second
                                                                     : default_log_level);
@@ -3,8 +3,9 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <iostream>
-#include <unordered_map>
 #include <vector>
 #include <spdlog/details/fmt_helper.h>
 #include <spdlog/sinks/basic_file_sink.h>
@@ -20,12 +21,14 @@ using spdlog_stdout = spdlog::sinks::stdout_color_sink_mt;
 #include <spdlog/spdlog.h>
 
 #include "common/logging/classes.h"
+#include "common/logging/deferred_log.h"
 #include "common/path_util.h"
 #include "common/thread.h"
 
 namespace Common::Log {
 extern bool g_should_append;
-extern std::unordered_map<std::string_view, std::shared_ptr<spdlog::logger>> ALL_LOGGERS;
+extern std::atomic<bool> g_deferred_logging;
+extern std::array<std::shared_ptr<spdlog::logger>, Class::ALL_CLASSES.size()> ALL_LOGGERS;
 
 void Setup(std::string_view shadps4_filename);
 
@@ -41,6 +44,8 @@ void UpdateSinks();
 
 void UpdateLogLevels(std::string_view log_filter);
 
+void UpdateDeferred();
+
 static constexpr std::array level_string_views{"Trace", "Debug",    "Info", "Warning",
                                                "Error", "Critical", "Off"};
 
@@ -52,7 +57,19 @@ static constexpr std::array level_string_views{"Trace", "Debug",    "Info", "War
 // Define the fmt lib macros
 #define LOG_GENERIC(log_class, log_level, format, ...)                                             \
     do {                                                                                           \
-        if (auto logger = Common::Log::ALL_LOGGERS[log_class]) {                                   \
+        constexpr auto log_class_index = Common::Log::Class::ClassIndex(log_class);                \
+        static_assert(log_class_index < Common::Log::Class::ALL_CLASSES.size(),                    \
+                      "Unknown log class");                                                        \
+        const auto& logger = Common::Log::ALL_LOGGERS[log_class_index];                            \
+        if (!logger || !logger->should_log(log_level)) {                                           \
+            break;                                                                                 \
+        }                                                                                          \
+        if (Common::Log::g_deferred_logging.load(std::memory_order_relaxed) &&                     \
+            log_level < spdlog::level::critical) {                                                 \
+            static const Common::Log::LogSite log_site = {                                         \
+                log_class_index, __FILE__, __LINE__, __func__, format};                            \
+            Common::Log::Deferred::PushRecord(log_site, log_level, ##__VA_ARGS__);                 \
+        } else {                                                                                   \
             logger->log(log_level, "[{}] <{}> ({}) {}:{} {}: " format, log_class,                  \
                         Common::Log::to_string_view(log_level), Common::GetCurrentThreadName(),    \
                         spdlog::source_loc::basename(__FILE__), __LINE__,                          \
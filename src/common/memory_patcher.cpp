@@ -6,11 +6,13 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include <pugixml.hpp>
 #include "common/elf_info.h"
 #include "common/logging/log.h"
 #include "common/path_util.h"
+#include "common/pattern_scanner.h"
 #include "core/emulator_state.h"
 #include "core/file_format/psf.h"
 #include "memory_patcher.h"
@@ -24,6 +26,11 @@ std::string patch_file;
 bool patches_applied = false;
 std::vector<patchInfo> pending_patches;
 
+// Eboot offsets of the first match of every signature in a batch of patches, found with a single
+// scan before the batch writes anything, and the ranges the batch has written since.
+std::unordered_map<std::string, size_t> prescanned_patterns;
+std::vector<std::pair<uintptr_t, size_t>> written_ranges;
+
 std::string toHex(u64 value, size_t byteSize) {
     std::stringstream ss;
     ss << std::hex << std::setfill('0') << std::setw(byteSize * 2) << value;
@@ -114,6 +121,46 @@ std::string convertValueToHex(const std::string type, const std::string valueStr
 
 void ApplyPendingPatches();
 
+static void PrescanPatterns(const std::vector<patchInfo>& patches) {
+    Common::PatternScanner scanner;
+    std::vector<std::string> signatures;
+    const auto add_signature = [&](const std::string& signature) {
+        if (!signature.empty() && !prescanned_patterns.contains(signature) &&
+            std::ranges::find(signatures, signature) == signatures.end() &&
+            scanner.AddPattern(signature)) {
+            signatures.push_back(signature);
+        }
+    };
+    for (const patchInfo& patch : patches) {
+        if (patch.patchMask != PatchMask::None) {
+            add_signature(patch.offsetStr);
+        }
+        if (patch.patchMask == PatchMask::Mask_Jump32) {
+            add_signature(patch.targetStr);
+        }
+    }
+    if (signatures.empty()) {
+        return;
+    }
+
+    const std::span image{reinterpret_cast<const u8*>(g_eboot_address), g_eboot_image_size};
+    const auto results = scanner.Scan(image);
+    for (size_t i = 0; i < signatures.size(); i++) {
+        prescanned_patterns.emplace(signatures[i], results[i]);
+    }
+}
+
+static void ApplyPatches(const std::vector<patchInfo>& patches) {
+    PrescanPatterns(patches);
+    for (const patchInfo& patch : patches) {
+        PatchMemory(patch.modNameStr, patch.offsetStr, patch.valueStr, patch.targetStr,
+                    patch.sizeStr, patch.isOffset, patch.littleEndian, patch.patchMask,
+                    patch.maskOffset);
+    }
+    prescanned_patterns.clear();
+    written_ranges.clear();
+}
+
 void ApplyPatchesFromXML(std::filesystem::path path) {
     pugi::xml_document doc;
     pugi::xml_parse_result result = doc.load_file(path.c_str());
@@ -122,6 +169,7 @@ void ApplyPatchesFromXML(std::filesystem::path path) {
     auto app_version = param_sfo->GetString("APP_VER").value_or("Unknown version");
 
     if (result) {
+        std::vector<patchInfo> patches;
         auto patchXML = doc.child("Patch");
         for (pugi::xml_node_iterator it = patchXML.children().begin();
              it != patchXML.children().end(); ++it) {
@@ -170,13 +218,14 @@ void ApplyPatchesFromXML(std::filesystem::path path) {
                             maskOffsetValue = std::stoi(maskOffsetStr, 0, 10);
                         }
 
-                        MemoryPatcher::PatchMemory(currentPatchName, address, patchValue, targetStr,
-                                                   sizeStr, false, littleEndian, patchMask,
-                                                   maskOffsetValue);
+                        patches.push_back({"", currentPatchName, address, patchValue, targetStr,
+                                           sizeStr, false, littleEndian, patchMask,
+                                           maskOffsetValue});
                     }
                 }
             }
         }
+        ApplyPatches(patches);
     } else {
         LOG_ERROR(Loader, "Could not parse patch XML: {}", result.description());
     }
@@ -226,18 +275,18 @@ void AddPatchToQueue(patchInfo patchToAdd) {
 
 void ApplyPendingPatches() {
     patches_applied = true;
-    for (size_t i = 0; i < pending_patches.size(); ++i) {
-        const patchInfo& currentPatch = pending_patches[i];
-
-        if (currentPatch.gameSerial != "*" && currentPatch.gameSerial != g_game_serial)
-            continue;
+    std::erase_if(pending_patches, [](const patchInfo& patch) {
+        return patch.gameSerial != "*" && patch.gameSerial != g_game_serial;
+    });
+    ApplyPatches(pending_patches);
+    pending_patches.clear();
+}
 
-        PatchMemory(currentPatch.modNameStr, currentPatch.offsetStr, currentPatch.valueStr,
-                    currentPatch.targetStr, currentPatch.sizeStr, currentPatch.isOffset,
-                    currentPatch.littleEndian, currentPatch.patchMask, currentPatch.maskOffset);
+static void WriteMemory(uintptr_t address, const void* data, size_t size) {
+    std::memcpy(reinterpret_cast<void*>(address), data, size);
+    if (!prescanned_patterns.empty()) {
+        written_ranges.emplace_back(address, size);
     }
-
-    pending_patches.clear();
 }
 
 void PatchMemory(std::string modNameStr, std::string offsetStr, std::string valueStr,
@@ -282,7 +331,7 @@ void PatchMemory(std::string modNameStr, std::string offsetStr, std::string valu
 
         // Fills the original region (jumpSize bytes) with NOPs
         std::vector<u8> nopBytes(jumpSize, 0x90);
-        std::memcpy(reinterpret_cast<void*>(patchAddress), nopBytes.data(), nopBytes.size());
+        WriteMemory(patchAddress, nopBytes.data(), nopBytes.size());
 
         // Use "Target" to locate the start of the code cave
         uintptr_t jump_target = PatternScan(targetStr);
@@ -311,15 +360,14 @@ void PatchMemory(std::string modNameStr, std::string offsetStr, std::string valu
         uintptr_t code_cave_end = jump_target + payload.size();
 
         // Write the payload to the code cave, from jump_target
-        std::memcpy(reinterpret_cast<void*>(jump_target), payload.data(), payload.size());
+        WriteMemory(jump_target, payload.data(), payload.size());
 
         // Inserts the initial jump in the original region to divert to the code cave
         u8 jumpInstruction[5];
         jumpInstruction[0] = 0xE9;
         s32 relJump = static_cast<s32>(jump_target - patchAddress - 5);
         std::memcpy(&jumpInstruction[1], &relJump, sizeof(relJump));
-        std::memcpy(reinterpret_cast<void*>(patchAddress), jumpInstruction,
-                    sizeof(jumpInstruction));
+        WriteMemory(patchAddress, jumpInstruction, sizeof(jumpInstruction));
 
         // Inserts jump back at the end of the code cave to resume execution after patching
         u8 jumpBack[5];
@@ -328,7 +376,7 @@ void PatchMemory(std::string modNameStr, std::string offsetStr, std::string valu
         // overwritten region
         s32 target_return = static_cast<s32>((patchAddress + jumpSize) - (code_cave_end + 5));
         std::memcpy(&jumpBack[1], &target_return, sizeof(target_return));
-        std::memcpy(reinterpret_cast<void*>(code_cave_end), jumpBack, sizeof(jumpBack));
+        WriteMemory(code_cave_end, jumpBack, sizeof(jumpBack));
 
         LOG_INFO(Loader,
                  "Applied Patch mask_jump32: {}, PatchAddress: {:#x}, JumpTarget: {:#x}, "
@@ -355,55 +403,49 @@ void PatchMemory(std::string modNameStr, std::string offsetStr, std::string valu
         std::reverse(bytePatch.begin(), bytePatch.end());
     }
 
-    std::memcpy(cheatAddress, bytePatch.data(), bytePatch.size());
+    WriteMemory(reinterpret_cast<uintptr_t>(cheatAddress), bytePatch.data(), bytePatch.size());
 
     LOG_INFO(Loader, "Applied patch: {}, Offset: {}, Value: {}", modNameStr,
              (uintptr_t)cheatAddress, valueStr);
 }
 
-static std::vector<int32_t> PatternToByte(const std::string& pattern) {
-    std::vector<int32_t> bytes;
-    const char* start = pattern.data();
-    const char* end = start + pattern.size();
-
-    for (const char* current = start; current < end; ++current) {
-        if (*current == '?') {
-            ++current;
-            if (*current == '?')
-                ++current;
-            bytes.push_back(-1);
-        } else {
-            bytes.push_back(strtoul(current, const_cast<char**>(&current), 16));
-        }
+uintptr_t PatternScan(const std::string& signature) {
+    Common::PatternScanner scanner;
+    if (!scanner.AddPattern(signature)) {
+        LOG_ERROR(Loader, "Invalid pattern: {}", signature);
+        return 0;
+    }
+    const std::span image{reinterpret_cast<const u8*>(g_eboot_address), g_eboot_image_size};
+    const auto to_address = [&](size_t offset) -> uintptr_t {
+        return offset == Common::PatternScanner::NotFound ? 0 : g_eboot_address + offset;
+    };
+
+    const auto it = prescanned_patterns.find(signature);
+    if (it == prescanned_patterns.end()) {
+        return to_address(scanner.Scan(image)[0]);
     }
 
-    return bytes;
-}
-
-uintptr_t PatternScan(const std::string& signature) {
-    std::vector<int32_t> patternBytes = PatternToByte(signature);
-    const auto scanBytes = static_cast<uint8_t*>((void*)g_eboot_address);
-
-    const int32_t* sigPtr = patternBytes.data();
-    const size_t sigSize = patternBytes.size();
-
-    uint32_t foundResults = 0;
-    for (uint32_t i = 0; i < g_eboot_image_size - sigSize; ++i) {
-        bool found = true;
-        for (uint32_t j = 0; j < sigSize; ++j) {
-            if (scanBytes[i + j] != sigPtr[j] && sigPtr[j] != -1) {
-                found = false;
-                break;
+    // Patches applied since the prescan may have created an earlier match, which can only
+    // overlap a written range, or overwritten the one that was found.
+    size_t offset = it->second;
+    const size_t size = scanner.PatternSize(0);
+    for (const auto& [address, length] : written_ranges) {
+        const size_t write_offset = address - g_eboot_address;
+        const size_t begin = write_offset - std::min(write_offset, size - 1);
+        const size_t end = std::min(write_offset + length + size - 1, image.size());
+        if (begin < end && begin < offset) {
+            const size_t match = scanner.Scan(image.subspan(begin, end - begin), 1)[0];
+            if (match != Common::PatternScanner::NotFound) {
+                offset = std::min(offset, begin + match);
             }
         }
-
-        if (found) {
-            foundResults++;
-            return reinterpret_cast<uintptr_t>(&scanBytes[i]);
-        }
     }
-
-    return 0;
+    if (offset != Common::PatternScanner::NotFound && !scanner.MatchesAt(0, image, offset)) {
+        const size_t match = scanner.Scan(image.subspan(offset + 1))[0];
+        offset = match == Common::PatternScanner::NotFound ? match : offset + 1 + match;
+    }
+    it->second = offset;
+    return to_address(offset);
 }
 
 } // namespace MemoryPatcher
@@ -47,7 +47,6 @@ void PatchMemory(std::string modNameStr, std::string offsetStr, std::string valu
                  std::string targetStr, std::string sizeStr, bool isOffset, bool littleEndian,
                  PatchMask patchMask = PatchMask::None, int maskOffset = 0);
 
-static std::vector<int32_t> PatternToByte(const std::string& pattern);
 uintptr_t PatternScan(const std::string& signature);
 
 } // namespace MemoryPatcher
\ No newline at end of file
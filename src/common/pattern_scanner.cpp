@@ -0,0 +1,362 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include "common/pattern_scanner.h"
+
+#ifdef __AVX2__
+#define PATTERN_SCANNER_USE_AVX
+#include <immintrin.h>
+#endif
+
+namespace Common {
+
+// Every position of the image is looked up in a filter keyed by the two bytes starting there.
+// Each pattern sets the key of its rarest pair of adjacent concrete bytes (its anchor), so only
+// positions that may begin an anchor reach the full comparison.
+static constexpr size_t NumKeys = 1 << 16;
+
+// Chunks smaller than this are not worth a thread.
+static constexpr size_t MinChunkSize = 1_MB;
+
+// The byte histogram used to pick anchors samples this many bytes at most.
+static constexpr size_t MaxHistogramSamples = 1 << 20;
+
+#ifdef PATTERN_SCANNER_USE_AVX
+// The vector prefilter sorts anchors into 8 buckets by nibble, which stops rejecting anything
+// once each bucket holds more than a handful of distinct anchors.
+static constexpr size_t MaxPrefilterAnchors = 16;
+#endif
+
+// A pattern without two adjacent concrete bytes anchors on a single byte and takes all 256 keys
+// starting with it.
+static constexpr u32 AnyByte = 0x100;
+
+struct Anchor {
+    u32 offset;
+    u32 first;
+    u32 second;
+};
+
+template <typename Func>
+static void ForEachKey(const Anchor& anchor, Func&& func) {
+    if (anchor.second != AnyByte) {
+        func(anchor.first | (anchor.second << 8));
+        return;
+    }
+    for (u32 second = 0; second < 256; second++) {
+        func(anchor.first | (second << 8));
+    }
+}
+
+struct PatternScanner::CompiledSet {
+    struct Entry {
+        u32 pattern;
+        u32 anchor;
+    };
+
+    std::vector<u64> filter;
+    std::vector<u32> key_start;
+    std::vector<Entry> entries;
+    std::vector<std::optional<Anchor>> anchors;
+    size_t num_anchored;
+#ifdef PATTERN_SCANNER_USE_AVX
+    bool use_prefilter;
+    std::array<u8, 16> lo0;
+    std::array<u8, 16> hi0;
+    std::array<u8, 16> lo1;
+    std::array<u8, 16> hi1;
+#endif
+};
+
+std::optional<size_t> PatternScanner::AddPattern(std::string_view signature) {
+    Pattern pattern{};
+    size_t pos = 0;
+    while (pos < signature.size()) {
+        if (signature[pos] == ' ') {
+            pos++;
+            continue;
+        }
+        const size_t end = std::min(signature.find(' ', pos), signature.size());
+        const std::string_view token = signature.substr(pos, end - pos);
+        pos = end;
+
+        if (token == "?" || token == "??") {
+            pattern.bytes.push_back(0);
+            pattern.mask.push_back(0);
+            continue;
+        }
+        u8 value{};
+        const char* token_end = token.data() + token.size();
+        const auto [ptr, ec] = std::from_chars(token.data(), token_end, value, 16);
+        if (token.size() > 2 || ec != std::errc{} || ptr != token_end) {
+            return std::nullopt;
+        }
+        pattern.bytes.push_back(value);
+        pattern.mask.push_back(0xFF);
+    }
+    if (pattern.bytes.empty()) {
+        return std::nullopt;
+    }
+    pattern.size = pattern.bytes.size();
+    patterns.push_back(std::move(pattern));
+    return patterns.size() - 1;
+}
+
+bool PatternScanner::MatchesAt(size_t index, std::span<const u8> image, size_t offset) const {
+    const Pattern& pattern = patterns[index];
+    if (offset > image.size() || image.size() - offset < pattern.size) {
+        return false;
+    }
+    const u8* data = image.data() + offset;
+    size_t i = 0;
+    for (; i + sizeof(u64) <= pattern.size; i += sizeof(u64)) {
+        u64 value, bytes, mask;
+        std::memcpy(&value, data + i, sizeof(u64));
+        std::memcpy(&bytes, pattern.bytes.data() + i, sizeof(u64));
+        std::memcpy(&mask, pattern.mask.data() + i, sizeof(u64));
+        if (((value ^ bytes) & mask) != 0) {
+            return false;
+        }
+    }
+    for (; i < pattern.size; i++) {
+        if (((data[i] ^ pattern.bytes[i]) & pattern.mask[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::array<u64, 256> SampleHistogram(std::span<const u8> image) {
+    std::array<u64, 256> histogram;
+    histogram.fill(1);
+    // An odd stride keeps the samples from lining up with instruction or table alignment.
+    const size_t stride = (image.size() / MaxHistogramSamples) | 1;
+    for (size_t i = 0; i < image.size(); i += stride) {
+        histogram[image[i]]++;
+    }
+    return histogram;
+}
+
+std::vector<size_t> PatternScanner::Scan(std::span<const u8> image, u32 num_threads) const {
+    std::vector<size_t> results(patterns.size(), NotFound);
+    if (patterns.empty() || image.empty()) {
+        return results;
+    }
+
+    // Anchor every pattern on the pair of bytes that is least frequent in the image.
+    const auto histogram = SampleHistogram(image);
+    CompiledSet set{};
+    auto& anchors = set.anchors;
+    anchors.resize(patterns.size());
+    for (size_t p = 0; p < patterns.size(); p++) {
+        const Pattern& pattern = patterns[p];
+        u64 best_cost = ~u64{0};
+        for (size_t i = 0; i < pattern.size; i++) {
+            if (pattern.mask[i] == 0) {
+                continue;
+            }
+            const bool pair = i + 1 < pattern.size && pattern.mask[i + 1] != 0;
+            const u64 cost = histogram[pattern.bytes[i]] *
+                             (pair ? histogram[pattern.bytes[i + 1]] : MaxHistogramSamples * 2);
+            if (cost < best_cost) {
+                best_cost = cost;
+                anchors[p] = Anchor{static_cast<u32>(i), pattern.bytes[i],
+                                    pair ? pattern.bytes[i + 1] : AnyByte};
+            }
+        }
+    }
+
+    set.filter.resize(NumKeys / 64);
+    set.key_start.resize(NumKeys + 1);
+    for (size_t p = 0; p < patterns.size(); p++) {
+        if (!anchors[p]) {
+            // Nothing but wildcards, so the pattern matches at the start of any large enough image
+            results[p] = patterns[p].size <= image.size() ? 0 : NotFound;
+            continue;
+        }
+        set.num_anchored++;
+        ForEachKey(*anchors[p], [&](u32 key) {
+            set.filter[key / 64] |= u64{1} << (key % 64);
+            set.key_start[key + 1]++;
+        });
+    }
+    if (set.num_anchored == 0) {
+        return results;
+    }
+    for (size_t key = 0; key < NumKeys; key++) {
+        set.key_start[key + 1] += set.key_start[key];
+    }
+    set.entries.resize(set.key_start[NumKeys]);
+    std::vector<u32> fill(set.key_start.begin(), set.key_start.end() - 1);
+    for (size_t p = 0; p < patterns.size(); p++) {
+        if (anchors[p]) {
+            ForEachKey(*anchors[p], [&](u32 key) {
+                set.entries[fill[key]++] = {static_cast<u32>(p), anchors[p]->offset};
+            });
+        }
+    }
+
+#ifdef PATTERN_SCANNER_USE_AVX
+    std::vector<std::pair<u32, u32>> distinct;
+    for (const auto& anchor : anchors) {
+        if (anchor) {
+            distinct.emplace_back(anchor->first, anchor->second);
+        }
+    }
+    std::ranges::sort(distinct);
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    set.use_prefilter = distinct.size() <= MaxPrefilterAnchors;
+    for (size_t i = 0; i < distinct.size(); i++) {
+        const u8 bucket = static_cast<u8>(1 << (i % 8));
+        const auto [first, second] = distinct[i];
+        set.lo0[first & 0xF] |= bucket;
+        set.hi0[first >> 4] |= bucket;
+        for (u32 nibble = 0; nibble < 16; nibble++) {
+            if (second == AnyByte || (second & 0xF) == nibble) {
+                set.lo1[nibble] |= bucket;
+            }
+            if (second == AnyByte || (second >> 4) == nibble) {
+                set.hi1[nibble] |= bucket;
+            }
+        }
+    }
+#endif
+
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    const size_t chunk_size =
+        std::max(MinChunkSize, (image.size() + num_threads - 1) / num_threads);
+    const size_t num_chunks = (image.size() + chunk_size - 1) / chunk_size;
+    if (num_chunks == 1) {
+        ScanChunk(set, image, 0, image.size(), results);
+        return results;
+    }
+
+    // Each chunk owns the anchor positions inside it and may read past its end to compare whole
+    // patterns, so the first chunk that found a pattern holds its first match.
+    std::vector<std::vector<size_t>> chunk_results(num_chunks, results);
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(num_chunks);
+        for (size_t c = 0; c < num_chunks; c++) {
+            const size_t begin = c * chunk_size;
+            const size_t end = std::min(begin + chunk_size, image.size());
+            workers.emplace_back(
+                [&, c, begin, end] { ScanChunk(set, image, begin, end, chunk_results[c]); });
+        }
+    }
+    for (size_t p = 0; p < patterns.size(); p++) {
+        for (const auto& chunk : chunk_results) {
+            if (chunk[p] != NotFound) {
+                results[p] = chunk[p];
+                break;
+            }
+        }
+    }
+    return results;
+}
+
+void PatternScanner::ScanChunk(const CompiledSet& set, std::span<const u8> image, size_t begin,
+                               size_t end, std::vector<size_t>& results) const {
+    const u8* data = image.data();
+    const size_t size = image.size();
+    size_t remaining = set.num_anchored;
+
+    // Keys are dropped from the chunk's copy of the filter once all their patterns were found,
+    // so a common anchor stops costing lookups after its first match.
+    std::vector<u64> filter = set.filter;
+    const auto retire = [&](u32 pattern) {
+        ForEachKey(*set.anchors[pattern], [&](u32 key) {
+            for (u32 e = set.key_start[key]; e < set.key_start[key + 1]; e++) {
+                if (results[set.entries[e].pattern] == NotFound) {
+                    return;
+                }
+            }
+            filter[key / 64] &= ~(u64{1} << (key % 64));
+        });
+    };
+
+    // Returns true once every pattern has been found in this chunk.
+    const auto check = [&](size_t pos) {
+        const u32 key = data[pos] | (pos + 1 < size ? data[pos + 1] << 8 : 0);
+        if (((filter[key / 64] >> (key % 64)) & 1) == 0) {
+            return false;
+        }
+        for (u32 e = set.key_start[key]; e < set.key_start[key + 1]; e++) {
+            const auto& entry = set.entries[e];
+            if (pos < entry.anchor || results[entry.pattern] != NotFound) {
+                continue;
+            }
+            const size_t start = pos - entry.anchor;
+            if (MatchesAt(entry.pattern, image, start)) {
+                results[entry.pattern] = start;
+                if (--remaining == 0) {
+                    return true;
+                }
+                retire(entry.pattern);
+            }
+        }
+        return false;
+    };
+
+    size_t pos = begin;
+#ifdef PATTERN_SCANNER_USE_AVX
+    if (set.use_prefilter) {
+        const auto load_table = [](const std::array<u8, 16>& table) {
+            return _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+        };
+        const __m256i lo0 = load_table(set.lo0);
+        const __m256i hi0 = load_table(set.hi0);
+        const __m256i lo1 = load_table(set.lo1);
+        const __m256i hi1 = load_table(set.hi1);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const auto classify = [&](__m256i bytes, __m256i lo_table, __m256i hi_table) {
+            const __m256i lo = _mm256_and_si256(bytes, nibble);
+            const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble);
+            return _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                    _mm256_shuffle_epi8(hi_table, hi));
+        };
+        // Each lane checks the byte at its position against the first anchor byte and the next
+        // one against the second, for all buckets at once.
+        for (; pos + 32 <= end && pos + 33 <= size; pos += 32) {
+            const __m256i first =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            const __m256i second =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 1));
+            const __m256i buckets =
+                _mm256_and_si256(classify(first, lo0, hi0), classify(second, lo1, hi1));
+            u32 candidates = ~static_cast<u32>(_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(buckets, _mm256_setzero_si256())));
+            while (candidates != 0) {
+                if (check(pos + std::countr_zero(candidates))) {
+                    return;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+    }
+#endif
+    const size_t pair_end = std::min(end, size - 1);
+    for (; pos < pair_end; pos++) {
+        u16 key;
+        std::memcpy(&key, data + pos, sizeof(key));
+        if (((filter[key / 64] >> (key % 64)) & 1) != 0 && check(pos)) {
+            return;
+        }
+    }
+    for (; pos < end; pos++) {
+        if (check(pos)) {
+            return;
+        }
+    }
+}
+
+} // namespace Common
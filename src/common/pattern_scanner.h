@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "common/types.h"
+
+namespace Common {
+
+/**
+ * Finds the first occurrence of many byte signatures with a single pass over an image.
+ * Signatures are written as space separated hex bytes, with "?" or "??" matching any byte,
+ * e.g. "48 8B ?? ?? E8".
+ */
+class PatternScanner {
+public:
+    static constexpr size_t NotFound = ~size_t{0};
+
+    /// Adds a signature and returns its index, or nothing if it is malformed.
+    std::optional<size_t> AddPattern(std::string_view signature);
+
+    /// Returns the offset of the first match of every pattern in index order, or NotFound.
+    /// The image is split into chunks scanned by up to num_threads threads (0 picks one per
+    /// hardware thread).
+    std::vector<size_t> Scan(std::span<const u8> image, u32 num_threads = 0) const;
+
+    /// Returns whether the pattern matches the image at the given offset.
+    bool MatchesAt(size_t index, std::span<const u8> image, size_t offset) const;
+
+    size_t PatternSize(size_t index) const {
+        return patterns[index].size;
+    }
+
+    size_t NumPatterns() const {
+        return patterns.size();
+    }
+
+private:
+    struct Pattern {
+        std::vector<u8> bytes;
+        std::vector<u8> mask;
+        size_t size;
+    };
+
+    struct CompiledSet;
+
+    void ScanChunk(const CompiledSet& set, std::span<const u8> image, size_t begin, size_t end,
+                   std::vector<size_t>& results) const;
+
+    std::vector<Pattern> patterns;
+};
+
+} // namespace Common
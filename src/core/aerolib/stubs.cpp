@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <mutex>
 #include "common/logging/log.h"
 #include "core/aerolib/aerolib.h"
 #include "core/aerolib/stubs.h"
@@ -54,20 +56,33 @@ consteval auto MakeStubArray(std::index_sequence<Is...>) {
 
 constexpr auto stub_handlers = MakeStubArray(std::make_index_sequence<MAX_STUBS>{});
 static u32 UsedStubEntries;
+static std::mutex stub_mutex;
 
 u64 GetStub(const char* nid) {
+    // The linker resolves relocations from several threads.
+    std::scoped_lock lk{stub_mutex};
     if (UsedStubEntries >= MAX_STUBS) {
         return (u64)&UnknownStub;
     }
 
+    // Released slots are handed out again, so both fields are set
     const auto entry = FindByNid(nid);
+    stub_nids[UsedStubEntries] = entry;
     if (!entry) {
         stub_nids_unknown[UsedStubEntries] = nid;
-    } else {
-        stub_nids[UsedStubEntries] = entry;
     }
 
     return (u64)stub_handlers[UsedStubEntries++];
 }
 
+u32 GetNumUsedStubs() {
+    std::scoped_lock lk{stub_mutex};
+    return UsedStubEntries;
+}
+
+void ReleaseStubs(u32 num_used) {
+    std::scoped_lock lk{stub_mutex};
+    UsedStubEntries = std::min(UsedStubEntries, num_used);
+}
+
 } // namespace Core::AeroLib
@@ -11,4 +11,10 @@ u64 UnresolvedStub();
 
 u64 GetStub(const char* nid);
 
+/// Returns how many stub slots are in use, to release the ones handed out after this point.
+u32 GetNumUsedStubs();
+
+/// Returns the slots handed out since GetNumUsedStubs returned num_used to the pool.
+void ReleaseStubs(u32 num_used);
+
 } // namespace Core::AeroLib
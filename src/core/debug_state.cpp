@@ -210,8 +210,10 @@ void DebugStateImpl::PushRegsDumpCompute(uintptr_t base_addr, uintptr_t header_a
 void DebugStateImpl::CollectShader(const std::string& name, Shader::LogicalStage l_stage,
                                    vk::ShaderModule module, std::span<const u32> spv,
                                    std::span<const u32> raw_code, std::span<const u32> patch_spv,
-                                   bool is_patched) {
-    shader_dump_list.emplace_back(name, l_stage, module, std::vector<u32>{spv.begin(), spv.end()},
-                                  std::vector<u32>{raw_code.begin(), raw_code.end()},
-                                  std::vector<u32>{patch_spv.begin(), patch_spv.end()}, is_patched);
+                                   bool is_patched, std::span<const Shader::PassStats> pass_stats) {
+    shader_dump_list.emplace_back(
+        name, l_stage, module, std::vector<u32>{spv.begin(), spv.end()},
+        std::vector<u32>{raw_code.begin(), raw_code.end()},
+        std::vector<u32>{patch_spv.begin(), patch_spv.end()}, is_patched,
+        std::vector<Shader::PassStats>{pass_stats.begin(), pass_stats.end()});
 }
@@ -18,6 +18,7 @@
 #include "video_core/renderer_vulkan/vk_presenter.h"
 #include "widget/frame_dump.h"
 #include "widget/frame_graph.h"
+#include "widget/lock_contention.h"
 #include "widget/memory_map.h"
 #include "widget/module_list.h"
 #include "widget/shader_list.h"
@@ -48,6 +49,7 @@ static bool just_opened_options = false;
 static Widget::MemoryMapViewer memory_map;
 static Widget::ShaderList shader_list;
 static Widget::ModuleList module_list;
+static Widget::LockContention lock_contention;
 
 // clang-format off
 static std::string help_text =
@@ -129,6 +131,9 @@ void L::DrawMenuBar() {
             if (MenuItem("Module list")) {
                 module_list.open = true;
             }
+            if (MenuItem("Lock contention")) {
+                lock_contention.open = true;
+            }
             ImGui::EndMenu();
         }
 
@@ -273,6 +278,9 @@ void L::DrawAdvanced() {
     if (module_list.open) {
         module_list.Draw();
     }
+    if (lock_contention.open) {
+        lock_contention.Draw();
+    }
 }
 
 void L::DrawSimple() {
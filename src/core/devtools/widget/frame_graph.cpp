@@ -6,8 +6,10 @@
 #include "common/singleton.h"
 #include "core/debug_state.h"
 #include "core/emulator_settings.h"
+#include "core/libraries/font/glyph_cache.h"
 #include "imgui.h"
 #include "imgui_internal.h"
+#include "video_core/cache_storage.h"
 
 using namespace ImGui;
 
@@ -101,6 +103,36 @@ void FrameGraph::Draw() {
         Text("Output Res: %dx%d", DebugState.output_resolution.first,
              DebugState.output_resolution.second);
         Text("FSR: %s", DebugState.is_using_fsr ? "on" : "off");
+        Text("Page write faults: %u, protection changes: %u per frame",
+             DebugState.page_write_faults.load(), DebugState.page_protect_calls.load());
+        Text("Dirty page scans: %u pages in %u us per frame", DebugState.page_scan_dirty.load(),
+             DebugState.page_scan_us.load());
+
+        const auto& cache = Storage::DataBase::Instance();
+        if (cache.IsOpened()) {
+            const auto stats = cache.GetWriteStats();
+            SeparatorText("Pipeline cache");
+            Text("Write queue: %u blobs", stats.queue_depth);
+            Text("Written: %llu blobs, %.1f KiB in %llu flushes",
+                 static_cast<unsigned long long>(stats.blobs_written),
+                 static_cast<double>(stats.bytes_written) / 1024.0,
+                 static_cast<unsigned long long>(stats.num_flushes));
+        }
+
+        const auto glyphs = Libraries::Font::Internal::GlyphCache::Instance().GetStats();
+        if (glyphs.hits + glyphs.misses != 0) {
+            SeparatorText("Glyph cache");
+            Text("Hits: %llu, misses: %llu (%.1f%% hit rate)",
+                 static_cast<unsigned long long>(glyphs.hits),
+                 static_cast<unsigned long long>(glyphs.misses),
+                 100.0 * static_cast<double>(glyphs.hits) /
+                     static_cast<double>(glyphs.hits + glyphs.misses));
+            Text("%zu glyphs in %.1f of %.1f KiB, %llu evicted, %llu too large", glyphs.num_glyphs,
+                 static_cast<double>(glyphs.used_bytes) / 1024.0,
+                 static_cast<double>(glyphs.capacity) / 1024.0,
+                 static_cast<unsigned long long>(glyphs.evictions),
+                 static_cast<unsigned long long>(glyphs.uncached));
+        }
     }
     End();
 }
@@ -0,0 +1,83 @@
+//  SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "lock_contention.h"
+
+#include <algorithm>
+#include <functional>
+#include <imgui.h>
+
+using namespace ImGui;
+using namespace Libraries::Kernel;
+
+namespace Core::Devtools::Widget {
+
+// Collecting takes every sleep queue chain lock, so the table is only refreshed periodically.
+constexpr double RefreshInterval = 0.5;
+
+void LockContention::Draw() {
+    SetNextWindowSize({700.0f, 400.0f}, ImGuiCond_FirstUseEver);
+    if (!Begin("Lock Contention", &open)) {
+        End();
+        return;
+    }
+
+    const double now = GetTime();
+    bool reset = Button("Reset");
+    if (reset) {
+        SleepqResetStats();
+    }
+    if (reset || last_refresh < 0.0 || now - last_refresh >= RefreshInterval) {
+        stats = SleepqGetStats();
+        std::ranges::sort(stats, std::greater{}, &SleepqStats::blocked_ns);
+        last_refresh = now;
+    }
+    SameLine();
+    Text("%zu wait channels", stats.size());
+
+    if (BeginTable("LockContentionTable", 7,
+                   ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                       ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg)) {
+        TableSetupScrollFreeze(0, 1);
+        TableSetupColumn("Wait channel", ImGuiTableColumnFlags_WidthStretch);
+        TableSetupColumn("Sleeps");
+        TableSetupColumn("Wakeups");
+        TableSetupColumn("Chain contended");
+        TableSetupColumn("Max waiters");
+        TableSetupColumn("Blocked ms");
+        TableSetupColumn("Avg us");
+        TableHeadersRow();
+
+        for (const auto& entry : stats) {
+            TableNextRow();
+
+            TableSetColumnIndex(0);
+            if (entry.name[0] != '\0') {
+                Text("%s (%p)", entry.name.data(), entry.wchan);
+            } else {
+                Text("%p", entry.wchan);
+            }
+            TableSetColumnIndex(1);
+            Text("%llu", static_cast<unsigned long long>(entry.sleeps));
+            TableSetColumnIndex(2);
+            Text("%llu", static_cast<unsigned long long>(entry.wakeups));
+            TableSetColumnIndex(3);
+            Text("%llu", static_cast<unsigned long long>(entry.chain_contended));
+            TableSetColumnIndex(4);
+            Text("%u", entry.max_waiters);
+            TableSetColumnIndex(5);
+            Text("%.2f", static_cast<double>(entry.blocked_ns) / 1e6);
+            TableSetColumnIndex(6);
+            if (entry.wakeups != 0) {
+                Text("%.1f", static_cast<double>(entry.blocked_ns) / 1e3 / entry.wakeups);
+            } else {
+                TextUnformatted("-");
+            }
+        }
+        EndTable();
+    }
+
+    End();
+}
+
+} // namespace Core::Devtools::Widget
@@ -0,0 +1,22 @@
+//  SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <vector>
+
+#include "core/libraries/kernel/threads/sleepq.h"
+
+namespace Core::Devtools::Widget {
+
+class LockContention {
+    std::vector<Libraries::Kernel::SleepqStats> stats;
+    double last_refresh = -1.0;
+
+public:
+    bool open = false;
+
+    void Draw();
+};
+
+} // namespace Core::Devtools::Widget
@@ -15,6 +15,7 @@
 #include "core/emulator_settings.h"
 #include "imgui/imgui_std.h"
 #include "sdl_window.h"
+#include "shader_recompiler/pass_stats.h"
 #include "video_core/renderer_vulkan/vk_presenter.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 
@@ -24,6 +25,61 @@ using namespace ImGui;
 
 namespace Core::Devtools::Widget {
 
+static void DrawPassStats(std::span<const Shader::PassStats> passes) {
+    if (!BeginTable("PASS_STATS", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        return;
+    }
+    TableSetupColumn("Pass");
+    TableSetupColumn("Time (us)");
+    TableSetupColumn("Instructions");
+    TableSetupColumn("Blocks");
+    TableHeadersRow();
+    for (const auto& pass : passes) {
+        TableNextRow();
+        TableSetColumnIndex(0);
+        TextUnformatted(pass.name.data(), pass.name.data() + pass.name.size());
+        TableSetColumnIndex(1);
+        Text("%.1f", static_cast<double>(pass.time_ns) / 1000.0);
+        TableSetColumnIndex(2);
+        Text("%u -> %u", pass.insts_before, pass.insts_after);
+        TableSetColumnIndex(3);
+        Text("%u -> %u", pass.blocks_before, pass.blocks_after);
+    }
+    EndTable();
+}
+
+static void DrawPassTotals() {
+    const auto totals = Shader::GetPassTotals();
+    if (totals.empty()) {
+        TextUnformatted("No shaders were translated yet");
+        return;
+    }
+    if (!BeginTable("PASS_TOTALS", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        return;
+    }
+    TableSetupColumn("Pass");
+    TableSetupColumn("Runs");
+    TableSetupColumn("Total (ms)");
+    TableSetupColumn("Max (us)");
+    TableSetupColumn("Removed");
+    TableHeadersRow();
+    for (const auto& pass : totals) {
+        TableNextRow();
+        TableSetColumnIndex(0);
+        TextUnformatted(pass.name.data(), pass.name.data() + pass.name.size());
+        TableSetColumnIndex(1);
+        Text("%llu", static_cast<unsigned long long>(pass.num_runs));
+        TableSetColumnIndex(2);
+        Text("%.2f", static_cast<double>(pass.time_ns) / 1000000.0);
+        TableSetColumnIndex(3);
+        Text("%.1f", static_cast<double>(pass.max_time_ns) / 1000.0);
+        TableSetColumnIndex(4);
+        Text("%lld", static_cast<long long>(pass.insts_before) -
+                         static_cast<long long>(pass.insts_after));
+    }
+    EndTable();
+}
+
 ShaderList::Selection::Selection(int index)
     : index(index), isa_editor(std::make_unique<TextEditor>()),
       glsl_editor(std::make_unique<TextEditor>()) {
@@ -217,6 +273,10 @@ bool ShaderList::Selection::DrawShader(DebugStateType::ShaderDump& value) {
         }
     }
 
+    if (!value.pass_stats.empty() && CollapsingHeader("Pass statistics")) {
+        DrawPassStats(value.pass_stats);
+    }
+
     if (showing_bin) {
         isa_editor->Render(value.is_patched ? "SPIRV" : "ISA", GetContentRegionAvail());
     } else {
@@ -253,6 +313,18 @@ void ShaderList::Draw() {
     InputTextEx("##search_shader", "Search by name", search_box, sizeof(search_box), {},
                 ImGuiInputTextFlags_None);
 
+    if (EmulatorSettings.IsShaderPassStats() && CollapsingHeader("Pass statistics")) {
+        if (Button("Export")) {
+            const auto path =
+                Common::FS::GetUserPath(Common::FS::PathType::ShaderDir) / "pass_stats.json";
+            if (Shader::WritePassStats(path)) {
+                DebugState.ShowDebugMessage("Pass statistics saved to " +
+                                            Common::U8stringToString(path.u8string()));
+            }
+        }
+        DrawPassTotals();
+    }
+
     auto width = GetContentRegionAvail().x;
     int i = 0;
     for (const auto& shader : DebugState.shader_dump_list) {
@@ -35,6 +35,12 @@ enum GpuReadbacksMode : int {
     Precise,
 };
 
+enum GpuWriteTracking : int {
+    Faults,
+    DirtyScan,
+    Auto,
+};
+
 enum class ConfigMode {
     Default,
     Global,
@@ -226,7 +232,8 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(GeneralSettings, install_dirs, addon_install_
 // -------------------------------
 struct LogSettings {
     Setting<bool> append{false}; // specific
-    Setting<bool> enable{true};  // specific
+    Setting<bool> deferred{false};
+    Setting<bool> enable{true}; // specific
     Setting<std::string> filter{""};
     Setting<u32> max_skip_duration{5'000};
     Setting<bool> separate{false}; // specific
@@ -241,6 +248,7 @@ struct LogSettings {
     std::vector<OverrideItem> GetOverrideableFields() const {
         return std::vector<OverrideItem>{
             make_override<LogSettings>("append", &LogSettings::append),
+            make_override<LogSettings>("deferred", &LogSettings::deferred),
             make_override<LogSettings>("enable", &LogSettings::enable),
             make_override<LogSettings>("filter", &LogSettings::filter),
             make_override<LogSettings>("max_skip_duration", &LogSettings::max_skip_duration),
@@ -255,11 +263,11 @@ struct LogSettings {
     }
 };
 #ifdef _WIN32
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LogSettings, append, enable, filter, max_skip_duration, separate,
-                                   size_limit, skip_duplicate, sync, type)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LogSettings, append, deferred, enable, filter, max_skip_duration,
+                                   separate, size_limit, skip_duplicate, sync, type)
 #else
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LogSettings, append, enable, filter, max_skip_duration, separate,
-                                   size_limit, skip_duplicate, sync)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LogSettings, append, deferred, enable, filter, max_skip_duration,
+                                   separate, size_limit, skip_duplicate, sync)
 #endif
 
 // -------------------------------
@@ -268,15 +276,24 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LogSettings, append, enable, filter, max_skip
 struct DebugSettings {
     Setting<bool> debug_dump{false};         // specific
     Setting<bool> shader_collect{false};     // specific
+    Setting<bool> shader_pass_stats{false};  // specific
+    Setting<u32> pm4_capture_frames{0};      // specific
+    Setting<bool> verify_relocations{false}; // specific
     Setting<std::string> config_version{""}; // specific
 
     std::vector<OverrideItem> GetOverrideableFields() const {
         return std::vector<OverrideItem>{
             make_override<DebugSettings>("debug_dump", &DebugSettings::debug_dump),
-            make_override<DebugSettings>("shader_collect", &DebugSettings::shader_collect)};
+            make_override<DebugSettings>("shader_collect", &DebugSettings::shader_collect),
+            make_override<DebugSettings>("shader_pass_stats", &DebugSettings::shader_pass_stats),
+            make_override<DebugSettings>("pm4_capture_frames",
+                                         &DebugSettings::pm4_capture_frames),
+            make_override<DebugSettings>("verify_relocations",
+                                         &DebugSettings::verify_relocations)};
     }
 };
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(DebugSettings, debug_dump, shader_collect, config_version)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(DebugSettings, debug_dump, shader_collect, shader_pass_stats,
+                                   pm4_capture_frames, verify_relocations, config_version)
 
 // -------------------------------
 // Input settings
@@ -367,6 +384,8 @@ struct GPUSettings {
     Setting<u32> readbacks_mode{GpuReadbacksMode::Disabled};
     Setting<bool> readback_linear_images_enabled{false};
     Setting<bool> direct_memory_access_enabled{false};
+    Setting<bool> batch_write_faults{false};
+    Setting<u32> write_tracking{GpuWriteTracking::Faults};
     Setting<bool> dump_shaders{false};
     Setting<bool> patch_shaders{false};
     Setting<u32> vblank_frequency{60};
@@ -398,6 +417,8 @@ struct GPUSettings {
                                        &GPUSettings::readback_linear_images_enabled),
             make_override<GPUSettings>("direct_memory_access_enabled",
                                        &GPUSettings::direct_memory_access_enabled),
+            make_override<GPUSettings>("batch_write_faults", &GPUSettings::batch_write_faults),
+            make_override<GPUSettings>("write_tracking", &GPUSettings::write_tracking),
             make_override<GPUSettings>("vblank_frequency", &GPUSettings::vblank_frequency),
         };
     }
@@ -405,9 +426,10 @@ struct GPUSettings {
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(GPUSettings, window_width, window_height, internal_screen_width,
                                    internal_screen_height, null_gpu, copy_gpu_buffers,
                                    readbacks_mode, readback_linear_images_enabled,
-                                   direct_memory_access_enabled, dump_shaders, patch_shaders,
-                                   vblank_frequency, full_screen, full_screen_mode, present_mode,
-                                   hdr_allowed, fsr_enabled, rcas_enabled, rcas_attenuation)
+                                   direct_memory_access_enabled, batch_write_faults, write_tracking,
+                                   dump_shaders, patch_shaders, vblank_frequency, full_screen,
+                                   full_screen_mode, present_mode, hdr_allowed, fsr_enabled,
+                                   rcas_enabled, rcas_attenuation)
 // -------------------------------
 // Vulkan settings
 // -------------------------------
@@ -423,6 +445,8 @@ struct VulkanSettings {
     Setting<bool> vkguest_markers{false};
     Setting<bool> pipeline_cache_enabled{false};
     Setting<bool> pipeline_cache_archived{false};
+    Setting<bool> pipeline_cache_background_load{false};
+    Setting<bool> async_shader_compile{false};
     std::vector<OverrideItem> GetOverrideableFields() const {
         return std::vector<OverrideItem>{
             make_override<VulkanSettings>("gpu_id", &VulkanSettings::gpu_id),
@@ -443,6 +467,10 @@ struct VulkanSettings {
                                           &VulkanSettings::pipeline_cache_enabled),
             make_override<VulkanSettings>("pipeline_cache_archived",
                                           &VulkanSettings::pipeline_cache_archived),
+            make_override<VulkanSettings>("pipeline_cache_background_load",
+                                          &VulkanSettings::pipeline_cache_background_load),
+            make_override<VulkanSettings>("async_shader_compile",
+                                          &VulkanSettings::async_shader_compile),
         };
     }
 };
@@ -450,7 +478,8 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(VulkanSettings, gpu_id, renderdoc_enabled, vk
                                    vkvalidation_core_enabled, vkvalidation_sync_enabled,
                                    vkvalidation_gpu_enabled, vkcrash_diagnostic_enabled,
                                    vkhost_markers, vkguest_markers, pipeline_cache_enabled,
-                                   pipeline_cache_archived)
+                                   pipeline_cache_archived, pipeline_cache_background_load,
+                                   async_shader_compile)
 
 // -------------------------------
 // Main manager
@@ -609,6 +638,7 @@ public:
 
     // Log settings
     SETTING_FORWARD_BOOL(m_log, LogAppend, append)
+    SETTING_FORWARD_BOOL(m_log, LogDeferred, deferred)
     SETTING_FORWARD_BOOL(m_log, LogEnable, enable)
     SETTING_FORWARD(m_log, LogFilter, filter)
     SETTING_FORWARD(m_log, LogMaxSkipDuration, max_skip_duration)
@@ -632,6 +662,9 @@ public:
     // Debug settings
     SETTING_FORWARD_BOOL(m_debug, DebugDump, debug_dump)
     SETTING_FORWARD_BOOL(m_debug, ShaderCollect, shader_collect)
+    SETTING_FORWARD_BOOL(m_debug, ShaderPassStats, shader_pass_stats)
+    SETTING_FORWARD(m_debug, Pm4CaptureFrames, pm4_capture_frames)
+    SETTING_FORWARD_BOOL(m_debug, VerifyRelocations, verify_relocations)
     SETTING_FORWARD(m_debug, ConfigVersion, config_version)
 
     // GPU Settings
@@ -652,6 +685,8 @@ public:
     SETTING_FORWARD(m_gpu, ReadbacksMode, readbacks_mode)
     SETTING_FORWARD_BOOL(m_gpu, ReadbackLinearImagesEnabled, readback_linear_images_enabled)
     SETTING_FORWARD_BOOL(m_gpu, DirectMemoryAccessEnabled, direct_memory_access_enabled)
+    SETTING_FORWARD_BOOL(m_gpu, BatchWriteFaults, batch_write_faults)
+    SETTING_FORWARD(m_gpu, WriteTracking, write_tracking)
     SETTING_FORWARD_BOOL_READONLY(m_gpu, PatchShaders, patch_shaders)
 
     u32 GetVblankFrequency() {
@@ -696,6 +731,8 @@ public:
     SETTING_FORWARD_BOOL(m_vulkan, VkGuestMarkersEnabled, vkguest_markers)
     SETTING_FORWARD_BOOL(m_vulkan, PipelineCacheEnabled, pipeline_cache_enabled)
     SETTING_FORWARD_BOOL(m_vulkan, PipelineCacheArchived, pipeline_cache_archived)
+    SETTING_FORWARD_BOOL(m_vulkan, PipelineCacheBackgroundLoad, pipeline_cache_background_load)
+    SETTING_FORWARD_BOOL(m_vulkan, AsyncShaderCompile, async_shader_compile)
 
 #undef SETTING_FORWARD
 #undef SETTING_FORWARD_BOOL
@@ -1,6 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2024-2026 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <fmt/format.h>
 #include "common/aes.h"
 #include "common/key_manager.h"
 #include "common/logging/log.h"
@@ -42,22 +46,19 @@ static void hexToBytes(const char* hex, unsigned char* dst) {
     }
 }
 
-bool TRP::Extract(const std::filesystem::path& trophyPath, std::string npCommId,
-                  const std::filesystem::path& outputPath) {
-    // Retrieve trophy key
-    const auto& user_key_vec =
-        KeyManager::GetInstance()->GetAllKeys().TrophyKeySet.ReleaseTrophyKey;
-
-    if (user_key_vec.size() != 16) {
-        LOG_INFO(Common_Filesystem, "Trophy decryption key is not specified");
-        return false;
-    }
+// Written once every entry was extracted, so interrupted extractions are redone.
+static constexpr std::string_view ExtractedStampName = "TRP.STAMP";
+static constexpr u32 MaxExtractThreads = 8;
 
-    std::array<u8, 16> user_key{};
-    std::copy(user_key_vec.begin(), user_key_vec.end(), user_key.begin());
+static std::string ReadStamp(const std::filesystem::path& path) {
+    Common::FS::IOFile file(path, Common::FS::FileAccessMode::Read);
+    return file.IsOpen() ? file.ReadString(file.GetSize()) : std::string{};
+}
 
-    s32 trpFileIndex = 0;
-    bool success = true;
+bool TRP::Extract(const std::filesystem::path& trophyPath, std::string npCommId,
+                  const std::filesystem::path& outputPath) {
+    u32 trpFileIndex = 0;
+    std::atomic_bool success = true;
     try {
         if (trophyPath.extension() != ".trp") {
             return false;
@@ -79,57 +80,105 @@ bool TRP::Extract(const std::filesystem::path& trophyPath, std::string npCommId,
             return false;
         }
 
-        s64 seekPos = sizeof(TrpHeader);
-        // Create output directories
+        // The header carries a SHA-1 of the whole file, which identifies its contents.
+        std::string stamp;
+        for (const u8 byte : header.digest) {
+            stamp += fmt::format("{:02x}", byte);
+        }
+        stamp += fmt::format(" {}", static_cast<u64>(header.file_size));
+        const auto stamp_path = outputPath / ExtractedStampName;
+        if (ReadStamp(stamp_path) == stamp) {
+            LOG_INFO(Common_Filesystem, "Trophy files for {} are up to date", npCommId);
+            return true;
+        }
+
+        // Retrieve trophy key
+        const auto& user_key_vec =
+            KeyManager::GetInstance()->GetAllKeys().TrophyKeySet.ReleaseTrophyKey;
+        if (user_key_vec.size() != 16) {
+            LOG_INFO(Common_Filesystem, "Trophy decryption key is not specified");
+            return false;
+        }
+        std::array<u8, 16> user_key{};
+        std::copy(user_key_vec.begin(), user_key_vec.end(), user_key.begin());
+
+        // Create output directories, dropping what an older or interrupted extraction left.
+        std::filesystem::remove_all(outputPath);
         if (!std::filesystem::create_directories(outputPath / "Icons") ||
             !std::filesystem::create_directories(outputPath / "Xml")) {
             LOG_ERROR(Common_Filesystem, "Failed to create output directories for {}", npCommId);
             return false;
         }
 
-        // Process each entry in the TRP file
-        for (u32 i = 0; i < header.entry_num; i++) {
-            if (!file.Seek(seekPos)) {
-                LOG_ERROR(Common_Filesystem, "Failed to seek to TRP entry offset");
-                success = false;
-                break;
-            }
-            seekPos += static_cast<s64>(header.entry_size);
+        // Trophy files are a few megabytes, read them at once so entries can be decoded in
+        // parallel.
+        std::vector<u8> data(file.GetSize());
+        if (!file.Seek(0) || file.Read(data) != data.size()) {
+            LOG_ERROR(Common_Filesystem, "Failed to read trophy file {}", trophyPath.string());
+            return false;
+        }
 
-            TrpEntry entry;
-            if (!file.Read(entry)) {
+        std::vector<TrpEntry> entries;
+        for (u32 i = 0; i < header.entry_num; i++) {
+            const u64 offset = sizeof(TrpHeader) + u64{i} * header.entry_size;
+            if (offset + sizeof(TrpEntry) > data.size()) {
                 LOG_ERROR(Common_Filesystem, "Failed to read TRP entry");
                 success = false;
                 break;
             }
+            std::memcpy(&entries.emplace_back(), data.data() + offset, sizeof(TrpEntry));
+        }
 
-            std::string_view name(entry.entry_name);
-
-            if (entry.flag == ENTRY_FLAG_PNG) {
-                if (!ProcessPngEntry(file, entry, outputPath, name)) {
-                    success = false;
-                    // Continue with next entry
-                }
-            } else if (entry.flag == ENTRY_FLAG_ENCRYPTED_XML) {
-                // Check if we have a valid NPCommID for decryption
-                if (npCommId.size() >= 12 && npCommId[0] == 'N' && npCommId[1] == 'P') {
-                    if (!ProcessEncryptedXmlEntry(file, entry, outputPath, name, user_key,
-                                                  npCommId)) {
-                        success = false;
-                        // Continue with next entry
+        // Process each entry in the TRP file
+        std::atomic<u32> next_entry = 0;
+        const auto process_entries = [&] {
+            for (u32 i = next_entry++; i < entries.size(); i = next_entry++) {
+                const TrpEntry& entry = entries[i];
+                const std::string_view name(entry.entry_name,
+                                            strnlen(entry.entry_name, sizeof(entry.entry_name)));
+                try {
+                    if (entry.flag == ENTRY_FLAG_PNG) {
+                        if (!ProcessPngEntry(data, entry, outputPath, name)) {
+                            success = false;
+                        }
+                    } else if (entry.flag == ENTRY_FLAG_ENCRYPTED_XML) {
+                        // Check if we have a valid NPCommID for decryption
+                        if (npCommId.size() >= 12 && npCommId[0] == 'N' && npCommId[1] == 'P') {
+                            if (!ProcessEncryptedXmlEntry(data, entry, outputPath, name, user_key,
+                                                          npCommId)) {
+                                success = false;
+                            }
+                        } else {
+                            LOG_WARNING(Common_Filesystem,
+                                        "Skipping encrypted XML entry - invalid NPCommID");
+                        }
+                    } else {
+                        LOG_DEBUG(Common_Filesystem, "Unknown entry flag: {} for {}",
+                                  static_cast<u32>(entry.flag), name);
                     }
-                } else {
-                    LOG_WARNING(Common_Filesystem,
-                                "Skipping encrypted XML entry - invalid NPCommID");
-                    // Skip this entry but continue
+                } catch (const std::exception& e) {
+                    LOG_ERROR(Common_Filesystem, "Error extracting trophy entry {}: {}", name,
+                              e.what());
+                    success = false;
                 }
-            } else {
-                LOG_DEBUG(Common_Filesystem, "Unknown entry flag: {} for {}",
-                          static_cast<u32>(entry.flag), name);
             }
-            trpFileIndex++;
+        };
+        const u32 num_threads = std::min<u32>(
+            entries.size(), std::clamp(std::thread::hardware_concurrency(), 1U, MaxExtractThreads));
+        {
+            std::vector<std::jthread> workers;
+            for (u32 i = 1; i < num_threads; i++) {
+                workers.emplace_back(process_entries);
+            }
+            process_entries();
         }
+        trpFileIndex = static_cast<u32>(entries.size());
 
+        if (success) {
+            Common::FS::IOFile stamp_file(stamp_path, Common::FS::FileAccessMode::Create,
+                                          Common::FS::FileType::TextFile);
+            stamp_file.WriteString(stamp);
+        }
     } catch (const std::filesystem::filesystem_error& e) {
         LOG_CRITICAL(Common_Filesystem, "Filesystem error during trophy extraction: {}", e.what());
         return false;
@@ -146,18 +195,13 @@ bool TRP::Extract(const std::filesystem::path& trophyPath, std::string npCommId,
     return success;
 }
 
-bool TRP::ProcessPngEntry(Common::FS::IOFile& file, const TrpEntry& entry,
+bool TRP::ProcessPngEntry(std::span<const u8> data, const TrpEntry& entry,
                           const std::filesystem::path& outputPath, std::string_view name) {
-    if (!file.Seek(entry.entry_pos)) {
-        LOG_ERROR(Common_Filesystem, "Failed to seek to PNG entry offset");
-        return false;
-    }
-
-    std::vector<u8> icon(entry.entry_len);
-    if (!file.Read(icon)) {
-        LOG_ERROR(Common_Filesystem, "Failed to read PNG data");
+    if (entry.entry_pos > data.size() || entry.entry_len > data.size() - entry.entry_pos) {
+        LOG_ERROR(Common_Filesystem, "PNG entry {} is out of bounds", name);
         return false;
     }
+    const auto icon = data.subspan(entry.entry_pos, entry.entry_len);
 
     auto outputFile = outputPath / "Icons" / name;
     size_t written = Common::FS::IOFile::WriteBytes(outputFile, icon);
@@ -170,20 +214,14 @@ bool TRP::ProcessPngEntry(Common::FS::IOFile& file, const TrpEntry& entry,
     return true;
 }
 
-bool TRP::ProcessEncryptedXmlEntry(Common::FS::IOFile& file, const TrpEntry& entry,
+bool TRP::ProcessEncryptedXmlEntry(std::span<const u8> data, const TrpEntry& entry,
                                    const std::filesystem::path& outputPath, std::string_view name,
                                    const std::array<u8, 16>& user_key,
                                    const std::string& npCommId) {
     constexpr size_t IV_LEN = 16;
 
-    if (!file.Seek(entry.entry_pos)) {
-        LOG_ERROR(Common_Filesystem, "Failed to seek to encrypted XML entry offset");
-        return false;
-    }
-
-    std::array<u8, IV_LEN> esfmIv;
-    if (!file.Read(esfmIv)) {
-        LOG_ERROR(Common_Filesystem, "Failed to read IV for encrypted XML");
+    if (entry.entry_pos > data.size() || entry.entry_len > data.size() - entry.entry_pos) {
+        LOG_ERROR(Common_Filesystem, "Encrypted XML entry {} is out of bounds", name);
         return false;
     }
 
@@ -192,20 +230,12 @@ bool TRP::ProcessEncryptedXmlEntry(Common::FS::IOFile& file, const TrpEntry& ent
         return false;
     }
 
-    // Skip to the encrypted data (after IV)
-    if (!file.Seek(entry.entry_pos + IV_LEN)) {
-        LOG_ERROR(Common_Filesystem, "Failed to seek to encrypted data");
-        return false;
-    }
-
-    std::vector<u8> ESFM(entry.entry_len - IV_LEN);
+    // The IV is followed by the encrypted data
+    std::array<u8, IV_LEN> esfmIv;
+    std::memcpy(esfmIv.data(), data.data() + entry.entry_pos, IV_LEN);
+    const auto ESFM = data.subspan(entry.entry_pos + IV_LEN, entry.entry_len - IV_LEN);
     std::vector<u8> XML(entry.entry_len - IV_LEN);
 
-    if (!file.Read(ESFM)) {
-        LOG_ERROR(Common_Filesystem, "Failed to read encrypted XML data");
-        return false;
-    }
-
     // Decrypt the data
     std::span<const u8, 16> key_span(user_key);
 
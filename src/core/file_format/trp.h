@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <span>
 #include <vector>
 #include "common/endian.h"
 #include "common/io_file.h"
@@ -36,13 +37,17 @@ class TRP {
 public:
     TRP();
     ~TRP();
+
+    /// Extracts the icons and decrypted XML of a trophy file, decoding entries in parallel.
+    /// Skipped when the TRP.STAMP in outputPath matches the file. Otherwise outputPath is removed,
+    /// including an install extracted before stamps existed, and the file is extracted again.
     bool Extract(const std::filesystem::path& trophyPath, std::string npCommId,
                  const std::filesystem::path& outputPath);
 
 private:
-    bool ProcessPngEntry(Common::FS::IOFile& file, const TrpEntry& entry,
+    bool ProcessPngEntry(std::span<const u8> data, const TrpEntry& entry,
                          const std::filesystem::path& outputPath, std::string_view name);
-    bool ProcessEncryptedXmlEntry(Common::FS::IOFile& file, const TrpEntry& entry,
+    bool ProcessEncryptedXmlEntry(std::span<const u8> data, const TrpEntry& entry,
                                   const std::filesystem::path& outputPath, std::string_view name,
                                   const std::array<u8, 16>& user_key, const std::string& npCommId);
 
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include "common/logging/log.h"
 #include "common/string_util.h"
 #include "core/file_sys/devices/logger.h"
 #include "core/file_sys/devices/nop_device.h"
@@ -24,7 +25,23 @@ void MntPoints::Mount(const std::filesystem::path& host_folder, const std::strin
                       bool read_only) {
     std::scoped_lock lock{m_mutex};
     const auto guest_folder_sanitized = RemoveTrailingSlashes(guest_folder);
-    m_mnt_pairs.emplace_back(host_folder, guest_folder_sanitized, read_only);
+
+    // Read-only trees don't change while mounted, so their lookups can be served from an index.
+    // Mounts of the same folder, like /app0 and /hostapp, share it.
+    std::shared_ptr<const PathIndex> index{};
+    if (read_only) {
+        const auto it = std::ranges::find_if(m_mnt_pairs, [&](const MntPair& mount) {
+            return mount.index && mount.host_path == host_folder;
+        });
+        if (it != m_mnt_pairs.end()) {
+            index = it->index;
+        } else {
+            index = std::make_shared<const PathIndex>(host_folder);
+            LOG_INFO(Kernel_Fs, "Indexed {} host entries for {}", index->NumEntries(),
+                     guest_folder_sanitized);
+        }
+    }
+    m_mnt_pairs.emplace_back(host_folder, guest_folder_sanitized, read_only, std::move(index));
 }
 
 void MntPoints::Unmount(const std::filesystem::path& host_folder, const std::string& guest_folder) {
@@ -41,6 +58,17 @@ void MntPoints::UnmountAll() {
     m_mnt_pairs.clear();
 }
 
+void MntPoints::InvalidatePathIndex(std::string_view guest_path) {
+    std::scoped_lock lock{m_mutex};
+    for (auto& mount : m_mnt_pairs) {
+        if (mount.index && guest_path.starts_with(mount.mount) &&
+            (guest_path.size() == mount.mount.size() || guest_path[mount.mount.size()] == '/')) {
+            LOG_INFO(Kernel_Fs, "Dropping path index of {}", mount.mount);
+            mount.index.reset();
+        }
+    }
+}
+
 std::filesystem::path MntPoints::GetHostPath(std::string_view path, bool* is_read_only,
                                              HostPathType path_type) {
     // Evil games like Turok2 pass double slashes e.g /app0//game.kpf
@@ -64,14 +92,19 @@ std::filesystem::path MntPoints::GetHostPath(std::string_view path, bool* is_rea
     }
 
     const auto corrected_path_sanitized = RemoveTrailingSlashes(corrected_path);
+    const auto& index = mount->index;
     std::filesystem::path host_path = mount->host_path;
 
     // Update folder is either mount + "-UPDATE" or mount + "-patch"
     std::filesystem::path patch_path = mount->host_path;
-    patch_path += "-UPDATE";
-    if (!std::filesystem::exists(patch_path)) {
-        patch_path = mount->host_path;
-        patch_path += "-patch";
+    if (index) {
+        patch_path = index->GetRoot(PathIndex::Layer::Patch);
+    } else {
+        patch_path += "-UPDATE";
+        if (!std::filesystem::exists(patch_path)) {
+            patch_path = mount->host_path;
+            patch_path += "-patch";
+        }
     }
 
     // Mods folder can only be at mount + "-mods"
@@ -101,6 +134,27 @@ std::filesystem::path MntPoints::GetHostPath(std::string_view path, bool* is_rea
         return patch_path;
     }
 
+    if (index) {
+        // Same priority as below, mods first, then the patch and finally the base folder
+        const bool is_app = corrected_path.starts_with("/app0") ||
+                            corrected_path.starts_with("/hostapp");
+        if (is_app && path_type != HostPathType::Base) {
+            if (auto path = index->Resolve(PathIndex::Layer::Mod, rel_path); !path.empty()) {
+                return path;
+            }
+        }
+        if ((is_app || NeedsCaseInsensitiveSearch) && path_type != HostPathType::Base &&
+            !ignore_game_patches) {
+            if (auto path = index->Resolve(PathIndex::Layer::Patch, rel_path); !path.empty()) {
+                return path;
+            }
+        }
+        if (auto path = index->Resolve(PathIndex::Layer::Base, rel_path); !path.empty()) {
+            return path;
+        }
+        return host_path;
+    }
+
     if ((corrected_path.starts_with("/app0") || corrected_path.starts_with("/hostapp")) &&
         path_type != HostPathType::Base && std::filesystem::exists(mods_path)) {
         return mods_path;
@@ -268,9 +322,17 @@ int HandleTable::CreateHandle() {
 }
 
 void HandleTable::DeleteHandle(int d) {
-    std::scoped_lock lock{m_mutex};
-    delete m_files.at(d);
-    m_files[d] = nullptr;
+    File* file;
+    {
+        std::scoped_lock lock{m_mutex};
+        file = m_files.at(d);
+        m_files[d] = nullptr;
+    }
+    if (file) {
+        // Wait for positional reads that looked the file up before it left the table
+        std::unique_lock io_lock{file->m_io_mutex};
+    }
+    delete file;
 }
 
 File* HandleTable::GetFile(int d) {
@@ -281,6 +343,18 @@ File* HandleTable::GetFile(int d) {
     return m_files.at(d);
 }
 
+File* HandleTable::GetFile(int d, std::shared_lock<std::shared_mutex>& io_lock) {
+    std::scoped_lock lock{m_mutex};
+    if (d < 0 || d >= m_files.size()) {
+        return nullptr;
+    }
+    File* file = m_files.at(d);
+    if (file) {
+        io_lock = std::shared_lock{file->m_io_mutex};
+    }
+    return file;
+}
+
 File* HandleTable::GetSocket(int d) {
     std::scoped_lock lock{m_mutex};
     if (d < 0 || d >= m_files.size()) {
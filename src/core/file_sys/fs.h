@@ -6,6 +6,7 @@
 #include <atomic>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include <tsl/robin_map.h>
@@ -13,6 +14,7 @@
 #include "common/logging/formatter.h"
 #include "core/file_sys/devices/base_device.h"
 #include "core/file_sys/directories/base_directory.h"
+#include "core/file_sys/path_index.h"
 
 namespace Libraries::Net {
 struct Socket;
@@ -34,6 +36,7 @@ public:
         std::filesystem::path host_path;
         std::string mount; // e.g /app0
         bool read_only;
+        std::shared_ptr<const PathIndex> index{}; // only built for read-only mounts
     };
 
     enum class HostPathType {
@@ -51,6 +54,9 @@ public:
     void Unmount(const std::filesystem::path& host_folder, const std::string& guest_folder);
     void UnmountAll();
 
+    /// Drops the path index of the mount containing the guest path, as its host tree changed.
+    void InvalidatePathIndex(std::string_view guest_path);
+
     std::filesystem::path GetHostPath(std::string_view guest_directory,
                                       bool* is_read_only = nullptr,
                                       HostPathType host_path = HostPathType::Default);
@@ -104,6 +110,7 @@ struct File {
     std::string m_guest_name;
     Common::FS::IOFile f;
     std::mutex m_mutex;
+    std::shared_mutex m_io_mutex; // Shared by positional reads, exclusive to close the file
     std::shared_ptr<Directories::BaseDirectory> directory; // only valid for type == Directory
     std::shared_ptr<Devices::BaseDevice> device;           // only valid for type == Device
     std::shared_ptr<Libraries::Net::Socket> socket;        // only valid for type == Socket
@@ -119,6 +126,9 @@ public:
     int CreateHandle();
     void DeleteHandle(int d);
     File* GetFile(int d);
+    /// Returns the file with io_lock holding its I/O lock shared, so it stays open until the
+    /// lock is released.
+    File* GetFile(int d, std::shared_lock<std::shared_mutex>& io_lock);
     File* GetSocket(int d);
     File* GetEpoll(int d);
     File* GetResolver(int d);
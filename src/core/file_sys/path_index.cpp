@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "common/logging/log.h"
+#include "common/path_util.h"
+#include "common/string_util.h"
+#include "core/file_sys/path_index.h"
+
+namespace Core::FileSys {
+
+PathIndex::PathIndex(const std::filesystem::path& host_path) {
+    // Update folder is either mount + "-UPDATE" or mount + "-patch"
+    auto patch_path = host_path;
+    patch_path += "-UPDATE";
+    if (!std::filesystem::exists(patch_path)) {
+        patch_path = host_path;
+        patch_path += "-patch";
+    }
+    auto mods_path = host_path;
+    mods_path += "-mods";
+
+    trees[static_cast<u32>(Layer::Base)].root = host_path;
+    trees[static_cast<u32>(Layer::Patch)].root = patch_path;
+    trees[static_cast<u32>(Layer::Mod)].root = mods_path;
+    for (auto& tree : trees) {
+        Build(tree);
+    }
+}
+
+void PathIndex::Build(Tree& tree) {
+    std::error_code ec{};
+    if (!std::filesystem::is_directory(tree.root, ec)) {
+        return;
+    }
+
+    // Node 0 is the root folder itself
+    tree.nodes.push_back({.parent = 0});
+    std::vector<std::pair<u32, std::filesystem::path>> pending_dirs{{0, tree.root}};
+    while (!pending_dirs.empty()) {
+        const auto [dir, dir_path] = std::move(pending_dirs.back());
+        pending_dirs.pop_back();
+
+        std::vector<std::pair<std::string, u32>> keys{};
+        auto it = std::filesystem::directory_iterator{
+            dir_path, std::filesystem::directory_options::skip_permission_denied, ec};
+        for (; !ec && it != std::filesystem::directory_iterator{}; it.increment(ec)) {
+            const auto name = it->path().filename();
+            const u32 child = static_cast<u32>(tree.nodes.size());
+            keys.emplace_back(Common::FS::PathToUTF8String(name), child);
+            tree.nodes.push_back({.name = name, .parent = dir});
+
+            // Symlinked folders aren't followed, their contents resolve through the plain host path
+            if (it->is_directory(ec) && !it->is_symlink(ec)) {
+                pending_dirs.emplace_back(child, it->path());
+            }
+        }
+        if (ec) {
+            LOG_WARNING(Kernel_Fs, "Failed to index {}: {}", Common::FS::PathToUTF8String(dir_path),
+                        ec.message());
+            ec.clear();
+        }
+
+        // Exact names take precedence, so they are all added before the folded ones, which only
+        // fill in the gaps
+        auto& children = tree.nodes[dir].children;
+        for (const auto& [key, child] : keys) {
+            children.insert_or_assign(key, child);
+        }
+        for (const auto& [key, child] : keys) {
+            children.try_emplace(Common::ToLower(key), child);
+        }
+    }
+}
+
+std::filesystem::path PathIndex::Resolve(Layer layer, std::string_view rel_path) const {
+    const auto& tree = trees[static_cast<u32>(layer)];
+    if (tree.nodes.empty()) {
+        return {};
+    }
+
+    u32 node = 0;
+    while (!rel_path.empty()) {
+        const size_t sep = rel_path.find('/');
+        const auto part = rel_path.substr(0, sep);
+        rel_path = sep == std::string_view::npos ? std::string_view{} : rel_path.substr(sep + 1);
+
+        if (part.empty() || part == ".") {
+            continue;
+        }
+        if (part == "..") {
+            node = tree.nodes[node].parent;
+            continue;
+        }
+
+        const auto& children = tree.nodes[node].children;
+        auto it = children.find(std::string{part});
+        if (it == children.end()) {
+            it = children.find(Common::ToLower(part));
+            if (it == children.end()) {
+                return {};
+            }
+        }
+        node = it->second;
+    }
+
+    // Walk back up to the root to assemble the host path
+    std::vector<u32> chain{};
+    for (u32 i = node; i != 0; i = tree.nodes[i].parent) {
+        chain.push_back(i);
+    }
+    auto host_path = tree.root;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        host_path /= tree.nodes[*it].name;
+    }
+    return host_path;
+}
+
+size_t PathIndex::NumEntries() const {
+    size_t num_entries = 0;
+    for (const auto& tree : trees) {
+        num_entries += tree.nodes.size();
+    }
+    return num_entries;
+}
+
+} // namespace Core::FileSys
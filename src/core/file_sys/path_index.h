@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tsl/robin_map.h>
+
+#include "common/types.h"
+
+namespace Core::FileSys {
+
+/**
+ * Snapshot of the host directory trees behind a mount point and its overlays, the "-mods"
+ * folder and the "-UPDATE" or "-patch" folder.
+ *
+ * The index is built once and never modified afterwards, so lookups need no locking and make no
+ * host syscalls. Each path component is matched exactly first and then case-insensitively, the
+ * same way MntPoints falls back to a case-insensitive directory search on the host.
+ */
+class PathIndex {
+public:
+    enum class Layer : u32 {
+        Base,
+        Patch,
+        Mod,
+    };
+
+    explicit PathIndex(const std::filesystem::path& host_path);
+
+    /// Returns the host folder backing a layer, whether it exists or not.
+    [[nodiscard]] const std::filesystem::path& GetRoot(Layer layer) const {
+        return trees[static_cast<u32>(layer)].root;
+    }
+
+    /// Resolves a path relative to the mount point to its host path in the given layer.
+    /// Returns an empty path if the layer doesn't contain it.
+    [[nodiscard]] std::filesystem::path Resolve(Layer layer, std::string_view rel_path) const;
+
+    [[nodiscard]] size_t NumEntries() const;
+
+private:
+    struct Node {
+        std::filesystem::path name;
+        u32 parent;
+        tsl::robin_map<std::string, u32> children;
+    };
+
+    struct Tree {
+        std::filesystem::path root;
+        std::vector<Node> nodes;
+    };
+
+    static void Build(Tree& tree);
+
+    std::array<Tree, 3> trees;
+};
+
+} // namespace Core::FileSys
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <fmt/format.h>
+
+#include "common/io_file.h"
+#include "common/logging/log.h"
+#include "core/libraries/ajm/ajm_aac.h"
+#include "core/libraries/ajm/ajm_at9.h"
+#include "core/libraries/ajm/ajm_benchmark.h"
+#include "core/libraries/ajm/ajm_mp3.h"
+#include "core/libraries/ajm/ajm_result.h"
+
+namespace Libraries::Ajm {
+
+// Large enough for a frame of any supported codec
+constexpr size_t BenchmarkOutputSize = 64_KB;
+
+static std::unique_ptr<AjmCodec> CreateCodec(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), ::tolower);
+    if (extension == ".mp3") {
+        return std::make_unique<AjmMp3Decoder>(AjmFormatEncoding::S16, AjmMp3CodecFlags{}, 0);
+    }
+    if (extension == ".aac") {
+        auto codec =
+            std::make_unique<AjmAacDecoder>(AjmFormatEncoding::S16, AjmAacCodecFlags{}, 0);
+        const std::array<u32, 2> init_params = {ConfigType::ADTS, 0};
+        codec->Initialize(init_params.data(), sizeof(init_params));
+        return codec;
+    }
+    if (extension == ".at9") {
+        return std::make_unique<AjmAt9Decoder>(AjmFormatEncoding::S16, AjmAt9CodecFlags{}, 0);
+    }
+    return nullptr;
+}
+
+struct StreamStats {
+    std::vector<u64> job_ns;
+    u64 samples{};
+    u32 sample_rate{};
+};
+
+/// Decodes a stream the way AjmInstance runs jobs, timing each codec call.
+static void DecodeStream(AjmCodec& codec, std::span<u8> input, StreamStats& stats) {
+    std::vector<u8> output_data(BenchmarkOutputSize);
+    AjmInstanceGapless gapless{};
+    while (!input.empty() && input.size() >= codec.GetMinimumInputSize()) {
+        std::array<std::span<u8>, 1> chunks = {std::span<u8>{output_data}};
+        SparseOutputBuffer output{chunks};
+        const size_t input_size = input.size();
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = codec.ProcessData(input, output, gapless);
+        const auto end = std::chrono::steady_clock::now();
+
+        stats.job_ns.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        stats.samples += result.samples_written;
+        if ((result.result & ~ORBIS_AJM_RESULT_PARTIAL_INPUT) != 0 || input.size() == input_size) {
+            break;
+        }
+    }
+    stats.sample_rate = codec.GetFormat().sampl_freq;
+}
+
+int RunAjmBenchmark(const std::filesystem::path& corpus, u32 passes) {
+    std::vector<std::filesystem::path> paths;
+    if (std::filesystem::is_directory(corpus)) {
+        for (const auto& entry : std::filesystem::directory_iterator(corpus)) {
+            if (entry.is_regular_file() && CreateCodec(entry.path())) {
+                paths.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(paths);
+    } else {
+        paths.push_back(corpus);
+    }
+    if (paths.empty()) {
+        LOG_ERROR(Lib_Ajm, "No .mp3, .aac or .at9 streams found in {}", corpus.string());
+        return 1;
+    }
+
+    fmt::print("{:<32}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}\n", "stream", "jobs", "avg us",
+               "p50 us", "p99 us", "max us", "x rt");
+    for (const auto& path : paths) {
+        Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read};
+        std::vector<u8> data(file.IsOpen() ? file.GetSize() : 0);
+        if (data.empty() || file.ReadSpan<u8>(data) != data.size()) {
+            LOG_ERROR(Lib_Ajm, "Failed to read {}", path.string());
+            return 1;
+        }
+
+        StreamStats stats{};
+        for (u32 pass = 0; pass < passes; ++pass) {
+            auto codec = CreateCodec(path);
+            if (!codec) {
+                LOG_ERROR(Lib_Ajm, "Unsupported stream {}", path.string());
+                return 1;
+            }
+            DecodeStream(*codec, data, stats);
+        }
+        if (stats.job_ns.empty()) {
+            continue;
+        }
+
+        u64 total_ns = 0;
+        for (const u64 ns : stats.job_ns) {
+            total_ns += ns;
+        }
+        std::ranges::sort(stats.job_ns);
+        const auto percentile = [&](double p) {
+            return stats.job_ns[static_cast<size_t>(p * (stats.job_ns.size() - 1))] / 1e3;
+        };
+        const double audio_s =
+            stats.sample_rate != 0 ? static_cast<double>(stats.samples) / stats.sample_rate : 0.0;
+        fmt::print("{:<32}{:>8}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.1f}\n",
+                   path.filename().string(), stats.job_ns.size(),
+                   total_ns / 1e3 / stats.job_ns.size(), percentile(0.5), percentile(0.99),
+                   stats.job_ns.back() / 1e3, audio_s / (total_ns / 1e9));
+    }
+    return 0;
+}
+
+} // namespace Libraries::Ajm
@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+
+#include "common/types.h"
+
+namespace Libraries::Ajm {
+
+/**
+ * Decodes the .mp3, .aac (ADTS) and .at9 streams in a file or directory without a guest and
+ * prints the latency of every decode job, one job being a codec call for one frame. Each stream
+ * is decoded the given number of passes. Returns the process exit code.
+ */
+int RunAjmBenchmark(const std::filesystem::path& corpus, u32 passes);
+
+} // namespace Libraries::Ajm
@@ -13,8 +13,11 @@
 #include "core/libraries/ajm/ajm_mp3.h"
 #include "core/libraries/error_codes.h"
 
+#include <algorithm>
+#include <bit>
 #include <span>
 #include <utility>
+#include <fmt/format.h>
 
 namespace Libraries::Ajm {
 
@@ -22,13 +25,21 @@ constexpr u32 ORBIS_AJM_WAIT_INFINITE = -1;
 constexpr int INSTANCE_ID_MASK = 0x3FFF;
 
 AjmContext::AjmContext() {
-    worker_thread = std::jthread([this](std::stop_token stop) { this->WorkerThread(stop); });
+    num_workers = std::clamp(std::thread::hardware_concurrency() / 4, 1U, MaxWorkers);
+    for (u32 worker = 0; worker < num_workers; ++worker) {
+        worker_threads[worker] = std::jthread(
+            [this, worker](std::stop_token stop) { this->WorkerThread(stop, worker); });
+    }
 }
 
 bool AjmContext::IsRegistered(AjmCodecType type) const {
     return registered_codecs[std::to_underlying(type)];
 }
 
+u32 AjmContext::GetWorker(u32 instance_id) const {
+    return (instance_id & INSTANCE_ID_MASK) % num_workers;
+}
+
 s32 AjmContext::BatchCancel(const u32 batch_id) {
     std::shared_ptr<AjmBatch> batch{};
     {
@@ -60,24 +71,37 @@ s32 AjmContext::ModuleRegister(AjmCodecType type) {
     return ORBIS_OK;
 }
 
-void AjmContext::WorkerThread(std::stop_token stop) {
-    Common::SetCurrentThreadName("shadPS4:AjmWorker");
+void AjmContext::WorkerThread(std::stop_token stop, u32 worker) {
+    {
+        const auto thread_name = fmt::format("shadPS4:AjmWorker:{}", worker);
+        Common::SetCurrentThreadName(thread_name.c_str());
+    }
+    auto& batch_queue = batch_queues[worker];
     while (!stop.stop_requested()) {
         auto batch = batch_queue.PopWait(stop);
-        if (batch != nullptr && !batch->canceled) {
+        if (batch == nullptr) {
+            continue;
+        }
+        if (!batch->canceled) {
             bool expected = false;
             batch->processed.compare_exchange_strong(expected, true);
-            ProcessBatch(batch->id, batch->jobs);
+            ProcessBatch(*batch, worker);
+        }
+        // The last worker done with the batch completes it
+        if (batch->pending_workers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
             batch->finished.release();
         }
     }
 }
 
-void AjmContext::ProcessBatch(u32 id, std::span<AjmJob> jobs) {
+void AjmContext::ProcessBatch(AjmBatch& batch, u32 worker) {
     // Perform operation requested by control flags.
-    for (auto& job : jobs) {
-        LOG_TRACE(Lib_Ajm, "Processing job {} for instance {}. flags = {:#x}", id, job.instance_id,
-                  job.flags.raw);
+    for (auto& job : batch.jobs) {
+        if (GetWorker(job.instance_id) != worker) {
+            continue;
+        }
+        LOG_TRACE(Lib_Ajm, "Processing job {} for instance {}. flags = {:#x}", batch.id,
+                  job.instance_id, job.flags.raw);
 
         if (job.instance_id == AJM_INSTANCE_STATISTICS) {
             AjmInstanceStatistics::Getinstance().ExecuteJob(job);
@@ -150,7 +174,16 @@ int AjmContext::BatchStartBuffer(u8* p_batch, u32 batch_size, const int priority
     batch_info->id = *out_batch_id;
 
     if (!batch_info->jobs.empty()) {
-        batch_queue.EmplaceWait(batch_info);
+        u32 worker_mask = 0;
+        for (const auto& job : batch_info->jobs) {
+            worker_mask |= 1U << GetWorker(job.instance_id);
+        }
+        batch_info->pending_workers = std::popcount(worker_mask);
+        for (u32 worker = 0; worker < num_workers; ++worker) {
+            if (worker_mask & (1U << worker)) {
+                batch_queues[worker].EmplaceWait(batch_info);
+            }
+        }
     } else {
         // Empty batches are not submitted to the processor and are marked as finished
         batch_info->finished.release();
@@ -32,15 +32,17 @@ public:
     s32 BatchStartBuffer(u8* p_batch, u32 batch_size, const int priority,
                          AjmBatchError* p_batch_error, u32* p_batch_id);
 
-    void WorkerThread(std::stop_token stop);
-    void ProcessBatch(u32 id, std::span<AjmJob> jobs);
+    void WorkerThread(std::stop_token stop, u32 worker);
+    void ProcessBatch(AjmBatch& batch, u32 worker);
 
 private:
     static constexpr u32 MaxInstances = 0x2fff;
     static constexpr u32 MaxBatches = 0x0400;
+    static constexpr u32 MaxWorkers = 4;
     static constexpr u32 NumAjmCodecs = std::to_underlying(AjmCodecType::Max);
 
     [[nodiscard]] bool IsRegistered(AjmCodecType type) const;
+    [[nodiscard]] u32 GetWorker(u32 instance_id) const;
 
     std::array<bool, NumAjmCodecs> registered_codecs{};
 
@@ -50,8 +52,11 @@ private:
     std::shared_mutex batches_mutex;
     Common::SlotArray<u32, std::shared_ptr<AjmBatch>, MaxBatches, 1> batches;
 
-    std::jthread worker_thread{};
-    Common::MPSCQueue<std::shared_ptr<AjmBatch>> batch_queue;
+    // Each instance is always run by the same worker, which keeps its jobs in order while
+    // different instances decode in parallel
+    u32 num_workers{};
+    std::array<Common::MPSCQueue<std::shared_ptr<AjmBatch>>, MaxWorkers> batch_queues;
+    std::array<std::jthread, MaxWorkers> worker_threads{};
 };
 
 } // namespace Libraries::Ajm
@@ -78,43 +78,72 @@ static AVSampleFormat AjmToAVSampleFormat(AjmFormatEncoding format) {
 }
 
 AVFrame* AjmMp3Decoder::ConvertAudioFrame(AVFrame* frame) {
-    AVSampleFormat format = AjmToAVSampleFormat(m_format);
+    const AVSampleFormat format = AjmToAVSampleFormat(m_format);
     if (frame->format == format) {
         return frame;
     }
 
-    AVFrame* new_frame = av_frame_alloc();
-    new_frame->pts = frame->pts;
-    new_frame->pkt_dts = frame->pkt_dts < 0 ? 0 : frame->pkt_dts;
-    new_frame->format = format;
-    new_frame->ch_layout = frame->ch_layout;
-    new_frame->sample_rate = frame->sample_rate;
-
-    AVChannelLayout in_ch_layout = frame->ch_layout;
-    AVChannelLayout out_ch_layout = new_frame->ch_layout;
-    swr_alloc_set_opts2(&m_swr_context, &out_ch_layout, AVSampleFormat(new_frame->format),
-                        frame->sample_rate, &in_ch_layout, AVSampleFormat(frame->format),
-                        frame->sample_rate, 0, nullptr);
-    swr_init(m_swr_context);
-    const auto res = swr_convert_frame(m_swr_context, new_frame, frame);
+    // The resampler is only rebuilt when the stream changes its format
+    if (m_swr_context == nullptr || m_swr_in_format != frame->format ||
+        m_swr_sample_rate != frame->sample_rate ||
+        av_channel_layout_compare(&m_swr_ch_layout, &frame->ch_layout) != 0) {
+        int res = swr_alloc_set_opts2(&m_swr_context, &frame->ch_layout, format,
+                                      frame->sample_rate, &frame->ch_layout,
+                                      AVSampleFormat(frame->format), frame->sample_rate, 0,
+                                      nullptr);
+        if (res >= 0) {
+            res = swr_init(m_swr_context);
+        }
+        if (res < 0) {
+            LOG_ERROR(Lib_Ajm, "Could not initialize resampler: {}", av_err2str(res));
+            swr_free(&m_swr_context);
+            return nullptr;
+        }
+        m_swr_in_format = AVSampleFormat(frame->format);
+        m_swr_sample_rate = frame->sample_rate;
+        av_channel_layout_uninit(&m_swr_ch_layout);
+        av_channel_layout_copy(&m_swr_ch_layout, &frame->ch_layout);
+        av_frame_unref(m_converted_frame);
+    }
+
+    // Keep converting into the same buffer while it is large enough
+    if (m_converted_frame->data[0] == nullptr || m_converted_capacity < frame->nb_samples) {
+        av_frame_unref(m_converted_frame);
+        m_converted_frame->format = format;
+        m_converted_frame->sample_rate = frame->sample_rate;
+        m_converted_frame->nb_samples = frame->nb_samples;
+        av_channel_layout_copy(&m_converted_frame->ch_layout, &frame->ch_layout);
+        const int res = av_frame_get_buffer(m_converted_frame, 0);
+        if (res < 0) {
+            LOG_ERROR(Lib_Ajm, "Could not allocate converted frame: {}", av_err2str(res));
+            return nullptr;
+        }
+        m_converted_capacity = frame->nb_samples;
+    }
+    m_converted_frame->nb_samples = m_converted_capacity;
+
+    const auto res = swr_convert_frame(m_swr_context, m_converted_frame, frame);
     if (res < 0) {
-        LOG_ERROR(Lib_AvPlayer, "Could not convert frame: {}", av_err2str(res));
-        av_frame_free(&new_frame);
-        av_frame_free(&frame);
+        LOG_ERROR(Lib_Ajm, "Could not convert frame: {}", av_err2str(res));
         return nullptr;
     }
-    av_frame_free(&frame);
-    return new_frame;
+    return m_converted_frame;
 }
 
 AjmMp3Decoder::AjmMp3Decoder(AjmFormatEncoding format, AjmMp3CodecFlags flags, u32)
     : m_format(format), m_flags(flags), m_codec(avcodec_find_decoder(AV_CODEC_ID_MP3)),
-      m_codec_context(avcodec_alloc_context3(m_codec)), m_parser(av_parser_init(m_codec->id)) {
+      m_codec_context(avcodec_alloc_context3(m_codec)), m_parser(av_parser_init(m_codec->id)),
+      m_packet(av_packet_alloc()), m_frame(av_frame_alloc()), m_converted_frame(av_frame_alloc()) {
     int ret = avcodec_open2(m_codec_context, m_codec, nullptr);
     ASSERT_MSG(ret >= 0, "Could not open m_codec");
+    ASSERT_MSG(m_packet && m_frame && m_converted_frame, "Could not allocate decoder frames");
 }
 
 AjmMp3Decoder::~AjmMp3Decoder() {
+    av_frame_free(&m_converted_frame);
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
+    av_channel_layout_uninit(&m_swr_ch_layout);
     swr_free(&m_swr_context);
     av_parser_close(m_parser);
     avcodec_free_context(&m_codec_context);
@@ -148,7 +177,7 @@ u32 AjmMp3Decoder::GetMinimumInputSize() const {
 DecoderResult AjmMp3Decoder::ProcessData(std::span<u8>& in_buf, SparseOutputBuffer& output,
                                          AjmInstanceGapless& gapless) {
     DecoderResult result{};
-    AVPacket* pkt = av_packet_alloc();
+    AVPacket* pkt = m_packet;
 
     m_header = std::byteswap(*reinterpret_cast<u32*>(in_buf.data()));
     AjmDecMp3ParseFrame info{};
@@ -182,15 +211,16 @@ DecoderResult AjmMp3Decoder::ProcessData(std::span<u8>& in_buf, SparseOutputBuff
 
         // Read all the output frames (in general there may be any number of them
         while (ret >= 0) {
-            AVFrame* frame = av_frame_alloc();
-            ret = avcodec_receive_frame(m_codec_context, frame);
+            ret = avcodec_receive_frame(m_codec_context, m_frame);
             if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                av_frame_free(&frame);
                 break;
             } else if (ret < 0) {
                 UNREACHABLE_MSG("Error during decoding");
             }
-            frame = ConvertAudioFrame(frame);
+            AVFrame* frame = ConvertAudioFrame(m_frame);
+            if (frame == nullptr) {
+                continue;
+            }
 
             result.frames_decoded += 1;
             u32 skip_samples = 0;
@@ -225,12 +255,10 @@ DecoderResult AjmMp3Decoder::ProcessData(std::span<u8>& in_buf, SparseOutputBuff
                 gapless.current.total_samples -= samples;
             }
             result.samples_written += samples;
-
-            av_frame_free(&frame);
         }
     }
 
-    av_packet_free(&pkt);
+    av_packet_unref(pkt);
 
     return result;
 }
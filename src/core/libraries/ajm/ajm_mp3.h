@@ -89,6 +89,8 @@ private:
         return output.Write(pcm_data.subspan(0, std::min(u32(pcm_data.size()), max_pcm)));
     }
 
+    /// Returns the frame in the output format, either the frame itself or a converted frame that
+    /// stays valid until the next conversion.
     AVFrame* ConvertAudioFrame(AVFrame* frame);
 
     const AjmFormatEncoding m_format;
@@ -96,7 +98,14 @@ private:
     const AVCodec* m_codec = nullptr;
     AVCodecContext* m_codec_context = nullptr;
     AVCodecParserContext* m_parser = nullptr;
+    AVPacket* m_packet = nullptr;
+    AVFrame* m_frame = nullptr;
+    AVFrame* m_converted_frame = nullptr;
+    int m_converted_capacity = 0;
     SwrContext* m_swr_context = nullptr;
+    AVSampleFormat m_swr_in_format = AV_SAMPLE_FMT_NONE;
+    int m_swr_sample_rate = 0;
+    AVChannelLayout m_swr_ch_layout{};
     std::optional<u32> m_header;
     u32 m_frame_samples = 0;
 };
@@ -675,6 +675,10 @@ s32 PS4_SYSV_ABI sceFontAttachDeviceCacheBuffer(OrbisFontLib library, void* buff
                 lib->flags |= owned;
                 rc = ORBIS_OK;
                 cache_to_store = header;
+                // The pages after the header bound the glyphs this library keeps in the host
+                // glyph cache, the same way they bound the glyph cache of the real library.
+                Internal::GlyphCache::Instance().SetLibraryCapacity(library,
+                                                                    size_t{page_count} << 12);
                 if (owned) {
                     auto& state = GetLibState(library);
                     state.alloc_ctx = lib->alloc_ctx;
@@ -915,6 +919,7 @@ s32 PS4_SYSV_ABI sceFontClearDeviceCache(OrbisFontLib library) {
     if (current_cache != nullptr) {
         current_cache[3] = current_cache[1];
         current_cache[2] = 0;
+        Internal::GlyphCache::Instance().EraseLibrary(library);
         rc = ORBIS_OK;
     }
 
@@ -1130,6 +1135,7 @@ s32 PS4_SYSV_ABI sceFontDestroyLibrary(OrbisFontLib* pLibrary) {
     }
 
     RemoveLibState(lib);
+    Internal::GlyphCache::Instance().RemoveLibrary(lib);
 
     const auto free_fn = native->alloc_vtbl
                              ? reinterpret_cast<Internal::FontFreeFn>(native->alloc_vtbl[1])
@@ -110,12 +110,137 @@ void DestroyFreeTypeFace(FT_Face& face) {
     if (!face) {
         return;
     }
+    GlyphCache::Instance().EraseFace(face);
     FT_Done_Face(face);
     face = nullptr;
 }
 
 namespace {
 
+/// Renders the glyph at the pen offset and copies it out of the glyph slot, expanding
+/// monochrome bitmaps to one byte per pixel.
+bool LoadRenderedGlyph(FT_Face face, FT_UInt glyph_index, FT_Vector delta, RasterizedGlyph& out) {
+    FT_Set_Transform(face, nullptr, &delta);
+    if (FT_Load_Glyph(face, glyph_index, kFtLoadFlagsRender) != 0) {
+        FT_Set_Transform(face, nullptr, nullptr);
+        return false;
+    }
+    FT_Set_Transform(face, nullptr, nullptr);
+
+    const FT_GlyphSlot slot = face->glyph;
+    if (!slot) {
+        return false;
+    }
+    const int glyph_w = static_cast<int>(slot->bitmap.width);
+    const int glyph_h = static_cast<int>(slot->bitmap.rows);
+    out.metrics = {
+        .width = glyph_w,
+        .rows = glyph_h,
+        .left = static_cast<s32>(slot->bitmap_left),
+        .top = static_cast<s32>(slot->bitmap_top),
+        .hori_bearing_x = static_cast<s64>(slot->metrics.horiBearingX),
+        .hori_bearing_y = static_cast<s64>(slot->metrics.horiBearingY),
+        .hori_advance = static_cast<s64>(slot->metrics.horiAdvance),
+        .metrics_width = static_cast<s64>(slot->metrics.width),
+        .metrics_height = static_cast<s64>(slot->metrics.height),
+    };
+
+    out.bitmap.resize(static_cast<std::size_t>(glyph_w) * static_cast<std::size_t>(glyph_h));
+    if (glyph_w > 0 && glyph_h > 0) {
+        const int pitch = static_cast<int>(slot->bitmap.pitch);
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(slot->bitmap.buffer);
+        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
+            for (int row = 0; row < glyph_h; ++row) {
+                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
+                unsigned char* dst_row =
+                    out.bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
+                for (int col = 0; col < glyph_w; ++col) {
+                    const unsigned char byte = src_row[col >> 3];
+                    const unsigned char bit = static_cast<unsigned char>(0x80u >> (col & 7));
+                    dst_row[col] = (byte & bit) ? 0xFFu : 0x00u;
+                }
+            }
+        } else {
+            for (int row = 0; row < glyph_h; ++row) {
+                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
+                unsigned char* dst_row =
+                    out.bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
+                std::memcpy(dst_row, src_row, static_cast<std::size_t>(glyph_w));
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Games redraw the same strings every frame, so rendered glyphs are cached by everything that
+// affects the output. On a hit the face is neither sized nor loaded.
+bool RasterizeGlyph(const void* library, FT_Face face, FT_UInt glyph_index, FT_F26Dot6 char_w,
+                    FT_F26Dot6 char_h, FT_Vector delta, s32 shift_x_units, s32 shift_y_units,
+                    RasterizedGlyph& out) {
+    const GlyphCacheKey key{
+        .library = library,
+        .face = face,
+        .glyph_index = glyph_index,
+        .load_flags = kFtLoadFlagsRender,
+        .face_scale = false,
+        .size_x = char_w,
+        .size_y = char_h,
+        .delta_x = delta.x,
+        .delta_y = delta.y,
+        .shift_x = shift_x_units,
+        .shift_y = shift_y_units,
+    };
+    auto& cache = GlyphCache::Instance();
+    if (cache.Lookup(key, out)) {
+        return true;
+    }
+    if (FT_Set_Char_Size(face, char_w, char_h, 72, 72) != 0) {
+        return false;
+    }
+    if ((shift_x_units != 0 || shift_y_units != 0) && face->size) {
+        const long x_scale = static_cast<long>(face->size->metrics.x_scale);
+        const long y_scale = static_cast<long>(face->size->metrics.y_scale);
+
+        delta.x += static_cast<FT_Pos>(RoundFixedMul16x16ToS32(x_scale, shift_x_units));
+        delta.y += static_cast<FT_Pos>(RoundFixedMul16x16ToS32(y_scale, shift_y_units));
+    }
+    if (!LoadRenderedGlyph(face, glyph_index, delta, out)) {
+        return false;
+    }
+    cache.Insert(key, out);
+    return true;
+}
+
+bool RasterizeSizedGlyph(const void* library, FT_Face face, FT_UInt glyph_index, FT_Vector delta,
+                         RasterizedGlyph& out) {
+    const GlyphCacheKey key{
+        .library = library,
+        .face = face,
+        .glyph_index = glyph_index,
+        .load_flags = kFtLoadFlagsRender,
+        .face_scale = true,
+        .size_x = static_cast<s64>(face->size->metrics.x_scale),
+        .size_y = static_cast<s64>(face->size->metrics.y_scale),
+        .delta_x = delta.x,
+        .delta_y = delta.y,
+        .shift_x = 0,
+        .shift_y = 0,
+    };
+    auto& cache = GlyphCache::Instance();
+    if (cache.Lookup(key, out)) {
+        return true;
+    }
+    if (!LoadRenderedGlyph(face, glyph_index, delta, out)) {
+        return false;
+    }
+    cache.Insert(key, out);
+    return true;
+}
+
+namespace {
+
 constexpr std::string_view kBuiltinFontPrefix = "@builtin/";
 constexpr std::string_view kBuiltinFontLatin = "@builtin/NotoSans-Regular.ttf";
 constexpr std::string_view kBuiltinFontArabic = "@builtin/NotoSansArabic-Regular.ttf";
@@ -1216,14 +1341,10 @@ s32 RenderCodepointToSurface(FontState& st, Libraries::Font::OrbisFontHandle han
         return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
     }
 
-    const auto set_size = [&](float w, float h) -> bool {
-        const auto char_w = static_cast<FT_F26Dot6>(static_cast<s32>(w * 64.0f));
-        const auto char_h = static_cast<FT_F26Dot6>(static_cast<s32>(h * 64.0f));
-        return FT_Set_Char_Size(resolved_face, char_w, char_h, 72, 72) == 0;
-    };
-    if (!set_size(pixel_w * resolved_scale_factor, pixel_h * resolved_scale_factor)) {
-        return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
-    }
+    const float scaled_w = pixel_w * resolved_scale_factor;
+    const float scaled_h = pixel_h * resolved_scale_factor;
+    const auto char_w = static_cast<FT_F26Dot6>(static_cast<s32>(scaled_w * 64.0f));
+    const auto char_h = static_cast<FT_F26Dot6>(static_cast<s32>(scaled_h * 64.0f));
 
     const float frac_x = x - std::floor(x);
     const float frac_y = y - std::floor(y);
@@ -1231,71 +1352,26 @@ s32 RenderCodepointToSurface(FontState& st, Libraries::Font::OrbisFontHandle han
     delta.x = static_cast<FT_Pos>(static_cast<s32>(frac_x * 64.0f));
     delta.y = static_cast<FT_Pos>(-static_cast<s32>(frac_y * 64.0f));
 
-    if ((shift_x_units != 0 || shift_y_units != 0) && resolved_face->size) {
-        const long x_scale = static_cast<long>(resolved_face->size->metrics.x_scale);
-        const long y_scale = static_cast<long>(resolved_face->size->metrics.y_scale);
-
-        delta.x += static_cast<FT_Pos>(RoundFixedMul16x16ToS32(x_scale, shift_x_units));
-        delta.y += static_cast<FT_Pos>(RoundFixedMul16x16ToS32(y_scale, shift_y_units));
-    }
-    FT_Set_Transform(resolved_face, nullptr, &delta);
-
-    if (FT_Load_Glyph(resolved_face, resolved_glyph_index, kFtLoadFlagsRender) != 0) {
-        FT_Set_Transform(resolved_face, nullptr, nullptr);
+    RasterizedGlyph glyph;
+    if (!RasterizeGlyph(st.library, resolved_face, resolved_glyph_index, char_w, char_h, delta,
+                        shift_x_units, shift_y_units, glyph)) {
         return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
     }
-    std::vector<unsigned char> glyph_bitmap;
-    int x0 = 0, y0 = 0;
-    int glyph_w = 0;
-    int glyph_h = 0;
-
-    const FT_GlyphSlot slot = resolved_face->glyph;
-    glyph_w = static_cast<int>(slot->bitmap.width);
-    glyph_h = static_cast<int>(slot->bitmap.rows);
-    x0 = static_cast<int>(slot->bitmap_left);
-    y0 = -static_cast<int>(slot->bitmap_top);
-    FT_Set_Transform(resolved_face, nullptr, nullptr);
-
-    const float bearing_x = static_cast<float>(slot->metrics.horiBearingX) / 64.0f;
-    const float bearing_y = static_cast<float>(slot->metrics.horiBearingY) / 64.0f;
-    const float advance = static_cast<float>(slot->metrics.horiAdvance) / 64.0f;
-    const float width_px = static_cast<float>(slot->metrics.width) / 64.0f;
-    const float height_px = static_cast<float>(slot->metrics.height) / 64.0f;
-
-    metrics->width = width_px;
-    metrics->height = height_px;
-    metrics->Horizontal.bearingX = bearing_x;
-    metrics->Horizontal.bearingY = bearing_y;
-    metrics->Horizontal.advance = advance;
+    const std::vector<unsigned char>& glyph_bitmap = glyph.bitmap;
+    const int glyph_w = glyph.metrics.width;
+    const int glyph_h = glyph.metrics.rows;
+    const int x0 = glyph.metrics.left;
+    const int y0 = -glyph.metrics.top;
+
+    metrics->width = static_cast<float>(glyph.metrics.metrics_width) / 64.0f;
+    metrics->height = static_cast<float>(glyph.metrics.metrics_height) / 64.0f;
+    metrics->Horizontal.bearingX = static_cast<float>(glyph.metrics.hori_bearing_x) / 64.0f;
+    metrics->Horizontal.bearingY = static_cast<float>(glyph.metrics.hori_bearing_y) / 64.0f;
+    metrics->Horizontal.advance = static_cast<float>(glyph.metrics.hori_advance) / 64.0f;
     metrics->Vertical.bearingX = 0.0f;
     metrics->Vertical.bearingY = 0.0f;
     metrics->Vertical.advance = 0.0f;
 
-    glyph_bitmap.resize(static_cast<std::size_t>(glyph_w) * static_cast<std::size_t>(glyph_h));
-    if (glyph_w > 0 && glyph_h > 0) {
-        const int pitch = static_cast<int>(slot->bitmap.pitch);
-        const unsigned char* src = reinterpret_cast<const unsigned char*>(slot->bitmap.buffer);
-        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
-            for (int row = 0; row < glyph_h; ++row) {
-                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
-                unsigned char* dst_row =
-                    glyph_bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
-                for (int col = 0; col < glyph_w; ++col) {
-                    const unsigned char byte = src_row[col >> 3];
-                    const unsigned char bit = static_cast<unsigned char>(0x80u >> (col & 7));
-                    dst_row[col] = (byte & bit) ? 0xFFu : 0x00u;
-                }
-            }
-        } else {
-            for (int row = 0; row < glyph_h; ++row) {
-                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
-                unsigned char* dst_row =
-                    glyph_bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
-                std::memcpy(dst_row, src_row, static_cast<std::size_t>(glyph_w));
-            }
-        }
-    }
-
     const int dest_x = static_cast<int>(std::floor(x)) + x0;
     const int dest_y = static_cast<int>(std::floor(y)) + y0;
 
@@ -1457,78 +1533,35 @@ s32 RenderCodepointToSurfaceWithScale(FontState& st, Libraries::Font::OrbisFontH
     const float pixel_w = scale_x * static_cast<float>(base_units) * resolved_scale_factor;
     const float pixel_h = scale_y * static_cast<float>(base_units) * resolved_scale_factor;
 
-    const auto set_size = [&](float w, float h) -> bool {
-        const auto char_w = static_cast<FT_F26Dot6>(static_cast<s32>(w * 64.0f));
-        const auto char_h = static_cast<FT_F26Dot6>(static_cast<s32>(h * 64.0f));
-        return FT_Set_Char_Size(resolved_face, char_w, char_h, 72, 72) == 0;
-    };
-    if (!set_size(pixel_w, pixel_h)) {
-        return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
-    }
+    const auto char_w = static_cast<FT_F26Dot6>(static_cast<s32>(pixel_w * 64.0f));
+    const auto char_h = static_cast<FT_F26Dot6>(static_cast<s32>(pixel_h * 64.0f));
 
     const float frac_x = x - std::floor(x);
     const float frac_y = y - std::floor(y);
     FT_Vector delta{};
     delta.x = static_cast<FT_Pos>(static_cast<s32>(frac_x * 64.0f));
     delta.y = static_cast<FT_Pos>(-static_cast<s32>(frac_y * 64.0f));
-    FT_Set_Transform(resolved_face, nullptr, &delta);
 
-    if (FT_Load_Glyph(resolved_face, resolved_glyph_index, kFtLoadFlagsRender) != 0) {
-        FT_Set_Transform(resolved_face, nullptr, nullptr);
+    RasterizedGlyph glyph;
+    if (!RasterizeGlyph(st.library, resolved_face, resolved_glyph_index, char_w, char_h, delta, 0,
+                        0, glyph)) {
         return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
     }
-    std::vector<unsigned char> glyph_bitmap;
-    int x0 = 0, y0 = 0;
-    int glyph_w = 0;
-    int glyph_h = 0;
-
-    const FT_GlyphSlot slot = resolved_face->glyph;
-    glyph_w = static_cast<int>(slot->bitmap.width);
-    glyph_h = static_cast<int>(slot->bitmap.rows);
-    x0 = static_cast<int>(slot->bitmap_left);
-    y0 = -static_cast<int>(slot->bitmap_top);
-    FT_Set_Transform(resolved_face, nullptr, nullptr);
-
-    const float bearing_x = static_cast<float>(slot->metrics.horiBearingX) / 64.0f;
-    const float bearing_y = static_cast<float>(slot->metrics.horiBearingY) / 64.0f;
-    const float advance = static_cast<float>(slot->metrics.horiAdvance) / 64.0f;
-    const float width_px = static_cast<float>(slot->metrics.width) / 64.0f;
-    const float height_px = static_cast<float>(slot->metrics.height) / 64.0f;
-
-    m->width = width_px;
-    m->height = height_px;
-    m->Horizontal.bearingX = bearing_x;
-    m->Horizontal.bearingY = bearing_y;
-    m->Horizontal.advance = advance;
+    const std::vector<unsigned char>& glyph_bitmap = glyph.bitmap;
+    const int glyph_w = glyph.metrics.width;
+    const int glyph_h = glyph.metrics.rows;
+    const int x0 = glyph.metrics.left;
+    const int y0 = -glyph.metrics.top;
+
+    m->width = static_cast<float>(glyph.metrics.metrics_width) / 64.0f;
+    m->height = static_cast<float>(glyph.metrics.metrics_height) / 64.0f;
+    m->Horizontal.bearingX = static_cast<float>(glyph.metrics.hori_bearing_x) / 64.0f;
+    m->Horizontal.bearingY = static_cast<float>(glyph.metrics.hori_bearing_y) / 64.0f;
+    m->Horizontal.advance = static_cast<float>(glyph.metrics.hori_advance) / 64.0f;
     m->Vertical.bearingX = 0.0f;
     m->Vertical.bearingY = 0.0f;
     m->Vertical.advance = 0.0f;
 
-    glyph_bitmap.resize(static_cast<std::size_t>(glyph_w) * static_cast<std::size_t>(glyph_h));
-    if (glyph_w > 0 && glyph_h > 0) {
-        const int pitch = static_cast<int>(slot->bitmap.pitch);
-        const unsigned char* src = reinterpret_cast<const unsigned char*>(slot->bitmap.buffer);
-        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
-            for (int row = 0; row < glyph_h; ++row) {
-                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
-                unsigned char* dst_row =
-                    glyph_bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
-                for (int col = 0; col < glyph_w; ++col) {
-                    const unsigned char byte = src_row[col >> 3];
-                    const unsigned char bit = static_cast<unsigned char>(0x80u >> (col & 7));
-                    dst_row[col] = (byte & bit) ? 0xFFu : 0x00u;
-                }
-            }
-        } else {
-            for (int row = 0; row < glyph_h; ++row) {
-                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
-                unsigned char* dst_row =
-                    glyph_bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
-                std::memcpy(dst_row, src_row, static_cast<std::size_t>(glyph_w));
-            }
-        }
-    }
-
     const int dest_x = static_cast<int>(std::floor(x)) + x0;
     const int dest_y = static_cast<int>(std::floor(y)) + y0;
 
@@ -40,6 +40,7 @@
 #include "core/file_sys/fs.h"
 #include "core/libraries/error_codes.h"
 #include "core/libraries/font/font.h"
+#include "core/libraries/font/glyph_cache.h"
 #include "core/libraries/libs.h"
 #include "font_error.h"
 
@@ -857,6 +858,11 @@ bool AcquireLibraryLock(FontLibOpaque* lib, u32& out_prev_lock_word);
 void ReleaseLibraryLock(FontLibOpaque* lib, u32 prev_lock_word);
 FT_Face CreateFreeTypeFaceFromBytes(const unsigned char* data, std::size_t size, u32 subfont_index);
 void DestroyFreeTypeFace(FT_Face& face);
+bool RasterizeGlyph(const void* library, FT_Face face, FT_UInt glyph_index, FT_F26Dot6 char_w,
+                    FT_F26Dot6 char_h, FT_Vector delta, s32 shift_x_units, s32 shift_y_units,
+                    RasterizedGlyph& out);
+bool RasterizeSizedGlyph(const void* library, FT_Face face, FT_UInt glyph_index, FT_Vector delta,
+                         RasterizedGlyph& out);
 void LogFontOpenError(s32 rc);
 void LogExternalFormatSupport(u32 formats_mask);
 std::optional<std::filesystem::path> ResolveKnownSysFontAlias(
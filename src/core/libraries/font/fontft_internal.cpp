@@ -1779,67 +1779,28 @@ static s32 RenderGlyphIndexToSurface(FontObj& font_obj, u32 glyph_index,
         delta.y += static_cast<FT_Pos>(RoundFixedMul16x16ToS32(y_scale, font_obj.shift_units_y));
     }
 
-    FT_Set_Transform(face, nullptr, &delta);
-
-    constexpr FT_Int32 kFtLoadFlagsRender = static_cast<FT_Int32>(
-        FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP | FT_LOAD_VERTICAL_LAYOUT | FT_LOAD_RENDER);
-    if (FT_Load_Glyph(face, static_cast<FT_UInt>(glyph_index), kFtLoadFlagsRender) != 0) {
-        FT_Set_Transform(face, nullptr, nullptr);
-        return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
-    }
-    FT_Set_Transform(face, nullptr, nullptr);
-
-    const FT_GlyphSlot slot = face->glyph;
-    if (!slot) {
+    const auto* font = GetNativeFont(font_obj.font_handle);
+    RasterizedGlyph glyph;
+    if (!RasterizeSizedGlyph(font ? font->library : nullptr, face,
+                             static_cast<FT_UInt>(glyph_index), delta, glyph)) {
         return ORBIS_FONT_ERROR_NO_SUPPORT_GLYPH;
     }
 
-    const int glyph_w = static_cast<int>(slot->bitmap.width);
-    const int glyph_h = static_cast<int>(slot->bitmap.rows);
-    const int x0 = static_cast<int>(slot->bitmap_left);
-    const int y0 = -static_cast<int>(slot->bitmap_top);
-
-    const float bearing_x = static_cast<float>(slot->metrics.horiBearingX) / 64.0f;
-    const float bearing_y = static_cast<float>(slot->metrics.horiBearingY) / 64.0f;
-    const float advance = static_cast<float>(slot->metrics.horiAdvance) / 64.0f;
-    const float width_px = static_cast<float>(slot->metrics.width) / 64.0f;
-    const float height_px = static_cast<float>(slot->metrics.height) / 64.0f;
+    const std::vector<unsigned char>& glyph_bitmap = glyph.bitmap;
+    const int glyph_w = glyph.metrics.width;
+    const int glyph_h = glyph.metrics.rows;
+    const int x0 = glyph.metrics.left;
+    const int y0 = -glyph.metrics.top;
 
-    metrics->width = width_px;
-    metrics->height = height_px;
-    metrics->Horizontal.bearingX = bearing_x;
-    metrics->Horizontal.bearingY = bearing_y;
-    metrics->Horizontal.advance = advance;
+    metrics->width = static_cast<float>(glyph.metrics.metrics_width) / 64.0f;
+    metrics->height = static_cast<float>(glyph.metrics.metrics_height) / 64.0f;
+    metrics->Horizontal.bearingX = static_cast<float>(glyph.metrics.hori_bearing_x) / 64.0f;
+    metrics->Horizontal.bearingY = static_cast<float>(glyph.metrics.hori_bearing_y) / 64.0f;
+    metrics->Horizontal.advance = static_cast<float>(glyph.metrics.hori_advance) / 64.0f;
     metrics->Vertical.bearingX = 0.0f;
     metrics->Vertical.bearingY = 0.0f;
     metrics->Vertical.advance = 0.0f;
 
-    std::vector<unsigned char> glyph_bitmap;
-    glyph_bitmap.resize(static_cast<std::size_t>(glyph_w) * static_cast<std::size_t>(glyph_h));
-    if (glyph_w > 0 && glyph_h > 0) {
-        const int pitch = static_cast<int>(slot->bitmap.pitch);
-        const unsigned char* src = reinterpret_cast<const unsigned char*>(slot->bitmap.buffer);
-        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
-            for (int row = 0; row < glyph_h; ++row) {
-                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
-                unsigned char* dst_row =
-                    glyph_bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
-                for (int col = 0; col < glyph_w; ++col) {
-                    const unsigned char byte = src_row[col >> 3];
-                    const unsigned char bit = static_cast<unsigned char>(0x80u >> (col & 7));
-                    dst_row[col] = (byte & bit) ? 0xFFu : 0x00u;
-                }
-            }
-        } else {
-            for (int row = 0; row < glyph_h; ++row) {
-                const unsigned char* src_row = src + static_cast<std::size_t>(row) * pitch;
-                unsigned char* dst_row =
-                    glyph_bitmap.data() + static_cast<std::size_t>(row) * glyph_w;
-                std::memcpy(dst_row, src_row, static_cast<std::size_t>(glyph_w));
-            }
-        }
-    }
-
     const int dest_x = static_cast<int>(std::floor(x)) + x0;
     const int dest_y = static_cast<int>(std::floor(y)) + y0;
 
@@ -2520,6 +2481,7 @@ alignas(Libraries::FontFt::OrbisFontRendererSelection) static Libraries::FontFt:
 
 using Libraries::Font::Internal::FontLibOpaque;
 using Libraries::Font::Internal::FontObj;
+using Libraries::Font::Internal::GlyphCache;
 
 static constexpr float kOneOver64 = 1.0f / 64.0f;
 
@@ -3157,6 +3119,7 @@ s32 PS4_SYSV_ABI LibraryCloseFontObjStub(void* fontObj, u32 /*flags*/) {
     }
 
     if (face) {
+        GlyphCache::Instance().EraseFace(face);
         FT_Done_Face(face);
         obj->ft_face = nullptr;
     }
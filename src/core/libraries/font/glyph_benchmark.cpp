@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cmath>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+#include "core/libraries/font/font_internal.h"
+#include "core/libraries/font/glyph_benchmark.h"
+
+namespace Libraries::Font {
+
+using namespace Internal;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::string_view SampleText = "The quick brown fox jumps over the lazy dog. 0123456789 "
+                                        "HP 1250/1300  MP 87/90  Gold 48213  Quest Log ";
+constexpr float LineHeights[] = {14.0f, 20.0f, 32.0f};
+
+struct GlyphRun {
+    FT_UInt glyph_index;
+    FT_F26Dot6 char_size;
+    FT_Vector delta;
+};
+
+/// Lays out the sample text over as many lines as needed, keeping the fractional pen positions.
+static std::vector<GlyphRun> LayoutFrame(FT_Face face, u32 num_glyphs) {
+    std::vector<GlyphRun> runs;
+    runs.reserve(num_glyphs);
+    float pen_x = 0.0f;
+    for (u32 i = 0; i < num_glyphs; i++) {
+        const float height = LineHeights[(i / SampleText.size()) % std::size(LineHeights)];
+        const auto char_size = static_cast<FT_F26Dot6>(height * 64.0f);
+        const char c = SampleText[i % SampleText.size()];
+        if (i % SampleText.size() == 0) {
+            pen_x = 0.0f;
+        }
+        GlyphRun run{FT_Get_Char_Index(face, static_cast<FT_ULong>(c)), char_size, {}};
+        run.delta.x = static_cast<FT_Pos>((pen_x - std::floor(pen_x)) * 64.0f);
+        runs.push_back(run);
+
+        RasterizedGlyph glyph;
+        if (RasterizeGlyph(nullptr, face, run.glyph_index, char_size, char_size, run.delta, 0, 0,
+                           glyph)) {
+            pen_x += static_cast<float>(glyph.metrics.hori_advance) / 64.0f;
+        }
+    }
+    return runs;
+}
+
+static void PrintRow(const char* name, u64 glyphs, Clock::duration elapsed) {
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    const auto stats = GlyphCache::Instance().GetStats();
+    fmt::print("{:<12}{:>12}{:>12.1f}{:>12.2f}{:>12}{:>12}{:>12}\n", name, glyphs,
+               ns / static_cast<double>(glyphs), ns / 1'000'000.0, stats.hits, stats.misses,
+               stats.num_glyphs);
+}
+
+int RunGlyphBenchmark(u32 numGlyphs, u32 numFrames) {
+    std::vector<unsigned char> bytes;
+    if (!LoadFontFile("@builtin/NotoSans-Regular.ttf", bytes)) {
+        fmt::print(stderr, "Failed to load the builtin font\n");
+        return 1;
+    }
+    FT_Face face = CreateFreeTypeFaceFromBytes(bytes.data(), bytes.size(), 0);
+    if (!face) {
+        fmt::print(stderr, "Failed to create the font face\n");
+        return 1;
+    }
+
+    auto& cache = GlyphCache::Instance();
+    cache.SetCapacity(GlyphCache::DefaultCapacity);
+    const auto runs = LayoutFrame(face, numGlyphs);
+
+    fmt::print("{:<12}{:>12}{:>12}{:>12}{:>12}{:>12}{:>12}\n", "cache", "glyphs", "ns/glyph",
+               "total ms", "hits", "misses", "cached");
+    RasterizedGlyph glyph;
+    for (const size_t capacity : {size_t{0}, GlyphCache::DefaultCapacity}) {
+        cache.SetCapacity(capacity);
+        cache.ResetStats();
+        const auto start = Clock::now();
+        for (u32 frame = 0; frame < numFrames; frame++) {
+            for (const auto& run : runs) {
+                RasterizeGlyph(nullptr, face, run.glyph_index, run.char_size, run.char_size,
+                               run.delta, 0, 0, glyph);
+            }
+        }
+        PrintRow(capacity == 0 ? "off" : "on", static_cast<u64>(runs.size()) * numFrames,
+                 Clock::now() - start);
+    }
+
+    DestroyFreeTypeFace(face);
+    return 0;
+}
+
+} // namespace Libraries::Font
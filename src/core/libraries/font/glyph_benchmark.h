@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "common/types.h"
+
+namespace Libraries::Font {
+
+/**
+ * Lays out the given number of glyphs per frame with the builtin Latin font, the way a game
+ * redraws its UI text, and renders them for numFrames frames with and without the glyph cache.
+ * Prints the time per glyph and the cache statistics. Returns the process exit code.
+ */
+int RunGlyphBenchmark(u32 numGlyphs, u32 numFrames);
+
+} // namespace Libraries::Font
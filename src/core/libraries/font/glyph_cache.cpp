@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "common/hash.h"
+#include "core/libraries/font/glyph_cache.h"
+
+namespace Libraries::Font::Internal {
+
+static constexpr u32 MinBlockSize = 64;
+static constexpr u32 NoSlab = ~0U;
+
+static u32 GetBlockSize(u32 size) {
+    return size == 0 ? 0 : std::bit_ceil(std::max(size, MinBlockSize));
+}
+
+GlyphCache::GlyphCache(size_t capacity) : max_slabs{capacity / SlabSize} {}
+
+GlyphCache::~GlyphCache() = default;
+
+GlyphCache& GlyphCache::Instance() {
+    static GlyphCache instance;
+    return instance;
+}
+
+size_t GlyphCache::KeyHash::operator()(const GlyphCacheKey& key) const {
+    u64 hash = reinterpret_cast<uintptr_t>(key.face);
+    hash = HashCombine(hash, reinterpret_cast<uintptr_t>(key.library));
+    hash = HashCombine(hash, (u64{key.glyph_index} << 32) | static_cast<u32>(key.load_flags));
+    hash = HashCombine(hash, static_cast<u64>(key.size_x) * 31 + static_cast<u64>(key.size_y));
+    hash = HashCombine(hash, static_cast<u64>(key.delta_x) * 31 + static_cast<u64>(key.delta_y));
+    hash = HashCombine(hash, (u64{static_cast<u32>(key.shift_x)} << 32) |
+                                 static_cast<u32>(key.shift_y));
+    return HashCombine(hash, u64{key.face_scale});
+}
+
+bool GlyphCache::Lookup(const GlyphCacheKey& key, RasterizedGlyph& out) {
+    std::scoped_lock lk{mutex};
+    const auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    lru.splice(lru.begin(), lru, it->second);
+    const Entry& entry = *it->second;
+    out.metrics = entry.metrics;
+    out.bitmap.resize(entry.size);
+    if (entry.size != 0) {
+        std::memcpy(out.bitmap.data(), slabs[entry.slab].memory.get() + entry.offset, entry.size);
+    }
+    return true;
+}
+
+void GlyphCache::Insert(const GlyphCacheKey& key, const RasterizedGlyph& glyph) {
+    std::scoped_lock lk{mutex};
+    if (entries.contains(key)) {
+        return;
+    }
+    const u32 size = static_cast<u32>(glyph.bitmap.size());
+    if (size > SlabSize || max_slabs == 0) {
+        uncached++;
+        return;
+    }
+    const auto budget = libraries.find(key.library);
+    if (budget != libraries.end()) {
+        const u32 block_size = GetBlockSize(size);
+        if (block_size > budget->second.capacity) {
+            uncached++;
+            return;
+        }
+        while (budget->second.used_bytes + block_size > budget->second.capacity) {
+            EvictOldestOf(key.library);
+        }
+        budget->second.used_bytes += block_size;
+    }
+
+    u32 slab = NoSlab;
+    u32 offset = 0;
+    if (size != 0) {
+        // Once every glyph is gone all slabs are free, so this always finds a block.
+        while (!AllocateBlock(size, slab, offset)) {
+            EvictOldest();
+        }
+        std::memcpy(slabs[slab].memory.get() + offset, glyph.bitmap.data(), size);
+    }
+    lru.push_front({key, glyph.metrics, slab, offset, size});
+    entries.emplace(key, lru.begin());
+}
+
+template <typename Pred>
+void GlyphCache::EraseIf(Pred pred) {
+    for (auto it = lru.begin(); it != lru.end();) {
+        if (!pred(it->key)) {
+            ++it;
+            continue;
+        }
+        FreeBlock(*it);
+        entries.erase(it->key);
+        it = lru.erase(it);
+    }
+}
+
+void GlyphCache::EraseFace(const void* face) {
+    std::scoped_lock lk{mutex};
+    EraseIf([face](const GlyphCacheKey& key) { return key.face == face; });
+}
+
+void GlyphCache::EraseLibrary(const void* library) {
+    std::scoped_lock lk{mutex};
+    EraseIf([library](const GlyphCacheKey& key) { return key.library == library; });
+}
+
+void GlyphCache::SetLibraryCapacity(const void* library, size_t capacity) {
+    std::scoped_lock lk{mutex};
+    EraseIf([library](const GlyphCacheKey& key) { return key.library == library; });
+    libraries.insert_or_assign(library, LibraryBudget{.capacity = capacity, .used_bytes = 0});
+}
+
+void GlyphCache::RemoveLibrary(const void* library) {
+    std::scoped_lock lk{mutex};
+    EraseIf([library](const GlyphCacheKey& key) { return key.library == library; });
+    libraries.erase(library);
+}
+
+void GlyphCache::Clear() {
+    std::scoped_lock lk{mutex};
+    ClearLocked();
+}
+
+void GlyphCache::SetCapacity(size_t capacity) {
+    std::scoped_lock lk{mutex};
+    ClearLocked();
+    slabs.clear();
+    max_slabs = capacity / SlabSize;
+}
+
+GlyphCacheStats GlyphCache::GetStats() const {
+    std::scoped_lock lk{mutex};
+    return {
+        .hits = hits,
+        .misses = misses,
+        .evictions = evictions,
+        .uncached = uncached,
+        .num_glyphs = entries.size(),
+        .used_bytes = used_bytes,
+        .capacity = max_slabs * SlabSize,
+    };
+}
+
+void GlyphCache::ResetStats() {
+    std::scoped_lock lk{mutex};
+    hits = misses = evictions = uncached = 0;
+}
+
+bool GlyphCache::AllocateBlock(u32 size, u32& slab_out, u32& offset_out) {
+    const u32 block_size = GetBlockSize(size);
+
+    // Prefer a slab of the same block size, then an empty one that can be carved up again.
+    u32 target = NoSlab;
+    for (u32 i = 0; i < slabs.size(); i++) {
+        const Slab& slab = slabs[i];
+        if (slab.block_size == block_size && !slab.free_blocks.empty()) {
+            target = i;
+            break;
+        }
+        if (slab.used == 0 && target == NoSlab) {
+            target = i;
+        }
+    }
+    if (target == NoSlab) {
+        if (slabs.size() >= max_slabs) {
+            return false;
+        }
+        target = static_cast<u32>(slabs.size());
+        slabs.push_back({std::make_unique<u8[]>(SlabSize), 0, 0, {}});
+    }
+
+    Slab& slab = slabs[target];
+    if (slab.block_size != block_size) {
+        slab.block_size = block_size;
+        slab.free_blocks.clear();
+        for (u32 offset = SlabSize; offset >= block_size;) {
+            offset -= block_size;
+            slab.free_blocks.push_back(offset);
+        }
+    }
+    slab_out = target;
+    offset_out = slab.free_blocks.back();
+    slab.free_blocks.pop_back();
+    slab.used++;
+    used_bytes += block_size;
+    return true;
+}
+
+void GlyphCache::FreeBlock(const Entry& entry) {
+    if (entry.slab == NoSlab) {
+        return;
+    }
+    Slab& slab = slabs[entry.slab];
+    slab.free_blocks.push_back(entry.offset);
+    slab.used--;
+    used_bytes -= slab.block_size;
+    if (const auto budget = libraries.find(entry.key.library); budget != libraries.end()) {
+        budget->second.used_bytes -= slab.block_size;
+    }
+}
+
+void GlyphCache::Evict(EntryList::iterator it) {
+    FreeBlock(*it);
+    entries.erase(it->key);
+    lru.erase(it);
+    evictions++;
+}
+
+void GlyphCache::EvictOldest() {
+    Evict(std::prev(lru.end()));
+}
+
+void GlyphCache::EvictOldestOf(const void* library) {
+    // Usually a single library renders glyphs, so its oldest one is close to the back.
+    const auto it = std::find_if(lru.rbegin(), lru.rend(), [library](const Entry& entry) {
+        return entry.key.library == library;
+    });
+    Evict(std::prev(it.base()));
+}
+
+void GlyphCache::ClearLocked() {
+    for (const Entry& entry : lru) {
+        FreeBlock(entry);
+    }
+    lru.clear();
+    entries.clear();
+}
+
+} // namespace Libraries::Font::Internal
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "common/types.h"
+
+namespace Libraries::Font::Internal {
+
+/**
+ * Identifies a rendered glyph. The size is either the requested 26.6 character size, or the
+ * 16.16 scale of the face when the caller sized the face beforehand.
+ */
+struct GlyphCacheKey {
+    const void* library; ///< Library that rendered the glyph, so it can drop only its own glyphs
+    const void* face;
+    u32 glyph_index;
+    s32 load_flags;
+    bool face_scale;
+    s64 size_x;
+    s64 size_y;
+    s64 delta_x; ///< Pen offset in 26.6 pixels
+    s64 delta_y;
+    s32 shift_x; ///< Offset in font units, scaled by the face size
+    s32 shift_y;
+
+    bool operator==(const GlyphCacheKey&) const = default;
+};
+
+/// The FreeType glyph slot fields the renderers read. Metrics are in 26.6 pixels.
+struct CachedGlyphMetrics {
+    s32 width;
+    s32 rows;
+    s32 left;
+    s32 top;
+    s64 hori_bearing_x;
+    s64 hori_bearing_y;
+    s64 hori_advance;
+    s64 metrics_width;
+    s64 metrics_height;
+};
+
+/// A glyph with an 8-bit coverage bitmap of width * rows bytes.
+struct RasterizedGlyph {
+    CachedGlyphMetrics metrics;
+    std::vector<u8> bitmap;
+};
+
+struct GlyphCacheStats {
+    u64 hits;
+    u64 misses;
+    u64 evictions;
+    u64 uncached; ///< Glyphs too large for a slab
+    size_t num_glyphs;
+    size_t used_bytes;
+    size_t capacity;
+};
+
+/**
+ * LRU cache of rendered glyphs shared by the font libraries. Bitmaps live in fixed size slabs
+ * carved into power of two blocks, so evicting glyphs never fragments the arena. A library that
+ * attached a device cache buffer may only use as many bytes as the buffer holds, and evicts its
+ * own glyphs to stay within them. The shared arena is never resized or cleared for one library.
+ */
+class GlyphCache {
+public:
+    static constexpr size_t DefaultCapacity = 4_MB;
+    static constexpr size_t SlabSize = 64_KB;
+
+    explicit GlyphCache(size_t capacity = DefaultCapacity);
+    ~GlyphCache();
+
+    static GlyphCache& Instance();
+
+    /// Copies the glyph into out and marks it as most recently used.
+    bool Lookup(const GlyphCacheKey& key, RasterizedGlyph& out);
+
+    /// Stores a copy of the glyph, evicting the least recently used ones to make room.
+    void Insert(const GlyphCacheKey& key, const RasterizedGlyph& glyph);
+
+    /// Drops the glyphs of a face that is about to be destroyed.
+    void EraseFace(const void* face);
+
+    /// Drops the glyphs a library rendered, when the guest clears its device cache.
+    void EraseLibrary(const void* library);
+
+    /// Drops the glyphs of a library and limits the ones it renders from now on to the given
+    /// number of bytes.
+    void SetLibraryCapacity(const void* library, size_t capacity);
+
+    /// Drops the glyphs and the limit of a library that is being destroyed.
+    void RemoveLibrary(const void* library);
+
+    void Clear();
+
+    /// Drops every glyph and limits the arena to the given number of bytes.
+    void SetCapacity(size_t capacity);
+
+    GlyphCacheStats GetStats() const;
+    void ResetStats();
+
+private:
+    struct KeyHash {
+        size_t operator()(const GlyphCacheKey& key) const;
+    };
+
+    struct Slab {
+        std::unique_ptr<u8[]> memory;
+        u32 block_size;
+        u32 used;
+        std::vector<u32> free_blocks;
+    };
+
+    struct Entry {
+        GlyphCacheKey key;
+        CachedGlyphMetrics metrics;
+        u32 slab;
+        u32 offset;
+        u32 size;
+    };
+
+    struct LibraryBudget {
+        size_t capacity;
+        size_t used_bytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    template <typename Pred>
+    void EraseIf(Pred pred);
+    bool AllocateBlock(u32 size, u32& slab_out, u32& offset_out);
+    void FreeBlock(const Entry& entry);
+    void Evict(EntryList::iterator it);
+    void EvictOldest();
+    void EvictOldestOf(const void* library);
+    void ClearLocked();
+
+    mutable std::mutex mutex;
+    size_t max_slabs;
+    std::vector<Slab> slabs;
+    EntryList lru;
+    std::unordered_map<GlyphCacheKey, EntryList::iterator, KeyHash> entries;
+    std::unordered_map<const void*, LibraryBudget> libraries;
+    size_t used_bytes{};
+    u64 hits{};
+    u64 misses{};
+    u64 evictions{};
+    u64 uncached{};
+};
+
+} // namespace Libraries::Font::Internal
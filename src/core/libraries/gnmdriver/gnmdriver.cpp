@@ -5,6 +5,7 @@
 #include "gnmdriver.h"
 
 #include "common/assert.h"
+#include "common/boot_timeline.h"
 #include "common/debug.h"
 #include "common/elf_info.h"
 #include "common/logging/log.h"
@@ -2876,8 +2877,10 @@ int PS4_SYSV_ABI Func_F916890425496553() {
 
 void RegisterLib(Core::Loader::SymbolsResolver* sym) {
     LOG_INFO(Lib_GnmDriver, "Initializing presenter");
+    Common::BootTimeline::Begin("Create presenter");
     liverpool = std::make_unique<AmdGpu::Liverpool>();
     presenter = std::make_unique<Vulkan::Presenter>(*g_window, liverpool.get());
+    Common::BootTimeline::End();
 
     const s32 result = sceKernelGetCompiledSdkVersion(&sdk_version);
     if (result != ORBIS_OK) {
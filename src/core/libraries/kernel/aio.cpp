@@ -1,12 +1,22 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <span>
 #include <thread>
+#include <unordered_map>
 
 #include "aio.h"
 #include "common/assert.h"
 #include "common/debug.h"
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
 #include "core/libraries/kernel/equeue.h"
 #include "core/libraries/kernel/orbis_error.h"
 #include "core/libraries/libs.h"
@@ -14,10 +24,215 @@
 
 namespace Libraries::Kernel {
 
-#define MAX_QUEUE 512
+namespace {
 
-static s32* id_state;
-static s32 id_index;
+constexpr u32 NumAioWorkers = 4;
+
+// Games don't always delete finished requests, so finished ones are pruned past this count
+constexpr size_t MaxTrackedRequests = 4096;
+
+struct AioRequest {
+    std::vector<OrbisKernelAioRWRequest> commands;
+    bool is_write;
+    s32 prio;
+    u64 seq;
+    std::atomic<u32> state{ORBIS_KERNEL_AIO_STATE_SUBMITTED};
+    std::atomic_bool cancel_requested{};
+};
+
+bool IsFinished(u32 state) {
+    return state == ORBIS_KERNEL_AIO_STATE_COMPLETED || state == ORBIS_KERNEL_AIO_STATE_ABORTED;
+}
+
+/**
+ * Requests are queued by priority, then by submission order, and picked up by a small pool of
+ * workers, so they can complete out of order. A request is cancelled outright while it's still
+ * queued. Once a worker picked it up, cancellation takes effect between its commands.
+ */
+class AioEngine {
+public:
+    OrbisKernelAioSubmitId Submit(std::span<const OrbisKernelAioRWRequest> commands, s32 prio,
+                                  bool is_write) {
+        auto request = std::make_shared<AioRequest>();
+        request->commands.assign(commands.begin(), commands.end());
+        request->is_write = is_write;
+        // Unknown priorities are ordered like the closest defined one
+        request->prio = std::clamp<s32>(prio, ORBIS_KERNEL_AIO_PRIORITY_LOW,
+                                        ORBIS_KERNEL_AIO_PRIORITY_HIGH);
+        for (const auto& command : commands) {
+            command.result->state = ORBIS_KERNEL_AIO_STATE_SUBMITTED;
+        }
+
+        std::scoped_lock lk{mutex};
+        if (workers.empty()) {
+            for (u32 i = 0; i < NumAioWorkers; ++i) {
+                workers.emplace_back([this](std::stop_token stoken) { WorkerThread(stoken); });
+            }
+        }
+
+        if (requests.size() >= MaxTrackedRequests) {
+            std::erase_if(requests, [](const auto& entry) {
+                return IsFinished(entry.second->state);
+            });
+        }
+
+        // Id 0 is never handed out, games use it as an invalid id
+        do {
+            next_id = next_id == std::numeric_limits<s32>::max() ? 1 : next_id + 1;
+        } while (requests.contains(next_id));
+
+        request->seq = next_seq++;
+        requests.emplace(next_id, request);
+        queue.push(std::move(request));
+        queue_cv.notify_one();
+        return next_id;
+    }
+
+    /// Returns the state of a request, or zero if the id is unknown.
+    u32 Poll(OrbisKernelAioSubmitId id) {
+        std::scoped_lock lk{mutex};
+        const auto it = requests.find(id);
+        return it == requests.end() ? 0 : it->second->state.load();
+    }
+
+    u32 Cancel(OrbisKernelAioSubmitId id) {
+        std::scoped_lock lk{mutex};
+        const auto it = requests.find(id);
+        if (it == requests.end()) {
+            return 0;
+        }
+        auto& request = *it->second;
+        u32 expected = ORBIS_KERNEL_AIO_STATE_SUBMITTED;
+        if (request.state.compare_exchange_strong(expected, ORBIS_KERNEL_AIO_STATE_ABORTED)) {
+            for (const auto& command : request.commands) {
+                command.result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+                command.result->returnValue = ORBIS_KERNEL_ERROR_ECANCELED;
+            }
+            completion_cv.notify_all();
+            return ORBIS_KERNEL_AIO_STATE_ABORTED;
+        }
+        request.cancel_requested = true;
+        return request.state.load();
+    }
+
+    bool Delete(OrbisKernelAioSubmitId id) {
+        std::scoped_lock lk{mutex};
+        const auto it = requests.find(id);
+        if (it == requests.end()) {
+            return false;
+        }
+        // A queued request is dropped with its entry, one being processed is left to finish
+        u32 expected = ORBIS_KERNEL_AIO_STATE_SUBMITTED;
+        it->second->state.compare_exchange_strong(expected, ORBIS_KERNEL_AIO_STATE_ABORTED);
+        requests.erase(it);
+        return true;
+    }
+
+    /// Waits until all (or any, with wait_any) of the requests are finished. A null or zero
+    /// timeout waits forever. Returns false on timeout.
+    bool Wait(std::span<const OrbisKernelAioSubmitId> ids, bool wait_any, const u32* usec) {
+        const auto is_done = [&] {
+            u32 num_finished = 0;
+            for (const auto id : ids) {
+                const auto it = requests.find(id);
+                if (it == requests.end() || IsFinished(it->second->state)) {
+                    ++num_finished;
+                }
+            }
+            return wait_any ? num_finished > 0 : num_finished == ids.size();
+        };
+
+        std::unique_lock lk{mutex};
+        if (!usec || *usec == 0) {
+            completion_cv.wait(lk, is_done);
+            return true;
+        }
+        return completion_cv.wait_for(lk, std::chrono::microseconds{*usec}, is_done);
+    }
+
+private:
+    struct QueueOrder {
+        bool operator()(const std::shared_ptr<AioRequest>& lhs,
+                        const std::shared_ptr<AioRequest>& rhs) const {
+            if (lhs->prio != rhs->prio) {
+                return lhs->prio < rhs->prio;
+            }
+            return lhs->seq > rhs->seq;
+        }
+    };
+
+    void WorkerThread(std::stop_token stoken) {
+        Common::SetCurrentThreadName("shadPS4:AioWorker");
+        while (!stoken.stop_requested()) {
+            std::shared_ptr<AioRequest> request;
+            {
+                std::unique_lock lk{mutex};
+                Common::CondvarWait(queue_cv, lk, stoken, [this] { return !queue.empty(); });
+                if (stoken.stop_requested()) {
+                    return;
+                }
+                request = queue.top();
+                queue.pop();
+            }
+            u32 expected = ORBIS_KERNEL_AIO_STATE_SUBMITTED;
+            if (!request->state.compare_exchange_strong(expected,
+                                                        ORBIS_KERNEL_AIO_STATE_PROCESSING)) {
+                // Cancelled while queued
+                continue;
+            }
+            Process(*request);
+            {
+                std::scoped_lock lk{mutex};
+                completion_cv.notify_all();
+            }
+        }
+    }
+
+    void Process(AioRequest& request) {
+        bool failed = false;
+        for (const auto& command : request.commands) {
+            auto* result = command.result;
+            if (request.cancel_requested) {
+                result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+                result->returnValue = ORBIS_KERNEL_ERROR_ECANCELED;
+                failed = true;
+                continue;
+            }
+            result->state = ORBIS_KERNEL_AIO_STATE_PROCESSING;
+            const s64 ret =
+                request.is_write
+                    ? sceKernelPwrite(command.fd, command.buf, command.nbyte, command.offset)
+                    : sceKernelPread(command.fd, command.buf, command.nbyte, command.offset);
+            result->returnValue = ret;
+            result->state = ret < 0 ? ORBIS_KERNEL_AIO_STATE_ABORTED
+                                    : ORBIS_KERNEL_AIO_STATE_COMPLETED;
+            failed |= ret < 0;
+        }
+
+        // Batched submissions only report a failure through the per-command results
+        const bool batched = request.commands.size() > 1;
+        request.state = failed && !batched ? ORBIS_KERNEL_AIO_STATE_ABORTED
+                                           : ORBIS_KERNEL_AIO_STATE_COMPLETED;
+        if (request.cancel_requested) {
+            request.state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable_any queue_cv;
+    std::condition_variable completion_cv;
+    std::priority_queue<std::shared_ptr<AioRequest>, std::vector<std::shared_ptr<AioRequest>>,
+                        QueueOrder>
+        queue;
+    std::unordered_map<OrbisKernelAioSubmitId, std::shared_ptr<AioRequest>> requests;
+    std::vector<std::jthread> workers;
+    OrbisKernelAioSubmitId next_id{};
+    u64 next_seq{};
+};
+
+AioEngine* g_aio{};
+
+} // Anonymous namespace
 
 s32 PS4_SYSV_ABI sceKernelAioInitializeImpl(void* p, s32 size) {
 
@@ -28,8 +243,7 @@ s32 PS4_SYSV_ABI sceKernelAioDeleteRequest(OrbisKernelAioSubmitId id, s32* ret)
     if (ret == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    id_state[id] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-    *ret = 0;
+    *ret = g_aio->Delete(id) ? 0 : ORBIS_KERNEL_ERROR_ESRCH;
     return 0;
 }
 
@@ -38,8 +252,7 @@ s32 PS4_SYSV_ABI sceKernelAioDeleteRequests(OrbisKernelAioSubmitId id[], s32 num
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
     for (s32 i = 0; i < num; i++) {
-        id_state[id[i]] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-        ret[i] = 0;
+        ret[i] = g_aio->Delete(id[i]) ? 0 : ORBIS_KERNEL_ERROR_ESRCH;
     }
 
     return 0;
@@ -48,7 +261,11 @@ s32 PS4_SYSV_ABI sceKernelAioPollRequest(OrbisKernelAioSubmitId id, s32* state)
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    *state = id_state[id];
+    const u32 request_state = g_aio->Poll(id);
+    if (request_state == 0) {
+        return ORBIS_KERNEL_ERROR_ESRCH;
+    }
+    *state = request_state;
     return 0;
 }
 
@@ -57,7 +274,7 @@ s32 PS4_SYSV_ABI sceKernelAioPollRequests(OrbisKernelAioSubmitId id[], s32 num,
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
     for (s32 i = 0; i < num; i++) {
-        state[i] = id_state[id[i]];
+        state[i] = g_aio->Poll(id[i]);
     }
 
     return 0;
@@ -67,12 +284,11 @@ s32 PS4_SYSV_ABI sceKernelAioCancelRequest(OrbisKernelAioSubmitId id, s32* state
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    if (id) {
-        id_state[id] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-        *state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-    } else {
-        *state = ORBIS_KERNEL_AIO_STATE_PROCESSING;
+    const u32 request_state = g_aio->Cancel(id);
+    if (request_state == 0) {
+        return ORBIS_KERNEL_ERROR_ESRCH;
     }
+    *state = request_state;
     return 0;
 }
 
@@ -81,12 +297,7 @@ s32 PS4_SYSV_ABI sceKernelAioCancelRequests(OrbisKernelAioSubmitId id[], s32 num
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
     for (s32 i = 0; i < num; i++) {
-        if (id[i]) {
-            id_state[id[i]] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            state[i] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-        } else {
-            state[i] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-        }
+        state[i] = g_aio->Cancel(id[i]);
     }
 
     return 0;
@@ -96,65 +307,26 @@ s32 PS4_SYSV_ABI sceKernelAioWaitRequest(OrbisKernelAioSubmitId id, s32* state,
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    u32 timer = 0;
-
-    s32 timeout = 0;
-
-    while (id_state[id] == ORBIS_KERNEL_AIO_STATE_PROCESSING) {
-        sceKernelUsleep(10);
-
-        timer += 10;
-        if (*usec) {
-            if (timer > *usec) {
-                timeout = 1;
-                break;
-            }
-        }
-    }
-
-    *state = id_state[id];
-
-    if (timeout)
+    const bool finished = g_aio->Wait(std::span{&id, 1}, false, usec);
+    *state = g_aio->Poll(id);
+    if (!finished) {
         return ORBIS_KERNEL_ERROR_ETIMEDOUT;
-    return 0;
+    }
+    return *state == 0 ? ORBIS_KERNEL_ERROR_ESRCH : 0;
 }
 
 s32 PS4_SYSV_ABI sceKernelAioWaitRequests(OrbisKernelAioSubmitId id[], s32 num, s32 state[],
                                           u32 mode, u32* usec) {
-    if (state == nullptr) {
+    if (state == nullptr || id == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    u32 timer = 0;
-    s32 timeout = 0;
-    s32 completion = 0;
-
+    // Mode 0x01 waits for all of the requests, mode 0x02 for any of them
+    const bool finished =
+        g_aio->Wait(std::span{id, static_cast<size_t>(num)}, mode == 0x02, usec);
     for (s32 i = 0; i < num; i++) {
-        if (!completion && !timeout) {
-            while (id_state[id[i]] == ORBIS_KERNEL_AIO_STATE_PROCESSING) {
-                sceKernelUsleep(10);
-                timer += 10;
-
-                if (*usec) {
-                    if (timer > *usec) {
-                        timeout = 1;
-                        break;
-                    }
-                }
-            }
-        }
-
-        if (mode == 0x02) {
-            if (id_state[id[i]] == ORBIS_KERNEL_AIO_STATE_COMPLETED)
-                completion = 1;
-        }
-
-        state[i] = id_state[id[i]];
+        state[i] = g_aio->Poll(id[i]);
     }
-
-    if (timeout)
-        return ORBIS_KERNEL_ERROR_ETIMEDOUT;
-
-    return 0;
+    return finished ? 0 : ORBIS_KERNEL_ERROR_ETIMEDOUT;
 }
 
 s32 PS4_SYSV_ABI sceKernelAioSubmitReadCommands(OrbisKernelAioRWRequest req[], s32 size, s32 prio,
@@ -165,31 +337,7 @@ s32 PS4_SYSV_ABI sceKernelAioSubmitReadCommands(OrbisKernelAioRWRequest req[], s
     if (id == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-
-    for (s32 i = 0; i < size; i++) {
-
-        s64 ret = sceKernelPread(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-        }
-    }
-
-    id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-
-    *id = id_index;
-
-    id_index = (id_index + 1) % MAX_QUEUE;
-
-    if (!id_index)
-        id_index++;
-
+    *id = g_aio->Submit(std::span{req, static_cast<size_t>(size)}, prio, false);
     return 0;
 }
 
@@ -202,31 +350,8 @@ s32 PS4_SYSV_ABI sceKernelAioSubmitReadCommandsMultiple(OrbisKernelAioRWRequest
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
     for (s32 i = 0; i < size; i++) {
-        id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-
-        s64 ret = sceKernelPread(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-        }
-
-        id[i] = id_index;
-
-        id_index = (id_index + 1) % MAX_QUEUE;
-
-        if (!id_index)
-            id_index++;
+        id[i] = g_aio->Submit(std::span{&req[i], 1}, prio, false);
     }
-
     return 0;
 }
 
@@ -238,34 +363,7 @@ s32 PS4_SYSV_ABI sceKernelAioSubmitWriteCommands(OrbisKernelAioRWRequest req[],
     if (id == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    for (s32 i = 0; i < size; i++) {
-        id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-
-        s64 ret = sceKernelPwrite(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-        }
-    }
-
-    *id = id_index;
-
-    id_index = (id_index + 1) % MAX_QUEUE;
-
-    // skip id_index equals 0 , because sceKernelAioCancelRequest will submit id
-    // equal to 0
-    if (!id_index)
-        id_index++;
-
+    *id = g_aio->Submit(std::span{req, static_cast<size_t>(size)}, prio, true);
     return 0;
 }
 
@@ -278,26 +376,7 @@ s32 PS4_SYSV_ABI sceKernelAioSubmitWriteCommandsMultiple(OrbisKernelAioRWRequest
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
     for (s32 i = 0; i < size; i++) {
-        id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-        s64 ret = sceKernelPwrite(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-        }
-
-        id[i] = id_index;
-        id_index = (id_index + 1) % MAX_QUEUE;
-
-        if (!id_index)
-            id_index++;
+        id[i] = g_aio->Submit(std::span{&req[i], 1}, prio, true);
     }
     return 0;
 }
@@ -313,9 +392,8 @@ s32 PS4_SYSV_ABI sceKernelAioInitializeParam() {
 }
 
 void RegisterAio(Core::Loader::SymbolsResolver* sym) {
-    id_index = 1;
-    id_state = (int*)malloc(sizeof(int) * MAX_QUEUE);
-    memset(id_state, 0, sizeof(sizeof(int) * MAX_QUEUE));
+    static AioEngine engine{};
+    g_aio = &engine;
 
     LIB_FUNCTION("fR521KIGgb8", "libkernel", 1, "libkernel", sceKernelAioCancelRequest);
     LIB_FUNCTION("3Lca1XBrQdY", "libkernel", 1, "libkernel", sceKernelAioCancelRequests);
@@ -336,4 +414,4 @@ void RegisterAio(Core::Loader::SymbolsResolver* sym) {
     LIB_FUNCTION("lgK+oIWkJyA", "libkernel", 1, "libkernel", sceKernelAioWaitRequests);
 }
 
-} // namespace Libraries::Kernel
\ No newline at end of file
+} // namespace Libraries::Kernel
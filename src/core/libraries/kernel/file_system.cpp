@@ -8,7 +8,6 @@
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/logging/log.h"
-#include "common/scope_exit.h"
 #include "common/singleton.h"
 #include "core/file_sys/devices/console_device.h"
 #include "core/file_sys/devices/deci_tty6_device.h"
@@ -153,6 +152,7 @@ s32 PS4_SYSV_ABI open(const char* raw_path, s32 flags, u16 mode) {
             }
             // Create a file if it doesn't exist
             Common::FS::IOFile out(file->m_host_name, Common::FS::FileAccessMode::Create);
+            mnt->InvalidatePathIndex(file->m_guest_name);
         }
     } else if (!exists) {
         // If we're not creating a file, and it doesn't exist, return ENOENT
@@ -288,6 +288,7 @@ s32 PS4_SYSV_ABI close(s32 fd) {
         return -1;
     }
     if (file->type == Core::FileSys::FileType::Regular) {
+        std::unique_lock io_lock{file->m_io_mutex};
         file->f.Close();
     } else if (file->type == Core::FileSys::FileType::Socket) {
         file->socket->Close();
@@ -352,6 +353,12 @@ s64 PS4_SYSV_ABI sceKernelWrite(s32 fd, const void* buf, u64 nbytes) {
     return result;
 }
 
+static std::span<const Common::FS::IoVec> AsIoVecs(const OrbisKernelIovec* iov, s32 iovcnt) {
+    static_assert(sizeof(OrbisKernelIovec) == sizeof(Common::FS::IoVec) &&
+                  offsetof(OrbisKernelIovec, iov_len) == offsetof(Common::FS::IoVec, size));
+    return {reinterpret_cast<const Common::FS::IoVec*>(iov), static_cast<size_t>(iovcnt)};
+}
+
 s64 ReadFile(Common::FS::IOFile& file, void* buf, u64 nbytes) {
     const auto* memory = Core::Memory::Instance();
     // Invalidate up to the actual number of bytes that could be read.
@@ -603,6 +610,7 @@ s32 PS4_SYSV_ABI posix_mkdir(const char* path, u16 mode) {
         *__Error() = POSIX_EIO;
         return -1;
     }
+    mnt->InvalidatePathIndex(path);
 
     if (!fs::exists(dir_name)) {
         *__Error() = POSIX_ENOENT;
@@ -647,6 +655,7 @@ s32 PS4_SYSV_ABI posix_rmdir(const char* path) {
 
     std::error_code ec;
     s32 result = fs::remove_all(dir_name, ec);
+    mnt->InvalidatePathIndex(path);
 
     if (ec) {
         *__Error() = POSIX_EIO;
@@ -920,6 +929,8 @@ s32 PS4_SYSV_ABI posix_rename(const char* from, const char* to) {
     } else {
         fs::remove_all(src_path);
     }
+    mnt->InvalidatePathIndex(from);
+    mnt->InvalidatePathIndex(to);
 
     return ORBIS_OK;
 }
@@ -940,14 +951,15 @@ s64 PS4_SYSV_ABI posix_preadv(s32 fd, OrbisKernelIovec* iov, s32 iovcnt, s64 off
     }
 
     auto* h = Common::Singleton<Core::FileSys::HandleTable>::Instance();
-    auto* file = h->GetFile(fd);
+    std::shared_lock<std::shared_mutex> io_lock;
+    auto* file = h->GetFile(fd, io_lock);
     if (file == nullptr) {
         *__Error() = POSIX_EBADF;
         return -1;
     }
 
-    std::scoped_lock lk{file->m_mutex};
     if (file->type == Core::FileSys::FileType::Device) {
+        std::scoped_lock lk{file->m_mutex};
         s64 result = file->device->preadv(iov, iovcnt, offset);
         if (result < 0) {
             ErrSceToPosix(result);
@@ -955,6 +967,7 @@ s64 PS4_SYSV_ABI posix_preadv(s32 fd, OrbisKernelIovec* iov, s32 iovcnt, s64 off
         }
         return result;
     } else if (file->type == Core::FileSys::FileType::Directory) {
+        std::scoped_lock lk{file->m_mutex};
         s64 result = file->directory->preadv(iov, iovcnt, offset);
         if (result < 0) {
             ErrSceToPosix(result);
@@ -968,19 +981,21 @@ s64 PS4_SYSV_ABI posix_preadv(s32 fd, OrbisKernelIovec* iov, s32 iovcnt, s64 off
         return -1;
     }
 
-    const s64 pos = file->f.Tell();
-    SCOPE_EXIT {
-        file->f.Seek(pos);
-    };
-    if (!file->f.Seek(offset)) {
-        *__Error() = POSIX_EIO;
-        return -1;
-    }
-    s64 total_read = 0;
+    // Regular files are read positionally, which leaves the file position alone, so reads of
+    // the same file run concurrently. The shared I/O lock keeps close from destroying the stream
+    // meanwhile. Invalidating downloads GPU data into the buffers, so it has to happen before the
+    // read and covers what was requested.
+    const auto* memory = Core::Memory::Instance();
     for (s32 i = 0; i < iovcnt; i++) {
-        total_read += ReadFile(file->f, iov[i].iov_base, iov[i].iov_len);
+        memory->InvalidateMemory(reinterpret_cast<VAddr>(iov[i].iov_base), iov[i].iov_len);
     }
-    return total_read;
+
+    const s64 result = file->f.ReadAtv(AsIoVecs(iov, iovcnt), offset);
+    if (result < 0) {
+        SetPosixErrno(errno);
+        return -1;
+    }
+    return result;
 }
 
 s64 PS4_SYSV_ABI sceKernelPreadv(s32 fd, OrbisKernelIovec* iov, s32 iovcnt, s64 offset) {
@@ -1132,19 +1147,12 @@ s64 PS4_SYSV_ABI posix_pwritev(s32 fd, const OrbisKernelIovec* iov, s32 iovcnt,
         return -1;
     }
 
-    const s64 pos = file->f.Tell();
-    SCOPE_EXIT {
-        file->f.Seek(pos);
-    };
-    if (!file->f.Seek(offset)) {
-        *__Error() = POSIX_EIO;
+    const s64 result = file->f.WriteAtv(AsIoVecs(iov, iovcnt), offset);
+    if (result < 0) {
+        SetPosixErrno(errno);
         return -1;
     }
-    s64 total_written = 0;
-    for (s32 i = 0; i < iovcnt; i++) {
-        total_written += file->f.WriteRaw<u8>(iov[i].iov_base, iov[i].iov_len);
-    }
-    return total_written;
+    return result;
 }
 
 s64 PS4_SYSV_ABI posix_pwrite(s32 fd, void* buf, u64 nbytes, s64 offset) {
@@ -1208,6 +1216,7 @@ s32 PS4_SYSV_ABI posix_unlink(const char* path) {
     } else {
         file->f.Unlink();
     }
+    mnt->InvalidatePathIndex(path);
 
     LOG_INFO(Kernel_Fs, "Unlinked {}", path);
     return ORBIS_OK;
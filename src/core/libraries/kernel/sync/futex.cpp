@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "common/assert.h"
+#include "core/libraries/kernel/sync/futex.h"
+
+namespace Libraries::Kernel::Futex {
+
+static_assert(sizeof(std::atomic<u32>) == sizeof(u32) && std::atomic<u32>::is_always_lock_free);
+
+bool Wait(std::atomic<u32>& word, u32 expected, s64 deadline_ns, DeadlineClock clock) {
+    // FUTEX_WAIT_BITSET takes an absolute deadline, so retrying after a signal does not stretch
+    // the timeout the way relative FUTEX_WAIT would.
+    int op = FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG;
+    if (clock == DeadlineClock::Realtime) {
+        op |= FUTEX_CLOCK_REALTIME;
+    }
+    timespec ts{};
+    timespec* timeout = nullptr;
+    if (deadline_ns >= 0) {
+        ts.tv_sec = static_cast<time_t>(deadline_ns / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(deadline_ns % 1'000'000'000);
+        timeout = &ts;
+    }
+    const long ret = syscall(SYS_futex, reinterpret_cast<u32*>(&word), op, expected, timeout,
+                             nullptr, FUTEX_BITSET_MATCH_ANY);
+    if (ret == 0) {
+        return true;
+    }
+    switch (errno) {
+    case EAGAIN:
+    case EINTR:
+        return true;
+    case ETIMEDOUT:
+        return false;
+    default:
+        UNREACHABLE_MSG("futex wait failed with errno {}", errno);
+    }
+}
+
+void Wake(std::atomic<u32>& word, s32 count) {
+    syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count,
+            nullptr, nullptr, 0);
+}
+
+} // namespace Libraries::Kernel::Futex
+
+#endif
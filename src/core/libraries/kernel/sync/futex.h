@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+#include "common/types.h"
+
+namespace Libraries::Kernel::Futex {
+
+/// Clock an absolute futex deadline is measured against.
+enum class DeadlineClock : u32 {
+    Monotonic,
+    Realtime,
+};
+
+/**
+ * Sleeps while word still holds expected. The deadline is absolute nanoseconds since the epoch
+ * of clock, or negative to wait forever. Returns false only when the deadline passed; spurious
+ * wakeups and signals return true so the caller rechecks its condition.
+ */
+bool Wait(std::atomic<u32>& word, u32 expected, s64 deadline_ns,
+          DeadlineClock clock = DeadlineClock::Monotonic);
+
+/// Wakes up to count threads sleeping on word.
+void Wake(std::atomic<u32>& word, s32 count);
+
+/// Converts an absolute time point into a futex deadline, picking the matching kernel clock.
+template <class Clock, class Duration>
+s64 ToDeadline(const std::chrono::time_point<Clock, Duration>& abs_time, DeadlineClock& clock) {
+    using namespace std::chrono;
+    if constexpr (std::is_same_v<Clock, steady_clock>) {
+        clock = DeadlineClock::Monotonic;
+        return ceil<nanoseconds>(abs_time).time_since_epoch().count();
+    } else if constexpr (std::is_same_v<Clock, system_clock>) {
+        clock = DeadlineClock::Realtime;
+        return ceil<nanoseconds>(abs_time).time_since_epoch().count();
+    } else {
+        clock = DeadlineClock::Monotonic;
+        const auto rel_time = ceil<nanoseconds>(abs_time - Clock::now());
+        return (steady_clock::now() + rel_time).time_since_epoch().count();
+    }
+}
+
+/// Converts a relative timeout into a monotonic futex deadline, saturating on overflow.
+template <class Rep, class Period>
+s64 ToDeadline(const std::chrono::duration<Rep, Period>& rel_time) {
+    using namespace std::chrono;
+    const s64 now = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    if (rel_time <= duration<Rep, Period>::zero()) {
+        return now;
+    }
+    if (rel_time >= duration_cast<duration<Rep, Period>>(hours{24 * 365})) {
+        return -1;
+    }
+    return now + ceil<nanoseconds>(rel_time).count();
+}
+
+} // namespace Libraries::Kernel::Futex
+
+#endif
@@ -5,8 +5,22 @@
 
 #include "common/assert.h"
 
+#if defined(__linux__) && defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
 namespace Libraries::Kernel {
 
+#ifdef __linux__
+static void ThreadPause() {
+#ifdef __x86_64__
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+#endif
+
 TimedMutex::TimedMutex() {
 #ifdef _WIN64
     mtx = CreateMutex(nullptr, false, nullptr);
@@ -28,6 +42,10 @@ void TimedMutex::lock() {
             return;
         }
     }
+#elif defined(__linux__)
+    if (!try_lock()) {
+        LockSlow(-1, Futex::DeadlineClock::Monotonic);
+    }
 #else
     mtx.lock();
 #endif
@@ -36,6 +54,10 @@ void TimedMutex::lock() {
 bool TimedMutex::try_lock() {
 #ifdef _WIN64
     return WaitForSingleObjectEx(mtx, 0, true) == WAIT_OBJECT_0;
+#elif defined(__linux__)
+    u32 expected = Unlocked;
+    return state.compare_exchange_strong(expected, Locked, std::memory_order_acquire,
+                                         std::memory_order_relaxed);
 #else
     return mtx.try_lock();
 #endif
@@ -44,9 +66,41 @@ bool TimedMutex::try_lock() {
 void TimedMutex::unlock() {
 #ifdef _WIN64
     ReleaseMutex(mtx);
+#elif defined(__linux__)
+    if (state.exchange(Unlocked, std::memory_order_release) == Contended) {
+        Futex::Wake(state, 1);
+    }
 #else
     mtx.unlock();
 #endif
 }
 
+#ifdef __linux__
+bool TimedMutex::LockSlow(s64 deadline, Futex::DeadlineClock clock) {
+    // Guest critical sections are usually short, so spin briefly before paying for a syscall.
+    for (u32 spin = 0; spin < 100; spin++) {
+        u32 current = state.load(std::memory_order_relaxed);
+        if (current == Contended) {
+            break;
+        }
+        if (current == Unlocked &&
+            state.compare_exchange_weak(current, Locked, std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+            return true;
+        }
+        ThreadPause();
+    }
+    // Once a thread has slept the lock is marked contended, so unlock() knows to wake the next
+    // sleeper. This may cost a spare wake after the last waiter leaves, never a lost one.
+    while (state.exchange(Contended, std::memory_order_acquire) != Unlocked) {
+        if (!Futex::Wait(state, Contended, deadline, clock)) {
+            u32 expected = Unlocked;
+            return state.compare_exchange_strong(expected, Contended, std::memory_order_acquire,
+                                                 std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+#endif
+
 } // namespace Libraries::Kernel
\ No newline at end of file
@@ -9,6 +9,9 @@
 
 #ifdef _WIN64
 #include <windows.h>
+#elif defined(__linux__)
+#include <atomic>
+#include "core/libraries/kernel/sync/futex.h"
 #else
 #include <mutex>
 #endif
@@ -42,6 +45,8 @@ public:
         }
 
         return try_lock_until(abs_time);
+#elif defined(__linux__)
+        return try_lock() || LockSlow(Futex::ToDeadline(rel_time), Futex::DeadlineClock::Monotonic);
 #else
         return mtx.try_lock_for(rel_time);
 #endif
@@ -64,14 +69,33 @@ public:
                 return false;
             }
         }
+#elif defined(__linux__)
+        if (try_lock()) {
+            return true;
+        }
+        Futex::DeadlineClock clock;
+        const s64 deadline = Futex::ToDeadline(abs_time, clock);
+        return LockSlow(deadline, clock);
 #else
         return mtx.try_lock_until(abs_time);
 #endif
     }
 
 private:
+#ifdef __linux__
+    enum State : u32 {
+        Unlocked = 0,
+        Locked = 1,
+        Contended = 2,
+    };
+
+    bool LockSlow(s64 deadline, Futex::DeadlineClock clock);
+#endif
+
 #ifdef _WIN64
     HANDLE mtx;
+#elif defined(__linux__)
+    std::atomic<u32> state{Unlocked};
 #else
     std::timed_mutex mtx;
 #endif
@@ -13,6 +13,8 @@
 #include <windows.h>
 #elif defined(__APPLE__)
 #include <dispatch/dispatch.h>
+#elif defined(__linux__)
+#include "core/libraries/kernel/sync/futex.h"
 #else
 #include <semaphore>
 #endif
@@ -23,7 +25,9 @@ template <s64 max>
 class Semaphore {
 public:
     Semaphore(s32 initialCount)
-#if !defined(_WIN64) && !defined(__APPLE__)
+#if defined(__linux__)
+        : count{static_cast<u32>(initialCount)}
+#elif !defined(_WIN64) && !defined(__APPLE__)
         : sem{initialCount}
 #endif
     {
@@ -49,6 +53,11 @@ public:
         ReleaseSemaphore(sem, 1, nullptr);
 #elif defined(__APPLE__)
         dispatch_semaphore_signal(sem);
+#elif defined(__linux__)
+        count.fetch_add(1);
+        if (waiters.load() != 0) {
+            Futex::Wake(count, 1);
+        }
 #else
         sem.release();
 #endif
@@ -69,6 +78,8 @@ public:
                 return;
             }
         }
+#elif defined(__linux__)
+        AcquireUntil(-1, Futex::DeadlineClock::Monotonic);
 #else
         sem.acquire();
 #endif
@@ -79,6 +90,8 @@ public:
         return WaitForSingleObjectEx(sem, 0, true) == WAIT_OBJECT_0;
 #elif defined(__APPLE__)
         return dispatch_semaphore_wait(sem, DISPATCH_TIME_NOW) == 0;
+#elif defined(__linux__)
+        return TryDecrement();
 #else
         return sem.try_acquire();
 #endif
@@ -107,6 +120,9 @@ public:
         const auto rel_time_ns = std::chrono::ceil<std::chrono::nanoseconds>(rel_time);
         const auto timeout = dispatch_time(DISPATCH_TIME_NOW, rel_time_ns.count());
         return dispatch_semaphore_wait(sem, timeout) == 0;
+#elif defined(__linux__)
+        return TryDecrement() ||
+               AcquireUntil(Futex::ToDeadline(rel_time), Futex::DeadlineClock::Monotonic);
 #else
         return sem.try_acquire_for(rel_time);
 #endif
@@ -114,18 +130,59 @@ public:
 
     template <class Clock, class Duration>
     bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& abs_time) {
+#ifdef __linux__
+        if (TryDecrement()) {
+            return true;
+        }
+        Futex::DeadlineClock clock;
+        const s64 deadline = Futex::ToDeadline(abs_time, clock);
+        return AcquireUntil(deadline, clock);
+#else
         const auto current = Clock::now();
         if (current >= abs_time) {
             return try_acquire();
         }
         return try_acquire_for(abs_time - current);
+#endif
     }
 
 private:
+#ifdef __linux__
+    bool TryDecrement() {
+        u32 current = count.load(std::memory_order_relaxed);
+        while (current != 0) {
+            if (count.compare_exchange_weak(current, current - 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool AcquireUntil(s64 deadline, Futex::DeadlineClock clock) {
+        for (;;) {
+            if (TryDecrement()) {
+                return true;
+            }
+            // The waiter count is published before sleeping so release() only pays for the wake
+            // syscall when somebody can actually be blocked on the counter.
+            waiters.fetch_add(1);
+            const bool woken = Futex::Wait(count, 0, deadline, clock);
+            waiters.fetch_sub(1);
+            if (!woken) {
+                return TryDecrement();
+            }
+        }
+    }
+#endif
+
 #ifdef _WIN64
     HANDLE sem;
 #elif defined(__APPLE__)
     dispatch_semaphore_t sem;
+#elif defined(__linux__)
+    std::atomic<u32> count;
+    std::atomic<u32> waiters{0};
 #else
     std::counting_semaphore<max> sem;
 #endif
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+
+#include "core/libraries/kernel/sync/mutex.h"
+#include "core/libraries/kernel/sync/semaphore.h"
+#include "core/libraries/kernel/sync/sync_benchmark.h"
+
+namespace Libraries::Kernel {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr u32 OpsPerRound = 1'000'000;
+constexpr u32 TimedWaitsPerRound = 200;
+
+static double NsPerOp(Clock::duration elapsed, u64 ops) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(ops);
+}
+
+static void PrintRow(const char* name, u32 threads, u64 ops, Clock::duration elapsed) {
+    fmt::print("{:<24}{:>8}{:>12}{:>10.1f}\n", name, threads, ops, NsPerOp(elapsed, ops));
+}
+
+template <typename Body>
+static Clock::duration RunThreads(u32 numThreads, Body&& body) {
+    std::vector<std::jthread> threads;
+    threads.reserve(numThreads);
+    const auto start = Clock::now();
+    for (u32 i = 0; i < numThreads; i++) {
+        threads.emplace_back(body, i);
+    }
+    threads.clear();
+    return Clock::now() - start;
+}
+
+static void BenchUncontended(u64 ops) {
+    CountingSemaphore sem{0};
+    auto start = Clock::now();
+    for (u64 i = 0; i < ops; i++) {
+        sem.release();
+        sem.acquire();
+    }
+    PrintRow("sema release/acquire", 1, ops, Clock::now() - start);
+
+    TimedMutex mutex;
+    start = Clock::now();
+    for (u64 i = 0; i < ops; i++) {
+        mutex.lock();
+        mutex.unlock();
+    }
+    PrintRow("mutex lock/unlock", 1, ops, Clock::now() - start);
+}
+
+static void BenchContendedMutex(u32 numThreads, u64 ops) {
+    TimedMutex mutex;
+    u64 counter = 0;
+    const u64 opsPerThread = ops / numThreads;
+    const auto elapsed = RunThreads(numThreads, [&](u32) {
+        for (u64 i = 0; i < opsPerThread; i++) {
+            mutex.lock();
+            counter++;
+            mutex.unlock();
+        }
+    });
+    PrintRow("mutex contended", numThreads, counter, elapsed);
+}
+
+static void BenchContendedSemaphore(u32 numThreads, u64 ops) {
+    // Half the threads produce and half consume, so consumers regularly sleep on an empty count.
+    const u32 producers = std::max(numThreads / 2, 1U);
+    const u32 consumers = std::max(numThreads - producers, 1U);
+    const u64 total = ops / (producers * consumers) * producers * consumers;
+    CountingSemaphore sem{0};
+    const auto elapsed = RunThreads(producers + consumers, [&](u32 index) {
+        if (index < producers) {
+            for (u64 i = 0; i < total / producers; i++) {
+                sem.release();
+            }
+        } else {
+            for (u64 i = 0; i < total / consumers; i++) {
+                sem.acquire();
+            }
+        }
+    });
+    PrintRow("sema producer/consumer", producers + consumers, total, elapsed);
+}
+
+template <typename Wait>
+static void PrintOvershoot(const char* name, std::chrono::microseconds timeout, u32 waits,
+                           Wait&& wait) {
+    Clock::duration total{};
+    Clock::duration worst{};
+    for (u32 i = 0; i < waits; i++) {
+        const auto start = Clock::now();
+        wait(timeout);
+        const auto over = Clock::now() - start - timeout;
+        total += over;
+        worst = std::max(worst, over);
+    }
+    fmt::print("{:<24}{:>8}{:>8}{:>12.1f}{:>12.1f}\n", name, timeout.count(), waits,
+               std::chrono::duration<double, std::micro>(total).count() / waits,
+               std::chrono::duration<double, std::micro>(worst).count());
+}
+
+static void BenchTimedWait(u32 waits) {
+    fmt::print("\n{:<24}{:>8}{:>8}{:>12}{:>12}\n", "timed wait", "us", "waits", "avg over us",
+               "max over us");
+    CountingSemaphore sem{0};
+    TimedMutex mutex;
+    BinarySemaphore locked{0};
+    BinarySemaphore done{0};
+    std::jthread holder([&] {
+        mutex.lock();
+        locked.release();
+        done.acquire();
+        mutex.unlock();
+    });
+    locked.acquire();
+    for (const auto timeout : {std::chrono::microseconds(50), std::chrono::microseconds(200),
+                               std::chrono::microseconds(1000)}) {
+        PrintOvershoot("sema try_acquire_for", timeout, waits,
+                       [&](auto rel_time) { void(sem.try_acquire_for(rel_time)); });
+        PrintOvershoot("mutex try_lock_for", timeout, waits,
+                       [&](auto rel_time) { void(mutex.try_lock_for(rel_time)); });
+    }
+    done.release();
+}
+
+int RunSyncBenchmark(u32 numThreads, u32 rounds) {
+    const u64 ops = static_cast<u64>(OpsPerRound) * rounds;
+    fmt::print("{:<24}{:>8}{:>12}{:>10}\n", "test", "threads", "ops", "ns/op");
+    BenchUncontended(ops);
+    if (numThreads > 1) {
+        BenchContendedMutex(numThreads, ops);
+        BenchContendedSemaphore(numThreads, ops);
+    }
+    BenchTimedWait(TimedWaitsPerRound * rounds);
+    return 0;
+}
+
+} // namespace Libraries::Kernel
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "common/types.h"
+
+namespace Libraries::Kernel {
+
+/**
+ * Measures uncontended and contended acquire/release of the kernel Semaphore and TimedMutex with
+ * the given number of threads, and how far short timed waits overshoot their deadline. Each round
+ * adds a million operations and 200 timed waits per test. Returns the process exit code.
+ */
+int RunSyncBenchmark(u32 numThreads, u32 rounds);
+
+} // namespace Libraries::Kernel
@@ -115,7 +115,7 @@ int PthreadCond::Wait(PthreadMutexT* mutex, const OrbisKernelTimespec* abstime,
     mp->CvUnlock(&recurse);
 
     curthread->mutex_obj = mp;
-    SleepqAdd(this, curthread);
+    SleepqAdd(this, curthread, SleepqType::Priority, name);
 
     int error = 0;
     for (;;) {
@@ -196,7 +196,7 @@ int PthreadCond::Signal(Pthread* thread) {
         return 0;
     }
 
-    Pthread* td = thread ? thread : sq->sq_blocked.front();
+    Pthread* td = thread ? thread : SleepqFirst(sq);
 
     PthreadMutex* mp = td->mutex_obj;
     has_user_waiters = SleepqRemove(sq, td);
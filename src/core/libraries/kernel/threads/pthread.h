@@ -13,6 +13,7 @@
 #include "common/shared_first_mutex.h"
 #include "core/libraries/kernel/sync/mutex.h"
 #include "core/libraries/kernel/sync/semaphore.h"
+#include "core/libraries/kernel/threads/sleepq.h"
 #include "core/libraries/kernel/time.h"
 #include "core/thread.h"
 #include "core/tls.h"
@@ -262,8 +263,6 @@ using PthreadEntryFunc = void* PS4_SYSV_ABI (*)(void*);
 
 constexpr s32 TidTerminated = 1;
 
-struct SleepQueue;
-
 struct SchedParam {
     int sched_priority;
 };
@@ -314,6 +313,7 @@ struct Pthread {
     std::string name;
     BinarySemaphore wake_sema{0};
     SleepQueue* sleepqueue;
+    SleepqWaiter sleepq_waiter;
     void* wchan;
     PthreadMutex* mutex_obj;
     bool will_sleep;
@@ -1,30 +1,74 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
-#include "common/spin_lock.h"
+#include <chrono>
+#include <mutex>
 #include "core/libraries/kernel/threads/pthread.h"
 #include "core/libraries/kernel/threads/sleepq.h"
 
 namespace Libraries::Kernel {
 
-static constexpr int HASHSHIFT = 9;
+static constexpr int HASHSHIFT = 10;
 static constexpr int HASHSIZE = (1 << HASHSHIFT);
-#define SC_HASH(wchan)                                                                             \
-    ((u32)((((uintptr_t)(wchan) >> 3) ^ ((uintptr_t)(wchan) >> (HASHSHIFT + 3))) & (HASHSIZE - 1)))
+// Fibonacci hashing spreads the 16 byte aligned guest objects evenly over the chains.
+#define SC_HASH(wchan) ((u32)(((uintptr_t)(wchan) * 0x9E3779B97F4A7C15ULL) >> (64 - HASHSHIFT)))
 #define SC_LOOKUP(wc) &sc_table[SC_HASH(wc)]
 
-struct SleepQueueChain {
-    Common::SpinLock sc_lock;
+static constexpr size_t StatsPerChain = 2;
+
+// Each chain owns a cache line so that threads blocking on unrelated objects do not bounce the
+// same line between cores.
+struct alignas(64) SleepQueueChain {
+    std::mutex sc_lock;
     SleepqList sc_queues;
-    int sc_type;
+    std::array<SleepqStats, StatsPerChain> sc_stats;
 };
 
 static std::array<SleepQueueChain, HASHSIZE> sc_table{};
 
+static u64 Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// Returns the stats slot of wchan, recycling the least used slot of the chain if it has none.
+static SleepqStats& GetStats(SleepQueueChain* sc, void* wchan, std::string_view name = {}) {
+    SleepqStats* slot = &sc->sc_stats[0];
+    for (auto& stats : sc->sc_stats) {
+        if (stats.wchan == wchan) {
+            slot = &stats;
+            break;
+        }
+        if (stats.sleeps < slot->sleeps) {
+            slot = &stats;
+        }
+    }
+    if (slot->wchan != wchan) {
+        *slot = {};
+        slot->wchan = wchan;
+    }
+    if (!name.empty() && slot->name[0] == '\0') {
+        const size_t length = std::min(name.size(), slot->name.size() - 1);
+        std::copy_n(name.data(), length, slot->name.data());
+    }
+    return *slot;
+}
+
+static void RecordWakeup(SleepQueue* sq, const SleepqWaiter& waiter, u64 now) {
+    SleepqStats& stats = GetStats(SC_LOOKUP(sq->sq_wchan), sq->sq_wchan);
+    stats.wakeups++;
+    stats.blocked_ns += now - waiter.blocked_since;
+}
+
 void SleepqLock(void* wchan) {
     SleepQueueChain* sc = SC_LOOKUP(wchan);
-    sc->sc_lock.lock();
+    if (!sc->sc_lock.try_lock()) {
+        sc->sc_lock.lock();
+        GetStats(sc, wchan).chain_contended++;
+    }
 }
 
 void SleepqUnlock(void* wchan) {
@@ -42,24 +86,47 @@ SleepQueue* SleepqLookup(void* wchan) {
     return nullptr;
 }
 
-void SleepqAdd(void* wchan, Pthread* td) {
+void SleepqAdd(void* wchan, Pthread* td, SleepqType type, std::string_view name) {
+    SleepQueueChain* sc = SC_LOOKUP(wchan);
     SleepQueue* sq = SleepqLookup(wchan);
     if (sq != nullptr) {
         sq->sq_freeq.push_front(*td->sleepqueue);
     } else {
-        SleepQueueChain* sc = SC_LOOKUP(wchan);
         sq = td->sleepqueue;
         sc->sc_queues.push_front(*sq);
         sq->sq_wchan = wchan;
-        /* sq->sq_type = type; */
+        sq->sq_type = type;
     }
     td->sleepqueue = nullptr;
     td->wchan = wchan;
-    sq->sq_blocked.push_front(td);
+
+    SleepqWaiter& waiter = td->sleepq_waiter;
+    waiter.td = td;
+    waiter.blocked_since = Now();
+    if (sq->sq_type == SleepqType::Priority) {
+        // Lower values are more urgent. Threads of equal priority stay in arrival order, and as
+        // most waiters share a priority the scan from the back usually stops right away.
+        auto it = sq->sq_blocked.end();
+        while (it != sq->sq_blocked.begin() && std::prev(it)->td->attr.prio > td->attr.prio) {
+            --it;
+        }
+        sq->sq_blocked.insert(it, waiter);
+    } else {
+        sq->sq_blocked.push_back(waiter);
+    }
+
+    SleepqStats& stats = GetStats(sc, wchan, name);
+    stats.sleeps++;
+    stats.max_waiters = std::max<u32>(stats.max_waiters, sq->sq_blocked.size());
+}
+
+Pthread* SleepqFirst(SleepQueue* sq) {
+    return sq->sq_blocked.front().td;
 }
 
 bool SleepqRemove(SleepQueue* sq, Pthread* td) {
-    std::erase(sq->sq_blocked, td);
+    RecordWakeup(sq, td->sleepq_waiter, Now());
+    sq->sq_blocked.erase(sq->sq_blocked.iterator_to(td->sleepq_waiter));
     if (sq->sq_blocked.empty()) {
         td->sleepqueue = sq;
         sq->unlink();
@@ -79,23 +146,45 @@ void SleepqDrop(SleepQueue* sq, void (*callback)(Pthread*, void*), void* arg) {
     }
 
     sq->unlink();
-    Pthread* td = sq->sq_blocked.front();
-    sq->sq_blocked.pop_front();
-
-    callback(td, arg);
-
-    td->sleepqueue = sq;
-    td->wchan = nullptr;
-
+    const u64 now = Now();
     auto sq2 = sq->sq_freeq.begin();
-    for (Pthread* td2 : sq->sq_blocked) {
-        callback(td2, arg);
-        td2->sleepqueue = std::addressof(*sq2);
-        td2->wchan = nullptr;
-        ++sq2;
+    for (bool first = true; !sq->sq_blocked.empty(); first = false) {
+        SleepqWaiter& waiter = sq->sq_blocked.front();
+        RecordWakeup(sq, waiter, now);
+        sq->sq_blocked.pop_front();
+
+        Pthread* td = waiter.td;
+        callback(td, arg);
+
+        if (first) {
+            td->sleepqueue = sq;
+        } else {
+            td->sleepqueue = std::addressof(*sq2);
+            ++sq2;
+        }
+        td->wchan = nullptr;
     }
-    sq->sq_blocked.clear();
     sq->sq_freeq.clear();
 }
 
-} // namespace Libraries::Kernel
\ No newline at end of file
+std::vector<SleepqStats> SleepqGetStats() {
+    std::vector<SleepqStats> result;
+    for (auto& sc : sc_table) {
+        std::scoped_lock lk{sc.sc_lock};
+        for (const auto& stats : sc.sc_stats) {
+            if (stats.wchan != nullptr) {
+                result.push_back(stats);
+            }
+        }
+    }
+    return result;
+}
+
+void SleepqResetStats() {
+    for (auto& sc : sc_table) {
+        std::scoped_lock lk{sc.sc_lock};
+        sc.sc_stats = {};
+    }
+}
+
+} // namespace Libraries::Kernel
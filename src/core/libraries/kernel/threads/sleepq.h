@@ -1,10 +1,16 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#include <forward_list>
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <vector>
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/list_hook.hpp>
 
+#include "common/types.h"
+
 namespace Libraries::Kernel {
 
 struct Pthread;
@@ -15,11 +21,37 @@ using ListBaseHook =
 
 using SleepqList = boost::intrusive::list<SleepQueue, boost::intrusive::constant_time_size<false>>;
 
+/// Order in which threads blocked on a wait channel are woken.
+enum class SleepqType : int {
+    Fifo,
+    Priority,
+};
+
+/// Queue entry embedded in every thread, so blocking never allocates.
+struct SleepqWaiter : public boost::intrusive::list_base_hook<> {
+    Pthread* td;
+    u64 blocked_since;
+};
+
+using SleepqWaiterList =
+    boost::intrusive::list<SleepqWaiter, boost::intrusive::constant_time_size<true>>;
+
 struct SleepQueue : public ListBaseHook {
-    std::forward_list<Pthread*> sq_blocked;
+    SleepqWaiterList sq_blocked;
     SleepqList sq_freeq;
     void* sq_wchan;
-    int sq_type;
+    SleepqType sq_type;
+};
+
+/// Contention counters of one wait channel, as shown by the devtools lock contention report.
+struct SleepqStats {
+    void* wchan;
+    std::array<char, 32> name;
+    u64 sleeps;
+    u64 wakeups;
+    u64 chain_contended;
+    u64 blocked_ns;
+    u32 max_waiters;
 };
 
 void SleepqLock(void* wchan);
@@ -28,10 +60,19 @@ void SleepqUnlock(void* wchan);
 
 SleepQueue* SleepqLookup(void* wchan);
 
-void SleepqAdd(void* wchan, Pthread* td);
+void SleepqAdd(void* wchan, Pthread* td, SleepqType type = SleepqType::Fifo,
+               std::string_view name = {});
+
+/// Returns the thread that should be woken first.
+Pthread* SleepqFirst(SleepQueue* sq);
 
 bool SleepqRemove(SleepQueue* sq, Pthread* td);
 
 void SleepqDrop(SleepQueue* sq, void (*callback)(Pthread*, void*), void* arg);
 
+/// Snapshot of the wait channels that have blocked threads since the last reset.
+std::vector<SleepqStats> SleepqGetStats();
+
+void SleepqResetStats();
+
 } // namespace Libraries::Kernel
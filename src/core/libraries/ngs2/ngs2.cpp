@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
+
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 #include "core/libraries/libs.h"
@@ -51,67 +54,171 @@ s32 PS4_SYSV_ABI sceNgs2RackCreate(OrbisNgs2Handle systemHandle, u32 rackId,
                                    const OrbisNgs2RackOption* option,
                                    const OrbisNgs2ContextBufferInfo* bufferInfo,
                                    OrbisNgs2Handle* outHandle) {
-    LOG_ERROR(Lib_Ngs2, "rackId = {}", rackId);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    if (!bufferInfo || !outHandle) {
+        if (!bufferInfo) {
+            LOG_ERROR(Lib_Ngs2, "Invalid rack buffer info {}", (void*)bufferInfo);
+            return ORBIS_NGS2_ERROR_INVALID_BUFFER_INFO;
+        }
+        LOG_ERROR(Lib_Ngs2, "Invalid rack handle address {}", (void*)outHandle);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
     }
-    return ORBIS_OK;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    OrbisNgs2ContextBufferInfo localInfo = *bufferInfo;
+    LOG_INFO(Lib_Ngs2, "rackId = {:#x}", rackId);
+    return RackSetup(system, rackId, option, &localInfo, nullptr, outHandle);
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackCreateWithAllocator(OrbisNgs2Handle systemHandle, u32 rackId,
                                                 const OrbisNgs2RackOption* option,
                                                 const OrbisNgs2BufferAllocator* allocator,
                                                 OrbisNgs2Handle* outHandle) {
-    LOG_ERROR(Lib_Ngs2, "rackId = {}", rackId);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    if (!allocator || !allocator->allocHandler) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack buffer allocator {}", (void*)allocator);
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_ALLOCATOR;
     }
-    return ORBIS_OK;
+    if (!outHandle) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack handle address {}", (void*)outHandle);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+
+    OrbisNgs2ContextBufferInfo bufferInfo{};
+    s32 result = RackSetup(system, rackId, option, &bufferInfo, nullptr, nullptr);
+    if (result < 0) {
+        return result;
+    }
+    bufferInfo.userData = allocator->userData;
+    result = allocator->allocHandler(&bufferInfo);
+    if (result < 0) {
+        return result;
+    }
+    result = RackSetup(system, rackId, option, &bufferInfo, allocator->freeHandler, outHandle);
+    if (result < 0 && allocator->freeHandler) {
+        allocator->freeHandler(&bufferInfo);
+    }
+    LOG_INFO(Lib_Ngs2, "rackId = {:#x}", rackId);
+    return result;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackDestroy(OrbisNgs2Handle rackHandle,
                                     OrbisNgs2ContextBufferInfo* outBufferInfo) {
-    LOG_ERROR(Lib_Ngs2, "called");
-    return ORBIS_OK;
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    LOG_INFO(Lib_Ngs2, "called");
+    return RackCleanup(rack, outBufferInfo);
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackGetInfo(OrbisNgs2Handle rackHandle, OrbisNgs2RackInfo* outInfo,
                                     size_t infoSize) {
-    LOG_ERROR(Lib_Ngs2, "infoSize = {}", infoSize);
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    if (!outInfo) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack info address {}", (void*)outInfo);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    if (infoSize < sizeof(OrbisNgs2RackInfo)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack info size ({})", infoSize);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_SIZE;
+    }
+
+    std::scoped_lock lock{rack->systemData->lock};
+    MemoryClear(outInfo, infoSize);
+    std::memcpy(outInfo->name, rack->option.name, sizeof(outInfo->name));
+    outInfo->rackHandle = rackHandle;
+    outInfo->bufferInfo = rack->bufferInfo;
+    outInfo->ownerSystemHandle = rack->systemData->systemHandle;
+    outInfo->rackId = rack->rackId;
+    outInfo->uid = rack->handleID;
+    outInfo->minGrainSamples = rack->systemData->minGrainSamples;
+    outInfo->maxGrainSamples = rack->option.maxGrainSamples;
+    outInfo->maxVoices = rack->option.maxVoices;
+    outInfo->maxMatrices = rack->option.maxMatrices;
+    outInfo->maxPorts = rack->option.maxPorts;
+    outInfo->lastProcessRatio = rack->lastProcessRatio;
+    outInfo->lastProcessTick = rack->lastProcessTick;
+    outInfo->renderCount = rack->renderCount;
+    outInfo->activeVoiceCount = static_cast<u32>(std::ranges::count_if(
+        rack->stateFlags, [](u32 flags) { return flags & ORBIS_NGS2_VOICE_STATE_FLAG_INUSE; }));
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackGetUserData(OrbisNgs2Handle rackHandle, uintptr_t* outUserData) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    if (!outUserData) {
+        LOG_ERROR(Lib_Ngs2, "Invalid user data address {}", (void*)outUserData);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outUserData = rack->userData;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackGetVoiceHandle(OrbisNgs2Handle rackHandle, u32 voiceIndex,
                                            OrbisNgs2Handle* outHandle) {
-    LOG_DEBUG(Lib_Ngs2, "(STUBBED) voiceIndex = {}", voiceIndex);
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    if (voiceIndex >= rack->voices.size()) {
+        LOG_ERROR(Lib_Ngs2, "Invalid voice index ({})", voiceIndex);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_INDEX;
+    }
+    if (!outHandle) {
+        LOG_ERROR(Lib_Ngs2, "Invalid voice handle address {}", (void*)outHandle);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outHandle = reinterpret_cast<OrbisNgs2Handle>(
+        static_cast<HandleInternal*>(&rack->voices[voiceIndex]));
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackLock(OrbisNgs2Handle rackHandle) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    // Racks render under the lock of their system
+    rack->systemData->lock.lock();
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackQueryBufferSize(u32 rackId, const OrbisNgs2RackOption* option,
                                             OrbisNgs2ContextBufferInfo* outBufferInfo) {
-    LOG_ERROR(Lib_Ngs2, "rackId = {}", rackId);
-    return ORBIS_OK;
+    if (!outBufferInfo) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack buffer info {}", (void*)outBufferInfo);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    LOG_INFO(Lib_Ngs2, "rackId = {:#x}", rackId);
+    return RackSetup(nullptr, rackId, option, outBufferInfo, nullptr, nullptr);
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackSetUserData(OrbisNgs2Handle rackHandle, uintptr_t userData) {
-    LOG_ERROR(Lib_Ngs2, "userData = {}", userData);
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    rack->userData = userData;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackUnlock(OrbisNgs2Handle rackHandle) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    RackInternal* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    rack->systemData->lock.unlock();
     return ORBIS_OK;
 }
 
@@ -185,50 +292,89 @@ s32 PS4_SYSV_ABI sceNgs2SystemCreateWithAllocator(const OrbisNgs2SystemOption* o
 
 s32 PS4_SYSV_ABI sceNgs2SystemDestroy(OrbisNgs2Handle systemHandle,
                                       OrbisNgs2ContextBufferInfo* outBufferInfo) {
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
-    }
     LOG_INFO(Lib_Ngs2, "called");
-    return ORBIS_OK;
+    return SystemCleanup(systemHandle, outBufferInfo);
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemEnumHandles(OrbisNgs2Handle* aOutHandle, u32 maxHandles) {
-    LOG_ERROR(Lib_Ngs2, "maxHandles = {}", maxHandles);
-    return ORBIS_OK;
+    if (!aOutHandle && maxHandles != 0) {
+        LOG_ERROR(Lib_Ngs2, "Invalid system handle array {}", (void*)aOutHandle);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    return static_cast<s32>(EnumSystems(aOutHandle, maxHandles));
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemEnumRackHandles(OrbisNgs2Handle systemHandle,
                                               OrbisNgs2Handle* aOutHandle, u32 maxHandles) {
-    LOG_ERROR(Lib_Ngs2, "maxHandles = {}", maxHandles);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
-    return ORBIS_OK;
+    if (!aOutHandle && maxHandles != 0) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack handle array {}", (void*)aOutHandle);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    std::scoped_lock lock{system->lock};
+    const u32 numRacks = static_cast<u32>(system->racks.size());
+    for (u32 i = 0; i < std::min(numRacks, maxHandles); i++) {
+        aOutHandle[i] = reinterpret_cast<OrbisNgs2Handle>(
+            static_cast<HandleInternal*>(system->racks[i].get()));
+    }
+    return static_cast<s32>(numRacks);
 }
 
-s32 PS4_SYSV_ABI sceNgs2SystemGetInfo(OrbisNgs2Handle rackHandle, OrbisNgs2SystemInfo* outInfo,
+s32 PS4_SYSV_ABI sceNgs2SystemGetInfo(OrbisNgs2Handle systemHandle, OrbisNgs2SystemInfo* outInfo,
                                       size_t infoSize) {
-    LOG_ERROR(Lib_Ngs2, "infoSize = {}", infoSize);
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (!outInfo) {
+        LOG_ERROR(Lib_Ngs2, "Invalid system info address {}", (void*)outInfo);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    if (infoSize < sizeof(OrbisNgs2SystemInfo)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid system info size ({})", infoSize);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_SIZE;
+    }
+
+    std::scoped_lock lock{system->lock};
+    MemoryClear(outInfo, infoSize);
+    std::memcpy(outInfo->name, system->name, sizeof(outInfo->name));
+    outInfo->systemHandle = systemHandle;
+    outInfo->bufferInfo = system->bufferInfo;
+    outInfo->uid = system->uid;
+    outInfo->minGrainSamples = system->minGrainSamples;
+    outInfo->maxGrainSamples = system->maxGrainSamples;
+    outInfo->rackCount = system->rackCount;
+    outInfo->lastRenderRatio = system->lastRenderRatio;
+    outInfo->lastRenderTick = system->lastRenderTick;
+    outInfo->renderCount = system->renderCount;
+    outInfo->sampleRate = system->currentSampleRate;
+    outInfo->numGrainSamples = system->currentNumGrainSamples;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemGetUserData(OrbisNgs2Handle systemHandle, uintptr_t* outUserData) {
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
-    LOG_ERROR(Lib_Ngs2, "called");
+    if (!outUserData) {
+        LOG_ERROR(Lib_Ngs2, "Invalid user data address {}", (void*)outUserData);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outUserData = system->userData;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemLock(OrbisNgs2Handle systemHandle) {
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
-    LOG_ERROR(Lib_Ngs2, "called");
+    system->lock.lock();
+    system->lockCount++;
     return ORBIS_OK;
 }
 
@@ -249,12 +395,15 @@ s32 PS4_SYSV_ABI sceNgs2SystemQueryBufferSize(const OrbisNgs2SystemOption* optio
 s32 PS4_SYSV_ABI sceNgs2SystemRender(OrbisNgs2Handle systemHandle,
                                      const OrbisNgs2RenderBufferInfo* aBufferInfo,
                                      u32 numBufferInfo) {
-    LOG_DEBUG(Lib_Ngs2, "(STUBBED) numBufferInfo = {}", numBufferInfo);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
-    return ORBIS_OK;
+    if (!aBufferInfo && numBufferInfo != 0) {
+        LOG_ERROR(Lib_Ngs2, "Invalid render buffer info {}", (void*)aBufferInfo);
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_INFO;
+    }
+    return SystemRender(system, aBufferInfo, numBufferInfo);
 }
 
 static s32 PS4_SYSV_ABI sceNgs2SystemResetOption(OrbisNgs2SystemOption* outOption) {
@@ -272,73 +421,156 @@ static s32 PS4_SYSV_ABI sceNgs2SystemResetOption(OrbisNgs2SystemOption* outOptio
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemSetGrainSamples(OrbisNgs2Handle systemHandle, u32 numSamples) {
-    LOG_ERROR(Lib_Ngs2, "numSamples = {}", numSamples);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
+    if (numSamples < system->minGrainSamples || numSamples > system->maxGrainSamples ||
+        (numSamples & 63) != 0) {
+        LOG_ERROR(Lib_Ngs2, "Invalid grain samples ({},x64)", numSamples);
+        return ORBIS_NGS2_ERROR_INVALID_NUM_GRAIN_SAMPLES;
+    }
+    std::scoped_lock lock{system->lock};
+    system->currentNumGrainSamples = numSamples;
+    LOG_INFO(Lib_Ngs2, "numSamples = {}", numSamples);
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemSetSampleRate(OrbisNgs2Handle systemHandle, u32 sampleRate) {
-    LOG_ERROR(Lib_Ngs2, "sampleRate = {}", sampleRate);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (!IsValidSampleRate(sampleRate)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid sample rate ({})", sampleRate);
+        return ORBIS_NGS2_ERROR_INVALID_SAMPLE_RATE;
     }
+    std::scoped_lock lock{system->lock};
+    system->currentSampleRate = sampleRate;
+    LOG_INFO(Lib_Ngs2, "sampleRate = {}", sampleRate);
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemSetUserData(OrbisNgs2Handle systemHandle, uintptr_t userData) {
-    LOG_ERROR(Lib_Ngs2, "userData = {}", userData);
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
+    system->userData = userData;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemUnlock(OrbisNgs2Handle systemHandle) {
-    if (!systemHandle) {
-        LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
-        return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
+    SystemInternal* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
     }
-    LOG_ERROR(Lib_Ngs2, "called");
+    system->lockCount--;
+    system->lock.unlock();
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceControl(OrbisNgs2Handle voiceHandle,
                                      const OrbisNgs2VoiceParamHeader* paramList) {
-    LOG_ERROR(Lib_Ngs2, "called");
-    return ORBIS_OK;
+    VoiceInternal* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!paramList) {
+        LOG_ERROR(Lib_Ngs2, "Invalid voice control address {}", (void*)paramList);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ADDRESS;
+    }
+    return VoiceControl(voice, paramList);
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetMatrixInfo(OrbisNgs2Handle voiceHandle, u32 matrixId,
                                            OrbisNgs2VoiceMatrixInfo* outInfo, size_t outInfoSize) {
-    LOG_ERROR(Lib_Ngs2, "matrixId = {}, outInfoSize = {}", matrixId, outInfoSize);
+    VoiceInternal* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (matrixId >= voice->matrices.size()) {
+        LOG_ERROR(Lib_Ngs2, "Invalid matrix id ({})", matrixId);
+        return ORBIS_NGS2_ERROR_INVALID_MATRIX_INDEX;
+    }
+    if (!outInfo || outInfoSize < sizeof(OrbisNgs2VoiceMatrixInfo)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid matrix info ({}, {})", (void*)outInfo, outInfoSize);
+        return outInfo ? ORBIS_NGS2_ERROR_INVALID_OUT_SIZE : ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    std::scoped_lock lock{voice->systemData->lock};
+    const VoiceMatrix& matrix = voice->matrices[matrixId];
+    outInfo->numLevels = matrix.numLevels;
+    std::ranges::copy(matrix.aLevel, outInfo->aLevel);
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetOwner(OrbisNgs2Handle voiceHandle, OrbisNgs2Handle* outRackHandle,
                                       u32* outVoiceId) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    VoiceInternal* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (outRackHandle) {
+        *outRackHandle =
+            reinterpret_cast<OrbisNgs2Handle>(static_cast<HandleInternal*>(voice->rack));
+    }
+    if (outVoiceId) {
+        *outVoiceId = voice->index;
+    }
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetPortInfo(OrbisNgs2Handle voiceHandle, u32 port,
                                          OrbisNgs2VoicePortInfo* outInfo, size_t outInfoSize) {
-    LOG_ERROR(Lib_Ngs2, "port = {}, outInfoSize = {}", port, outInfoSize);
+    VoiceInternal* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (port >= voice->ports.size()) {
+        LOG_ERROR(Lib_Ngs2, "Invalid port index ({})", port);
+        return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+    }
+    if (!outInfo || outInfoSize < sizeof(OrbisNgs2VoicePortInfo)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid port info ({}, {})", (void*)outInfo, outInfoSize);
+        return outInfo ? ORBIS_NGS2_ERROR_INVALID_OUT_SIZE : ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    std::scoped_lock lock{voice->systemData->lock};
+    const VoicePort& voicePort = voice->ports[port];
+    outInfo->matrixId = voicePort.matrixId;
+    outInfo->volume = voicePort.volume;
+    outInfo->numDelaySamples = voicePort.numDelaySamples;
+    outInfo->destInputId = voicePort.destInputId;
+    outInfo->destHandle =
+        voicePort.dest
+            ? reinterpret_cast<OrbisNgs2Handle>(static_cast<HandleInternal*>(voicePort.dest))
+            : 0;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetState(OrbisNgs2Handle voiceHandle, OrbisNgs2VoiceState* outState,
                                       size_t stateSize) {
-    LOG_ERROR(Lib_Ngs2, "stateSize = {}", stateSize);
-    return ORBIS_OK;
+    VoiceInternal* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!outState) {
+        LOG_ERROR(Lib_Ngs2, "Invalid voice state address {}", (void*)outState);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    return VoiceGetState(voice, outState, stateSize);
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetStateFlags(OrbisNgs2Handle voiceHandle, u32* outStateFlags) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    VoiceInternal* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!outStateFlags) {
+        LOG_ERROR(Lib_Ngs2, "Invalid state flags address {}", (void*)outStateFlags);
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    std::scoped_lock lock{voice->systemData->lock};
+    *outStateFlags = voice->rack->stateFlags[voice->index];
     return ORBIS_OK;
 }
 
@@ -380,15 +612,13 @@ s32 PS4_SYSV_ABI sceNgs2GeomApply(const OrbisNgs2GeomListenerWork* listener,
 
 s32 PS4_SYSV_ABI sceNgs2PanInit(OrbisNgs2PanWork* work, const float* aSpeakerAngle, float unitAngle,
                                 u32 numSpeakers) {
-    LOG_ERROR(Lib_Ngs2, "unitAngle = {}, numSpeakers = {}", unitAngle, numSpeakers);
-    return ORBIS_OK;
+    return PanInit(work, aSpeakerAngle, unitAngle, numSpeakers);
 }
 
 s32 PS4_SYSV_ABI sceNgs2PanGetVolumeMatrix(OrbisNgs2PanWork* work, const OrbisNgs2PanParam* aParam,
                                            u32 numParams, u32 matrixFormat,
                                            float* outVolumeMatrix) {
-    LOG_ERROR(Lib_Ngs2, "numParams = {}, matrixFormat = {}", numParams, matrixFormat);
-    return ORBIS_OK;
+    return PanGetVolumeMatrix(work, aParam, numParams, matrixFormat, outVolumeMatrix);
 }
 
 // Ngs2Report
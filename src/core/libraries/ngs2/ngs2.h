@@ -3,8 +3,6 @@
 
 #pragma once
 
-#include "core/libraries/ngs2/ngs2_impl.h"
-
 #include <atomic>
 #include <mutex>
 #include <vector>
@@ -16,6 +14,79 @@ class SymbolsResolver;
 
 namespace Libraries::Ngs2 {
 
+static const int ORBIS_NGS2_SYSTEM_NAME_LENGTH = 16;
+static const int ORBIS_NGS2_RACK_NAME_LENGTH = 16;
+
+typedef uintptr_t OrbisNgs2Handle;
+
+struct OrbisNgs2ContextBufferInfo {
+    void* hostBuffer;
+    size_t hostBufferSize;
+    uintptr_t reserved[5];
+    uintptr_t userData;
+};
+
+struct OrbisNgs2SystemOption {
+    size_t size;
+    char name[ORBIS_NGS2_SYSTEM_NAME_LENGTH];
+
+    u32 flags;
+    u32 maxGrainSamples;
+    u32 numGrainSamples;
+    u32 sampleRate;
+    u32 aReserved[6];
+};
+
+using OrbisNgs2BufferAllocHandler =
+    s32 PS4_SYSV_ABI (*)(OrbisNgs2ContextBufferInfo* io_buffer_info);
+using OrbisNgs2BufferFreeHandler = s32 PS4_SYSV_ABI (*)(OrbisNgs2ContextBufferInfo* io_buffer_info);
+
+struct OrbisNgs2SystemInfo {
+    char name[ORBIS_NGS2_SYSTEM_NAME_LENGTH]; // 0
+
+    OrbisNgs2Handle systemHandle;          // 16
+    OrbisNgs2ContextBufferInfo bufferInfo; // 24
+
+    u32 uid;             // 88
+    u32 minGrainSamples; // 92
+    u32 maxGrainSamples; // 96
+
+    u32 stateFlags;        // 100
+    u32 rackCount;         // 104
+    float lastRenderRatio; // 108
+    s64 lastRenderTick;    // 112
+    s64 renderCount;       // 120
+    u32 sampleRate;        // 128
+    u32 numGrainSamples;   // 132
+};
+
+struct OrbisNgs2RackInfo {
+    char name[ORBIS_NGS2_RACK_NAME_LENGTH]; // 0
+
+    OrbisNgs2Handle rackHandle;            // 16
+    OrbisNgs2ContextBufferInfo bufferInfo; // 24
+
+    OrbisNgs2Handle ownerSystemHandle; // 88
+
+    u32 type;            // 96
+    u32 rackId;          // 100
+    u32 uid;             // 104
+    u32 minGrainSamples; // 108
+    u32 maxGrainSamples; // 112
+    u32 maxVoices;       // 116
+    u32 maxChannelWorks; // 120
+    u32 maxInputs;       // 124
+    u32 maxMatrices;     // 128
+    u32 maxPorts;        // 132
+
+    u32 stateFlags;             // 136
+    float lastProcessRatio;     // 140
+    u64 lastProcessTick;        // 144
+    u64 renderCount;            // 152
+    u32 activeVoiceCount;       // 160
+    u32 activeChannelWorkCount; // 164
+};
+
 using OrbisNgs2ParseReadHandler = s32 PS4_SYSV_ABI (*)(uintptr_t user_data, u32 offset, void* data,
                                                        size_t size);
 
@@ -32,6 +103,62 @@ static const int ORBIS_NGS2_WAVEFORM_INFO_MAX_BLOCKS = 4;
 static const int ORBIS_NGS2_MAX_MATRIX_LEVELS =
     (ORBIS_NGS2_MAX_VOICE_CHANNELS * ORBIS_NGS2_MAX_VOICE_CHANNELS);
 
+static const u32 ORBIS_NGS2_RACK_ID_SAMPLER = 0x1000;
+static const u32 ORBIS_NGS2_RACK_ID_SUBMIXER = 0x2000;
+static const u32 ORBIS_NGS2_RACK_ID_REVERB = 0x2001;
+static const u32 ORBIS_NGS2_RACK_ID_EQ = 0x2002;
+static const u32 ORBIS_NGS2_RACK_ID_MASTERING = 0x3000;
+static const u32 ORBIS_NGS2_RACK_ID_CUSTOM_SAMPLER = 0x4001;
+static const u32 ORBIS_NGS2_RACK_ID_CUSTOM_SUBMIXER = 0x4002;
+static const u32 ORBIS_NGS2_RACK_ID_CUSTOM_MASTERING = 0x4003;
+
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_NONE = 0;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I8 = 0x10;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_U8 = 0x11;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16L = 0x12;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16B = 0x13;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24L = 0x14;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24B = 0x15;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32L = 0x16;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32B = 0x17;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32L = 0x18;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32B = 0x19;
+static const u32 ORBIS_NGS2_WAVEFORM_TYPE_ATRAC9 = 0x40;
+
+static const u32 ORBIS_NGS2_VOICE_PARAM_MATRIX_LEVELS = 1;
+static const u32 ORBIS_NGS2_VOICE_PARAM_PORT_VOLUME = 2;
+static const u32 ORBIS_NGS2_VOICE_PARAM_PORT_MATRIX = 3;
+static const u32 ORBIS_NGS2_VOICE_PARAM_PORT_DELAY = 4;
+static const u32 ORBIS_NGS2_VOICE_PARAM_PATCH = 5;
+static const u32 ORBIS_NGS2_VOICE_PARAM_KICK_EVENT = 6;
+static const u32 ORBIS_NGS2_VOICE_PARAM_CALLBACK = 7;
+
+static const u32 ORBIS_NGS2_VOICE_EVENT_PLAY = 0;
+static const u32 ORBIS_NGS2_VOICE_EVENT_STOP = 1;
+static const u32 ORBIS_NGS2_VOICE_EVENT_STOP_IMM = 2;
+static const u32 ORBIS_NGS2_VOICE_EVENT_KILL = 3;
+static const u32 ORBIS_NGS2_VOICE_EVENT_PAUSE = 4;
+static const u32 ORBIS_NGS2_VOICE_EVENT_RESUME = 5;
+
+static const u32 ORBIS_NGS2_VOICE_STATE_FLAG_INUSE = 0x1;
+static const u32 ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING = 0x2;
+static const u32 ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED = 0x4;
+static const u32 ORBIS_NGS2_VOICE_STATE_FLAG_STOPPED = 0x8;
+static const u32 ORBIS_NGS2_VOICE_STATE_FLAG_ERROR = 0x10;
+static const u32 ORBIS_NGS2_VOICE_STATE_FLAG_EMPTY = 0x20;
+
+static const u32 ORBIS_NGS2_VOICE_CALLBACK_FLAG_WAVEFORM_BLOCK_END = 0x1;
+
+static const u32 ORBIS_NGS2_FILTER_TYPE_BYPASS = 0;
+static const u32 ORBIS_NGS2_FILTER_TYPE_DIRECT = 1;
+static const u32 ORBIS_NGS2_FILTER_TYPE_LOW_PASS = 2;
+static const u32 ORBIS_NGS2_FILTER_TYPE_HIGH_PASS = 3;
+static const u32 ORBIS_NGS2_FILTER_TYPE_BAND_PASS = 4;
+static const u32 ORBIS_NGS2_FILTER_TYPE_NOTCH = 5;
+static const u32 ORBIS_NGS2_FILTER_TYPE_PEAKING = 6;
+static const u32 ORBIS_NGS2_FILTER_TYPE_LOW_SHELF = 7;
+static const u32 ORBIS_NGS2_FILTER_TYPE_HIGH_SHELF = 8;
+
 struct OrbisNgs2WaveformFormat {
     u32 waveformType;
     u32 numChannels;
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include <fmt/format.h>
+
+#include "common/logging/log.h"
+#include "core/libraries/ngs2/ngs2_benchmark.h"
+#include "core/libraries/ngs2/ngs2_impl.h"
+#include "core/libraries/ngs2/ngs2_mastering.h"
+#include "core/libraries/ngs2/ngs2_sampler.h"
+#include "core/libraries/ngs2/ngs2_submixer.h"
+
+namespace Libraries::Ngs2 {
+
+constexpr u32 BenchmarkSampleRate = 48000;
+constexpr u32 BenchmarkGrainSamples = 256;
+
+// A 44.1 kHz source keeps every voice on the resampling path
+constexpr u32 WaveformSampleRate = 44100;
+constexpr u32 WaveformFrames = 4410;
+
+static OrbisNgs2Handle ToHandle(VoiceInternal& voice) {
+    return reinterpret_cast<OrbisNgs2Handle>(static_cast<HandleInternal*>(&voice));
+}
+
+static bool Check(s32 result, const char* what) {
+    if (result < 0) {
+        LOG_ERROR(Lib_Ngs2, "{} failed ({:#x})", what, static_cast<u32>(result));
+        return false;
+    }
+    return true;
+}
+
+static bool SetupRack(SystemInternal* system, u32 rackId, const OrbisNgs2RackOption* option,
+                      RackInternal** outRack) {
+    std::array<u8, 64> buffer{};
+    OrbisNgs2ContextBufferInfo bufferInfo{buffer.data(), buffer.size()};
+    OrbisNgs2Handle handle{};
+    if (!Check(RackSetup(system, rackId, option, &bufferInfo, nullptr, &handle), "RackSetup")) {
+        return false;
+    }
+    *outRack = GetRack(handle);
+    return true;
+}
+
+static bool Play(VoiceInternal& voice) {
+    OrbisNgs2VoiceEventParam event{};
+    event.header = {sizeof(event), 0, ORBIS_NGS2_VOICE_PARAM_KICK_EVENT};
+    event.eventId = ORBIS_NGS2_VOICE_EVENT_PLAY;
+    return Check(VoiceControl(&voice, &event.header), "VoiceControl");
+}
+
+static bool PatchAndPlay(VoiceInternal& voice, VoiceInternal& dest) {
+    OrbisNgs2VoicePatchParam patch{};
+    patch.header = {sizeof(patch), 0, ORBIS_NGS2_VOICE_PARAM_PATCH};
+    patch.destHandle = ToHandle(dest);
+    return Check(VoiceControl(&voice, &patch.header), "VoiceControl") && Play(voice);
+}
+
+static bool StartSamplerVoice(VoiceInternal& voice, VoiceInternal& dest, const s16* data,
+                              float pitch) {
+    static const OrbisNgs2WaveformBlock block = {
+        0, WaveformFrames * 2 * sizeof(s16), 0xFFFFFFFF, 0, WaveformFrames, 0, 0};
+    struct {
+        OrbisNgs2SamplerVoiceSetupParam setup;
+        OrbisNgs2SamplerVoiceWaveformBlocksParam blocks;
+        OrbisNgs2SamplerVoicePitchParam pitch;
+    } params{};
+    params.setup.header = {sizeof(params.setup), sizeof(params.setup),
+                           ORBIS_NGS2_SAMPLER_VOICE_PARAM_SETUP};
+    params.setup.format = {ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16L, 2, WaveformSampleRate};
+    params.blocks.header = {sizeof(params.blocks), sizeof(params.blocks),
+                            ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_BLOCKS};
+    params.blocks.data = data;
+    params.blocks.numBlocks = 1;
+    params.blocks.aBlock = &block;
+    params.pitch.header = {sizeof(params.pitch), 0, ORBIS_NGS2_SAMPLER_VOICE_PARAM_PITCH};
+    params.pitch.ratio = pitch;
+    return Check(VoiceControl(&voice, &params.setup.header), "VoiceControl") &&
+           PatchAndPlay(voice, dest);
+}
+
+int RunNgs2Benchmark(u32 numVoices, u32 seconds) {
+    std::vector<s16> waveform(WaveformFrames * 2);
+    for (u32 i = 0; i < WaveformFrames; i++) {
+        const double phase = 2.0 * std::numbers::pi * 441.0 * i / WaveformSampleRate;
+        waveform[i * 2] = static_cast<s16>(std::sin(phase) * 8192.0);
+        waveform[i * 2 + 1] = static_cast<s16>(std::cos(phase) * 8192.0);
+    }
+
+    OrbisNgs2SystemOption systemOption{};
+    systemOption.size = sizeof(OrbisNgs2SystemOption);
+    systemOption.maxGrainSamples = BenchmarkGrainSamples;
+    systemOption.numGrainSamples = BenchmarkGrainSamples;
+    systemOption.sampleRate = BenchmarkSampleRate;
+    std::array<u8, 64> systemBuffer{};
+    OrbisNgs2ContextBufferInfo systemBufferInfo{systemBuffer.data(), systemBuffer.size()};
+    OrbisNgs2Handle systemHandle{};
+    if (!Check(SystemSetup(&systemOption, &systemBufferInfo, nullptr, &systemHandle),
+               "SystemSetup")) {
+        return 1;
+    }
+    SystemInternal* system = GetSystem(systemHandle);
+
+    OrbisNgs2SamplerRackOption samplerOption{};
+    samplerOption.rackOption.size = sizeof(OrbisNgs2SamplerRackOption);
+    samplerOption.rackOption.maxGrainSamples = BenchmarkGrainSamples;
+    samplerOption.rackOption.maxVoices = numVoices;
+    samplerOption.rackOption.maxMatrices = 1;
+    samplerOption.rackOption.maxPorts = 1;
+    samplerOption.maxWaveformBlocks = 1;
+    samplerOption.maxEnvelopePoints = 4;
+    samplerOption.maxFilters = 1;
+    RackInternal* sampler{};
+    RackInternal* submixer{};
+    RackInternal* mastering{};
+    if (!SetupRack(system, ORBIS_NGS2_RACK_ID_SAMPLER, &samplerOption.rackOption, &sampler) ||
+        !SetupRack(system, ORBIS_NGS2_RACK_ID_SUBMIXER, nullptr, &submixer) ||
+        !SetupRack(system, ORBIS_NGS2_RACK_ID_MASTERING, nullptr, &mastering)) {
+        SystemCleanup(systemHandle, nullptr);
+        return 1;
+    }
+
+    bool ok = Play(mastering->voices[0]) &&
+              PatchAndPlay(submixer->voices[0], mastering->voices[0]);
+    // Spread the pitches so voices step through the source at different rates
+    for (u32 i = 0; ok && i < numVoices; i++) {
+        const float pitch = 0.5f + 1.5f * static_cast<float>(i) / static_cast<float>(numVoices);
+        ok = StartSamplerVoice(sampler->voices[i], submixer->voices[0], waveform.data(), pitch);
+    }
+    if (!ok) {
+        SystemCleanup(systemHandle, nullptr);
+        return 1;
+    }
+
+    std::vector<s16> output(BenchmarkGrainSamples * 2);
+    const OrbisNgs2RenderBufferInfo bufferInfo = {output.data(), output.size() * sizeof(s16),
+                                                  ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16L, 2};
+    const u32 numGrains = seconds * BenchmarkSampleRate / BenchmarkGrainSamples;
+    std::vector<u64> grainNs;
+    grainNs.reserve(numGrains);
+    for (u32 grain = 0; grain < numGrains; ++grain) {
+        const auto start = std::chrono::steady_clock::now();
+        const s32 result = SystemRender(system, &bufferInfo, 1);
+        const auto end = std::chrono::steady_clock::now();
+        if (!Check(result, "SystemRender")) {
+            SystemCleanup(systemHandle, nullptr);
+            return 1;
+        }
+        grainNs.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    SystemCleanup(systemHandle, nullptr);
+
+    u64 totalNs = 0;
+    for (const u64 ns : grainNs) {
+        totalNs += ns;
+    }
+    std::ranges::sort(grainNs);
+    const auto percentile = [&](double p) {
+        return grainNs[static_cast<size_t>(p * (grainNs.size() - 1))] / 1e3;
+    };
+    const double audioSeconds = static_cast<double>(numGrains) * BenchmarkGrainSamples /
+                           BenchmarkSampleRate;
+    // Throughput in voice grains rendered per millisecond of render time
+    const double voicesPerMs = static_cast<double>(numVoices) * numGrains / (totalNs / 1e6);
+    fmt::print("{:>8}{:>8}{:>10}{:>10}{:>10}{:>10}{:>12}{:>10}\n", "voices", "grains", "avg us",
+               "p50 us", "p99 us", "max us", "voices/ms", "x rt");
+    fmt::print("{:>8}{:>8}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.2f}{:>12.1f}{:>10.1f}\n", numVoices,
+               grainNs.size(), totalNs / 1e3 / grainNs.size(), percentile(0.5),
+               percentile(0.99), grainNs.back() / 1e3, voicesPerMs, audioSeconds / (totalNs / 1e9));
+    return 0;
+}
+
+} // namespace Libraries::Ngs2
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "common/types.h"
+
+namespace Libraries::Ngs2 {
+
+/**
+ * Renders looping PCM voices through sampler, submixer and mastering racks without a guest and
+ * prints the latency of every grain over the given number of seconds of audio. Returns the
+ * process exit code.
+ */
+int RunNgs2Benchmark(u32 numVoices, u32 seconds);
+
+} // namespace Libraries::Ngs2
@@ -1,6 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "ngs2_eq.h"
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
 
@@ -9,4 +14,173 @@
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+// Coefficients from the Audio EQ Cookbook, level is the linear gain of the filter
+s32 BiquadFilter::SetParam(u32 filterType, u32 mask, const float (&direct)[5], float fc, float q,
+                           float level, u32 sampleRate) {
+    if (filterType > ORBIS_NGS2_FILTER_TYPE_HIGH_SHELF) {
+        LOG_ERROR(Lib_Ngs2, "Invalid filter type ({})", filterType);
+        return ORBIS_NGS2_ERROR_INVALID_FILTER_TYPE;
+    }
+    type = filterType;
+    channelMask = mask;
+    history = {};
+    if (type == ORBIS_NGS2_FILTER_TYPE_BYPASS) {
+        return ORBIS_OK;
+    }
+    if (type == ORBIS_NGS2_FILTER_TYPE_DIRECT) {
+        b0 = direct[0];
+        b1 = direct[1];
+        b2 = direct[2];
+        a1 = direct[3];
+        a2 = direct[4];
+        return ORBIS_OK;
+    }
+
+    const double w0 = 2.0 * std::numbers::pi * std::clamp(fc, 1.0f, sampleRate * 0.49f) /
+                      sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * std::max(q, 0.01f));
+    const double a = std::sqrt(std::max(level, 1e-6f));
+    const double sqrtA = std::sqrt(a);
+    double nb0, nb1, nb2, na0, na1, na2;
+    double gain = 1.0;
+    switch (type) {
+    case ORBIS_NGS2_FILTER_TYPE_LOW_PASS:
+        nb0 = nb2 = (1.0 - cosW0) / 2.0;
+        nb1 = 1.0 - cosW0;
+        na0 = 1.0 + alpha;
+        na1 = -2.0 * cosW0;
+        na2 = 1.0 - alpha;
+        gain = level;
+        break;
+    case ORBIS_NGS2_FILTER_TYPE_HIGH_PASS:
+        nb0 = nb2 = (1.0 + cosW0) / 2.0;
+        nb1 = -(1.0 + cosW0);
+        na0 = 1.0 + alpha;
+        na1 = -2.0 * cosW0;
+        na2 = 1.0 - alpha;
+        gain = level;
+        break;
+    case ORBIS_NGS2_FILTER_TYPE_BAND_PASS:
+        nb0 = alpha;
+        nb1 = 0.0;
+        nb2 = -alpha;
+        na0 = 1.0 + alpha;
+        na1 = -2.0 * cosW0;
+        na2 = 1.0 - alpha;
+        gain = level;
+        break;
+    case ORBIS_NGS2_FILTER_TYPE_NOTCH:
+        nb0 = 1.0;
+        nb1 = -2.0 * cosW0;
+        nb2 = 1.0;
+        na0 = 1.0 + alpha;
+        na1 = -2.0 * cosW0;
+        na2 = 1.0 - alpha;
+        gain = level;
+        break;
+    case ORBIS_NGS2_FILTER_TYPE_PEAKING:
+        nb0 = 1.0 + alpha * a;
+        nb1 = -2.0 * cosW0;
+        nb2 = 1.0 - alpha * a;
+        na0 = 1.0 + alpha / a;
+        na1 = -2.0 * cosW0;
+        na2 = 1.0 - alpha / a;
+        break;
+    case ORBIS_NGS2_FILTER_TYPE_LOW_SHELF:
+        nb0 = a * ((a + 1.0) - (a - 1.0) * cosW0 + 2.0 * sqrtA * alpha);
+        nb1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosW0);
+        nb2 = a * ((a + 1.0) - (a - 1.0) * cosW0 - 2.0 * sqrtA * alpha);
+        na0 = (a + 1.0) + (a - 1.0) * cosW0 + 2.0 * sqrtA * alpha;
+        na1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosW0);
+        na2 = (a + 1.0) + (a - 1.0) * cosW0 - 2.0 * sqrtA * alpha;
+        break;
+    default: // ORBIS_NGS2_FILTER_TYPE_HIGH_SHELF
+        nb0 = a * ((a + 1.0) + (a - 1.0) * cosW0 + 2.0 * sqrtA * alpha);
+        nb1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW0);
+        nb2 = a * ((a + 1.0) + (a - 1.0) * cosW0 - 2.0 * sqrtA * alpha);
+        na0 = (a + 1.0) - (a - 1.0) * cosW0 + 2.0 * sqrtA * alpha;
+        na1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosW0);
+        na2 = (a + 1.0) - (a - 1.0) * cosW0 - 2.0 * sqrtA * alpha;
+        break;
+    }
+    b0 = static_cast<float>(nb0 * gain / na0);
+    b1 = static_cast<float>(nb1 * gain / na0);
+    b2 = static_cast<float>(nb2 * gain / na0);
+    a1 = static_cast<float>(na1 / na0);
+    a2 = static_cast<float>(na2 / na0);
+    return ORBIS_OK;
+}
+
+void BiquadFilter::Process(GrainBuffer& buffer, u32 numSamples) {
+    if (IsBypassed()) {
+        return;
+    }
+    for (u32 channel = 0; channel < buffer.numChannels; channel++) {
+        if ((channelMask & (1u << channel)) == 0) {
+            continue;
+        }
+        // Direct form I, the history holds x[n-1], x[n-2], y[n-1], y[n-2]
+        auto& [x1, x2, y1, y2] = history[channel];
+        float* data = buffer.Channel(channel);
+        for (u32 i = 0; i < numSamples; i++) {
+            const float x = data[i];
+            const float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            data[i] = y;
+        }
+    }
+}
+
+Ngs2Eq::Ngs2Eq(const OrbisNgs2RackOption* option) {
+    filters.resize(option ? option->maxVoices : 1);
+}
+
+s32 Ngs2Eq::VoiceControl(RackInternal& rack, VoiceInternal& handle,
+                         const OrbisNgs2VoiceParamHeader& header) {
+    switch (header.id) {
+    case ORBIS_NGS2_EQ_VOICE_PARAM_SETUP: {
+        const auto& param = *reinterpret_cast<const OrbisNgs2EqVoiceSetupParam*>(&header + 1);
+        if (param.numChannels == 0 || param.numChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid EQ channels ({})", param.numChannels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        handle.input.Clear(handle.input.stride);
+        handle.input.numChannels = param.numChannels;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_EQ_VOICE_PARAM_FILTER: {
+        const auto& param = *reinterpret_cast<const OrbisNgs2EqVoiceFilterParam*>(&header + 1);
+        const auto& direct = param.param.direct;
+        const float coefficients[5] = {direct.i0, direct.i1, direct.i2, direct.o1, direct.o2};
+        return filters[handle.index].SetParam(param.type, param.channelMask, coefficients,
+                                              param.param.fcq.fc, param.param.fcq.q,
+                                              param.param.fcq.level,
+                                              handle.systemData->currentSampleRate);
+    }
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid EQ voice parameter ({:#x})", header.id);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+void Ngs2Eq::Process(RackInternal& rack, const RenderContext& context) {
+    const u32 numSamples = context.numGrainSamples;
+    for (u32 index = 0; index < filters.size(); index++) {
+        VoiceInternal& handle = rack.voices[index];
+        const u32 stateFlags = rack.stateFlags[index];
+        if ((stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) != 0 &&
+            (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED) == 0) {
+            filters[index].Process(handle.input, numSamples);
+            MixToPorts(handle, handle.input, numSamples);
+        }
+        handle.input.Clear(numSamples);
+    }
+}
+
+} // namespace Libraries::Ngs2
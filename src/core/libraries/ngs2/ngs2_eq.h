@@ -3,11 +3,13 @@
 
 #pragma once
 
-#include "ngs2.h"
+#include "ngs2_impl.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Eq;
+// The EQ parameters follow a OrbisNgs2VoiceParamHeader
+static const u32 ORBIS_NGS2_EQ_VOICE_PARAM_SETUP = 0x20020001;
+static const u32 ORBIS_NGS2_EQ_VOICE_PARAM_FILTER = 0x20020002;
 
 struct OrbisNgs2EqVoiceSetupParam {
     u32 numChannels;
@@ -38,4 +40,17 @@ struct OrbisNgs2EqVoiceState {
     u32 stateFlags;
 };
 
+// Runs the voices patched into it through one biquad filter each.
+class Ngs2Eq final : public RackProcessor {
+public:
+    explicit Ngs2Eq(const OrbisNgs2RackOption* option);
+
+    s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                     const OrbisNgs2VoiceParamHeader& param) override;
+    void Process(RackInternal& rack, const RenderContext& context) override;
+
+private:
+    std::vector<BiquadFilter> filters;
+};
+
 } // namespace Libraries::Ngs2
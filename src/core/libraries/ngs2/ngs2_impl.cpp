@@ -1,17 +1,57 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "ngs2_eq.h"
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_mastering.h"
+#include "ngs2_reverb.h"
+#include "ngs2_sampler.h"
+#include "ngs2_submixer.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 #include "core/libraries/kernel/kernel.h"
 
+// SIMD support detection
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define HAS_SSE2
+#endif
+
 using namespace Libraries::Kernel;
 
 namespace Libraries::Ngs2 {
 
+// Weight of the newest render in the smoothed cpu load
+constexpr float CpuLoadSmoothing = 0.1f;
+
+// Bound on the length of a voice control list, to catch lists that link back on themselves
+constexpr u32 MaxVoiceControlParams = 4096;
+
+static std::mutex systemsLock;
+static std::vector<std::unique_ptr<SystemInternal>> systems;
+static std::atomic<u32> nextUid{1};
+
+// Voices of the custom racks accept every parameter and render silence
+class UnsupportedRack final : public RackProcessor {
+public:
+    s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                     const OrbisNgs2VoiceParamHeader& param) override {
+        return ORBIS_OK;
+    }
+
+    void Process(RackInternal& rack, const RenderContext& context) override {
+        for (VoiceInternal& voice : rack.voices) {
+            voice.input.Clear(context.numGrainSamples);
+        }
+    }
+};
+
 s32 HandleReportInvalid(OrbisNgs2Handle handle, u32 handleType) {
     switch (handleType) {
     case 1:
@@ -61,16 +101,85 @@ s32 StackBufferOpen(StackBuffer* stackBuffer, void* bufferStart, size_t bufferSi
     return ORBIS_OK;
 }
 
+SystemInternal* GetSystem(OrbisNgs2Handle systemHandle) {
+    std::scoped_lock lock{systemsLock};
+    for (const auto& system : systems) {
+        if (system->systemHandle == systemHandle) {
+            return system.get();
+        }
+    }
+    return nullptr;
+}
+
+u32 EnumSystems(OrbisNgs2Handle* aOutHandle, u32 maxHandles) {
+    std::scoped_lock lock{systemsLock};
+    const u32 numSystems = static_cast<u32>(systems.size());
+    for (u32 i = 0; i < std::min(numSystems, maxHandles); i++) {
+        aOutHandle[i] = systems[i]->systemHandle;
+    }
+    return numSystems;
+}
+
+RackInternal* GetRack(OrbisNgs2Handle rackHandle) {
+    auto* handle = reinterpret_cast<HandleInternal*>(rackHandle);
+    if (!handle || handle->selfPtr != handle ||
+        handle->handleType != static_cast<u32>(OrbisNgs2HandleType::Rack)) {
+        return nullptr;
+    }
+    return static_cast<RackInternal*>(handle);
+}
+
+VoiceInternal* GetVoice(OrbisNgs2Handle voiceHandle) {
+    auto* handle = reinterpret_cast<HandleInternal*>(voiceHandle);
+    if (!handle || handle->selfPtr != handle ||
+        handle->handleType != static_cast<u32>(OrbisNgs2HandleType::Voice)) {
+        return nullptr;
+    }
+    return static_cast<VoiceInternal*>(handle);
+}
+
 s32 SystemCleanup(OrbisNgs2Handle systemHandle, OrbisNgs2ContextBufferInfo* outInfo) {
     if (!systemHandle) {
         return ORBIS_NGS2_ERROR_INVALID_HANDLE;
     }
 
-    // TODO
+    std::unique_ptr<SystemInternal> system;
+    {
+        std::scoped_lock lock{systemsLock};
+        const auto it = std::ranges::find(systems, systemHandle, [](const auto& entry) {
+            return entry->systemHandle;
+        });
+        if (it == systems.end()) {
+            return HandleReportInvalid(systemHandle, 1);
+        }
+        system = std::move(*it);
+        systems.erase(it);
+    }
+
+    {
+        std::scoped_lock lock{system->lock};
+        while (!system->racks.empty()) {
+            RackCleanup(system->racks.back().get(), nullptr);
+        }
+    }
 
+    if (outInfo) {
+        *outInfo = system->bufferInfo;
+    }
+    if (system->hostFree) {
+        OrbisNgs2ContextBufferInfo bufferInfo = system->bufferInfo;
+        system->hostFree(&bufferInfo);
+    }
     return ORBIS_OK;
 }
 
+bool IsValidSampleRate(u32 sampleRate) {
+    return sampleRate == 11025 || sampleRate == 12000 || sampleRate == 22050 ||
+           sampleRate == 24000 || sampleRate == 44100 || sampleRate == 48000 ||
+           sampleRate == 88200 || sampleRate == 96000 || sampleRate == 176400 ||
+           sampleRate == 192000;
+}
+
 s32 SystemSetupCore(StackBuffer* stackBuffer, const OrbisNgs2SystemOption* option,
                     SystemInternal* outSystem) {
     u32 maxGrainSamples = 512;
@@ -88,21 +197,29 @@ s32 SystemSetupCore(StackBuffer* stackBuffer, const OrbisNgs2SystemOption* optio
         return ORBIS_NGS2_ERROR_INVALID_MAX_GRAIN_SAMPLES;
     }
 
-    if (numGrainSamples < 64 || numGrainSamples > 1024 || (numGrainSamples & 63) != 0) {
+    if (numGrainSamples < 64 || numGrainSamples > maxGrainSamples ||
+        (numGrainSamples & 63) != 0) {
         LOG_ERROR(Lib_Ngs2, "Invalid system option (numGrainSamples={},x64)", numGrainSamples);
         return ORBIS_NGS2_ERROR_INVALID_NUM_GRAIN_SAMPLES;
     }
 
-    if (sampleRate != 11025 && sampleRate != 12000 && sampleRate != 22050 && sampleRate != 24000 &&
-        sampleRate != 44100 && sampleRate != 48000 && sampleRate != 88200 && sampleRate != 96000 &&
-        sampleRate != 176400 && sampleRate != 192000) {
+    if (!IsValidSampleRate(sampleRate)) {
         LOG_ERROR(Lib_Ngs2, "Invalid system option(sampleRate={}:44.1/48kHz series)", sampleRate);
         return ORBIS_NGS2_ERROR_INVALID_SAMPLE_RATE;
     }
 
     if (outSystem) {
-        // dummy handle
-        outSystem->systemHandle = 1;
+        if (option) {
+            std::memcpy(outSystem->name, option->name, sizeof(outSystem->name));
+        }
+        outSystem->uid = nextUid++;
+        outSystem->minGrainSamples = 64;
+        outSystem->maxGrainSamples = maxGrainSamples;
+        outSystem->currentMaxGrainSamples = maxGrainSamples;
+        outSystem->numGrainSamples = numGrainSamples;
+        outSystem->currentNumGrainSamples = numGrainSamples;
+        outSystem->sampleRate = sampleRate;
+        outSystem->currentSampleRate = sampleRate;
     }
 
     return ORBIS_OK;
@@ -112,7 +229,6 @@ s32 SystemSetup(const OrbisNgs2SystemOption* option, OrbisNgs2ContextBufferInfo*
                 OrbisNgs2BufferFreeHandler hostFree, OrbisNgs2Handle* outHandle) {
     u8 optionFlags = 0;
     StackBuffer stackBuffer;
-    SystemInternal setupResult;
     void* systemList = NULL;
     size_t requiredBufferSize = 0;
     u32 result = ORBIS_NGS2_ERROR_INVALID_BUFFER_SIZE;
@@ -155,9 +271,10 @@ s32 SystemSetup(const OrbisNgs2SystemOption* option, OrbisNgs2ContextBufferInfo*
     }
 
     // Setup
+    auto setupResult = std::make_unique<SystemInternal>();
     StackBufferOpen(&stackBuffer, hostBufferInfo->hostBuffer, hostBufferInfo->hostBufferSize,
                     &systemList, optionFlags);
-    result = SystemSetupCore(&stackBuffer, option, &setupResult);
+    result = SystemSetupCore(&stackBuffer, option, setupResult.get());
 
     if (result < 0) {
         return result;
@@ -165,23 +282,619 @@ s32 SystemSetup(const OrbisNgs2SystemOption* option, OrbisNgs2ContextBufferInfo*
 
     StackBufferClose(&stackBuffer, &requiredBufferSize);
 
-    // Copy buffer results
-    setupResult.bufferInfo = *hostBufferInfo;
-    setupResult.hostFree = hostFree;
-    // TODO
-    // setupResult.systemList = systemList;
+    // Copy buffer results. The engine state lives on the host, the guest buffer is only handed
+    // back on destruction.
+    setupResult->bufferInfo = *hostBufferInfo;
+    setupResult->hostFree = hostFree;
+    setupResult->systemHandle = reinterpret_cast<OrbisNgs2Handle>(setupResult.get());
+
+    *outHandle = setupResult->systemHandle;
+    std::scoped_lock lock{systemsLock};
+    systems.push_back(std::move(setupResult));
+    return ORBIS_OK;
+}
+
+void GrainBuffer::Clear(u32 numSamples) {
+    for (u32 channel = 0; channel < numChannels; channel++) {
+        std::fill_n(Channel(channel), numSamples, 0.0f);
+    }
+}
+
+void MixScaled(float* dst, const float* src, float gain, u32 numSamples) {
+    u32 i = 0;
+#if defined(HAS_SSE2)
+    const __m128 scale = _mm_set1_ps(gain);
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 sum =
+            _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), scale));
+        _mm_storeu_ps(dst + i, sum);
+    }
+#endif
+    for (; i < numSamples; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+void ApplyGainRamp(float* data, u32 numSamples, float start, float step) {
+    if (start == 1.0f && step == 0.0f) {
+        return;
+    }
+    u32 i = 0;
+#if defined(HAS_SSE2)
+    __m128 gain = _mm_setr_ps(start, start + step, start + 2.0f * step, start + 3.0f * step);
+    const __m128 gainStep = _mm_set1_ps(4.0f * step);
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+        gain = _mm_add_ps(gain, gainStep);
+    }
+#endif
+    for (; i < numSamples; i++) {
+        data[i] *= start + step * static_cast<float>(i);
+    }
+}
+
+void MixMatrix(GrainBuffer& dst, const GrainBuffer& src, const VoiceMatrix* matrix, float volume,
+               u32 numSamples) {
+    if (volume == 0.0f || src.numChannels == 0) {
+        return;
+    }
+    if (matrix && matrix->numLevels >= src.numChannels) {
+        // Levels are stored input channel major
+        const u32 numOutputs = matrix->numLevels / src.numChannels;
+        for (u32 in = 0; in < src.numChannels; in++) {
+            for (u32 out = 0; out < std::min(numOutputs, dst.numChannels); out++) {
+                const float level = matrix->aLevel[in * numOutputs + out] * volume;
+                if (level != 0.0f) {
+                    MixScaled(dst.Channel(out), src.Channel(in), level, numSamples);
+                }
+            }
+        }
+        return;
+    }
+    // Without levels a mono voice feeds the front pair and other layouts map channel to channel
+    if (src.numChannels == 1) {
+        for (u32 out = 0; out < std::min(2u, dst.numChannels); out++) {
+            MixScaled(dst.Channel(out), src.Channel(0), volume, numSamples);
+        }
+        return;
+    }
+    for (u32 channel = 0; channel < std::min(src.numChannels, dst.numChannels); channel++) {
+        MixScaled(dst.Channel(channel), src.Channel(channel), volume, numSamples);
+    }
+}
+
+void MixToPorts(VoiceInternal& voice, const GrainBuffer& output, u32 numSamples) {
+    for (const VoicePort& port : voice.ports) {
+        if (!port.dest) {
+            continue;
+        }
+        const bool hasMatrix =
+            port.matrixId >= 0 && static_cast<u32>(port.matrixId) < voice.matrices.size();
+        MixMatrix(port.dest->input, output, hasMatrix ? &voice.matrices[port.matrixId] : nullptr,
+                  port.volume, numSamples);
+    }
+}
+
+s32 Envelope::SetPoints(const OrbisNgs2EnvelopePoint* aPoint, u32 numForward, u32 numRelease,
+                        u32 maxPoints) {
+    const u32 numPoints = numForward + numRelease;
+    if (numPoints > maxPoints) {
+        LOG_ERROR(Lib_Ngs2, "Invalid number of envelope points ({}>{})", numPoints, maxPoints);
+        return ORBIS_NGS2_ERROR_INVALID_NUM_ENVELOPE_POINTS;
+    }
+    if (numPoints != 0 && !aPoint) {
+        LOG_ERROR(Lib_Ngs2, "Invalid envelope point address");
+        return ORBIS_NGS2_ERROR_INVALID_ENVELOPE_POINT_ADDRESS;
+    }
+    points.assign(aPoint, aPoint + numPoints);
+    numForwardPoints = numForward;
+    return ORBIS_OK;
+}
+
+void Envelope::Start() {
+    nextPoint = 0;
+    remaining = 0;
+    step = 0.0f;
+    releasing = false;
+    height = target = numForwardPoints != 0 ? 0.0f : 1.0f;
+}
+
+void Envelope::Release() {
+    releasing = true;
+    nextPoint = numForwardPoints;
+    remaining = 0;
+    target = height;
+}
+
+bool Envelope::Apply(GrainBuffer& buffer, u32 numSamples, u32 sampleRate) {
+    if (points.empty()) {
+        return !releasing;
+    }
+    u32 offset = 0;
+    while (offset < numSamples) {
+        if (remaining == 0) {
+            height = target;
+            const u32 lastPoint = releasing ? static_cast<u32>(points.size()) : numForwardPoints;
+            if (nextPoint < lastPoint) {
+                // Durations are in microseconds, curves are approximated by lines
+                const OrbisNgs2EnvelopePoint& point = points[nextPoint++];
+                target = point.height;
+                remaining = static_cast<u32>(static_cast<u64>(point.duration) * sampleRate /
+                                             1000000);
+                step = remaining != 0 ? (target - height) / static_cast<float>(remaining) : 0.0f;
+                continue;
+            }
+            if (releasing) {
+                for (u32 channel = 0; channel < buffer.numChannels; channel++) {
+                    std::fill_n(buffer.Channel(channel) + offset, numSamples - offset, 0.0f);
+                }
+                return false;
+            }
+            // Hold the last forward point
+            step = 0.0f;
+            remaining = numSamples - offset;
+        }
+        const u32 count = std::min(remaining, numSamples - offset);
+        for (u32 channel = 0; channel < buffer.numChannels; channel++) {
+            ApplyGainRamp(buffer.Channel(channel) + offset, count, height, step);
+        }
+        height += step * static_cast<float>(count);
+        remaining -= count;
+        offset += count;
+    }
+    return true;
+}
+
+std::unique_ptr<RackProcessor> CreateRackProcessor(u32 rackId, const OrbisNgs2RackOption* option) {
+    switch (rackId) {
+    case ORBIS_NGS2_RACK_ID_SAMPLER:
+        return std::make_unique<Ngs2Sampler>(option);
+    case ORBIS_NGS2_RACK_ID_SUBMIXER:
+        return std::make_unique<Ngs2Submixer>(option);
+    case ORBIS_NGS2_RACK_ID_REVERB:
+        return std::make_unique<Ngs2Reverb>(option);
+    case ORBIS_NGS2_RACK_ID_EQ:
+        return std::make_unique<Ngs2Eq>(option);
+    case ORBIS_NGS2_RACK_ID_MASTERING:
+        return std::make_unique<Ngs2Mastering>(option);
+    case ORBIS_NGS2_RACK_ID_CUSTOM_SAMPLER:
+    case ORBIS_NGS2_RACK_ID_CUSTOM_SUBMIXER:
+    case ORBIS_NGS2_RACK_ID_CUSTOM_MASTERING:
+        LOG_WARNING(Lib_Ngs2, "Custom rack {:#x} is not implemented, voices render silence",
+                    rackId);
+        return std::make_unique<UnsupportedRack>();
+    default:
+        return nullptr;
+    }
+}
+
+s32 RackCleanup(RackInternal* rack, OrbisNgs2ContextBufferInfo* outInfo) {
+    SystemInternal* system = rack->systemData;
+    std::unique_ptr<RackInternal> owned;
+    {
+        std::scoped_lock lock{system->lock};
+        // Unpatch every port leading into the voices of this rack
+        for (const auto& other : system->racks) {
+            for (VoiceInternal& voice : other->voices) {
+                for (VoicePort& port : voice.ports) {
+                    if (port.dest && port.dest->rack == rack) {
+                        port.dest = nullptr;
+                    }
+                }
+            }
+        }
+        const auto it = std::ranges::find_if(
+            system->racks, [rack](const auto& entry) { return entry.get() == rack; });
+        if (it == system->racks.end()) {
+            return HandleReportInvalid(reinterpret_cast<OrbisNgs2Handle>(rack), 2);
+        }
+        owned = std::move(*it);
+        system->racks.erase(it);
+        system->rackCount--;
+    }
+
+    // Drop stale handles to the rack and its voices
+    owned->selfPtr = nullptr;
+    for (VoiceInternal& voice : owned->voices) {
+        voice.selfPtr = nullptr;
+    }
+    if (outInfo) {
+        *outInfo = owned->bufferInfo;
+    }
+    if (owned->hostFree) {
+        OrbisNgs2ContextBufferInfo bufferInfo = owned->bufferInfo;
+        owned->hostFree(&bufferInfo);
+    }
+    return ORBIS_OK;
+}
+
+s32 RackSetup(SystemInternal* system, u32 rackId, const OrbisNgs2RackOption* option,
+              OrbisNgs2ContextBufferInfo* hostBufferInfo, OrbisNgs2BufferFreeHandler hostFree,
+              OrbisNgs2Handle* outHandle) {
+    OrbisNgs2RackOption rackOption{};
+    rackOption.size = sizeof(OrbisNgs2RackOption);
+    rackOption.maxGrainSamples = 512;
+    rackOption.maxVoices = 1;
+    rackOption.maxMatrices = 1;
+    rackOption.maxPorts = 1;
+    if (option) {
+        if (option->size < sizeof(OrbisNgs2RackOption)) {
+            LOG_ERROR(Lib_Ngs2, "Invalid rack option size ({})", option->size);
+            return ORBIS_NGS2_ERROR_INVALID_OPTION_SIZE;
+        }
+        rackOption = *option;
+    }
+
+    auto processor = CreateRackProcessor(rackId, option);
+    if (!processor) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack id ({:#x})", rackId);
+        return ORBIS_NGS2_ERROR_INVALID_RACK_ID;
+    }
+    if (rackOption.maxVoices == 0) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack option (maxVoices={})", rackOption.maxVoices);
+        return ORBIS_NGS2_ERROR_INVALID_MAX_VOICES;
+    }
+    if (rackOption.maxMatrices > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack option (maxMatrices={})", rackOption.maxMatrices);
+        return ORBIS_NGS2_ERROR_INVALID_MAX_MATRICES;
+    }
+    if (rackOption.maxPorts > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack option (maxPorts={})", rackOption.maxPorts);
+        return ORBIS_NGS2_ERROR_INVALID_MAX_PORTS;
+    }
+
+    // Like systems, racks keep their state on the host and need no guest memory
+    StackBuffer stackBuffer;
+    size_t requiredBufferSize = 0;
+    StackBufferOpen(&stackBuffer, NULL, 0, NULL, 0);
+    StackBufferClose(&stackBuffer, &requiredBufferSize);
+
+    if (!outHandle) {
+        hostBufferInfo->hostBuffer = NULL;
+        hostBufferInfo->hostBufferSize = requiredBufferSize;
+        MemoryClear(&hostBufferInfo->reserved, sizeof(hostBufferInfo->reserved));
+        return ORBIS_OK;
+    }
+
+    if (!hostBufferInfo->hostBuffer) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack buffer address ({})", hostBufferInfo->hostBuffer);
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_ADDRESS;
+    }
+
+    if (hostBufferInfo->hostBufferSize < requiredBufferSize) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack buffer size ({}<{}[byte])",
+                  hostBufferInfo->hostBufferSize, requiredBufferSize);
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_SIZE;
+    }
 
-    OrbisNgs2Handle systemHandle = setupResult.systemHandle;
-    if (hostBufferInfo->hostBufferSize >= requiredBufferSize) {
-        *outHandle = systemHandle;
+    auto rack = std::make_unique<RackInternal>();
+    rack->selfPtr = rack.get();
+    rack->systemData = system;
+    rack->handleType = static_cast<u32>(OrbisNgs2HandleType::Rack);
+    rack->handleID = nextUid++;
+    rack->rackId = rackId;
+    rack->option = rackOption;
+    rack->bufferInfo = *hostBufferInfo;
+    rack->hostFree = hostFree;
+    rack->processor = std::move(processor);
+    rack->stateFlags.assign(rackOption.maxVoices, 0);
+    rack->voices = std::vector<VoiceInternal>(rackOption.maxVoices);
+
+    const bool hasInputs =
+        rackId != ORBIS_NGS2_RACK_ID_SAMPLER && rackId != ORBIS_NGS2_RACK_ID_CUSTOM_SAMPLER;
+    for (u32 i = 0; i < rackOption.maxVoices; i++) {
+        VoiceInternal& voice = rack->voices[i];
+        voice.selfPtr = &voice;
+        voice.systemData = system;
+        voice.handleType = static_cast<u32>(OrbisNgs2HandleType::Voice);
+        voice.handleID = i;
+        voice.rack = rack.get();
+        voice.index = i;
+        voice.matrices.resize(rackOption.maxMatrices);
+        voice.ports.resize(rackOption.maxPorts);
+        if (hasInputs) {
+            voice.input.Allocate(ORBIS_NGS2_MAX_VOICE_CHANNELS, system->maxGrainSamples);
+            voice.input.numChannels = 2;
+        }
+    }
+
+    std::scoped_lock lock{system->lock};
+    *outHandle = reinterpret_cast<OrbisNgs2Handle>(static_cast<HandleInternal*>(rack.get()));
+    const auto it = std::ranges::upper_bound(system->racks, rackId, {},
+                                             [](const auto& entry) { return entry->rackId; });
+    system->racks.insert(it, std::move(rack));
+    system->rackCount++;
+    return ORBIS_OK;
+}
+
+static s32 VoiceKickEvent(RackInternal& rack, VoiceInternal& voice, u32 eventId) {
+    u32& stateFlags = rack.stateFlags[voice.index];
+    switch (eventId) {
+    case ORBIS_NGS2_VOICE_EVENT_PLAY:
+        stateFlags = ORBIS_NGS2_VOICE_STATE_FLAG_INUSE | ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING;
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_STOP:
+        if (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) {
+            stateFlags |= ORBIS_NGS2_VOICE_STATE_FLAG_STOPPED;
+        }
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_STOP_IMM:
+    case ORBIS_NGS2_VOICE_EVENT_KILL:
+        stateFlags = 0;
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_PAUSE:
+        if (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) {
+            stateFlags |= ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED;
+        }
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_RESUME:
+        stateFlags &= ~ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED;
+        break;
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid voice event ({})", eventId);
+        return ORBIS_NGS2_ERROR_INVALID_EVENT_TYPE;
+    }
+    rack.processor->VoiceEvent(rack, voice, eventId);
+    return ORBIS_OK;
+}
+
+static s32 VoiceApplyParam(RackInternal& rack, VoiceInternal& voice,
+                           const OrbisNgs2VoiceParamHeader& header) {
+    switch (header.id) {
+    case ORBIS_NGS2_VOICE_PARAM_MATRIX_LEVELS: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoiceMatrixLevelsParam&>(header);
+        if (param.matrixId >= voice.matrices.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid matrix id ({})", param.matrixId);
+            return ORBIS_NGS2_ERROR_INVALID_MATRIX_INDEX;
+        }
+        if (param.numLevels > ORBIS_NGS2_MAX_MATRIX_LEVELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid number of matrix levels ({})", param.numLevels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_MATRIX_LEVELS;
+        }
+        if (param.numLevels != 0 && !param.aLevel) {
+            LOG_ERROR(Lib_Ngs2, "Invalid matrix level address");
+            return ORBIS_NGS2_ERROR_INVALID_MATRIX_LEVEL_ADDRESS;
+        }
+        VoiceMatrix& matrix = voice.matrices[param.matrixId];
+        matrix.numLevels = param.numLevels;
+        std::copy_n(param.aLevel, param.numLevels, matrix.aLevel.begin());
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_VOICE_PARAM_PORT_VOLUME: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoicePortVolumeParam&>(header);
+        if (param.port >= voice.ports.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid port index ({})", param.port);
+            return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+        }
+        voice.ports[param.port].volume = param.level;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_VOICE_PARAM_PORT_MATRIX: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoicePortMatrixParam&>(header);
+        if (param.port >= voice.ports.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid port index ({})", param.port);
+            return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+        }
+        if (param.matrixId >= static_cast<s32>(voice.matrices.size())) {
+            LOG_ERROR(Lib_Ngs2, "Invalid matrix id ({})", param.matrixId);
+            return ORBIS_NGS2_ERROR_INVALID_MATRIX_INDEX;
+        }
+        voice.ports[param.port].matrixId = param.matrixId;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_VOICE_PARAM_PORT_DELAY: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoicePortDelayParam&>(header);
+        if (param.port >= voice.ports.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid port index ({})", param.port);
+            return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+        }
+        // Stored for the port info, the mix itself is not delayed
+        voice.ports[param.port].numDelaySamples = param.numSamples;
         return ORBIS_OK;
     }
+    case ORBIS_NGS2_VOICE_PARAM_PATCH: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoicePatchParam&>(header);
+        if (param.port >= voice.ports.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid port index ({})", param.port);
+            return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+        }
+        VoicePort& port = voice.ports[param.port];
+        if (!param.destHandle) {
+            port.dest = nullptr;
+            return ORBIS_OK;
+        }
+        VoiceInternal* dest = GetVoice(param.destHandle);
+        if (!dest || dest == &voice || dest->systemData != voice.systemData ||
+            dest->input.data.empty()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid patch destination {}", param.destHandle);
+            return ORBIS_NGS2_ERROR_INVALID_PATCH;
+        }
+        port.dest = dest;
+        port.destInputId = param.destInputId;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_VOICE_PARAM_KICK_EVENT: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoiceEventParam&>(header);
+        return VoiceKickEvent(rack, voice, param.eventId);
+    }
+    case ORBIS_NGS2_VOICE_PARAM_CALLBACK: {
+        const auto& param = reinterpret_cast<const OrbisNgs2VoiceCallbackParam&>(header);
+        voice.callbackHandler = param.callbackHandler;
+        voice.callbackData = param.callbackData;
+        voice.callbackFlags = param.flags;
+        return ORBIS_OK;
+    }
+    default:
+        return rack.processor->VoiceControl(rack, voice, header);
+    }
+}
+
+s32 VoiceControl(VoiceInternal* voice, const OrbisNgs2VoiceParamHeader* paramList) {
+    std::scoped_lock lock{voice->systemData->lock};
+    const OrbisNgs2VoiceParamHeader* param = paramList;
+    for (u32 numParams = 0; numParams < MaxVoiceControlParams; numParams++) {
+        const s32 result = VoiceApplyParam(*voice->rack, *voice, *param);
+        if (result < 0) {
+            return result;
+        }
+        if (param->next == 0) {
+            return ORBIS_OK;
+        }
+        param = reinterpret_cast<const OrbisNgs2VoiceParamHeader*>(
+            reinterpret_cast<const u8*>(param) + param->next);
+    }
+    LOG_ERROR(Lib_Ngs2, "Voice control list has no end");
+    return ORBIS_NGS2_ERROR_DETECTED_CIRCULAR_VOICE_CONTROL;
+}
+
+s32 VoiceGetState(VoiceInternal* voice, OrbisNgs2VoiceState* outState, size_t stateSize) {
+    if (stateSize < sizeof(OrbisNgs2VoiceState)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid voice state size ({})", stateSize);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_STATE_SIZE;
+    }
+    RackInternal& rack = *voice->rack;
+    std::scoped_lock lock{voice->systemData->lock};
+    MemoryClear(outState, stateSize);
+    outState->stateFlags = rack.stateFlags[voice->index];
+    rack.processor->GetVoiceState(rack, *voice, outState, stateSize);
+    return ORBIS_OK;
+}
+
+static u32 GetRenderSampleSize(u32 waveformType) {
+    switch (waveformType) {
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16L:
+        return sizeof(s16);
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32L:
+        return sizeof(float);
+    default:
+        return 0;
+    }
+}
 
-    SystemCleanup(systemHandle, 0);
+static void WriteRenderBuffer(const OrbisNgs2RenderBufferInfo& bufferInfo,
+                              const GrainBuffer& output, u32 numSamples) {
+    const u32 numChannels = bufferInfo.numChannels;
+    if (bufferInfo.waveformType == ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32L) {
+        auto* dst = static_cast<float*>(bufferInfo.buffer);
+        u32 i = 0;
+#if defined(HAS_SSE2)
+        if (numChannels == 2) {
+            const float* left = output.Channel(0);
+            const float* right = output.Channel(1);
+            for (; i + 4 <= numSamples; i += 4) {
+                const __m128 l = _mm_loadu_ps(left + i);
+                const __m128 r = _mm_loadu_ps(right + i);
+                _mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(l, r));
+            }
+        }
+#endif
+        for (u32 channel = 0; channel < numChannels; channel++) {
+            const float* src = output.Channel(channel);
+            for (u32 j = i; j < numSamples; j++) {
+                dst[j * numChannels + channel] = src[j];
+            }
+        }
+        return;
+    }
+
+    auto* dst = static_cast<s16*>(bufferInfo.buffer);
+    u32 i = 0;
+#if defined(HAS_SSE2)
+    if (numChannels == 2) {
+        const float* left = output.Channel(0);
+        const float* right = output.Channel(1);
+        const __m128 scale = _mm_set1_ps(32768.0f);
+        for (; i + 4 <= numSamples; i += 4) {
+            const __m128 l = _mm_mul_ps(_mm_loadu_ps(left + i), scale);
+            const __m128 r = _mm_mul_ps(_mm_loadu_ps(right + i), scale);
+            const __m128i lo = _mm_cvtps_epi32(_mm_unpacklo_ps(l, r));
+            const __m128i hi = _mm_cvtps_epi32(_mm_unpackhi_ps(l, r));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_packs_epi32(lo, hi));
+        }
+    }
+#endif
+    for (u32 channel = 0; channel < numChannels; channel++) {
+        const float* src = output.Channel(channel);
+        for (u32 j = i; j < numSamples; j++) {
+            dst[j * numChannels + channel] =
+                static_cast<s16>(std::clamp(src[j] * 32768.0f, -32768.0f, 32767.0f));
+        }
+    }
+}
+
+s32 SystemRender(SystemInternal* system, const OrbisNgs2RenderBufferInfo* aBufferInfo,
+                 u32 numBufferInfo) {
+    const u32 numSamples = system->currentNumGrainSamples;
+    for (u32 i = 0; i < numBufferInfo; i++) {
+        const OrbisNgs2RenderBufferInfo& bufferInfo = aBufferInfo[i];
+        if (!bufferInfo.buffer) {
+            LOG_ERROR(Lib_Ngs2, "Invalid render buffer address ({})", i);
+            return ORBIS_NGS2_ERROR_INVALID_BUFFER_ADDRESS;
+        }
+        if (bufferInfo.numChannels == 0 ||
+            bufferInfo.numChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid render buffer channels ({})", bufferInfo.numChannels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        const u32 sampleSize = GetRenderSampleSize(bufferInfo.waveformType);
+        if (sampleSize == 0) {
+            LOG_ERROR(Lib_Ngs2, "Invalid render buffer type ({:#x})", bufferInfo.waveformType);
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_TYPE;
+        }
+        const size_t requiredSize = static_cast<size_t>(numSamples) * bufferInfo.numChannels *
+                                    sampleSize;
+        if (bufferInfo.bufferSize < requiredSize) {
+            LOG_ERROR(Lib_Ngs2, "Invalid render buffer size ({}<{}[byte])", bufferInfo.bufferSize,
+                      requiredSize);
+            return ORBIS_NGS2_ERROR_INVALID_BUFFER_SIZE;
+        }
+    }
+
+    using Clock = std::chrono::steady_clock;
+    std::scoped_lock lock{system->lock};
+    const auto start = Clock::now();
+    if (system->outputs.size() < numBufferInfo) {
+        system->outputs.resize(numBufferInfo);
+    }
+    for (u32 i = 0; i < numBufferInfo; i++) {
+        GrainBuffer& output = system->outputs[i];
+        if (output.data.empty()) {
+            output.Allocate(ORBIS_NGS2_MAX_VOICE_CHANNELS, system->maxGrainSamples);
+        }
+        output.numChannels = aBufferInfo[i].numChannels;
+        output.Clear(numSamples);
+    }
+
+    // Racks run in id order, samplers first and mastering last. A patch into a voice that was
+    // already processed in this grain is heard in the next one.
+    const double grainSeconds = static_cast<double>(numSamples) / system->currentSampleRate;
+    const RenderContext context{numSamples, system->currentSampleRate,
+                                std::span(system->outputs.data(), numBufferInfo)};
+    for (const auto& rack : system->racks) {
+        const auto rackStart = Clock::now();
+        rack->processor->Process(*rack, context);
+        const std::chrono::duration<double> elapsed = Clock::now() - rackStart;
+        rack->lastProcessRatio = static_cast<float>(elapsed.count() / grainSeconds);
+        rack->lastProcessTick =
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        rack->renderCount++;
+    }
 
-    LOG_ERROR(Lib_Ngs2, "Invalid system buffer size ({}<{}[byte])", hostBufferInfo->hostBufferSize,
-              requiredBufferSize);
-    return ORBIS_NGS2_ERROR_INVALID_BUFFER_SIZE;
+    for (u32 i = 0; i < numBufferInfo; i++) {
+        WriteRenderBuffer(aBufferInfo[i], system->outputs[i], numSamples);
+    }
+
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    const float ratio = static_cast<float>(elapsed.count() / grainSeconds);
+    system->lastRenderRatio = ratio;
+    system->cpuLoad = system->renderCount == 0
+                          ? ratio
+                          : system->cpuLoad + (ratio - system->cpuLoad) * CpuLoadSmoothing;
+    system->lastRenderTick =
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    system->renderCount++;
+    return ORBIS_OK;
 }
 
 } // namespace Libraries::Ngs2
@@ -3,93 +3,178 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
 #include "core/libraries/kernel/threads/pthread.h"
+#include "core/libraries/ngs2/ngs2.h"
 
 namespace Libraries::Ngs2 {
 
-static const int ORBIS_NGS2_SYSTEM_NAME_LENGTH = 16;
-static const int ORBIS_NGS2_RACK_NAME_LENGTH = 16;
+struct StackBuffer {
+    void** top;
+    void* base;
+    size_t size;
+    size_t currentOffset;
+    size_t usedSize;
+    size_t totalSize;
+    size_t alignment;
+    u8 flags;
+    char padding[7];
+};
 
-typedef uintptr_t OrbisNgs2Handle;
+struct SystemInternal;
 
-struct OrbisNgs2ContextBufferInfo {
-    void* hostBuffer;
-    size_t hostBufferSize;
-    uintptr_t reserved[5];
-    uintptr_t userData;
+struct HandleInternal {
+    HandleInternal* selfPtr;    // 0
+    SystemInternal* systemData; // 8
+    std::atomic<int> refCount;  // 16
+    u32 handleType;             // 24
+    u32 handleID;               // 28
 };
 
-struct OrbisNgs2SystemOption {
-    size_t size;
-    char name[ORBIS_NGS2_SYSTEM_NAME_LENGTH];
+// Samples of one grain, stored channel after channel so that the kernels stream through a single
+// channel at a time.
+struct GrainBuffer {
+    u32 numChannels{};
+    u32 stride{};
+    std::vector<float> data;
 
-    u32 flags;
-    u32 maxGrainSamples;
-    u32 numGrainSamples;
-    u32 sampleRate;
-    u32 aReserved[6];
+    void Allocate(u32 maxChannels, u32 maxSamples) {
+        numChannels = maxChannels;
+        stride = maxSamples;
+        data.assign(static_cast<size_t>(maxChannels) * maxSamples, 0.0f);
+    }
+
+    float* Channel(u32 channel) {
+        return data.data() + static_cast<size_t>(channel) * stride;
+    }
+
+    const float* Channel(u32 channel) const {
+        return data.data() + static_cast<size_t>(channel) * stride;
+    }
+
+    void Clear(u32 numSamples);
 };
 
-using OrbisNgs2BufferAllocHandler =
-    s32 PS4_SYSV_ABI (*)(OrbisNgs2ContextBufferInfo* io_buffer_info);
-using OrbisNgs2BufferFreeHandler = s32 PS4_SYSV_ABI (*)(OrbisNgs2ContextBufferInfo* io_buffer_info);
+// Piecewise linear volume envelope of sampler and submixer voices. The voice ramps from silence
+// through the forward points, holds the last one, and walks the release points once stopped.
+class Envelope {
+public:
+    s32 SetPoints(const OrbisNgs2EnvelopePoint* aPoint, u32 numForward, u32 numRelease,
+                  u32 maxPoints);
+    void Start();
+    void Release();
 
-struct OrbisNgs2SystemInfo {
-    char name[ORBIS_NGS2_SYSTEM_NAME_LENGTH]; // 0
+    // Scales the first numSamples of every channel. Returns false once the voice has faded out.
+    bool Apply(GrainBuffer& buffer, u32 numSamples, u32 sampleRate);
+
+    float GetHeight() const {
+        return height;
+    }
+
+private:
+    std::vector<OrbisNgs2EnvelopePoint> points;
+    u32 numForwardPoints{};
+    u32 nextPoint{};
+    u32 remaining{};
+    float height = 1.0f;
+    float target = 1.0f;
+    float step{};
+    bool releasing{};
+};
 
-    OrbisNgs2Handle systemHandle;          // 16
-    OrbisNgs2ContextBufferInfo bufferInfo; // 24
+// Second order IIR section, the EQ kernel behind the filter parameters of voices.
+class BiquadFilter {
+public:
+    s32 SetParam(u32 type, u32 channelMask, const float (&direct)[5], float fc, float q,
+                 float level, u32 sampleRate);
+    void Process(GrainBuffer& buffer, u32 numSamples);
 
-    u32 uid;             // 88
-    u32 minGrainSamples; // 92
-    u32 maxGrainSamples; // 96
+    bool IsBypassed() const {
+        return type == ORBIS_NGS2_FILTER_TYPE_BYPASS;
+    }
 
-    u32 stateFlags;        // 100
-    u32 rackCount;         // 104
-    float lastRenderRatio; // 108
-    s64 lastRenderTick;    // 112
-    s64 renderCount;       // 120
-    u32 sampleRate;        // 128
-    u32 numGrainSamples;   // 132
+private:
+    u32 type = ORBIS_NGS2_FILTER_TYPE_BYPASS;
+    u32 channelMask{};
+    float b0 = 1.0f;
+    float b1{};
+    float b2{};
+    float a1{};
+    float a2{};
+    std::array<std::array<float, 4>, ORBIS_NGS2_MAX_VOICE_CHANNELS> history{};
 };
 
-struct OrbisNgs2RackInfo {
-    char name[ORBIS_NGS2_RACK_NAME_LENGTH]; // 0
-
-    OrbisNgs2Handle rackHandle;            // 16
-    OrbisNgs2ContextBufferInfo bufferInfo; // 24
-
-    OrbisNgs2Handle ownerSystemHandle; // 88
-
-    u32 type;            // 96
-    u32 rackId;          // 100
-    u32 uid;             // 104
-    u32 minGrainSamples; // 108
-    u32 maxGrainSamples; // 112
-    u32 maxVoices;       // 116
-    u32 maxChannelWorks; // 120
-    u32 maxInputs;       // 124
-    u32 maxMatrices;     // 128
-    u32 maxPorts;        // 132
-
-    u32 stateFlags;             // 136
-    float lastProcessRatio;     // 140
-    u64 lastProcessTick;        // 144
-    u64 renderCount;            // 152
-    u32 activeVoiceCount;       // 160
-    u32 activeChannelWorkCount; // 164
+struct RackInternal;
+struct VoiceInternal;
+
+struct VoiceMatrix {
+    u32 numLevels{};
+    std::array<float, ORBIS_NGS2_MAX_MATRIX_LEVELS> aLevel{};
 };
 
-struct StackBuffer {
-    void** top;
-    void* base;
-    size_t size;
-    size_t currentOffset;
-    size_t usedSize;
-    size_t totalSize;
-    size_t alignment;
-    u8 flags;
-    char padding[7];
+struct VoicePort {
+    s32 matrixId{};
+    float volume = 1.0f;
+    u32 numDelaySamples{};
+    u32 destInputId{};
+    VoiceInternal* dest{};
+};
+
+struct VoiceInternal : HandleInternal {
+    RackInternal* rack{};
+    u32 index{};
+    GrainBuffer input; // Sum of the voices patched into this one, unused by samplers
+    std::vector<VoiceMatrix> matrices;
+    std::vector<VoicePort> ports;
+    OrbisNgs2VoiceCallbackHandler callbackHandler{};
+    uintptr_t callbackData{};
+    u32 callbackFlags{};
+};
+
+struct RenderContext {
+    u32 numGrainSamples;
+    u32 sampleRate;
+    std::span<GrainBuffer> outputs; // One per render buffer
+};
+
+// Rendering of one rack type. Racks keep the per voice state that is read every grain in arrays
+// indexed by voice, apart from the handles, so a grain walks contiguous memory.
+class RackProcessor {
+public:
+    virtual ~RackProcessor() = default;
+
+    // Applies a parameter specific to the rack type.
+    virtual s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                             const OrbisNgs2VoiceParamHeader& param) = 0;
+
+    // Lets the rack reset or release a voice after its state flags have changed.
+    virtual void VoiceEvent(RackInternal& rack, VoiceInternal& voice, u32 eventId) {}
+
+    // Renders one grain of every playing voice.
+    virtual void Process(RackInternal& rack, const RenderContext& context) = 0;
+
+    // Fills the rack specific state that follows OrbisNgs2VoiceState.
+    virtual void GetVoiceState(const RackInternal& rack, const VoiceInternal& voice,
+                               void* outState, size_t stateSize) const {}
+};
+
+struct RackInternal : HandleInternal {
+    u32 rackId{};
+    OrbisNgs2RackOption option{};
+    OrbisNgs2ContextBufferInfo bufferInfo{};
+    OrbisNgs2BufferFreeHandler hostFree{};
+    uintptr_t userData{};
+    std::vector<u32> stateFlags; // Walked every grain, kept apart from the voices
+    std::vector<VoiceInternal> voices;
+    std::unique_ptr<RackProcessor> processor;
+    u64 renderCount{};
+    u64 lastProcessTick{};
+    float lastProcessRatio{};
 };
 
 struct SystemInternal {
@@ -101,7 +186,7 @@ struct SystemInternal {
     void* unknown1;                           // 96
     void* unknown2;                           // 104
     OrbisNgs2Handle rackHandle;               // 112
-    uintptr_t* userData;                      // 120
+    uintptr_t userData;                       // 120
     SystemInternal* systemList;               // 128
     StackBuffer* stackBuffer;                 // 136
     OrbisNgs2SystemInfo ownerSystemInfo;      // 144
@@ -154,14 +239,10 @@ struct SystemInternal {
     u32 rackCount;              // 336
     float lastRenderRatio;      // 340
     float cpuLoad;              // 344
-};
 
-struct HandleInternal {
-    HandleInternal* selfPtr;    // 0
-    SystemInternal* systemData; // 8
-    std::atomic<int> refCount;  // 16
-    u32 handleType;             // 24
-    u32 handleID;               // 28
+    std::recursive_mutex lock;
+    std::vector<std::unique_ptr<RackInternal>> racks; // Sorted by rack id, the processing order
+    std::vector<GrainBuffer> outputs;
 };
 
 s32 StackBufferClose(StackBuffer* stackBuffer, size_t* outTotalSize);
@@ -169,11 +250,35 @@ s32 StackBufferOpen(StackBuffer* stackBuffer, void* buffer, size_t bufferSize, v
                     u8 flags);
 s32 SystemSetupCore(StackBuffer* stackBuffer, const OrbisNgs2SystemOption* option,
                     SystemInternal* outSystem);
+bool IsValidSampleRate(u32 sampleRate);
 
 s32 HandleReportInvalid(OrbisNgs2Handle handle, u32 handleType);
 void* MemoryClear(void* buffer, size_t size);
 s32 SystemCleanup(OrbisNgs2Handle systemHandle, OrbisNgs2ContextBufferInfo* outInfo);
 s32 SystemSetup(const OrbisNgs2SystemOption* option, OrbisNgs2ContextBufferInfo* hostBufferInfo,
                 OrbisNgs2BufferFreeHandler hostFree, OrbisNgs2Handle* outHandle);
+s32 SystemRender(SystemInternal* system, const OrbisNgs2RenderBufferInfo* aBufferInfo,
+                 u32 numBufferInfo);
+
+SystemInternal* GetSystem(OrbisNgs2Handle systemHandle);
+u32 EnumSystems(OrbisNgs2Handle* aOutHandle, u32 maxHandles);
+RackInternal* GetRack(OrbisNgs2Handle rackHandle);
+VoiceInternal* GetVoice(OrbisNgs2Handle voiceHandle);
+
+s32 RackCleanup(RackInternal* rack, OrbisNgs2ContextBufferInfo* outInfo);
+s32 RackSetup(SystemInternal* system, u32 rackId, const OrbisNgs2RackOption* option,
+              OrbisNgs2ContextBufferInfo* hostBufferInfo, OrbisNgs2BufferFreeHandler hostFree,
+              OrbisNgs2Handle* outHandle);
+std::unique_ptr<RackProcessor> CreateRackProcessor(u32 rackId, const OrbisNgs2RackOption* option);
+
+s32 VoiceControl(VoiceInternal* voice, const OrbisNgs2VoiceParamHeader* paramList);
+s32 VoiceGetState(VoiceInternal* voice, OrbisNgs2VoiceState* outState, size_t stateSize);
+
+// Kernels shared by the racks, vectorized with SSE2 where available
+void MixScaled(float* dst, const float* src, float gain, u32 numSamples);
+void ApplyGainRamp(float* data, u32 numSamples, float start, float step);
+void MixMatrix(GrainBuffer& dst, const GrainBuffer& src, const VoiceMatrix* matrix, float volume,
+               u32 numSamples);
+void MixToPorts(VoiceInternal& voice, const GrainBuffer& output, u32 numSamples);
 
 } // namespace Libraries::Ngs2
@@ -1,12 +1,164 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cmath>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_mastering.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+// Channel of the low frequency effects speaker in 5.1 and 7.1 layouts
+constexpr u32 LfeChannel = 3;
+
+// Time for the limiter gain to recover to unity after a peak
+constexpr float LimiterReleaseSeconds = 0.1f;
+
+Ngs2Mastering::Ngs2Mastering(const OrbisNgs2RackOption* option) {
+    u32 maxVoices = 1;
+    if (option) {
+        maxVoices = option->maxVoices;
+        if (option->size >= sizeof(OrbisNgs2MasteringRackOption)) {
+            maxChannels =
+                reinterpret_cast<const OrbisNgs2MasteringRackOption*>(option)->maxChannels;
+        }
+    }
+    voices.resize(maxVoices);
+}
+
+s32 Ngs2Mastering::VoiceControl(RackInternal& rack, VoiceInternal& handle,
+                                const OrbisNgs2VoiceParamHeader& header) {
+    Voice& voice = voices[handle.index];
+    switch (header.id) {
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_SETUP: {
+        const auto& param = reinterpret_cast<const OrbisNgs2MasteringVoiceSetupParam&>(header);
+        if (param.numInputChannels == 0 || param.numInputChannels > maxChannels ||
+            param.numInputChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid mastering channels ({})", param.numInputChannels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        handle.input.Clear(handle.input.stride);
+        handle.input.numChannels = param.numInputChannels;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_MATRIX: {
+        const auto& param = reinterpret_cast<const OrbisNgs2MasteringVoiceMatrixParam&>(header);
+        if (param.numLevels > ORBIS_NGS2_MAX_MATRIX_LEVELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid number of matrix levels ({})", param.numLevels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_MATRIX_LEVELS;
+        }
+        if (param.numLevels != 0 && !param.aLevel) {
+            LOG_ERROR(Lib_Ngs2, "Invalid matrix level address");
+            return ORBIS_NGS2_ERROR_INVALID_MATRIX_LEVEL_ADDRESS;
+        }
+        voice.matrix.numLevels = param.numLevels;
+        std::copy_n(param.aLevel, param.numLevels, voice.matrix.aLevel.begin());
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_LIMITER: {
+        const auto& param = reinterpret_cast<const OrbisNgs2MasteringVoiceLimiterParam&>(header);
+        voice.limiterEnabled = param.enableFlag != 0;
+        voice.limiterThreshold = param.threshold > 0.0f ? param.threshold : 1.0f;
+        voice.limiterGain = 1.0f;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_GAIN: {
+        const auto& param = reinterpret_cast<const OrbisNgs2MasteringVoiceGainParam&>(header);
+        voice.fbwLevel = param.fbwLevel;
+        voice.lfeLevel = param.lfeLevel;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_OUTPUT: {
+        const auto& param = reinterpret_cast<const OrbisNgs2MasteringVoiceOutputParam&>(header);
+        voice.outputId = param.outputId;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_LFE:
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_PEAK_METER:
+        LOG_DEBUG(Lib_Ngs2, "Ignoring mastering voice parameter {:#x}", header.id);
+        return ORBIS_OK;
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid mastering voice parameter ({:#x})", header.id);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+// Pulls the gain down to the threshold within the grain of a peak and lets it recover
+// exponentially afterwards.
+void Ngs2Mastering::Limit(Voice& voice, GrainBuffer& buffer, u32 numSamples, u32 sampleRate) {
+    float peak = 0.0f;
+    for (u32 channel = 0; channel < buffer.numChannels; channel++) {
+        const float* data = buffer.Channel(channel);
+        for (u32 i = 0; i < numSamples; i++) {
+            peak = std::max(peak, std::abs(data[i]));
+        }
+    }
+    voice.limiterPeak = peak;
+
+    const float recovery =
+        std::exp(-static_cast<float>(numSamples) / (LimiterReleaseSeconds * sampleRate));
+    float target = 1.0f - (1.0f - voice.limiterGain) * recovery;
+    if (peak * target > voice.limiterThreshold) {
+        target = voice.limiterThreshold / peak;
+    }
+    const float start = std::min(voice.limiterGain, target);
+    const float step = (target - start) / static_cast<float>(numSamples);
+    for (u32 channel = 0; channel < buffer.numChannels; channel++) {
+        ApplyGainRamp(buffer.Channel(channel), numSamples, start, step);
+    }
+    voice.limiterGain = target;
+}
+
+void Ngs2Mastering::Process(RackInternal& rack, const RenderContext& context) {
+    const u32 numSamples = context.numGrainSamples;
+    if (mix.stride < numSamples) {
+        mix.Allocate(ORBIS_NGS2_MAX_VOICE_CHANNELS, rack.systemData->maxGrainSamples);
+    }
+    for (u32 index = 0; index < voices.size(); index++) {
+        VoiceInternal& handle = rack.voices[index];
+        const u32 stateFlags = rack.stateFlags[index];
+        Voice& voice = voices[index];
+        if ((stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) != 0 &&
+            (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED) == 0 &&
+            voice.outputId < context.outputs.size()) {
+            GrainBuffer& output = context.outputs[voice.outputId];
+            mix.numChannels = output.numChannels;
+            mix.Clear(numSamples);
+            MixMatrix(mix, handle.input, voice.matrix.numLevels != 0 ? &voice.matrix : nullptr,
+                      1.0f, numSamples);
+
+            for (u32 channel = 0; channel < mix.numChannels; channel++) {
+                const bool isLfe = mix.numChannels >= 6 && channel == LfeChannel;
+                ApplyGainRamp(mix.Channel(channel), numSamples,
+                              isLfe ? voice.lfeLevel : voice.fbwLevel, 0.0f);
+            }
+            if (voice.limiterEnabled) {
+                Limit(voice, mix, numSamples, context.sampleRate);
+            }
+            for (u32 channel = 0; channel < mix.numChannels; channel++) {
+                MixScaled(output.Channel(channel), mix.Channel(channel), 1.0f, numSamples);
+            }
+        }
+        handle.input.Clear(numSamples);
+    }
+}
+
+void Ngs2Mastering::GetVoiceState(const RackInternal& rack, const VoiceInternal& handle,
+                                  void* outState, size_t stateSize) const {
+    if (stateSize < sizeof(OrbisNgs2MasteringVoiceState)) {
+        return;
+    }
+    const Voice& voice = voices[handle.index];
+    auto* state = static_cast<OrbisNgs2MasteringVoiceState*>(outState);
+    state->limiterPeakLevel = voice.limiterPeak;
+    state->limiterPressLevel = voice.limiterGain;
+}
+
+} // namespace Libraries::Ngs2
@@ -3,11 +3,17 @@
 
 #pragma once
 
-#include "ngs2.h"
+#include "ngs2_impl.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Mastering;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_SETUP = 0x30000001;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_MATRIX = 0x30000002;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_LFE = 0x30000003;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_LIMITER = 0x30000004;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_GAIN = 0x30000005;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_OUTPUT = 0x30000006;
+static const u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_PEAK_METER = 0x30000007;
 
 struct OrbisNgs2MasteringRackOption {
     OrbisNgs2RackOption rackOption;
@@ -78,4 +84,35 @@ struct OrbisNgs2MasteringRackInfo {
     u32 reserved;
 };
 
+// Mixes its inputs down to the layout of a render buffer, applies the output gains and a peak
+// limiter, and adds the result to that buffer.
+class Ngs2Mastering final : public RackProcessor {
+public:
+    explicit Ngs2Mastering(const OrbisNgs2RackOption* option);
+
+    s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                     const OrbisNgs2VoiceParamHeader& param) override;
+    void Process(RackInternal& rack, const RenderContext& context) override;
+    void GetVoiceState(const RackInternal& rack, const VoiceInternal& voice, void* outState,
+                       size_t stateSize) const override;
+
+private:
+    struct Voice {
+        VoiceMatrix matrix;
+        u32 outputId{};
+        float fbwLevel = 1.0f;
+        float lfeLevel = 1.0f;
+        bool limiterEnabled{};
+        float limiterThreshold = 1.0f;
+        float limiterGain = 1.0f;
+        float limiterPeak{};
+    };
+
+    void Limit(Voice& voice, GrainBuffer& buffer, u32 numSamples, u32 sampleRate);
+
+    u32 maxChannels = ORBIS_NGS2_MAX_VOICE_CHANNELS;
+    std::vector<Voice> voices;
+    GrainBuffer mix;
+};
+
 } // namespace Libraries::Ngs2
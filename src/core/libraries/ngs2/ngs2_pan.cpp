@@ -1,12 +1,159 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_pan.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+// Speaker of the low frequency effects channel in 5.1 and 7.1 layouts, it takes no part in panning
+constexpr u32 PanLfeSpeaker = 3;
+
+// ITU layouts in degrees, clockwise from the front: L, R, C, LFE, Ls, Rs, Lb, Rb
+constexpr std::array<float, 2> StereoAngles = {-30.0f, 30.0f};
+constexpr std::array<float, 6> Surround51Angles = {-30.0f, 30.0f, 0.0f, 0.0f, -110.0f, 110.0f};
+constexpr std::array<float, 8> Surround71Angles = {-30.0f, 30.0f,  0.0f,    0.0f,
+                                                   -90.0f, 90.0f, -150.0f, 150.0f};
+
+static bool HasLfe(u32 numSpeakers) {
+    return numSpeakers >= 6;
+}
+
+static float WrapAngle(float angle) {
+    constexpr float TwoPi = 2.0f * std::numbers::pi_v<float>;
+    angle = std::fmod(angle + std::numbers::pi_v<float>, TwoPi);
+    return (angle < 0.0f ? angle + TwoPi : angle) - std::numbers::pi_v<float>;
+}
+
+s32 PanInit(OrbisNgs2PanWork* work, const float* aSpeakerAngle, float unitAngle, u32 numSpeakers) {
+    if (!work) {
+        LOG_ERROR(Lib_Ngs2, "Invalid pan work address");
+        return ORBIS_NGS2_ERROR_INVALID_PAN_WORK;
+    }
+    if (!(unitAngle > 0.0f)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid pan unit angle ({})", unitAngle);
+        return ORBIS_NGS2_ERROR_INVALID_PAN_UNIT_ANGLE;
+    }
+    std::span<const float> defaultAngles;
+    switch (numSpeakers) {
+    case 2:
+        defaultAngles = StereoAngles;
+        break;
+    case 6:
+        defaultAngles = Surround51Angles;
+        break;
+    case 8:
+        defaultAngles = Surround71Angles;
+        break;
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid pan speakers ({})", numSpeakers);
+        return ORBIS_NGS2_ERROR_INVALID_PAN_SPEAKER;
+    }
+
+    // Angles are kept in radians, the unit only applies to the guest values
+    constexpr float DegreeToRadian = std::numbers::pi_v<float> / 180.0f;
+    for (u32 i = 0; i < numSpeakers; i++) {
+        work->aSpeakerAngle[i] = aSpeakerAngle ? WrapAngle(aSpeakerAngle[i] * unitAngle)
+                                               : defaultAngles[i] * DegreeToRadian;
+    }
+    work->unitAngle = unitAngle;
+    work->numSpeakers = numSpeakers;
+    return ORBIS_OK;
+}
+
+// Constant power panning between the two speakers around the source, blended towards an even
+// spread over every speaker as the source comes closer than distance 1.
+static void PanSource(const OrbisNgs2PanWork& work, const OrbisNgs2PanParam& param,
+                      u32 numOutputs, float* outLevels) {
+    std::fill_n(outLevels, numOutputs, 0.0f);
+    if (numOutputs == 1) {
+        outLevels[0] = param.fbwLevel;
+        return;
+    }
+
+    const u32 numSpeakers = std::min(work.numSpeakers, numOutputs);
+    std::array<u32, ORBIS_NGS2_MAX_VOICE_CHANNELS> order{};
+    u32 numPanned = 0;
+    for (u32 i = 0; i < numSpeakers; i++) {
+        if (!HasLfe(numSpeakers) || i != PanLfeSpeaker) {
+            order[numPanned++] = i;
+        }
+    }
+    std::sort(order.begin(), order.begin() + numPanned,
+              [&](u32 a, u32 b) { return work.aSpeakerAngle[a] < work.aSpeakerAngle[b]; });
+
+    // Find the pair of neighbouring speakers around the source, wrapping behind the listener
+    const float angle = WrapAngle(param.angle * work.unitAngle);
+    u32 first = order[numPanned - 1];
+    u32 second = order[0];
+    for (u32 i = 0; i + 1 < numPanned; i++) {
+        if (angle >= work.aSpeakerAngle[order[i]] && angle < work.aSpeakerAngle[order[i + 1]]) {
+            first = order[i];
+            second = order[i + 1];
+            break;
+        }
+    }
+    float span = WrapAngle(work.aSpeakerAngle[second] - work.aSpeakerAngle[first]);
+    float offset = WrapAngle(angle - work.aSpeakerAngle[first]);
+    if (span <= 0.0f) {
+        span += 2.0f * std::numbers::pi_v<float>;
+    }
+    if (offset < 0.0f) {
+        offset += 2.0f * std::numbers::pi_v<float>;
+    }
+    const float t = std::clamp(offset / span, 0.0f, 1.0f) * std::numbers::pi_v<float> * 0.5f;
+
+    const float focus = std::clamp(param.distance, 0.0f, 1.0f);
+    const float spread = (1.0f - focus) / static_cast<float>(numPanned);
+    for (u32 i = 0; i < numPanned; i++) {
+        const u32 speaker = order[i];
+        float direct = 0.0f;
+        if (speaker == first) {
+            direct = std::cos(t);
+        } else if (speaker == second) {
+            direct = std::sin(t);
+        }
+        outLevels[speaker] = std::sqrt(focus * direct * direct + spread) * param.fbwLevel;
+    }
+    if (HasLfe(numSpeakers)) {
+        outLevels[PanLfeSpeaker] = param.lfeLevel;
+    }
+}
+
+s32 PanGetVolumeMatrix(OrbisNgs2PanWork* work, const OrbisNgs2PanParam* aParam, u32 numParams,
+                       u32 matrixFormat, float* outVolumeMatrix) {
+    if (!work || work->numSpeakers == 0 || work->numSpeakers > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+        LOG_ERROR(Lib_Ngs2, "Invalid pan work");
+        return ORBIS_NGS2_ERROR_INVALID_PAN_WORK;
+    }
+    if (!aParam || numParams == 0 || numParams > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+        LOG_ERROR(Lib_Ngs2, "Invalid pan parameters ({})", numParams);
+        return ORBIS_NGS2_ERROR_INVALID_PAN_PARAM;
+    }
+    // The matrix format is the number of output channels
+    if (matrixFormat != 1 && matrixFormat != 2 && matrixFormat != 6 && matrixFormat != 8) {
+        LOG_ERROR(Lib_Ngs2, "Invalid pan matrix format ({})", matrixFormat);
+        return ORBIS_NGS2_ERROR_INVALID_PAN_MATRIX_FORMAT;
+    }
+    if (!outVolumeMatrix) {
+        LOG_ERROR(Lib_Ngs2, "Invalid volume matrix address");
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    for (u32 i = 0; i < numParams; i++) {
+        PanSource(*work, aParam[i], matrixFormat, outVolumeMatrix + i * matrixFormat);
+    }
+    return ORBIS_OK;
+}
+
+} // namespace Libraries::Ngs2
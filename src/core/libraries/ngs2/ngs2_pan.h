@@ -22,4 +22,8 @@ struct OrbisNgs2PanWork {
     u32 numSpeakers;
 };
 
+s32 PanInit(OrbisNgs2PanWork* work, const float* aSpeakerAngle, float unitAngle, u32 numSpeakers);
+s32 PanGetVolumeMatrix(OrbisNgs2PanWork* work, const OrbisNgs2PanParam* aParam, u32 numParams,
+                       u32 matrixFormat, float* outVolumeMatrix);
+
 } // namespace Libraries::Ngs2
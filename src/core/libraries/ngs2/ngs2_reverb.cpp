@@ -1,12 +1,156 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cmath>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_reverb.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+// Delay lengths at 48 kHz, mutually prime so the echoes do not line up
+constexpr std::array<u32, 4> CombDelays = {1557, 1617, 1491, 1422};
+constexpr std::array<u32, 4> AllpassDelays = {556, 441, 579, 464};
+constexpr float AllpassFeedback = 0.5f;
+
+float Ngs2Reverb::ProcessComb(DelayLine& line, float input) {
+    const float output = line.buffer[line.position];
+    line.filterState = output * (1.0f - line.damping) + line.filterState * line.damping;
+    line.buffer[line.position] = input + line.filterState * line.feedback;
+    line.position = line.position + 1 == line.buffer.size() ? 0 : line.position + 1;
+    return output;
+}
+
+float Ngs2Reverb::ProcessAllpass(DelayLine& line, float input) {
+    const float delayed = line.buffer[line.position];
+    line.buffer[line.position] = input + delayed * AllpassFeedback;
+    line.position = line.position + 1 == line.buffer.size() ? 0 : line.position + 1;
+    return delayed - input;
+}
+
+Ngs2Reverb::Ngs2Reverb(const OrbisNgs2RackOption* option) {
+    u32 maxVoices = 1;
+    if (option) {
+        maxVoices = option->maxVoices;
+        if (option->size >= sizeof(OrbisNgs2ReverbRackOption)) {
+            maxChannels = reinterpret_cast<const OrbisNgs2ReverbRackOption*>(option)->maxChannels;
+        }
+    }
+    voices.resize(maxVoices);
+}
+
+void Ngs2Reverb::Tune(Voice& voice, const OrbisNgs2ReverbI3DL2Param& param, u32 sampleRate) {
+    const float scale = static_cast<float>(sampleRate) / 48000.0f;
+    const float decayTime = std::max(param.decayTime, 0.1f);
+    const float damping = std::clamp(1.0f - param.decayHFRatio, 0.0f, 0.9f);
+    for (u32 i = 0; i < voice.combs.size(); i++) {
+        DelayLine& comb = voice.combs[i];
+        const u32 length = std::max(static_cast<u32>(CombDelays[i] * scale), 1u);
+        comb.buffer.assign(length, 0.0f);
+        comb.position = 0;
+        comb.filterState = 0.0f;
+        comb.damping = damping;
+        // Each pass through the comb decays by the share of 60 dB its length is of decayTime
+        comb.feedback = std::pow(10.0f, -3.0f * length / (decayTime * sampleRate));
+    }
+    for (u32 i = 0; i < voice.allpasses.size(); i++) {
+        DelayLine& allpass = voice.allpasses[i];
+        allpass.buffer.assign(std::max(static_cast<u32>(AllpassDelays[i] * scale), 1u), 0.0f);
+        allpass.position = 0;
+    }
+    // Levels are in millibels
+    voice.dry = param.dry;
+    voice.wet =
+        param.wet * std::pow(10.0f, static_cast<float>(param.room + param.reverb) / 2000.0f);
+}
+
+s32 Ngs2Reverb::VoiceControl(RackInternal& rack, VoiceInternal& handle,
+                             const OrbisNgs2VoiceParamHeader& header) {
+    Voice& voice = voices[handle.index];
+    switch (header.id) {
+    case ORBIS_NGS2_REVERB_VOICE_PARAM_SETUP: {
+        const auto& param = reinterpret_cast<const OrbisNgs2ReverbVoiceSetupParam&>(header);
+        if (param.numInputChannels == 0 || param.numInputChannels > maxChannels ||
+            param.numInputChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS ||
+            param.numOutputChannels == 0 ||
+            param.numOutputChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid reverb channels ({}, {})", param.numInputChannels,
+                      param.numOutputChannels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        handle.input.Clear(handle.input.stride);
+        handle.input.numChannels = param.numInputChannels;
+        voice.numOutputChannels = param.numOutputChannels;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_REVERB_VOICE_PARAM_I3DL2: {
+        const auto& param = reinterpret_cast<const OrbisNgs2ReverbVoiceI3DL2Param&>(header);
+        Tune(voice, param.i3dl2, handle.systemData->currentSampleRate);
+        return ORBIS_OK;
+    }
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid reverb voice parameter ({:#x})", header.id);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+void Ngs2Reverb::Reverberate(Voice& voice, const GrainBuffer& input, u32 numSamples) {
+    std::fill_n(mono.begin(), numSamples, 0.0f);
+    const float inputScale = 1.0f / static_cast<float>(input.numChannels);
+    for (u32 channel = 0; channel < input.numChannels; channel++) {
+        MixScaled(mono.data(), input.Channel(channel), inputScale, numSamples);
+    }
+
+    float* left = output.Channel(0);
+    float* right = output.numChannels > 1 ? output.Channel(1) : nullptr;
+    for (u32 i = 0; i < numSamples; i++) {
+        const float c0 = ProcessComb(voice.combs[0], mono[i]);
+        const float c1 = ProcessComb(voice.combs[1], mono[i]);
+        const float c2 = ProcessComb(voice.combs[2], mono[i]);
+        const float c3 = ProcessComb(voice.combs[3], mono[i]);
+        float wetLeft = c0 + c1 + c2 + c3;
+        float wetRight = c0 - c1 + c2 - c3;
+        wetLeft = ProcessAllpass(voice.allpasses[1], ProcessAllpass(voice.allpasses[0], wetLeft));
+        wetRight =
+            ProcessAllpass(voice.allpasses[3], ProcessAllpass(voice.allpasses[2], wetRight));
+        if (right) {
+            left[i] += wetLeft * voice.wet;
+            right[i] += wetRight * voice.wet;
+        } else {
+            left[i] += (wetLeft + wetRight) * 0.5f * voice.wet;
+        }
+    }
+}
+
+void Ngs2Reverb::Process(RackInternal& rack, const RenderContext& context) {
+    const u32 numSamples = context.numGrainSamples;
+    if (output.stride < numSamples) {
+        output.Allocate(ORBIS_NGS2_MAX_VOICE_CHANNELS, rack.systemData->maxGrainSamples);
+        mono.resize(rack.systemData->maxGrainSamples);
+    }
+    for (u32 index = 0; index < voices.size(); index++) {
+        VoiceInternal& handle = rack.voices[index];
+        const u32 stateFlags = rack.stateFlags[index];
+        if ((stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) != 0 &&
+            (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED) == 0) {
+            Voice& voice = voices[index];
+            output.numChannels = voice.numOutputChannels;
+            output.Clear(numSamples);
+            MixMatrix(output, handle.input, nullptr, voice.dry, numSamples);
+            if (voice.wet != 0.0f && !voice.combs[0].buffer.empty()) {
+                Reverberate(voice, handle.input, numSamples);
+            }
+            MixToPorts(handle, output, numSamples);
+        }
+        handle.input.Clear(numSamples);
+    }
+}
+
+} // namespace Libraries::Ngs2
@@ -3,11 +3,12 @@
 
 #pragma once
 
-#include "ngs2.h"
+#include "ngs2_impl.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Reverb;
+static const u32 ORBIS_NGS2_REVERB_VOICE_PARAM_SETUP = 0x20010001;
+static const u32 ORBIS_NGS2_REVERB_VOICE_PARAM_I3DL2 = 0x20010002;
 
 struct OrbisNgs2ReverbRackOption {
     OrbisNgs2RackOption rackOption;
@@ -58,4 +59,42 @@ struct OrbisNgs2ReverbRackInfo {
     u32 reverbSize;
 };
 
+// Schroeder reverberator, four parallel damped combs into a pair of allpasses per side, tuned from
+// the I3DL2 parameters. Without parameters a voice passes its input through dry.
+class Ngs2Reverb final : public RackProcessor {
+public:
+    explicit Ngs2Reverb(const OrbisNgs2RackOption* option);
+
+    s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                     const OrbisNgs2VoiceParamHeader& param) override;
+    void Process(RackInternal& rack, const RenderContext& context) override;
+
+private:
+    struct DelayLine {
+        std::vector<float> buffer;
+        u32 position{};
+        float feedback{};
+        float damping{};
+        float filterState{};
+    };
+
+    struct Voice {
+        u32 numOutputChannels = 2;
+        float dry = 1.0f;
+        float wet{};
+        std::array<DelayLine, 4> combs;
+        std::array<DelayLine, 4> allpasses; // Two per side of the stereo field
+    };
+
+    static float ProcessComb(DelayLine& line, float input);
+    static float ProcessAllpass(DelayLine& line, float input);
+    void Tune(Voice& voice, const OrbisNgs2ReverbI3DL2Param& param, u32 sampleRate);
+    void Reverberate(Voice& voice, const GrainBuffer& input, u32 numSamples);
+
+    u32 maxChannels = 2;
+    std::vector<Voice> voices;
+    std::vector<float> mono;
+    GrainBuffer output;
+};
+
 } // namespace Libraries::Ngs2
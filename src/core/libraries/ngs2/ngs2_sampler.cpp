@@ -1,12 +1,451 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_sampler.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
+// SIMD support detection
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define HAS_SSE2
+#endif
+
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+// Frames decoded at once; every resampled run fits in this plus one frame of lookahead
+constexpr u32 MaxSourceFrames = 2048;
+
+static u32 GetSampleSize(u32 waveformType) {
+    switch (waveformType) {
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I8:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_U8:
+        return 1;
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16B:
+        return 2;
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24B:
+        return 3;
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32B:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32B:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+template <typename T>
+static T Load(const u8* src, bool bigEndian) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return bigEndian ? std::byteswap(value) : value;
+}
+
+template <typename Convert>
+static void Deinterleave(const u8* src, u32 sampleSize, u32 numChannels, u32 numFrames,
+                         float* dst, u32 dstStride, Convert convert) {
+    for (u32 channel = 0; channel < numChannels; channel++) {
+        const u8* in = src + channel * sampleSize;
+        float* out = dst + channel * dstStride;
+        for (u32 frame = 0; frame < numFrames; frame++) {
+            out[frame] = convert(in + frame * numChannels * sampleSize);
+        }
+    }
+}
+
+// Converts interleaved PCM frames to one float array per channel
+static void DecodeFrames(const u8* src, u32 waveformType, u32 numChannels, u32 numFrames,
+                         float* dst, u32 dstStride) {
+    const u32 sampleSize = GetSampleSize(waveformType);
+    switch (waveformType) {
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I8:
+        Deinterleave(src, sampleSize, numChannels, numFrames, dst, dstStride,
+                     [](const u8* in) { return static_cast<s8>(*in) / 128.0f; });
+        break;
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_U8:
+        Deinterleave(src, sampleSize, numChannels, numFrames, dst, dstStride,
+                     [](const u8* in) { return (static_cast<s32>(*in) - 128) / 128.0f; });
+        break;
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16B: {
+        const bool bigEndian = waveformType == ORBIS_NGS2_WAVEFORM_TYPE_PCM_I16B;
+        Deinterleave(src, sampleSize, numChannels, numFrames, dst, dstStride,
+                     [bigEndian](const u8* in) { return Load<s16>(in, bigEndian) / 32768.0f; });
+        break;
+    }
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24B: {
+        const bool bigEndian = waveformType == ORBIS_NGS2_WAVEFORM_TYPE_PCM_I24B;
+        Deinterleave(src, sampleSize, numChannels, numFrames, dst, dstStride,
+                     [bigEndian](const u8* in) {
+                         const u32 value = bigEndian ? (in[0] << 24) | (in[1] << 16) | (in[2] << 8)
+                                                     : (in[2] << 24) | (in[1] << 16) | (in[0] << 8);
+                         return static_cast<s32>(value) / 2147483648.0f;
+                     });
+        break;
+    }
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32B: {
+        const bool bigEndian = waveformType == ORBIS_NGS2_WAVEFORM_TYPE_PCM_I32B;
+        Deinterleave(src, sampleSize, numChannels, numFrames, dst, dstStride,
+                     [bigEndian](const u8* in) {
+                         return Load<s32>(in, bigEndian) / 2147483648.0f;
+                     });
+        break;
+    }
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32L:
+    case ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32B: {
+        const bool bigEndian = waveformType == ORBIS_NGS2_WAVEFORM_TYPE_PCM_F32B;
+        Deinterleave(src, sampleSize, numChannels, numFrames, dst, dstStride,
+                     [bigEndian](const u8* in) {
+                         return std::bit_cast<float>(Load<u32>(in, bigEndian));
+                     });
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Linear interpolation from a 32.32 fixed point position advancing by step per output. The
+// source must hold one frame past the last position.
+static void Resample(const float* src, u64 position, u64 step, float* dst, u32 numSamples) {
+    if (step == (1ULL << 32) && (position & 0xFFFFFFFF) == 0) {
+        std::copy_n(src + (position >> 32), numSamples, dst);
+        return;
+    }
+    constexpr float FractionScale = 1.0f / (1 << 24);
+    u32 i = 0;
+#if defined(HAS_SSE2)
+    const __m128 scale = _mm_set1_ps(FractionScale);
+    for (; i + 4 <= numSamples; i += 4) {
+        alignas(16) float a[4];
+        alignas(16) float b[4];
+        alignas(16) s32 fraction[4];
+        for (u32 lane = 0; lane < 4; lane++) {
+            const u64 pos = position + (i + lane) * step;
+            a[lane] = src[pos >> 32];
+            b[lane] = src[(pos >> 32) + 1];
+            fraction[lane] = static_cast<s32>((pos & 0xFFFFFFFF) >> 8);
+        }
+        const __m128 va = _mm_load_ps(a);
+        const __m128 vb = _mm_load_ps(b);
+        const __m128 t = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(fraction))), scale);
+        _mm_storeu_ps(dst + i, _mm_add_ps(va, _mm_mul_ps(t, _mm_sub_ps(vb, va))));
+    }
+#endif
+    for (; i < numSamples; i++) {
+        const u64 pos = position + i * step;
+        const float t = static_cast<float>((pos & 0xFFFFFFFF) >> 8) * FractionScale;
+        const float a = src[pos >> 32];
+        dst[i] = a + t * (src[(pos >> 32) + 1] - a);
+    }
+}
+
+// Frames a block covers, limited to the data it points at
+static u32 GetBlockFrames(const OrbisNgs2WaveformBlock& block, u32 frameSize) {
+    const u32 dataFrames = block.dataSize / frameSize;
+    return block.numSamples != 0 ? std::min(block.numSamples, dataFrames) : dataFrames;
+}
+
+Ngs2Sampler::Ngs2Sampler(const OrbisNgs2RackOption* option) {
+    u32 maxVoices = 1;
+    if (option) {
+        maxVoices = option->maxVoices;
+        if (option->size >= sizeof(OrbisNgs2SamplerRackOption)) {
+            const auto* samplerOption = reinterpret_cast<const OrbisNgs2SamplerRackOption*>(option);
+            maxWaveformBlocks = samplerOption->maxWaveformBlocks;
+            maxEnvelopePoints = samplerOption->maxEnvelopePoints;
+            maxFilters = samplerOption->maxFilters;
+        }
+    }
+    voices.resize(maxVoices);
+    for (Voice& voice : voices) {
+        voice.filters.resize(maxFilters);
+        voice.numFilters = maxFilters;
+    }
+    source.resize(ORBIS_NGS2_MAX_VOICE_CHANNELS * (MaxSourceFrames + 1));
+}
+
+void Ngs2Sampler::Rewind(Voice& voice) {
+    voice.blockIndex = 0;
+    voice.numRepeated = 0;
+    voice.exitLoop = false;
+    voice.position = voice.blocks.empty() ? 0 : u64(voice.blocks[0].numSkipSamples) << 32;
+}
+
+s32 Ngs2Sampler::VoiceControl(RackInternal& rack, VoiceInternal& handle,
+                              const OrbisNgs2VoiceParamHeader& header) {
+    Voice& voice = voices[handle.index];
+    switch (header.id) {
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_SETUP: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SamplerVoiceSetupParam&>(header);
+        const OrbisNgs2WaveformFormat& format = param.format;
+        if (format.numChannels == 0 || format.numChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid waveform channels ({})", format.numChannels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        if (format.sampleRate == 0) {
+            LOG_ERROR(Lib_Ngs2, "Invalid waveform sample rate ({})", format.sampleRate);
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_SAMPLE_RATE;
+        }
+        const u32 sampleSize = GetSampleSize(format.waveformType);
+        if (sampleSize == 0) {
+            // Compressed waveforms are accepted so the game keeps running, the voice is silent
+            LOG_ERROR(Lib_Ngs2, "Unsupported waveform type ({:#x})", format.waveformType);
+        }
+        voice.format = format;
+        voice.frameSize = sampleSize * format.numChannels;
+        voice.blocks.clear();
+        Rewind(voice);
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_BLOCKS: {
+        const auto& param =
+            reinterpret_cast<const OrbisNgs2SamplerVoiceWaveformBlocksParam&>(header);
+        if (param.numBlocks > maxWaveformBlocks) {
+            LOG_ERROR(Lib_Ngs2, "Invalid number of waveform blocks ({}>{})", param.numBlocks,
+                      maxWaveformBlocks);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_WAVEFORM_BLOCKS;
+        }
+        if (param.numBlocks != 0 && !param.aBlock) {
+            LOG_ERROR(Lib_Ngs2, "Invalid waveform block address");
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_BLOCK_ADDRESS;
+        }
+        voice.data = static_cast<const u8*>(param.data);
+        voice.blocks.assign(param.aBlock, param.aBlock + param.numBlocks);
+        Rewind(voice);
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_ADDRESS: {
+        const auto& param =
+            reinterpret_cast<const OrbisNgs2SamplerVoiceWaveformAddressParam&>(header);
+        if (voice.data == param.from) {
+            voice.data = static_cast<const u8*>(param.to);
+        }
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_FRAME_OFFSET: {
+        const auto& param =
+            reinterpret_cast<const OrbisNgs2SamplerVoiceWaveformFrameOffsetParam&>(header);
+        voice.position = u64(param.frameOffset) << 32;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_EXIT_LOOP:
+        voice.exitLoop = true;
+        return ORBIS_OK;
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_PITCH: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SamplerVoicePitchParam&>(header);
+        voice.pitch = std::clamp(param.ratio, 1.0f / 64.0f, 64.0f);
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_ENVELOPE: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SamplerVoiceEnvelopeParam&>(header);
+        return voice.envelope.SetPoints(param.aPoint, param.numForwardPoints,
+                                        param.numReleasePoints, maxEnvelopePoints);
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_FILTER: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SamplerVoiceFilterParam&>(header);
+        if (param.index >= voice.filters.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid filter index ({})", param.index);
+            return ORBIS_NGS2_ERROR_INVALID_FILTER_INDEX;
+        }
+        const auto& direct = param.param.direct;
+        const float coefficients[5] = {direct.i0, direct.i1, direct.i2, direct.o1, direct.o2};
+        return voice.filters[param.index].SetParam(
+            param.type, param.channelMask, coefficients, param.param.fcq.fc, param.param.fcq.q,
+            param.param.fcq.level, handle.systemData->currentSampleRate);
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_NUM_FILTERS: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SamplerVoiceNumFilters&>(header);
+        if (param.numFilters > maxFilters) {
+            LOG_ERROR(Lib_Ngs2, "Invalid number of filters ({}>{})", param.numFilters,
+                      maxFilters);
+            return ORBIS_NGS2_ERROR_INVALID_MAX_FILTERS;
+        }
+        voice.numFilters = param.numFilters;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_DISTORTION:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_USER_FX:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_PEAK_METER:
+        LOG_DEBUG(Lib_Ngs2, "Ignoring sampler voice parameter {:#x}", header.id);
+        return ORBIS_OK;
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid sampler voice parameter ({:#x})", header.id);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+void Ngs2Sampler::VoiceEvent(RackInternal& rack, VoiceInternal& handle, u32 eventId) {
+    Voice& voice = voices[handle.index];
+    switch (eventId) {
+    case ORBIS_NGS2_VOICE_EVENT_PLAY:
+        Rewind(voice);
+        voice.numDecodedSamples = 0;
+        voice.decodedDataSize = 0;
+        voice.envelope.Start();
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_STOP:
+        voice.envelope.Release();
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_KILL:
+        voice = Voice{};
+        voice.filters.resize(maxFilters);
+        voice.numFilters = maxFilters;
+        break;
+    default:
+        break;
+    }
+}
+
+void Ngs2Sampler::EndBlock(RackInternal& rack, u32 index) {
+    Voice& voice = voices[index];
+    const OrbisNgs2WaveformBlock block = voice.blocks[voice.blockIndex];
+    const u32 numRepeated = voice.numRepeated;
+    const u64 overshoot = voice.position - (u64(GetBlockFrames(block, voice.frameSize)) << 32);
+    if (!voice.exitLoop && voice.numRepeated < block.numRepeats) {
+        voice.numRepeated++;
+        voice.position = (u64(block.numSkipSamples) << 32) + overshoot;
+    } else {
+        voice.blockIndex++;
+        voice.numRepeated = 0;
+        voice.exitLoop = false;
+        voice.position = overshoot;
+        if (voice.blockIndex < voice.blocks.size()) {
+            voice.position += u64(voice.blocks[voice.blockIndex].numSkipSamples) << 32;
+        }
+    }
+
+    // Runs after the voice moved on, so a callback that queues new blocks starts from them
+    VoiceInternal& handle = rack.voices[index];
+    if (handle.callbackHandler &&
+        (handle.callbackFlags & ORBIS_NGS2_VOICE_CALLBACK_FLAG_WAVEFORM_BLOCK_END)) {
+        OrbisNgs2VoiceCallbackInfo info{};
+        info.callbackData = handle.callbackData;
+        info.voiceHandle = reinterpret_cast<OrbisNgs2Handle>(static_cast<HandleInternal*>(&handle));
+        info.flag = ORBIS_NGS2_VOICE_CALLBACK_FLAG_WAVEFORM_BLOCK_END;
+        info.param.waveformBlock.userData = block.userData;
+        info.param.waveformBlock.data = voice.data + block.dataOffset;
+        info.param.waveformBlock.dataSize = block.dataSize;
+        info.param.waveformBlock.repeatedCount = numRepeated;
+        handle.callbackHandler(&info);
+    }
+}
+
+u32 Ngs2Sampler::Render(RackInternal& rack, u32 index, u32 numSamples, u32 sampleRate) {
+    Voice& voice = voices[index];
+    if (voice.frameSize == 0 || !voice.data) {
+        return 0;
+    }
+    const u64 step =
+        std::max<u64>(static_cast<u64>(static_cast<double>(voice.pitch) * voice.format.sampleRate /
+                                       sampleRate * 4294967296.0),
+                      1);
+    const u32 numChannels = voice.format.numChannels;
+    const u32 sourceStride = MaxSourceFrames + 1;
+    const u64 maxRun = std::max<u64>((u64(MaxSourceFrames - 1) << 32) / step, 1);
+
+    u32 offset = 0;
+    while (offset < numSamples && voice.blockIndex < voice.blocks.size()) {
+        const OrbisNgs2WaveformBlock& block = voice.blocks[voice.blockIndex];
+        const u32 numFrames = GetBlockFrames(block, voice.frameSize);
+        if (voice.position >= u64(numFrames) << 32) {
+            EndBlock(rack, index);
+            continue;
+        }
+
+        // Resample the outputs whose position stays inside the block
+        const u64 blockRemaining = (u64(numFrames) << 32) - voice.position;
+        const u32 count = static_cast<u32>(
+            std::min<u64>({numSamples - offset, (blockRemaining + step - 1) / step, maxRun}));
+        const u32 frame = static_cast<u32>(voice.position >> 32);
+        const u64 fraction = voice.position & 0xFFFFFFFF;
+        const u32 numSource =
+            std::min(static_cast<u32>((fraction + (count - 1) * step) >> 32) + 2,
+                     numFrames - frame);
+
+        const u8* data = voice.data + block.dataOffset + u64(frame) * voice.frameSize;
+        DecodeFrames(data, voice.format.waveformType, numChannels, numSource, source.data(),
+                     sourceStride);
+        for (u32 channel = 0; channel < numChannels; channel++) {
+            float* channelSource = source.data() + channel * sourceStride;
+            // The frame after the block end repeats the last one
+            channelSource[numSource] = channelSource[numSource - 1];
+            Resample(channelSource, fraction, step, output.Channel(channel) + offset, count);
+        }
+
+        voice.position += count * step;
+        voice.numDecodedSamples += numSource;
+        voice.decodedDataSize += u64(numSource) * voice.frameSize;
+        offset += count;
+    }
+    return offset;
+}
+
+void Ngs2Sampler::Process(RackInternal& rack, const RenderContext& context) {
+    const u32 numSamples = context.numGrainSamples;
+    if (output.stride < numSamples) {
+        output.Allocate(ORBIS_NGS2_MAX_VOICE_CHANNELS, rack.systemData->maxGrainSamples);
+    }
+    for (u32 index = 0; index < voices.size(); index++) {
+        const u32 stateFlags = rack.stateFlags[index];
+        if ((stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) == 0 ||
+            (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED) != 0) {
+            continue;
+        }
+        Voice& voice = voices[index];
+        output.numChannels = voice.format.numChannels;
+
+        const u32 numRendered = Render(rack, index, numSamples, context.sampleRate);
+        bool playing = numRendered == numSamples;
+        if (!playing) {
+            for (u32 channel = 0; channel < output.numChannels; channel++) {
+                std::fill_n(output.Channel(channel) + numRendered, numSamples - numRendered,
+                            0.0f);
+            }
+        }
+        if (!voice.envelope.Apply(output, numSamples, context.sampleRate)) {
+            playing = false;
+        }
+        for (u32 i = 0; i < voice.numFilters; i++) {
+            voice.filters[i].Process(output, numSamples);
+        }
+        MixToPorts(rack.voices[index], output, numSamples);
+        if (!playing) {
+            rack.stateFlags[index] = 0;
+        }
+    }
+}
+
+void Ngs2Sampler::GetVoiceState(const RackInternal& rack, const VoiceInternal& handle,
+                                void* outState, size_t stateSize) const {
+    if (stateSize < sizeof(OrbisNgs2SamplerVoiceState)) {
+        return;
+    }
+    const Voice& voice = voices[handle.index];
+    auto* state = static_cast<OrbisNgs2SamplerVoiceState*>(outState);
+    state->envelopeHeight = voice.envelope.GetHeight();
+    state->numDecodedSamples = voice.numDecodedSamples;
+    state->decodedDataSize = voice.decodedDataSize;
+    if (voice.blockIndex < voice.blocks.size()) {
+        const OrbisNgs2WaveformBlock& block = voice.blocks[voice.blockIndex];
+        state->userData = block.userData;
+        state->waveformData = voice.data + block.dataOffset;
+    }
+}
+
+} // namespace Libraries::Ngs2
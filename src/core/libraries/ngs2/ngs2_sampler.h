@@ -3,11 +3,22 @@
 
 #pragma once
 
-#include "ngs2.h"
+#include "ngs2_impl.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Sampler;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_SETUP = 0x10000001;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_BLOCKS = 0x10000002;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_PITCH = 0x10000003;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_ENVELOPE = 0x10000004;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_DISTORTION = 0x10000005;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_USER_FX = 0x10000006;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_PEAK_METER = 0x10000007;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_ADDRESS = 0x10000008;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_FRAME_OFFSET = 0x10000009;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_EXIT_LOOP = 0x1000000A;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_FILTER = 0x1000000B;
+static const u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_NUM_FILTERS = 0x1000000C;
 
 struct OrbisNgs2SamplerRackOption {
     OrbisNgs2RackOption rackOption;
@@ -159,4 +170,46 @@ struct OrbisNgs2SamplerRackInfo {
     u32 maxAjmAtrac9Decoders;
 };
 
+// Plays PCM waveform blocks, resampled to the system rate, through an envelope and filters.
+class Ngs2Sampler final : public RackProcessor {
+public:
+    explicit Ngs2Sampler(const OrbisNgs2RackOption* option);
+
+    s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                     const OrbisNgs2VoiceParamHeader& param) override;
+    void VoiceEvent(RackInternal& rack, VoiceInternal& voice, u32 eventId) override;
+    void Process(RackInternal& rack, const RenderContext& context) override;
+    void GetVoiceState(const RackInternal& rack, const VoiceInternal& voice, void* outState,
+                       size_t stateSize) const override;
+
+private:
+    struct Voice {
+        OrbisNgs2WaveformFormat format{};
+        u32 frameSize{};
+        const u8* data{};
+        std::vector<OrbisNgs2WaveformBlock> blocks;
+        u32 blockIndex{};
+        u32 numRepeated{};
+        bool exitLoop{};
+        u64 position{}; // Frame in the current block, 32.32 fixed point
+        float pitch = 1.0f;
+        u64 numDecodedSamples{};
+        u64 decodedDataSize{};
+        Envelope envelope;
+        std::vector<BiquadFilter> filters;
+        u32 numFilters{};
+    };
+
+    void Rewind(Voice& voice);
+    u32 Render(RackInternal& rack, u32 index, u32 numSamples, u32 sampleRate);
+    void EndBlock(RackInternal& rack, u32 index);
+
+    u32 maxWaveformBlocks = 4;
+    u32 maxEnvelopePoints = 4;
+    u32 maxFilters = 1;
+    std::vector<Voice> voices;
+    std::vector<float> source;
+    GrainBuffer output;
+};
+
 } // namespace Libraries::Ngs2
@@ -3,10 +3,131 @@
 
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_submixer.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+Ngs2Submixer::Ngs2Submixer(const OrbisNgs2RackOption* option) {
+    u32 maxVoices = 1;
+    if (option) {
+        maxVoices = option->maxVoices;
+        if (option->size >= sizeof(OrbisNgs2SubmixerRackOption)) {
+            const auto* submixerOption =
+                reinterpret_cast<const OrbisNgs2SubmixerRackOption*>(option);
+            maxChannels = submixerOption->maxChannels;
+            maxEnvelopePoints = submixerOption->maxEnvelopePoints;
+            maxFilters = submixerOption->maxFilters;
+        }
+    }
+    voices.resize(maxVoices);
+    for (Voice& voice : voices) {
+        voice.filters.resize(maxFilters);
+        voice.numFilters = maxFilters;
+    }
+}
+
+s32 Ngs2Submixer::VoiceControl(RackInternal& rack, VoiceInternal& handle,
+                               const OrbisNgs2VoiceParamHeader& header) {
+    Voice& voice = voices[handle.index];
+    switch (header.id) {
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_SETUP: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SubmixerVoiceSetupParam&>(header);
+        if (param.numIoChannels == 0 || param.numIoChannels > maxChannels ||
+            param.numIoChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            LOG_ERROR(Lib_Ngs2, "Invalid submixer channels ({})", param.numIoChannels);
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        handle.input.Clear(handle.input.stride);
+        handle.input.numChannels = param.numIoChannels;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_ENVELOPE: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SubmixerVoiceEnvelopeParam&>(header);
+        return voice.envelope.SetPoints(param.aPoint, param.numForwardPoints,
+                                        param.numReleasePoints, maxEnvelopePoints);
+    }
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_FILTER: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SubmixerVoiceFilterParam&>(header);
+        if (param.index >= voice.filters.size()) {
+            LOG_ERROR(Lib_Ngs2, "Invalid filter index ({})", param.index);
+            return ORBIS_NGS2_ERROR_INVALID_FILTER_INDEX;
+        }
+        const auto& direct = param.param.direct;
+        const float coefficients[5] = {direct.i0, direct.i1, direct.i2, direct.o1, direct.o2};
+        return voice.filters[param.index].SetParam(
+            param.type, param.channelMask, coefficients, param.param.fcq.fc, param.param.fcq.q,
+            param.param.fcq.level, handle.systemData->currentSampleRate);
+    }
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_NUM_FILTERS: {
+        const auto& param = reinterpret_cast<const OrbisNgs2SubmixerVoiceNumFilters&>(header);
+        if (param.numFilters > maxFilters) {
+            LOG_ERROR(Lib_Ngs2, "Invalid number of filters ({}>{})", param.numFilters,
+                      maxFilters);
+            return ORBIS_NGS2_ERROR_INVALID_MAX_FILTERS;
+        }
+        voice.numFilters = param.numFilters;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_COMPRESSOR:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_DISTORTION:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_USER_FX:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_PEAK_METER:
+        LOG_DEBUG(Lib_Ngs2, "Ignoring submixer voice parameter {:#x}", header.id);
+        return ORBIS_OK;
+    default:
+        LOG_ERROR(Lib_Ngs2, "Invalid submixer voice parameter ({:#x})", header.id);
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+void Ngs2Submixer::VoiceEvent(RackInternal& rack, VoiceInternal& handle, u32 eventId) {
+    Voice& voice = voices[handle.index];
+    switch (eventId) {
+    case ORBIS_NGS2_VOICE_EVENT_PLAY:
+        voice.envelope.Start();
+        break;
+    case ORBIS_NGS2_VOICE_EVENT_STOP:
+        voice.envelope.Release();
+        break;
+    default:
+        break;
+    }
+}
+
+void Ngs2Submixer::Process(RackInternal& rack, const RenderContext& context) {
+    const u32 numSamples = context.numGrainSamples;
+    for (u32 index = 0; index < voices.size(); index++) {
+        VoiceInternal& handle = rack.voices[index];
+        const u32 stateFlags = rack.stateFlags[index];
+        if ((stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING) != 0 &&
+            (stateFlags & ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED) == 0) {
+            Voice& voice = voices[index];
+            const bool playing = voice.envelope.Apply(handle.input, numSamples, context.sampleRate);
+            for (u32 i = 0; i < voice.numFilters; i++) {
+                voice.filters[i].Process(handle.input, numSamples);
+            }
+            MixToPorts(handle, handle.input, numSamples);
+            if (!playing) {
+                rack.stateFlags[index] = 0;
+            }
+        }
+        handle.input.Clear(numSamples);
+    }
+}
+
+void Ngs2Submixer::GetVoiceState(const RackInternal& rack, const VoiceInternal& handle,
+                                 void* outState, size_t stateSize) const {
+    if (stateSize < sizeof(OrbisNgs2SubmixerVoiceState)) {
+        return;
+    }
+    auto* state = static_cast<OrbisNgs2SubmixerVoiceState*>(outState);
+    state->envelopeHeight = voices[handle.index].envelope.GetHeight();
+    state->compressorHeight = 1.0f;
+}
+
+} // namespace Libraries::Ngs2
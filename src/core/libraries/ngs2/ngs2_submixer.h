@@ -3,11 +3,18 @@
 
 #pragma once
 
-#include "ngs2.h"
+#include "ngs2_impl.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Submixer;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_SETUP = 0x20000001;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_ENVELOPE = 0x20000002;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_COMPRESSOR = 0x20000003;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_DISTORTION = 0x20000004;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_USER_FX = 0x20000005;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_PEAK_METER = 0x20000006;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_FILTER = 0x20000007;
+static const u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_NUM_FILTERS = 0x20000008;
 
 struct OrbisNgs2SubmixerRackOption {
     OrbisNgs2RackOption rackOption;
@@ -123,4 +130,30 @@ struct OrbisNgs2SubmixerRackInfo {
     u32 maxInputs;
 };
 
+// Sums the voices patched into each of its voices and sends them on through an envelope and
+// filters.
+class Ngs2Submixer final : public RackProcessor {
+public:
+    explicit Ngs2Submixer(const OrbisNgs2RackOption* option);
+
+    s32 VoiceControl(RackInternal& rack, VoiceInternal& voice,
+                     const OrbisNgs2VoiceParamHeader& param) override;
+    void VoiceEvent(RackInternal& rack, VoiceInternal& voice, u32 eventId) override;
+    void Process(RackInternal& rack, const RenderContext& context) override;
+    void GetVoiceState(const RackInternal& rack, const VoiceInternal& voice, void* outState,
+                       size_t stateSize) const override;
+
+private:
+    struct Voice {
+        Envelope envelope;
+        std::vector<BiquadFilter> filters;
+        u32 numFilters{};
+    };
+
+    u32 maxChannels = 2;
+    u32 maxEnvelopePoints = 4;
+    u32 maxFilters = 1;
+    std::vector<Voice> voices;
+};
+
 } // namespace Libraries::Ngs2
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2025-2026 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <future>
 #include <unordered_map>
 #include <pugixml.hpp>
 
@@ -825,6 +826,7 @@ int PS4_SYSV_ABI sceNpTrophyRegisterContext(OrbisNpTrophyContext context,
     }
 
     // Resolve trophy-related paths using the context's service_label
+    WaitForTrophyExtraction();
     std::string np_comm_id;
     const auto& trophyMap = Common::ElfInfo::Instance().GetTrophyIndexMap();
     auto it = trophyMap.find(ctx.service_label);
@@ -1383,6 +1385,19 @@ int PS4_SYSV_ABI Func_FA7A2DD770447552() {
     return ORBIS_OK;
 }
 
+// Started before the game runs and only waited on afterwards, so it needs no lock.
+static std::shared_future<void> trophy_extraction;
+
+void ExtractTrophiesInBackground(std::function<void()> extract) {
+    trophy_extraction = std::async(std::launch::async, std::move(extract)).share();
+}
+
+void WaitForTrophyExtraction() {
+    if (trophy_extraction.valid()) {
+        trophy_extraction.wait();
+    }
+}
+
 void RegisterLib(Core::Loader::SymbolsResolver* sym) {
     LIB_FUNCTION("aTnHs7W-9Uk", "libSceNpTrophy", 1, "libSceNpTrophy", sceNpTrophyAbortHandle);
     LIB_FUNCTION("cqGkYAN-gRw", "libSceNpTrophy", 1, "libSceNpTrophy",
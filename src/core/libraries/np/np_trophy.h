@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <core/libraries/system/userservice.h>
 #include "common/types.h"
 #include "core/libraries/rtc/rtc.h"
@@ -225,5 +226,12 @@ int PS4_SYSV_ABI Func_9F80071876FFA5F6();
 int PS4_SYSV_ABI Func_F8EF6F5350A91990();
 int PS4_SYSV_ABI Func_FA7A2DD770447552();
 
+/// Runs the extraction of the title's trophy files in the background. Registering a trophy
+/// context waits for it, as that is where the extracted files are first looked up.
+void ExtractTrophiesInBackground(std::function<void()> extract);
+
+/// Blocks until the background trophy extraction, if any, has finished.
+void WaitForTrophyExtraction();
+
 void RegisterLib(Core::Loader::SymbolsResolver* sym);
 } // namespace Libraries::Np::NpTrophy
\ No newline at end of file
@@ -1,6 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
 #include "videodec2_impl.h"
 
 #include "common/assert.h"
@@ -13,22 +17,18 @@ namespace Libraries::Videodec2 {
 
 std::vector<OrbisVideodec2AvcPictureInfo> gPictureInfos;
 
-static inline void CopyNV12Data(u8* dst, const AVFrame& src) {
-    if (src.width == src.linesize[0]) {
-        std::memcpy(dst, src.data[0], src.width * src.height);
-        std::memcpy(dst + (src.width * src.height), src.data[1], (src.width * src.height) / 2);
-        return;
-    }
+// Access units that never produce a picture, like parameter sets, leave their entry behind
+static constexpr size_t MaxPendingPictures = 64;
 
-    for (u16 row = 0; row < src.height; row++) {
-        u64 dst_offset = row * src.width;
-        std::memcpy(dst + dst_offset, src.data[0] + (row * src.linesize[0]), src.width);
+static void CopyPlane(u8* dst, u32 dst_pitch, const u8* src, s32 src_pitch, u32 width,
+                      u32 height) {
+    if (src_pitch == static_cast<s32>(dst_pitch)) {
+        std::memcpy(dst, src, static_cast<u64>(dst_pitch) * height);
+        return;
     }
-
-    u64 dst_base = src.width * src.height;
-    for (u16 row = 0; row < src.height / 2; row++) {
-        u64 dst_offset = row * src.width;
-        std::memcpy(dst + dst_base + dst_offset, src.data[1] + (row * src.linesize[1]), src.width);
+    for (u32 row = 0; row < height; row++) {
+        std::memcpy(dst + static_cast<u64>(row) * dst_pitch,
+                    src + static_cast<s64>(row) * src_pitch, width);
     }
 }
 
@@ -44,6 +44,18 @@ VdecDecoder::VdecDecoder(const OrbisVideodec2DecoderConfigInfo& configInfo,
     mCodecContext->width = configInfo.maxFrameWidth;
     mCodecContext->height = configInfo.maxFrameHeight;
 
+    // Frame threading delays output by a frame per thread, so it is only used as far as the
+    // pipeline depth the game asked for allows. Slice threading adds no delay.
+    const u32 pipeline_depth = std::min<u32>(configInfo.decodePipelineDepth,
+                                             std::max(std::thread::hardware_concurrency(), 1U));
+    if (pipeline_depth > 1) {
+        mCodecContext->thread_count = static_cast<int>(pipeline_depth);
+        mCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    } else {
+        mCodecContext->thread_count = 0;
+        mCodecContext->thread_type = FF_THREAD_SLICE;
+    }
+
     avcodec_open2(mCodecContext, codec, nullptr);
 }
 
@@ -80,10 +92,20 @@ s32 VdecDecoder::Decode(const OrbisVideodec2InputData& inputData,
         return ORBIS_VIDEODEC2_ERROR_API_FAIL;
     }
 
+    // Decoding again after a partial flush starts a new stream
+    if (mDraining) {
+        Reset();
+    }
+
+    const s64 packet_index = mNextPacketIndex++;
+    mPendingPictures[packet_index] = {inputData.ptsData, inputData.dtsData, inputData.attachedData};
+    if (mPendingPictures.size() > MaxPendingPictures) {
+        mPendingPictures.erase(mPendingPictures.begin());
+    }
+
     packet->data = (u8*)inputData.auData;
     packet->size = inputData.auSize;
-    packet->pts = inputData.ptsData;
-    packet->dts = inputData.dtsData;
+    packet->pts = packet_index;
 
     int ret = avcodec_send_packet(mCodecContext, packet);
     if (ret < 0) {
@@ -110,49 +132,7 @@ s32 VdecDecoder::Decode(const OrbisVideodec2InputData& inputData,
             return ORBIS_VIDEODEC2_ERROR_API_FAIL;
         }
 
-        if (frame->format != AV_PIX_FMT_NV12) {
-            AVFrame* nv12_frame = ConvertNV12Frame(*frame);
-            ASSERT(nv12_frame);
-            av_frame_free(&frame);
-            frame = nv12_frame;
-        }
-
-        CopyNV12Data((u8*)frameBuffer.frameBuffer, *frame);
-        frameBuffer.isAccepted = true;
-
-        outputInfo.codecType = 1; // FIXME: Hardcoded to AVC
-        outputInfo.frameWidth = frame->width;
-        outputInfo.frameHeight = frame->height;
-        outputInfo.framePitch = frame->width;
-        outputInfo.frameBufferSize = frameBuffer.frameBufferSize;
-        outputInfo.frameBuffer = frameBuffer.frameBuffer;
-
-        outputInfo.isValid = true;
-        outputInfo.isErrorFrame = false;
-        outputInfo.pictureCount = 1; // TODO: 2 pictures for interlaced video
-
-        // Only set framePitchInBytes if the game uses the newer struct version.
-        if (outputInfo.thisSize == sizeof(OrbisVideodec2OutputInfo)) {
-            outputInfo.framePitchInBytes = frame->width;
-        }
-
-        if (outputInfo.isValid) {
-            OrbisVideodec2AvcPictureInfo pictureInfo = {};
-
-            pictureInfo.thisSize = sizeof(OrbisVideodec2AvcPictureInfo);
-            pictureInfo.isValid = true;
-
-            pictureInfo.ptsData = inputData.ptsData;
-            pictureInfo.dtsData = inputData.dtsData;
-            pictureInfo.attachedData = inputData.attachedData;
-
-            pictureInfo.frameCropLeftOffset = frame->crop_left;
-            pictureInfo.frameCropRightOffset = frame->crop_right;
-            pictureInfo.frameCropTopOffset = frame->crop_top;
-            pictureInfo.frameCropBottomOffset = frame->crop_bottom;
-
-            gPictureInfos.push_back(pictureInfo);
-        }
+        OutputFrame(*frame, frameBuffer, outputInfo);
     }
 
     av_packet_free(&packet);
@@ -172,15 +152,30 @@ s32 VdecDecoder::Flush(OrbisVideodec2FrameBuffer& frameBuffer,
         outputInfo.frameFormat = 0;
     }
 
+    // Signal the end of the stream so frame threading gives up the pictures it still holds
+    if (!mDraining) {
+        const int ret = avcodec_send_packet(mCodecContext, nullptr);
+        if (ret < 0) {
+            LOG_ERROR(Lib_Vdec2, "Error sending flush packet to decoder: {}", ret);
+            return ORBIS_VIDEODEC2_ERROR_API_FAIL;
+        }
+        mDraining = true;
+    }
+
     AVFrame* frame = av_frame_alloc();
     if (!frame) {
         LOG_ERROR(Lib_Vdec2, "Failed to allocate frame");
         return ORBIS_VIDEODEC2_ERROR_API_FAIL;
     }
 
-    while (true) {
+    // The game calls this until no picture is left, so hand them out one at a time
+    while (!frameBuffer.isAccepted) {
         int ret = avcodec_receive_frame(mCodecContext, frame);
-        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+        if (ret == AVERROR_EOF) {
+            // Fully drained, get ready for the next stream
+            avcodec_flush_buffers(mCodecContext);
+            mPendingPictures.clear();
+            mDraining = false;
             break;
         } else if (ret < 0) {
             LOG_ERROR(Lib_Vdec2, "Error receiving frame from decoder: {}", ret);
@@ -188,33 +183,7 @@ s32 VdecDecoder::Flush(OrbisVideodec2FrameBuffer& frameBuffer,
             return ORBIS_VIDEODEC2_ERROR_API_FAIL;
         }
 
-        if (frame->format != AV_PIX_FMT_NV12) {
-            AVFrame* nv12_frame = ConvertNV12Frame(*frame);
-            ASSERT(nv12_frame);
-            av_frame_free(&frame);
-            frame = nv12_frame;
-        }
-
-        CopyNV12Data((u8*)frameBuffer.frameBuffer, *frame);
-        frameBuffer.isAccepted = true;
-
-        outputInfo.codecType = 1; // FIXME: Hardcoded to AVC
-        outputInfo.frameWidth = frame->width;
-        outputInfo.frameHeight = frame->height;
-        outputInfo.framePitch = frame->width;
-        outputInfo.frameBufferSize = frameBuffer.frameBufferSize;
-        outputInfo.frameBuffer = frameBuffer.frameBuffer;
-
-        outputInfo.isValid = true;
-        outputInfo.isErrorFrame = false;
-        outputInfo.pictureCount = 1; // TODO: 2 pictures for interlaced video
-
-        // Only set framePitchInBytes if the game uses the newer struct version.
-        if (outputInfo.thisSize == sizeof(OrbisVideodec2OutputInfo)) {
-            outputInfo.framePitchInBytes = frame->width;
-        }
-
-        // FIXME: Should we add picture info here too?
+        OutputFrame(*frame, frameBuffer, outputInfo);
     }
 
     av_frame_free(&frame);
@@ -224,38 +193,92 @@ s32 VdecDecoder::Flush(OrbisVideodec2FrameBuffer& frameBuffer,
 s32 VdecDecoder::Reset() {
     avcodec_flush_buffers(mCodecContext);
     gPictureInfos.clear();
+    mPendingPictures.clear();
+    mDraining = false;
     return ORBIS_OK;
 }
 
-AVFrame* VdecDecoder::ConvertNV12Frame(AVFrame& frame) {
-    AVFrame* nv12_frame = av_frame_alloc();
-    nv12_frame->pts = frame.pts;
-    nv12_frame->pkt_dts = frame.pkt_dts < 0 ? 0 : frame.pkt_dts;
-    nv12_frame->format = AV_PIX_FMT_NV12;
-    nv12_frame->width = frame.width;
-    nv12_frame->height = frame.height;
-    nv12_frame->sample_aspect_ratio = frame.sample_aspect_ratio;
-    nv12_frame->crop_top = frame.crop_top;
-    nv12_frame->crop_bottom = frame.crop_bottom;
-    nv12_frame->crop_left = frame.crop_left;
-    nv12_frame->crop_right = frame.crop_right;
-
-    av_frame_get_buffer(nv12_frame, 0);
+void VdecDecoder::OutputFrame(const AVFrame& frame, OrbisVideodec2FrameBuffer& frameBuffer,
+                              OrbisVideodec2OutputInfo& outputInfo) {
+    if (!WriteNV12Frame(frame, frameBuffer)) {
+        return;
+    }
+    frameBuffer.isAccepted = true;
 
-    if (mSwsContext == nullptr) {
-        mSwsContext = sws_getContext(frame.width, frame.height, AVPixelFormat(frame.format),
-                                     nv12_frame->width, nv12_frame->height, AV_PIX_FMT_NV12,
-                                     SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    outputInfo.codecType = 1; // FIXME: Hardcoded to AVC
+    outputInfo.frameWidth = frame.width;
+    outputInfo.frameHeight = frame.height;
+    outputInfo.framePitch = frame.width;
+    outputInfo.frameBufferSize = frameBuffer.frameBufferSize;
+    outputInfo.frameBuffer = frameBuffer.frameBuffer;
+
+    outputInfo.isValid = true;
+    outputInfo.isErrorFrame = false;
+    outputInfo.pictureCount = 1; // TODO: 2 pictures for interlaced video
+
+    // Only set framePitchInBytes if the game uses the newer struct version.
+    if (outputInfo.thisSize == sizeof(OrbisVideodec2OutputInfo)) {
+        outputInfo.framePitchInBytes = frame.width;
     }
 
-    const auto res = sws_scale(mSwsContext, frame.data, frame.linesize, 0, frame.height,
-                               nv12_frame->data, nv12_frame->linesize);
+    OrbisVideodec2AvcPictureInfo pictureInfo = {};
+
+    pictureInfo.thisSize = sizeof(OrbisVideodec2AvcPictureInfo);
+    pictureInfo.isValid = true;
+
+    // Frames are output in presentation order, possibly a few access units late
+    if (const auto it = mPendingPictures.find(frame.pts); it != mPendingPictures.end()) {
+        pictureInfo.ptsData = it->second.ptsData;
+        pictureInfo.dtsData = it->second.dtsData;
+        pictureInfo.attachedData = it->second.attachedData;
+        mPendingPictures.erase(it);
+    } else {
+        LOG_WARNING(Lib_Vdec2, "No access unit found for decoded picture {}", frame.pts);
+    }
+
+    pictureInfo.frameCropLeftOffset = frame.crop_left;
+    pictureInfo.frameCropRightOffset = frame.crop_right;
+    pictureInfo.frameCropTopOffset = frame.crop_top;
+    pictureInfo.frameCropBottomOffset = frame.crop_bottom;
+
+    gPictureInfos.push_back(pictureInfo);
+}
+
+bool VdecDecoder::WriteNV12Frame(const AVFrame& frame, OrbisVideodec2FrameBuffer& frameBuffer) {
+    const u32 pitch = frame.width;
+    const u64 luma_size = static_cast<u64>(pitch) * frame.height;
+    if (frameBuffer.frameBufferSize < luma_size + luma_size / 2) {
+        LOG_ERROR(Lib_Vdec2, "Frame buffer of {:#x} bytes is too small for a {}x{} frame",
+                  frameBuffer.frameBufferSize, frame.width, frame.height);
+        return false;
+    }
+
+    u8* const luma = static_cast<u8*>(frameBuffer.frameBuffer);
+    u8* const chroma = luma + luma_size;
+    if (frame.format == AV_PIX_FMT_NV12) {
+        CopyPlane(luma, pitch, frame.data[0], frame.linesize[0], frame.width, frame.height);
+        CopyPlane(chroma, pitch, frame.data[1], frame.linesize[1], frame.width, frame.height / 2);
+        return true;
+    }
+
+    // Convert straight into the guest buffer instead of going through an intermediate frame
+    mSwsContext = sws_getCachedContext(mSwsContext, frame.width, frame.height,
+                                       AVPixelFormat(frame.format), frame.width, frame.height,
+                                       AV_PIX_FMT_NV12, SWS_FAST_BILINEAR, nullptr, nullptr,
+                                       nullptr);
+    if (mSwsContext == nullptr) {
+        LOG_ERROR(Lib_Vdec2, "Could not create NV12 conversion context");
+        return false;
+    }
+    u8* const dst_data[4] = {luma, chroma, nullptr, nullptr};
+    const int dst_linesize[4] = {static_cast<int>(pitch), static_cast<int>(pitch), 0, 0};
+    const auto res = sws_scale(mSwsContext, frame.data, frame.linesize, 0, frame.height, dst_data,
+                               dst_linesize);
     if (res < 0) {
         LOG_ERROR(Lib_Vdec2, "Could not convert to NV12: {}", av_err2str(res));
-        return nullptr;
+        return false;
     }
-
-    return nv12_frame;
+    return true;
 }
 
 } // namespace Libraries::Videodec2
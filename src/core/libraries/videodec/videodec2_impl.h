@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "videodec2.h"
@@ -29,11 +30,28 @@ public:
     s32 Reset();
 
 private:
-    AVFrame* ConvertNV12Frame(AVFrame& frame);
+    /// Timestamps and user data of an access unit, until its picture leaves the decoder.
+    struct PendingPicture {
+        u64 ptsData;
+        u64 dtsData;
+        u64 attachedData;
+    };
+
+    /// Writes a decoded frame into the guest frame buffer as NV12 with a pitch of the width.
+    bool WriteNV12Frame(const AVFrame& frame, OrbisVideodec2FrameBuffer& frameBuffer);
+
+    /// Fills the output info for a decoded frame and queues its picture info.
+    void OutputFrame(const AVFrame& frame, OrbisVideodec2FrameBuffer& frameBuffer,
+                     OrbisVideodec2OutputInfo& outputInfo);
 
 private:
     AVCodecContext* mCodecContext = nullptr;
     SwsContext* mSwsContext = nullptr;
+    // Packets carry a sequence number as their pts, which the decoder hands back on the frame
+    // decoded from them, even when frame threading delays it by a few packets.
+    std::map<s64, PendingPicture> mPendingPictures;
+    s64 mNextPacketIndex = 0;
+    bool mDraining = false;
 };
 
 } // namespace Libraries::Videodec2
\ No newline at end of file
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "common/assert.h"
+#include "common/boot_timeline.h"
 #include "common/debug.h"
 #include "common/thread.h"
 #include "core/debug_state.h"
@@ -239,6 +240,9 @@ void VideoOutDriver::Flip(const Request& req) {
 
     // Present the frame.
     presenter->Present(req.frame);
+    if (Common::BootTimeline::IsRecording()) {
+        Common::BootTimeline::Finish(*Libraries::Kernel::GetClock());
+    }
 
     // Update flip status.
     auto* port = req.port;
@@ -306,7 +310,9 @@ bool VideoOutDriver::SubmitFlip(VideoOutPort* port, s32 index, s64 flip_arg,
     }
 
     if (!is_eop) {
-        // Non EOP flips can arrive from any thread so ask GPU thread to perform them
+        // Non EOP flips can arrive from any thread so ask GPU thread to perform them. The buffer
+        // may have been written by the CPU since the last submission.
+        presenter->GetRasterizer().FlushGuestWrites();
         liverpool->SendCommand([=, this]() { SubmitFlipInternal(port, index, flip_arg, is_eop); });
     } else {
         SubmitFlipInternal(port, index, flip_arg, is_eop);
@@ -1,9 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2025-2026 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include "common/alignment.h"
 #include "common/arch.h"
 #include "common/assert.h"
+#include "common/boot_timeline.h"
 #include "common/elf_info.h"
 #include "common/logging/formatter.h"
 #include "common/logging/log.h"
@@ -71,9 +75,12 @@ void Linker::Execute(const std::vector<std::string>& args) {
     static_tls_size = module->tls.offset = module->tls.image_size;
 
     // Relocate all modules
-    for (const auto& m : m_modules) {
-        Relocate(m.get());
-    }
+    const auto relocate_start = std::chrono::steady_clock::now();
+    RelocateAllImports();
+    LOG_INFO(Core_Linker, "Relocated {} modules in {} ms", m_modules.size(),
+             std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - relocate_start)
+                 .count());
 
     // Configure the direct and flexible memory regions.
     u64 fmem_size = ORBIS_KERNEL_FLEXIBLE_MEMORY_SIZE;
@@ -178,6 +185,8 @@ s32 Linker::LoadModule(const std::filesystem::path& elf_name, bool is_dynamic) {
         return -1;
     }
 
+    const Common::BootTimeline::Scope phase{
+        fmt::format("Load {}", elf_name.filename().string())};
     auto module = std::make_unique<Module>(memory, elf_name, max_tls_index);
     if (!module->IsValid()) {
         LOG_ERROR(Core_Linker, "Provided file {} is not valid ELF file", elf_name.string());
@@ -221,6 +230,34 @@ s32 Linker::LoadAndStartModule(const std::filesystem::path& path, u64 args, cons
     return handle;
 }
 
+/// The words at the relocation targets of a module and its resolved relocations.
+struct RelocationSnapshot {
+    std::vector<u64> values;
+    std::vector<u8> rela_bits;
+};
+
+static RelocationSnapshot SnapshotRelocations(Module* module) {
+    RelocationSnapshot snapshot{.rela_bits = module->rela_bits};
+    snapshot.values.reserve(module->NumRelocations());
+    const VAddr base = module->GetBaseAddress();
+    module->ForEachRelocation([&](elf_relocation* rel, u32, bool) {
+        u64 value;
+        std::memcpy(&value, reinterpret_cast<const void*>(base + rel->rel_offset), sizeof(value));
+        snapshot.values.push_back(value);
+    });
+    return snapshot;
+}
+
+static void RestoreRelocations(Module* module, const RelocationSnapshot& snapshot) {
+    module->rela_bits = snapshot.rela_bits;
+    const VAddr base = module->GetBaseAddress();
+    u32 index = 0;
+    module->ForEachRelocation([&](elf_relocation* rel, u32, bool) {
+        std::memcpy(reinterpret_cast<void*>(base + rel->rel_offset), &snapshot.values[index++],
+                    sizeof(u64));
+    });
+}
+
 Module* Linker::FindByAddress(VAddr address) {
     for (auto& module : m_modules) {
         const VAddr base = module->GetBaseAddress();
@@ -232,7 +269,108 @@ Module* Linker::FindByAddress(VAddr address) {
 }
 
 void Linker::Relocate(Module* module) {
-    module->ForEachRelocation([&](elf_relocation* rel, u32 i, bool is_jmp_rel) {
+    RelocateModules({&module, 1});
+}
+
+void Linker::RelocateModules(std::span<Module* const> modules) {
+    // Relocations only write to their own module and resolve against symbol tables that do not
+    // change while the linker lock is held, so modules and slices of large tables are independent.
+    static constexpr u32 RelocationsPerTask = 4096;
+    struct Task {
+        Module* module;
+        u32 begin;
+        u32 end;
+    };
+    std::vector<Task> tasks;
+    u64 num_relocations = 0;
+    for (Module* module : modules) {
+        const u32 count = module->NumRelocations();
+        for (u32 begin = 0; begin < count; begin += RelocationsPerTask) {
+            tasks.emplace_back(module, begin, std::min(count, begin + RelocationsPerTask));
+        }
+        num_relocations += count;
+    }
+
+    std::vector<RelocationSnapshot> original;
+    if (EmulatorSettings.IsVerifyRelocations()) {
+        for (Module* module : modules) {
+            original.push_back(SnapshotRelocations(module));
+        }
+    }
+
+    const Common::BootTimeline::Scope phase{"Relocate modules"};
+    const u32 num_threads =
+        std::min<u32>(tasks.size(), std::max(std::thread::hardware_concurrency(), 1U));
+    std::atomic<size_t> next_task{0};
+    const auto run_tasks = [&] {
+        for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+            RelocateRange(tasks[i].module, tasks[i].begin, tasks[i].end);
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        for (u32 i = 1; i < num_threads; i++) {
+            workers.emplace_back(run_tasks);
+        }
+        run_tasks();
+    }
+
+    if (!original.empty()) {
+        VerifyRelocations(modules, original, num_relocations);
+    }
+}
+
+void Linker::VerifyRelocations(std::span<Module* const> modules,
+                               std::span<const RelocationSnapshot> original, u64 num_relocations) {
+    // Redo the pass serially from the original state and keep that result. Unresolved imports
+    // get stub slots in the order they are requested, so the serial pass hands out new ones. They
+    // go back to the pool and the imports keep the stubs of the parallel pass.
+    const u32 num_used_stubs = AeroLib::GetNumUsedStubs();
+    u64 num_mismatches = 0;
+    u64 num_stubs = 0;
+    for (size_t m = 0; m < modules.size(); m++) {
+        Module* module = modules[m];
+        const auto parallel = SnapshotRelocations(module);
+        RestoreRelocations(module, original[m]);
+        RelocateRange(module, 0, module->NumRelocations());
+        auto serial = SnapshotRelocations(module);
+        bool restore_stubs = false;
+        for (u32 i = 0; i < serial.values.size(); i++) {
+            if (serial.values[i] == parallel.values[i]) {
+                continue;
+            }
+            if (!module->TestRelaBit(i)) {
+                serial.values[i] = parallel.values[i];
+                restore_stubs = true;
+                num_stubs++;
+                continue;
+            }
+            num_mismatches++;
+            LOG_ERROR(Core_Linker, "Relocation {} of {} is {:#x} in parallel but {:#x} serially",
+                      i, module->name, parallel.values[i], serial.values[i]);
+        }
+        if (serial.rela_bits != parallel.rela_bits) {
+            num_mismatches++;
+            LOG_ERROR(Core_Linker, "Resolved relocations of {} differ from a serial pass",
+                      module->name);
+        }
+        if (restore_stubs) {
+            RestoreRelocations(module, serial);
+        }
+    }
+    AeroLib::ReleaseStubs(num_used_stubs);
+    if (num_mismatches != 0) {
+        LOG_ERROR(Core_Linker, "{} of {} relocations differ from a serial pass", num_mismatches,
+                  num_relocations);
+    } else {
+        LOG_INFO(Core_Linker,
+                 "Verified {} relocations of {} modules against a serial pass, {} stubs reordered",
+                 num_relocations, modules.size(), num_stubs);
+    }
+}
+
+void Linker::RelocateRange(Module* module, u32 begin, u32 end) {
+    module->ForEachRelocation(begin, end, [&](elf_relocation* rel, u32 i, bool is_jmp_rel) {
         const u32 num_relocs = module->dynamic_info.relocation_table_size / sizeof(elf_relocation);
         const u32 bit_idx = (is_jmp_rel ? num_relocs : 0) + i;
         if (module->TestRelaBit(bit_idx)) {
@@ -298,8 +436,7 @@ void Linker::Relocate(Module* module) {
                 break;
             case STB_GLOBAL:
             case STB_WEAK: {
-                rel_name = names_tlb + sym.st_name;
-                if (Resolve(rel_name, rel_sym_type, module, &symrec)) {
+                if (Resolve(names_tlb + sym.st_name, rel_sym_type, module, &symrec)) {
                     // Only set the rela bit if the symbol was actually resolved and not stubbed.
                     module->SetRelaBit(bit_idx);
                 }
@@ -326,31 +463,30 @@ void Linker::Relocate(Module* module) {
     });
 }
 
-bool Linker::Resolve(const std::string& name, Loader::SymbolType sym_type, Module* m,
+bool Linker::Resolve(std::string_view name, Loader::SymbolType sym_type, Module* m,
                      Loader::SymbolRecord* return_info) {
-    const auto ids = Common::SplitString(name, '#');
-    if (ids.size() != 3) {
+    // Split "nid#library#module" without copying, as this runs for every imported relocation.
+    const size_t library_pos = name.find('#');
+    const size_t module_pos =
+        library_pos == name.npos ? name.npos : name.find('#', library_pos + 1);
+    if (module_pos == name.npos || name.find('#', module_pos + 1) != name.npos) {
         return_info->virtual_address = 0;
         return_info->name = name;
         LOG_ERROR(Core_Linker, "Not Resolved {}", name);
         return false;
     }
+    const auto nid = name.substr(0, library_pos);
 
-    const LibraryInfo* library = m->FindLibrary(ids[1]);
-    const ModuleInfo* module = m->FindModule(ids[2]);
+    const LibraryInfo* library =
+        m->FindLibrary(name.substr(library_pos + 1, module_pos - library_pos - 1));
+    const ModuleInfo* module = m->FindModule(name.substr(module_pos + 1));
     ASSERT_MSG(library && module, "Unable to find library and module");
 
-    Loader::SymbolResolver sr{};
-    sr.name = ids.at(0);
-    sr.library = library->name;
-    sr.library_version = library->version;
-    sr.module = module->name;
-    sr.type = sym_type;
-
-    const auto* record = m_hle_symbols.FindSymbol(sr);
+    const auto* record =
+        m_hle_symbols.FindSymbol(nid, library->name, library->version, module->name, sym_type);
     if (record) {
         *return_info = *record;
-        Core::Devtools::Widget::ModuleList::AddModule(sr.library);
+        Core::Devtools::Widget::ModuleList::AddModule(library->name);
         return true;
     }
 
@@ -363,23 +499,25 @@ bool Linker::Resolve(const std::string& name, Loader::SymbolType sym_type, Modul
         if (mod->export_sym.GetSize() == 0) {
             continue;
         }
-        record = mod->export_sym.FindSymbol(sr);
+        record = mod->export_sym.FindSymbol(nid, library->name, library->version, module->name,
+                                            sym_type);
         if (record) {
             *return_info = *record;
             return true;
         }
     }
 
-    const auto aeronid = AeroLib::FindByNid(sr.name.c_str());
+    const std::string nid_str{nid};
+    const auto aeronid = AeroLib::FindByNid(nid_str.c_str());
     if (aeronid) {
         return_info->name = aeronid->name;
         return_info->virtual_address = AeroLib::GetStub(aeronid->nid);
     } else {
-        return_info->virtual_address = AeroLib::GetStub(sr.name.c_str());
+        return_info->virtual_address = AeroLib::GetStub(nid_str.c_str());
         return_info->name = "Unknown !!!";
     }
     if (library->name != "libc" && library->name != "libSceFios2") {
-        LOG_WARNING(Core_Linker, "Linker: Stub resolved {} as {} (lib: {}, mod: {})", sr.name,
+        LOG_WARNING(Core_Linker, "Linker: Stub resolved {} as {} (lib: {}, mod: {})", nid,
                     return_info->name, library->name, module->name);
     }
     return false;
@@ -14,6 +14,7 @@ namespace Core {
 struct DynamicModuleInfo;
 class Linker;
 class MemoryManager;
+struct RelocationSnapshot;
 
 struct OrbisKernelMemParam {
     u64 size;
@@ -112,23 +113,27 @@ public:
     void RelocateAnyImports(Module* m) {
         std::scoped_lock lk{mutex};
 
-        Relocate(m);
+        std::vector<Module*> modules{m};
         const auto exports = m->GetExportModules();
-        for (auto& export_mod : exports) {
-            for (auto& module : m_modules) {
-                const auto imports = module->GetImportModules();
-                if (std::ranges::contains(imports, export_mod.name, &ModuleInfo::name)) {
-                    Relocate(module.get());
-                }
+        for (auto& module : m_modules) {
+            const auto imports = module->GetImportModules();
+            const bool imports_m = std::ranges::any_of(exports, [&](const ModuleInfo& export_mod) {
+                return std::ranges::contains(imports, export_mod.name, &ModuleInfo::name);
+            });
+            if (imports_m && module.get() != m) {
+                modules.push_back(module.get());
             }
         }
+        RelocateModules(modules);
     }
 
     void RelocateAllImports() {
         std::scoped_lock lk{mutex};
+        std::vector<Module*> modules;
         for (auto& module : m_modules) {
-            Relocate(module.get());
+            modules.push_back(module.get());
         }
+        RelocateModules(modules);
     }
 
     void SetHeapAPI(void* func[]) {
@@ -149,12 +154,20 @@ public:
     Module* FindByAddress(VAddr address);
 
     void Relocate(Module* module);
-    bool Resolve(const std::string& name, Loader::SymbolType type, Module* module,
+    void RelocateModules(std::span<Module* const> modules);
+    bool Resolve(std::string_view name, Loader::SymbolType type, Module* module,
                  Loader::SymbolRecord* return_info);
     void Execute(const std::vector<std::string>& args = {});
     void DebugDump();
 
 private:
+    void RelocateRange(Module* module, u32 begin, u32 end);
+
+    /// Relocates the modules again on one thread and logs where that differs from the pass that
+    /// just ran. Enabled by the verify_relocations debug setting.
+    void VerifyRelocations(std::span<Module* const> modules,
+                           std::span<const RelocationSnapshot> original, u64 num_relocations);
+
     MemoryManager* memory;
     Libraries::Kernel::Thread main_thread;
     std::mutex mutex;
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+
+#include "core/loader/link_benchmark.h"
+#include "core/loader/symbols_resolver.h"
+
+namespace Core::Loader {
+
+using Clock = std::chrono::steady_clock;
+
+// Roughly the shape of a large title: many relocations per exported symbol, some of which miss
+// the HLE table and fall through to the module exports.
+constexpr u32 RelocationsPerSymbol = 20;
+constexpr u32 MissesPerHundred = 20;
+constexpr u32 NumLibraries = 64;
+constexpr u32 LinearLookups = 20'000;
+
+static std::string RandomNid(std::mt19937& rng) {
+    static constexpr std::string_view Alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+-";
+    std::string nid(11, '\0');
+    std::ranges::generate(nid, [&] { return Alphabet[rng() % Alphabet.size()]; });
+    return nid;
+}
+
+static void PrintRow(const char* name, u64 lookups, u64 hits, Clock::duration elapsed) {
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    fmt::print("{:<16}{:>12}{:>12}{:>12.1f}{:>12.2f}\n", name, lookups, hits,
+               ns / static_cast<double>(lookups), ns / 1'000'000.0);
+}
+
+int RunLinkBenchmark(u32 numSymbols, u32 passes) {
+    std::mt19937 rng{1};
+    std::vector<SymbolResolver> symbols(numSymbols);
+    SymbolsResolver resolver;
+    for (u32 i = 0; auto& s : symbols) {
+        const u32 lib = rng() % NumLibraries;
+        s.name = RandomNid(rng);
+        s.library = fmt::format("libSceBench{}", lib);
+        s.library_version = 1;
+        s.module = s.library;
+        s.type = i++ % 8 == 0 ? SymbolType::Object : SymbolType::Function;
+        resolver.AddSymbol(s, 0x1000 + i * 0x10);
+    }
+
+    // Relocations reference symbols in random order, misses use NIDs not in the table.
+    std::vector<SymbolResolver> relocs(static_cast<size_t>(numSymbols) * RelocationsPerSymbol);
+    for (auto& reloc : relocs) {
+        reloc = symbols[rng() % numSymbols];
+        if (rng() % 100 < MissesPerHundred) {
+            reloc.name = RandomNid(rng);
+        }
+    }
+
+    fmt::print("{:<16}{:>12}{:>12}{:>12}{:>12}\n", "lookup", "lookups", "hits", "ns/lookup",
+               "total ms");
+
+    u64 hits = 0;
+    auto start = Clock::now();
+    for (u32 pass = 0; pass < passes; pass++) {
+        for (const auto& reloc : relocs) {
+            hits += resolver.FindSymbol(reloc.name, reloc.library, reloc.library_version,
+                                        reloc.module, reloc.type) != nullptr;
+        }
+    }
+    PrintRow("hash index", static_cast<u64>(relocs.size()) * passes, hits,
+             Clock::now() - start);
+
+    // The previous lookup built the full name and compared it against every record, so only
+    // time a sample of it.
+    const auto records = resolver.GetSymbols();
+    const u32 linear_lookups = std::min<u32>(LinearLookups, relocs.size());
+    hits = 0;
+    start = Clock::now();
+    for (u32 i = 0; i < linear_lookups; i++) {
+        const std::string name = SymbolsResolver::GenerateName(relocs[i]);
+        hits += std::ranges::find(records, name, &SymbolRecord::name) != records.end();
+    }
+    PrintRow("linear scan", linear_lookups, hits, Clock::now() - start);
+    return 0;
+}
+
+} // namespace Core::Loader
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "common/types.h"
+
+namespace Core::Loader {
+
+/**
+ * Fills a symbol table with the given number of synthetic HLE symbols and resolves relocations
+ * against it the way the linker does at boot, comparing the hash index with a linear scan of
+ * generated names. The hash index resolves every relocation the given number of passes. Returns
+ * the process exit code.
+ */
+int RunLinkBenchmark(u32 numSymbols, u32 passes);
+
+} // namespace Core::Loader
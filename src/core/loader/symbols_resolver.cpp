@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <charconv>
 #include <fmt/format.h>
+#include "common/hash.h"
 #include "common/io_file.h"
 #include "common/string_util.h"
 #include "common/types.h"
@@ -10,7 +12,43 @@
 
 namespace Core::Loader {
 
+/// Returns whether a name built by GenerateName belongs to the given key, without building one.
+static bool NameMatches(std::string_view name, std::string_view nid, std::string_view library,
+                        u16 library_version, std::string_view module, std::string_view type) {
+    char version[8];
+    const auto [version_end, ec] = std::to_chars(version, version + sizeof(version),
+                                                 library_version);
+    const std::string_view parts[] = {nid, library, {version, version_end}, module, type};
+    for (size_t i = 0; i < std::size(parts); i++) {
+        if (!name.starts_with(parts[i])) {
+            return false;
+        }
+        name.remove_prefix(parts[i].size());
+        if (i + 1 < std::size(parts)) {
+            if (!name.starts_with('#')) {
+                return false;
+            }
+            name.remove_prefix(1);
+        }
+    }
+    return name.empty();
+}
+
+u64 SymbolsResolver::HashKey(std::string_view nid, std::string_view library, u16 library_version,
+                             std::string_view module, SymbolType type) {
+    const std::hash<std::string_view> hash{};
+    u64 seed = hash(nid);
+    seed = HashCombine(seed, u64{hash(library)});
+    seed = HashCombine(seed, u64{hash(module)});
+    return HashCombine(seed, (u64{library_version} << 8) | static_cast<u64>(type));
+}
+
 void SymbolsResolver::AddSymbol(const SymbolResolver& s, u64 virtual_addr) {
+    // Lookups return the first record of a key, so later duplicates are only listed.
+    if (!FindSymbol(s)) {
+        m_index.emplace(HashKey(s.name, s.library, s.library_version, s.module, s.type),
+                        static_cast<u32>(m_symbols.size()));
+    }
     m_symbols.emplace_back(GenerateName(s), s.nidName, virtual_addr);
 }
 
@@ -20,10 +58,19 @@ std::string SymbolsResolver::GenerateName(const SymbolResolver& s) {
 }
 
 const SymbolRecord* SymbolsResolver::FindSymbol(const SymbolResolver& s) const {
-    const std::string name = GenerateName(s);
-    for (u32 i = 0; i < m_symbols.size(); i++) {
-        if (m_symbols[i].name == name) {
-            return &m_symbols[i];
+    return FindSymbol(s.name, s.library, s.library_version, s.module, s.type);
+}
+
+const SymbolRecord* SymbolsResolver::FindSymbol(std::string_view nid, std::string_view library,
+                                                u16 library_version, std::string_view module,
+                                                SymbolType type) const {
+    const auto [begin, end] =
+        m_index.equal_range(HashKey(nid, library, library_version, module, type));
+    const auto type_name = SymbolTypeToS(type);
+    for (auto it = begin; it != end; ++it) {
+        const SymbolRecord& record = m_symbols[it->second];
+        if (NameMatches(record.name, nid, library, library_version, module, type_name)) {
+            return &record;
         }
     }
 
@@ -6,6 +6,8 @@
 #include <filesystem>
 #include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include "common/assert.h"
 #include "common/types.h"
@@ -43,6 +45,11 @@ public:
     void AddSymbol(const SymbolResolver& s, u64 virtual_addr);
     const SymbolRecord* FindSymbol(const SymbolResolver& s) const;
 
+    /// Looks up a symbol through the hash index without building its name.
+    const SymbolRecord* FindSymbol(std::string_view nid, std::string_view library,
+                                   u16 library_version, std::string_view module,
+                                   SymbolType type) const;
+
     void DebugDump(const std::filesystem::path& file_name);
 
     std::span<const SymbolRecord> GetSymbols() const {
@@ -73,7 +80,12 @@ public:
     }
 
 private:
+    static u64 HashKey(std::string_view nid, std::string_view library, u16 library_version,
+                       std::string_view module, SymbolType type);
+
     std::vector<SymbolRecord> m_symbols;
+    // Maps the key hash to the index of the first record with that key
+    std::unordered_multimap<u64, u32> m_index;
 };
 
 } // namespace Core::Loader
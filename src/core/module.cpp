@@ -1,9 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
+#include <thread>
 #include "common/alignment.h"
 #include "common/arch.h"
 #include "common/assert.h"
+#include "common/boot_timeline.h"
 #include "common/logging/log.h"
 #include "common/memory_patcher.h"
 #include "common/sha1.h"
@@ -85,11 +88,23 @@ static std::string StringToNid(std::string_view symbol) {
 
 Module::Module(Core::MemoryManager* memory_, const std::filesystem::path& file_, u32& max_tls_index)
     : memory{memory_}, file{file_}, name{file.filename().string()} {
+    using Clock = std::chrono::steady_clock;
+    const auto to_us = [](Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+    const auto start = Clock::now();
     elf.Open(file);
     if (elf.IsElfFile()) {
+        const auto opened = Clock::now();
         LoadModuleToMemory(max_tls_index);
+        const auto loaded = Clock::now();
         LoadDynamicInfo();
+        const auto parsed = Clock::now();
         LoadSymbols();
+        LOG_INFO(Core_Linker,
+                 "Loaded module {}: open {} us, memory {} us, dynamic info {} us, symbols {} us",
+                 name, to_us(opened - start), to_us(loaded - opened), to_us(parsed - loaded),
+                 to_us(Clock::now() - parsed));
     }
 }
 
@@ -97,6 +112,7 @@ Module::~Module() = default;
 
 s32 Module::Start(u64 args, const void* argp, void* param) {
     LOG_INFO(Core_Linker, "Module started : {}", name);
+    const Common::BootTimeline::Scope phase{fmt::format("Start {}", name)};
     const VAddr addr = dynamic_info.init_virtual_addr + GetBaseAddress();
     return reinterpret_cast<EntryFunc>(addr)(args, argp, param);
 }
@@ -423,9 +439,7 @@ void Module::LoadDynamicInfo() {
             LOG_INFO(Core_Linker, "unsupported dynamic tag ..........: {:#018x}", dyn->d_tag);
         }
     }
-    const u32 relabits_num = dynamic_info.relocation_table_size / sizeof(elf_relocation) +
-                             dynamic_info.jmp_relocation_table_size / sizeof(elf_relocation);
-    rela_bits.resize((relabits_num + 7) / 8);
+    rela_bits.resize((NumRelocations() + 7) / 8);
 }
 
 void Module::LoadSymbols() {
@@ -483,8 +497,16 @@ void Module::LoadSymbols() {
             symbol.AddSymbol(sym_r, sym_addr);
         }
     };
-    symbol_database(export_sym, true);
-    symbol_database(import_sym, false);
+
+    // Both tables walk the same symbols, build them side by side when there are many.
+    static constexpr u64 MinParallelSymbols = 2048;
+    if (dynamic_info.symbol_table_total_size / sizeof(elf_symbol) >= MinParallelSymbols) {
+        std::jthread import_thread{[&] { symbol_database(import_sym, false); }};
+        symbol_database(export_sym, true);
+    } else {
+        symbol_database(export_sym, true);
+        symbol_database(import_sym, false);
+    }
 }
 
 OrbisKernelModuleInfoEx Module::GetModuleInfoEx() const {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 #include "common/types.h"
@@ -195,20 +197,36 @@ public:
     }
 
     void ForEachRelocation(auto&& func) {
-        for (u32 i = 0; i < dynamic_info.relocation_table_size / sizeof(elf_relocation); i++) {
+        ForEachRelocation(0, NumRelocations(), func);
+    }
+
+    /// Visits the relocations in [begin, end), where the jump relocations follow the regular
+    /// ones. Ranges that do not overlap may be visited from different threads.
+    void ForEachRelocation(u32 begin, u32 end, auto&& func) {
+        const u32 num_relocs = dynamic_info.relocation_table_size / sizeof(elf_relocation);
+        for (u32 i = begin; i < std::min(end, num_relocs); i++) {
             func(&dynamic_info.relocation_table[i], i, false);
         }
-        for (u32 i = 0; i < dynamic_info.jmp_relocation_table_size / sizeof(elf_relocation); i++) {
-            func(&dynamic_info.jmp_relocation_table[i], i, true);
+        for (u32 i = std::max(begin, num_relocs); i < end; i++) {
+            func(&dynamic_info.jmp_relocation_table[i - num_relocs], i - num_relocs, true);
         }
     }
 
+    u32 NumRelocations() const noexcept {
+        return dynamic_info.relocation_table_size / sizeof(elf_relocation) +
+               dynamic_info.jmp_relocation_table_size / sizeof(elf_relocation);
+    }
+
+    // Neighbouring relocations may be resolved by different threads, so bits are accessed
+    // atomically.
     void SetRelaBit(u32 index) {
-        rela_bits[index >> 3] |= (1 << (index & 7));
+        std::atomic_ref{rela_bits[index >> 3]}.fetch_or(u8(1 << (index & 7)),
+                                                        std::memory_order_relaxed);
     }
 
-    bool TestRelaBit(u32 index) const {
-        return (rela_bits[index >> 3] >> (index & 7)) & 1;
+    bool TestRelaBit(u32 index) {
+        const u8 bits = std::atomic_ref{rela_bits[index >> 3]}.load(std::memory_order_relaxed);
+        return (bits >> (index & 7)) & 1;
     }
 
     s32 Start(u64 args, const void* argp, void* param);
@@ -10,6 +10,7 @@
 #include <fmt/xchar.h>
 #include <hwinfo/hwinfo.h>
 
+#include "common/boot_timeline.h"
 #include "common/debug.h"
 #include "common/logging/log.h"
 #include "common/thread.h"
@@ -130,6 +131,7 @@ std::map<s32, std::string> ExtractTrophies(const std::filesystem::path& npbind_p
         return trophy_index_map;
     }
 
+    std::vector<std::pair<std::filesystem::path, std::string>> trophy_files;
     std::string pattern = "trophy";
     for (const auto& entry : std::filesystem::directory_iterator(trophy_dir)) {
         if (entry.is_regular_file() && entry.path().extension() == ".trp") {
@@ -157,15 +159,24 @@ std::map<s32, std::string> ExtractTrophies(const std::filesystem::path& npbind_p
             trophy_index_map[trophy_index] = np_comm_id;
             LOG_DEBUG(Loader, "Mapped trophy index {} to NPCommID: {}", trophy_index, np_comm_id);
 
-            // Extract the actual trophies if they're no extracted yet
+            trophy_files.emplace_back(entry.path(), np_comm_id);
+        }
+    }
+
+    // Decrypting and writing the trophy files takes a while on first boot, so the game starts
+    // while it runs and the trophy library waits for it when a context is registered.
+    Libraries::Np::NpTrophy::ExtractTrophiesInBackground([trophy_files =
+                                                              std::move(trophy_files)] {
+        Common::SetCurrentThreadName("shadPS4:TrophyExtract");
+        const Common::BootTimeline::Scope phase{"Extract trophies"};
+        for (const auto& [trp_path, np_comm_id] : trophy_files) {
+            // Extract the actual trophies, this is skipped if they did not change
             const auto& trophy_output_dir =
                 Common::FS::GetUserPath(Common::FS::PathType::UserDir) / "trophy" / np_comm_id;
-            if (!std::filesystem::exists(trophy_output_dir)) {
-                TRP trp;
-                if (!trp.Extract(entry, np_comm_id, trophy_output_dir)) {
-                    LOG_ERROR(Loader, "Couldn't extract trophy file {}", filename);
-                    continue;
-                }
+            TRP trp;
+            if (!trp.Extract(trp_path, np_comm_id, trophy_output_dir)) {
+                LOG_ERROR(Loader, "Couldn't extract trophy file {}", trp_path.filename().string());
+                continue;
             }
 
             // Move extracted trophy contents into each user's folder
@@ -182,7 +193,7 @@ std::map<s32, std::string> ExtractTrophies(const std::filesystem::path& npbind_p
                 }
             }
         }
-    }
+    });
     return trophy_index_map;
 }
 
@@ -192,6 +203,8 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     if (waitForDebuggerBeforeRun) {
         Debugger::WaitForDebuggerAttach();
     }
+    // Closed when the first frame is presented.
+    Common::BootTimeline::Begin("Emulator::Run");
 
     if (std::filesystem::is_directory(file)) {
         file /= "eboot.bin";
@@ -227,6 +240,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     const auto param_sfo_exists = std::filesystem::exists(param_sfo_path);
 
     // Load param.sfo details if it exists
+    Common::BootTimeline::Begin("Read param.sfo");
     std::string id;
     std::string title;
     std::string app_version;
@@ -274,7 +288,9 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
             sdk_version = std::stoi(sdk_ver_string, nullptr, 16);
         }
     }
+    Common::BootTimeline::End();
 
+    Common::BootTimeline::Begin("Load settings");
     EmulatorSettings.Load(id);
     // Switch to configured log
     Common::Log::Switch((!id.empty() && EmulatorSettings.IsLogSeparate()) ? id + ".log"
@@ -292,6 +308,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     game_info.raw_firmware_ver = fw_version;
     game_info.sdk_ver = ReadCompiledSdkVersion(eboot_path);
     game_info.psf_attributes = psf_attributes;
+    Common::BootTimeline::End();
 
     const auto pic1_path = mnt->GetHostPath("/app0/sce_sys/pic1.png");
     if (std::filesystem::exists(pic1_path)) {
@@ -320,6 +337,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     LOG_INFO(Config, "General isConnectedToNetwork: {}", EmulatorSettings.IsConnectedToNetwork());
     LOG_INFO(Config, "General isShadNetEnabled: {}", EmulatorSettings.IsShadNetEnabled());
     LOG_INFO(Config, "Log sync: {}", EmulatorSettings.IsLogSync());
+    LOG_INFO(Config, "Log deferred: {}", EmulatorSettings.IsLogDeferred());
     LOG_INFO(Config, "Log skipDuplicate: {}", EmulatorSettings.IsLogSkipDuplicate());
 #ifdef _WIN32
     LOG_INFO(Config, "Log type: {}", EmulatorSettings.GetLogType());
@@ -329,6 +347,8 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     LOG_INFO(Config, "GPU readbackLinearImages: {}",
              EmulatorSettings.IsReadbackLinearImagesEnabled());
     LOG_INFO(Config, "GPU directMemoryAccess: {}", EmulatorSettings.IsDirectMemoryAccessEnabled());
+    LOG_INFO(Config, "GPU batchWriteFaults: {}", EmulatorSettings.IsBatchWriteFaults());
+    LOG_INFO(Config, "GPU writeTracking: {}", EmulatorSettings.GetWriteTracking());
     LOG_INFO(Config, "GPU shouldDumpShaders: {}", EmulatorSettings.IsDumpShaders());
     LOG_INFO(Config, "GPU vblankFrequency: {}", EmulatorSettings.GetVblankFrequency());
     LOG_INFO(Config, "GPU shouldCopyGPUBuffers: {}", EmulatorSettings.IsCopyGpuBuffers());
@@ -344,7 +364,11 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     LOG_INFO(Config, "Vulkan PipelineCacheEnabled: {}", EmulatorSettings.IsPipelineCacheEnabled());
     LOG_INFO(Config, "Vulkan PipelineCacheArchived: {}",
              EmulatorSettings.IsPipelineCacheArchived());
+    LOG_INFO(Config, "Vulkan PipelineCacheBackgroundLoad: {}",
+             EmulatorSettings.IsPipelineCacheBackgroundLoad());
+    LOG_INFO(Config, "Vulkan AsyncShaderCompile: {}", EmulatorSettings.IsAsyncShaderCompile());
 
+    Common::BootTimeline::Begin("Query hardware info");
     hwinfo::Memory ram;
     hwinfo::OS os;
     const auto cpus = hwinfo::getAllCPUs();
@@ -355,6 +379,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     }
     LOG_INFO(Config, "Total RAM: {} GB", std::round(ram.total_Bytes() / pow(1024, 3)));
     LOG_INFO(Config, "Operating System: {}", os.name());
+    Common::BootTimeline::End();
 
     if (param_sfo_exists) {
         LOG_INFO(Loader, "Game id: {} Title: {}", id, title);
@@ -384,6 +409,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     }
 
     // Create stdin/stdout/stderr
+    Common::BootTimeline::Begin("Initialize components");
     Common::Singleton<FileSys::HandleTable>::Instance()->CreateStdHandles();
 
     // Initialize components
@@ -398,11 +424,14 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     if (!id.empty()) {
         MemoryPatcher::g_game_serial = id;
     }
+    Common::BootTimeline::End();
 
     // Extract and load trophies
+    Common::BootTimeline::Begin("Map trophies");
     std::filesystem::path npbind_path = mnt->GetHostPath("/app0/sce_sys/npbind.dat");
     std::filesystem::path trophy_dir = mnt->GetHostPath("/app0/sce_sys/trophy");
     game_info.trophy_index_map = ExtractTrophies(npbind_path, trophy_dir);
+    Common::BootTimeline::End();
 
     std::string game_title = fmt::format("{} - {} <{}>", id, title, app_version);
     std::string window_title = "";
@@ -424,12 +453,15 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
                                        Common::g_scm_branch, Common::g_scm_desc, game_title);
         }
     }
+    Common::BootTimeline::Begin("Create window");
     window = std::make_unique<Frontend::WindowSDL>(EmulatorSettings.GetWindowWidth(),
                                                    EmulatorSettings.GetWindowHeight(), controllers,
                                                    window_title);
 
     g_window = window.get();
+    Common::BootTimeline::End();
 
+    Common::BootTimeline::Begin("Mount directories");
     const auto& mount_data_dir = Common::FS::GetUserPath(Common::FS::PathType::GameDataDir);
     mnt->Mount(mount_data_dir, "/data");
 
@@ -483,9 +515,12 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     if (std::filesystem::is_empty(host_font_dir) || std::filesystem::is_empty(host_font2_dir)) {
         LOG_WARNING(Loader, "No dumped system fonts, expect missing text or instability");
     }
+    Common::BootTimeline::End();
 
     // Initialize kernel and library facilities.
+    Common::BootTimeline::Begin("InitHLELibs");
     Libraries::InitHLELibs(&linker->GetHLESymbols());
+    Common::BootTimeline::End();
 
     // Load the module with the linker
     if (linker->LoadModule(eboot_path) == -1) {
@@ -516,7 +551,9 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
         });
     }
 
+    Common::BootTimeline::Begin("Linker::Execute");
     linker->Execute(args);
+    Common::BootTimeline::End();
 
     window->InitTimers();
     while (window->IsOpen()) {
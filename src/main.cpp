@@ -19,9 +19,15 @@
 #include "core/emulator_state.h"
 #include "core/file_sys/fs.h"
 #include "core/ipc/ipc.h"
+#include "core/libraries/ajm/ajm_benchmark.h"
+#include "core/libraries/font/glyph_benchmark.h"
+#include "core/libraries/kernel/sync/sync_benchmark.h"
+#include "core/libraries/ngs2/ngs2_benchmark.h"
+#include "core/loader/link_benchmark.h"
 #include "core/user_settings.h"
 #include "emulator.h"
 #include "imgui/big_picture/big_picture.h"
+#include "video_core/amdgpu/pm4_replay.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -66,6 +72,18 @@ int main(int argc, char* argv[]) {
     std::optional<std::filesystem::path> addGameFolder;
     std::optional<std::filesystem::path> setAddonFolder;
     std::optional<std::string> patchFile;
+    std::optional<std::filesystem::path> replayPm4;
+    u32 replayIterations = 1;
+    std::optional<std::filesystem::path> benchAjm;
+    u32 benchAjmPasses = 1;
+    std::optional<u32> benchNgs2;
+    u32 benchNgs2Seconds = 1;
+    std::optional<u32> benchSync;
+    u32 benchSyncRounds = 1;
+    std::optional<u32> benchLink;
+    u32 benchLinkPasses = 1;
+    std::optional<u32> benchGlyphs;
+    u32 benchGlyphsFrames = 60;
 
     // ---- Options ----
     app.add_option("-g,--game", gamePath, "Game path or ID");
@@ -91,6 +109,42 @@ int main(int argc, char* argv[]) {
     app.add_option("--add-game-folder", addGameFolder)->check(CLI::ExistingDirectory);
     app.add_option("--set-addon-folder", setAddonFolder)->check(CLI::ExistingDirectory);
 
+    app.add_option("--replay-pm4", replayPm4, "Replay a PM4 capture and print packet timings")
+        ->check(CLI::ExistingFile);
+    app.add_option("--replay-iterations", replayIterations, "Number of times to replay the capture")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-ajm", benchAjm,
+                   "Decode a .mp3/.aac/.at9 stream or directory of streams and print job latencies")
+        ->check(CLI::ExistingPath);
+    app.add_option("--bench-ajm-passes", benchAjmPasses,
+                   "Number of times to decode each stream with --bench-ajm")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-ngs2", benchNgs2,
+                   "Render the given number of NGS2 sampler voices and print grain latencies")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-ngs2-seconds", benchNgs2Seconds,
+                   "Seconds of audio to render with --bench-ngs2")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-sync", benchSync,
+                   "Time kernel semaphore and mutex operations with the given number of threads")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-sync-rounds", benchSyncRounds,
+                   "Rounds of a million operations per test to run with --bench-sync")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-link", benchLink,
+                   "Resolve relocations against the given number of HLE symbols and print lookup "
+                   "times")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-link-passes", benchLinkPasses,
+                   "Number of passes over the relocations with --bench-link")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-glyphs", benchGlyphs,
+                   "Render the given number of glyphs per frame with and without the glyph cache")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--bench-glyphs-frames", benchGlyphsFrames,
+                   "Number of frames to render with --bench-glyphs")
+        ->check(CLI::PositiveNumber);
+
     // ---- Capture args after `--` verbatim ----
     app.allow_extras();
     app.parse_complete_callback([&]() {
@@ -162,6 +216,30 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    if (replayPm4) {
+        return AmdGpu::ReplayPm4Capture(*replayPm4, replayIterations);
+    }
+
+    if (benchAjm) {
+        return Libraries::Ajm::RunAjmBenchmark(*benchAjm, benchAjmPasses);
+    }
+
+    if (benchNgs2) {
+        return Libraries::Ngs2::RunNgs2Benchmark(*benchNgs2, benchNgs2Seconds);
+    }
+
+    if (benchSync) {
+        return Libraries::Kernel::RunSyncBenchmark(*benchSync, benchSyncRounds);
+    }
+
+    if (benchLink) {
+        return Core::Loader::RunLinkBenchmark(*benchLink, benchLinkPasses);
+    }
+
+    if (benchGlyphs) {
+        return Libraries::Font::RunGlyphBenchmark(*benchGlyphs, benchGlyphsFrames);
+    }
+
     if (!gamePath.has_value()) {
         if (!gameArgs.empty()) {
             gamePath = gameArgs.front();
@@ -8,6 +8,7 @@
 #include "shader_recompiler/info.h"
 #include "shader_recompiler/ir/abstract_syntax_list.h"
 #include "shader_recompiler/ir/basic_block.h"
+#include "shader_recompiler/pass_stats.h"
 
 namespace Shader::IR {
 
@@ -18,6 +19,7 @@ struct Program {
     BlockList blocks;
     BlockList post_order_blocks;
     std::vector<Gcn::GcnInst> ins_list;
+    std::vector<PassStats> pass_stats;
     Info& info;
 };
 
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <mutex>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "common/io_file.h"
+#include "common/logging/log.h"
+#include "shader_recompiler/ir/program.h"
+#include "shader_recompiler/pass_stats.h"
+
+namespace Shader {
+
+namespace {
+
+std::mutex stats_mutex;
+std::vector<ProgramStats> program_stats;
+std::vector<PassTotals> pass_totals;
+
+} // Anonymous namespace
+
+PassRecorder::PassRecorder(const IR::Program& program_, bool enabled_)
+    : program{program_}, enabled{enabled_} {
+    stats.pgm_hash = program.info.pgm_hash;
+    stats.stage = program.info.stage;
+}
+
+std::pair<u32, u32> PassRecorder::CountIR() const {
+    u32 num_insts = 0;
+    for (const IR::Block* block : program.blocks) {
+        num_insts += static_cast<u32>(block->size());
+    }
+    return {num_insts, static_cast<u32>(program.blocks.size())};
+}
+
+std::vector<PassStats> PassRecorder::Finish() {
+    if (!enabled) {
+        return {};
+    }
+    for (const auto& pass : stats.passes) {
+        stats.time_ns += pass.time_ns;
+    }
+
+    std::scoped_lock lk{stats_mutex};
+    for (const auto& pass : stats.passes) {
+        auto it = std::ranges::find(pass_totals, pass.name, &PassTotals::name);
+        if (it == pass_totals.end()) {
+            it = pass_totals.insert(it, {.name = pass.name});
+        }
+        ++it->num_runs;
+        it->time_ns += pass.time_ns;
+        it->max_time_ns = std::max(it->max_time_ns, pass.time_ns);
+        it->insts_before += pass.insts_before;
+        it->insts_after += pass.insts_after;
+    }
+    program_stats.push_back(stats);
+    return std::move(stats.passes);
+}
+
+std::vector<ProgramStats> GetProgramStats() {
+    std::scoped_lock lk{stats_mutex};
+    return program_stats;
+}
+
+std::vector<PassTotals> GetPassTotals() {
+    std::scoped_lock lk{stats_mutex};
+    return pass_totals;
+}
+
+bool WritePassStats(const std::filesystem::path& path) {
+    nlohmann::json passes = nlohmann::json::array();
+    for (const auto& pass : GetPassTotals()) {
+        passes.push_back({
+            {"name", pass.name},
+            {"runs", pass.num_runs},
+            {"time_ns", pass.time_ns},
+            {"max_time_ns", pass.max_time_ns},
+            {"insts_before", pass.insts_before},
+            {"insts_after", pass.insts_after},
+        });
+    }
+
+    nlohmann::json programs = nlohmann::json::array();
+    for (const auto& program : GetProgramStats()) {
+        nlohmann::json program_passes = nlohmann::json::array();
+        for (const auto& pass : program.passes) {
+            program_passes.push_back({
+                {"name", pass.name},
+                {"time_ns", pass.time_ns},
+                {"insts_before", pass.insts_before},
+                {"insts_after", pass.insts_after},
+                {"blocks_before", pass.blocks_before},
+                {"blocks_after", pass.blocks_after},
+            });
+        }
+        programs.push_back({
+            {"hash", fmt::format("{:#018x}", program.pgm_hash)},
+            {"stage", fmt::format("{}", program.stage)},
+            {"time_ns", program.time_ns},
+            {"passes", std::move(program_passes)},
+        });
+    }
+
+    const nlohmann::json root = {{"passes", std::move(passes)}, {"programs", std::move(programs)}};
+    const auto file = Common::FS::IOFile{path, Common::FS::FileAccessMode::Create,
+                                         Common::FS::FileType::TextFile};
+    if (!file.IsOpen() || file.WriteString(root.dump(2)) == 0) {
+        LOG_ERROR(Render_Recompiler, "Failed to write shader pass statistics to {}",
+                  path.string());
+        return false;
+    }
+    return true;
+}
+
+} // namespace Shader
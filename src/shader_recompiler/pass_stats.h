@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include "common/types.h"
+#include "shader_recompiler/runtime_info.h"
+
+namespace Shader {
+
+namespace IR {
+struct Program;
+}
+
+/// Cost of a single translation step over one program.
+struct PassStats {
+    std::string_view name;
+    u64 time_ns;
+    u32 insts_before;
+    u32 insts_after;
+    u32 blocks_before;
+    u32 blocks_after;
+};
+
+struct ProgramStats {
+    u64 pgm_hash{};
+    Stage stage{};
+    u64 time_ns{};
+    std::vector<PassStats> passes;
+};
+
+/// Totals of a single translation step over every program of the session.
+struct PassTotals {
+    std::string_view name;
+    u64 num_runs{};
+    u64 time_ns{};
+    u64 max_time_ns{};
+    u64 insts_before{};
+    u64 insts_after{};
+};
+
+/// Times the steps of a translation and counts the IR they leave behind. Does nothing unless
+/// enabled, so the passes can be wrapped unconditionally.
+class PassRecorder {
+public:
+    explicit PassRecorder(const IR::Program& program, bool enabled);
+
+    template <typename Func>
+    void Run(std::string_view name, Func&& func) {
+        if (!enabled) {
+            func();
+            return;
+        }
+        const auto [insts_before, blocks_before] = CountIR();
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        const auto [insts_after, blocks_after] = CountIR();
+        stats.passes.push_back({
+            .name = name,
+            .time_ns = static_cast<u64>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()),
+            .insts_before = insts_before,
+            .insts_after = insts_after,
+            .blocks_before = blocks_before,
+            .blocks_after = blocks_after,
+        });
+    }
+
+    /// Adds the recorded program to the session statistics and returns its passes.
+    std::vector<PassStats> Finish();
+
+private:
+    std::pair<u32, u32> CountIR() const;
+
+    const IR::Program& program;
+    bool enabled;
+    ProgramStats stats;
+};
+
+/// Returns the statistics of every program recorded this session.
+std::vector<ProgramStats> GetProgramStats();
+
+/// Returns the statistics of every pass aggregated over the session, in pipeline order.
+std::vector<PassTotals> GetPassTotals();
+
+/// Writes the per-pass totals and per-program statistics as JSON.
+bool WritePassStats(const std::filesystem::path& path);
+
+} // namespace Shader
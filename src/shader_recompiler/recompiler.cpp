@@ -1,11 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <optional>
+
+#include "core/emulator_settings.h"
 #include "shader_recompiler/frontend/control_flow_graph.h"
 #include "shader_recompiler/frontend/decode.h"
 #include "shader_recompiler/frontend/structured_control_flow.h"
 #include "shader_recompiler/ir/passes/ir_passes.h"
 #include "shader_recompiler/ir/post_order.h"
+#include "shader_recompiler/pass_stats.h"
 #include "shader_recompiler/profile.h"
 #include "shader_recompiler/recompiler.h"
 
@@ -39,56 +43,88 @@ IR::Program TranslateProgram(const std::span<const u32>& code, Pools& pools, Inf
     Gcn::GcnCodeSlice slice(code.data(), code.data() + code.size());
     Gcn::GcnDecodeContext decoder;
 
-    // Decode and save instructions
     IR::Program program{info};
-    program.ins_list.reserve(code.size());
-    while (!slice.atEnd()) {
-        program.ins_list.emplace_back(decoder.decodeInstruction(slice));
-    }
+    PassRecorder recorder{program, EmulatorSettings.IsShaderPassStats()};
+
+    // Decode and save instructions
+    recorder.Run("Decode", [&] {
+        program.ins_list.reserve(code.size());
+        while (!slice.atEnd()) {
+            program.ins_list.emplace_back(decoder.decodeInstruction(slice));
+        }
+    });
 
     // Clear any previous pooled data.
     pools.ReleaseContents();
 
     // Create control flow graph
     Common::ObjectPool<Gcn::Block> gcn_block_pool{64};
-    Gcn::CFG cfg{gcn_block_pool, program.ins_list};
+    std::optional<Gcn::CFG> cfg;
+    recorder.Run("BuildCFG", [&] { cfg.emplace(gcn_block_pool, program.ins_list); });
 
     // Structurize control flow graph and create program.
-    program.syntax_list =
-        Shader::Gcn::BuildASL(pools.inst_pool, pools.block_pool, cfg, info, runtime_info, profile);
-    program.blocks = GenerateBlocks(program.syntax_list);
-    program.post_order_blocks = Shader::IR::PostOrder(program.syntax_list.front());
+    recorder.Run("BuildASL", [&] {
+        program.syntax_list = Shader::Gcn::BuildASL(pools.inst_pool, pools.block_pool, *cfg, info,
+                                                    runtime_info, profile);
+        program.blocks = GenerateBlocks(program.syntax_list);
+        program.post_order_blocks = Shader::IR::PostOrder(program.syntax_list.front());
+    });
 
     // On NVIDIA GPUs HW interpolation of clip distance values seems broken, and we need to emulate
     // it with expensive discard in PS.
-    Shader::InjectClipDistanceAttributes(program, runtime_info);
+    recorder.Run("InjectClipDistanceAttributes",
+                 [&] { Shader::InjectClipDistanceAttributes(program, runtime_info); });
 
     // Run optimization passes
     if (!profile.support_float64) {
-        Shader::Optimization::LowerFp64ToFp32(program);
+        recorder.Run("LowerFp64ToFp32", [&] { Shader::Optimization::LowerFp64ToFp32(program); });
     }
-    Shader::Optimization::SsaRewritePass(program.post_order_blocks);
-    Shader::Optimization::ConstantPropagationPass(program.post_order_blocks);
-    Shader::Optimization::IdentityRemovalPass(program.blocks);
+    recorder.Run("SsaRewritePass",
+                 [&] { Shader::Optimization::SsaRewritePass(program.post_order_blocks); });
+    recorder.Run("ConstantPropagationPass",
+                 [&] { Shader::Optimization::ConstantPropagationPass(program.post_order_blocks); });
+    recorder.Run("IdentityRemovalPass",
+                 [&] { Shader::Optimization::IdentityRemovalPass(program.blocks); });
     if (info.l_stage == LogicalStage::TessellationControl) {
-        Shader::Optimization::TessellationPreprocess(program, runtime_info);
-        Shader::Optimization::HullShaderTransform(program, runtime_info);
+        recorder.Run("TessellationPreprocess", [&] {
+            Shader::Optimization::TessellationPreprocess(program, runtime_info);
+        });
+        recorder.Run("HullShaderTransform",
+                     [&] { Shader::Optimization::HullShaderTransform(program, runtime_info); });
     } else if (info.l_stage == LogicalStage::TessellationEval) {
-        Shader::Optimization::TessellationPreprocess(program, runtime_info);
-        Shader::Optimization::DomainShaderTransform(program, runtime_info);
+        recorder.Run("TessellationPreprocess", [&] {
+            Shader::Optimization::TessellationPreprocess(program, runtime_info);
+        });
+        recorder.Run("DomainShaderTransform",
+                     [&] { Shader::Optimization::DomainShaderTransform(program, runtime_info); });
     }
-    Shader::Optimization::RingAccessElimination(program, runtime_info);
-    Shader::Optimization::ReadLaneEliminationPass(program);
-    Shader::Optimization::FlattenExtendedUserdataPass(program);
-    Shader::Optimization::ResourceTrackingPass(program, profile);
-    Shader::Optimization::LowerBufferFormatToRaw(program);
-    Shader::Optimization::SharedMemorySimplifyPass(program, profile);
-    Shader::Optimization::SharedMemoryToStoragePass(program, runtime_info, profile);
-    Shader::Optimization::SharedMemoryBarrierPass(program, runtime_info, profile);
-    Shader::Optimization::IdentityRemovalPass(program.blocks);
-    Shader::Optimization::DeadCodeEliminationPass(program);
-    Shader::Optimization::ConstantPropagationPass(program.post_order_blocks);
-    Shader::Optimization::CollectShaderInfoPass(program, profile);
+    recorder.Run("RingAccessElimination",
+                 [&] { Shader::Optimization::RingAccessElimination(program, runtime_info); });
+    recorder.Run("ReadLaneEliminationPass",
+                 [&] { Shader::Optimization::ReadLaneEliminationPass(program); });
+    recorder.Run("FlattenExtendedUserdataPass",
+                 [&] { Shader::Optimization::FlattenExtendedUserdataPass(program); });
+    recorder.Run("ResourceTrackingPass",
+                 [&] { Shader::Optimization::ResourceTrackingPass(program, profile); });
+    recorder.Run("LowerBufferFormatToRaw",
+                 [&] { Shader::Optimization::LowerBufferFormatToRaw(program); });
+    recorder.Run("SharedMemorySimplifyPass",
+                 [&] { Shader::Optimization::SharedMemorySimplifyPass(program, profile); });
+    recorder.Run("SharedMemoryToStoragePass", [&] {
+        Shader::Optimization::SharedMemoryToStoragePass(program, runtime_info, profile);
+    });
+    recorder.Run("SharedMemoryBarrierPass", [&] {
+        Shader::Optimization::SharedMemoryBarrierPass(program, runtime_info, profile);
+    });
+    recorder.Run("IdentityRemovalPass",
+                 [&] { Shader::Optimization::IdentityRemovalPass(program.blocks); });
+    recorder.Run("DeadCodeEliminationPass",
+                 [&] { Shader::Optimization::DeadCodeEliminationPass(program); });
+    recorder.Run("ConstantPropagationPass",
+                 [&] { Shader::Optimization::ConstantPropagationPass(program.post_order_blocks); });
+    recorder.Run("CollectShaderInfoPass",
+                 [&] { Shader::Optimization::CollectShaderInfoPass(program, profile); });
+    program.pass_stats = recorder.Finish();
 
     Shader::IR::DumpProgram(program, info);
 
@@ -1,10 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2024-2026 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
 #include <boost/preprocessor/stringize.hpp>
 
 #include "common/assert.h"
 #include "common/debug.h"
+#include "common/path_util.h"
 #include "common/polyfill_thread.h"
 #include "common/thread.h"
 #include "core/debug_state.h"
@@ -14,6 +16,7 @@
 #include "core/memory.h"
 #include "core/platform.h"
 #include "video_core/amdgpu/liverpool.h"
+#include "video_core/amdgpu/pm4_capture.h"
 #include "video_core/amdgpu/pm4_cmds.h"
 #include "video_core/renderdoc.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
@@ -65,8 +68,43 @@ static std::span<const u32> NextPacket(std::span<const u32> span, size_t offset)
     return span.subspan(offset);
 }
 
+/// Adds the time spent on a packet to the replay statistics, if they are being gathered.
+class PacketTimer {
+public:
+    explicit PacketTimer(Pm4Stats::Opcode* entry_) : entry{entry_} {
+        if (entry) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~PacketTimer() {
+        if (entry) {
+            const auto end = std::chrono::steady_clock::now();
+            ++entry->count;
+            entry->time_ns +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        }
+    }
+
+private:
+    Pm4Stats::Opcode* entry;
+    std::chrono::steady_clock::time_point start{};
+};
+
+static Pm4Stats::Opcode* GetStatsEntry(std::array<Pm4Stats::Opcode, 256>* table,
+                                       PM4ItOpcode opcode) {
+    return table ? &(*table)[static_cast<u32>(opcode) & 0xFF] : nullptr;
+}
+
 Liverpool::Liverpool() {
     num_counter_pairs = Libraries::Kernel::sceKernelIsNeoMode() ? 16 : 8;
+    if (const u32 num_frames = EmulatorSettings.GetPm4CaptureFrames(); num_frames > 0) {
+        const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch());
+        const auto path = Common::FS::GetUserPath(Common::FS::PathType::CapturesDir) /
+                          fmt::format("pm4_{}.bin", now.count());
+        recorder = std::make_unique<Pm4Recorder>(path, num_frames, num_counter_pairs);
+    }
     process_thread = std::jthread{std::bind_front(&Liverpool::Process, this)};
 }
 
@@ -75,6 +113,27 @@ Liverpool::~Liverpool() {
     process_thread.join();
 }
 
+void Liverpool::SubmitDone() noexcept {
+    if (recorder) {
+        recorder->RecordSubmitDone();
+    }
+    std::scoped_lock lk{submit_mutex};
+    mapped_queues[GfxQueueId].ccb_buffer_offset = 0;
+    mapped_queues[GfxQueueId].dcb_buffer_offset = 0;
+    submit_done = true;
+    submit_cv.notify_one();
+}
+
+void Liverpool::WriteFenceValue(void* address, u64 data, u32 num_bytes) {
+    if (!replay_mode) {
+        auto* memory = Core::Memory::Instance();
+        if (memory->TryWriteBacking(address, &data, num_bytes)) {
+            return;
+        }
+    }
+    memcpy(address, &data, num_bytes);
+}
+
 void Liverpool::ProcessCommands() {
     // Process incoming commands with high priority
     while (num_commands) {
@@ -163,6 +222,7 @@ Liverpool::Task Liverpool::ProcessCeUpdate(std::span<const u32> ccb) {
         }
 
         const PM4ItOpcode opcode = header->type3.opcode;
+        const PacketTimer timer{GetStatsEntry(pm4_stats ? &pm4_stats->gfx : nullptr, opcode)};
         const auto* it_body = reinterpret_cast<const u32*>(header) + 1;
         switch (opcode) {
         case PM4ItOpcode::Nop: {
@@ -254,6 +314,7 @@ Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<c
         case 3:
             const u32 count = header->type3.NumWords();
             const PM4ItOpcode opcode = header->type3.opcode;
+            const PacketTimer timer{GetStatsEntry(pm4_stats ? &pm4_stats->gfx : nullptr, opcode)};
             switch (opcode) {
             case PM4ItOpcode::Nop: {
                 const auto* nop = reinterpret_cast<const PM4CmdNop*>(header);
@@ -691,11 +752,8 @@ Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<c
             }
             case PM4ItOpcode::EventWriteEos: {
                 const auto* event_eos = reinterpret_cast<const PM4CmdEventWriteEos*>(header);
-                event_eos->SignalFence([](void* address, u64 data, u32 num_bytes) {
-                    auto* memory = Core::Memory::Instance();
-                    if (!memory->TryWriteBacking(address, &data, num_bytes)) {
-                        memcpy(address, &data, num_bytes);
-                    }
+                event_eos->SignalFence([this](void* address, u64 data, u32 num_bytes) {
+                    WriteFenceValue(address, data, num_bytes);
                 });
                 if (event_eos->command == PM4CmdEventWriteEos::Command::GdsStore) {
                     ASSERT(event_eos->size == 1);
@@ -710,11 +768,8 @@ Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<c
             case PM4ItOpcode::EventWriteEop: {
                 const auto* event_eop = reinterpret_cast<const PM4CmdEventWriteEop*>(header);
                 event_eop->SignalFence(
-                    [](void* address, u64 data, u32 num_bytes) {
-                        auto* memory = Core::Memory::Instance();
-                        if (!memory->TryWriteBacking(address, &data, num_bytes)) {
-                            memcpy(address, &data, num_bytes);
-                        }
+                    [this](void* address, u64 data, u32 num_bytes) {
+                        WriteFenceValue(address, data, num_bytes);
                     },
                     [] { Platform::IrqC::Instance()->Signal(Platform::InterruptId::GfxEop); });
                 break;
@@ -781,7 +836,7 @@ Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<c
                 const auto* mem_semaphore = reinterpret_cast<const PM4CmdMemSemaphore*>(header);
                 if (mem_semaphore->IsSignaling()) {
                     mem_semaphore->Signal();
-                } else {
+                } else if (!replay_mode || mem_semaphore->Signaled()) {
                     while (!mem_semaphore->Signaled()) {
                         YIELD_GFX();
                     }
@@ -806,6 +861,9 @@ Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<c
             case PM4ItOpcode::WaitRegMem: {
                 const auto* wait_reg_mem = reinterpret_cast<const PM4CmdWaitRegMem*>(header);
                 // ASSERT(wait_reg_mem->engine.Value() == PM4CmdWaitRegMem::Engine::Me);
+                if (replay_mode) {
+                    break;
+                }
                 // Optimization: VO label waits are special because the emulator
                 // will write to the label when presentation is finished. So if
                 // there are no other submits to yield to we can sleep the thread
@@ -952,6 +1010,7 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
         }
 
         const PM4ItOpcode opcode = header->type3.opcode;
+        const PacketTimer timer{GetStatsEntry(pm4_stats ? &pm4_stats->asc : nullptr, opcode)};
 
         const auto* it_body = reinterpret_cast<const u32*>(header) + 1;
         switch (opcode) {
@@ -1119,7 +1178,7 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
             const auto* mem_semaphore = reinterpret_cast<const PM4CmdMemSemaphore*>(header);
             if (mem_semaphore->IsSignaling()) {
                 mem_semaphore->Signal();
-            } else {
+            } else if (!replay_mode || mem_semaphore->Signaled()) {
                 while (!mem_semaphore->Signaled()) {
                     YIELD_ASC(vqid);
                 }
@@ -1130,7 +1189,7 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
         case PM4ItOpcode::WaitRegMem: {
             const auto* wait_reg_mem = reinterpret_cast<const PM4CmdWaitRegMem*>(header);
             ASSERT(wait_reg_mem->engine.Value() == PM4CmdWaitRegMem::Engine::Me);
-            while (!wait_reg_mem->Test(regs.reg_array)) {
+            while (!replay_mode && !wait_reg_mem->Test(regs.reg_array)) {
                 YIELD_ASC(vqid);
             }
             break;
@@ -1142,7 +1201,10 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
                     Platform::IrqC::Instance()->Signal(static_cast<Platform::InterruptId>(pipe_id));
                 },
                 [this](VAddr dst, u16 gds_index, u16 num_dwords) {
-                    rasterizer->CopyBuffer(dst, gds_index, num_dwords * sizeof(u32), false, true);
+                    if (rasterizer) {
+                        rasterizer->CopyBuffer(dst, gds_index, num_dwords * sizeof(u32), false,
+                                               true);
+                    }
                 });
             break;
         }
@@ -1202,6 +1264,12 @@ Liverpool::CmdBuffer Liverpool::CopyCmdBuffers(std::span<const u32> dcb, std::sp
 void Liverpool::SubmitGfx(std::span<const u32> dcb, std::span<const u32> ccb) {
     auto& queue = mapped_queues[GfxQueueId];
 
+    if (rasterizer) {
+        rasterizer->FlushGuestWrites();
+    }
+    if (recorder) {
+        recorder->RecordGfx(dcb, ccb);
+    }
     if (EmulatorSettings.IsCopyGpuBuffers()) {
         std::tie(dcb, ccb) = CopyCmdBuffers(dcb, ccb);
     }
@@ -1222,6 +1290,12 @@ void Liverpool::SubmitAsc(u32 gnm_vqid, std::span<const u32> acb) {
     auto& queue = mapped_queues[gnm_vqid];
 
     const auto vqid = gnm_vqid - 1;
+    if (rasterizer) {
+        rasterizer->FlushGuestWrites();
+    }
+    if (recorder) {
+        recorder->RecordAsc(gnm_vqid, asc_queues[{vqid}].pipe_id, acb);
+    }
     const auto& task = ProcessCompute(acb, vqid);
     {
         std::scoped_lock lock{queue.m_access};
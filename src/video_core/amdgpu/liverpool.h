@@ -6,6 +6,7 @@
 #include <condition_variable>
 #include <coroutine>
 #include <exception>
+#include <memory>
 #include <mutex>
 #include <semaphore>
 #include <span>
@@ -30,6 +31,19 @@ struct VideoOutPort;
 
 namespace AmdGpu {
 
+class Pm4Recorder;
+
+/// Per-opcode packet counts and processing times, gathered while replaying a capture. The time of
+/// indirect buffer packets includes the packets they contain.
+struct Pm4Stats {
+    struct Opcode {
+        u64 count;
+        u64 time_ns;
+    };
+    std::array<Opcode, 256> gfx{};
+    std::array<Opcode, 256> asc{};
+};
+
 struct Liverpool {
     static constexpr u32 GfxQueueId = 0u;
     static constexpr u32 NumGfxRings = 1u;     // actually 2, but HP is reserved by system software
@@ -70,13 +84,7 @@ public:
     void SubmitGfx(std::span<const u32> dcb, std::span<const u32> ccb);
     void SubmitAsc(u32 gnm_vqid, std::span<const u32> acb);
 
-    void SubmitDone() noexcept {
-        std::scoped_lock lk{submit_mutex};
-        mapped_queues[GfxQueueId].ccb_buffer_offset = 0;
-        mapped_queues[GfxQueueId].dcb_buffer_offset = 0;
-        submit_done = true;
-        submit_cv.notify_one();
-    }
+    void SubmitDone() noexcept;
 
     void WaitGpuIdle() noexcept {
         std::unique_lock lk{submit_mutex};
@@ -95,6 +103,17 @@ public:
         rasterizer = rasterizer_;
     }
 
+    /// Prepares for replaying a capture: memory is plain host memory and nothing outside the
+    /// command streams will ever satisfy a wait, so waits are skipped.
+    void EnableReplayMode(u32 num_counter_pairs_) {
+        replay_mode = true;
+        num_counter_pairs = num_counter_pairs_;
+    }
+
+    void SetPm4Stats(Pm4Stats* stats) {
+        pm4_stats = stats;
+    }
+
     template <bool wait_done = false>
     void SendCommand(auto&& func) {
         if (std::this_thread::get_id() == gpu_id) {
@@ -185,6 +204,7 @@ private:
 
     void ProcessCommands();
     void Process(std::stop_token stoken);
+    void WriteFenceValue(void* address, u64 data, u32 num_bytes);
 
     struct GpuQueue {
         std::mutex m_access{};
@@ -231,6 +251,9 @@ private:
     std::queue<Common::UniqueFunction<void>> command_queue{};
     std::thread::id gpu_id;
     s32 curr_qid{-1};
+    std::unique_ptr<Pm4Recorder> recorder;
+    Pm4Stats* pm4_stats{};
+    bool replay_mode{};
 };
 
 } // namespace AmdGpu
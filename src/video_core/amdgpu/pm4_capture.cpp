@@ -0,0 +1,278 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "common/alignment.h"
+#include "common/logging/log.h"
+#include "video_core/amdgpu/pm4_capture.h"
+#include "video_core/amdgpu/pm4_cmds.h"
+
+namespace AmdGpu {
+
+// Referenced memory is captured in whole pages, packets only point at a few bytes of it
+constexpr u64 CapturePageSize = 4_KB;
+constexpr u32 MaxIndirectDepth = 8;
+
+Pm4Recorder::Pm4Recorder(const std::filesystem::path& path_, u32 num_frames,
+                         u32 num_counter_pairs_)
+    : path{path_}, frames_left{num_frames}, num_counter_pairs{num_counter_pairs_} {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    file.Open(path, Common::FS::FileAccessMode::Create);
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render, "Failed to open PM4 capture file {}", path.string());
+        return;
+    }
+    const Pm4CaptureHeader header = {
+        .magic = Pm4CaptureMagic,
+        .version = Pm4CaptureVersion,
+        .num_counter_pairs = num_counter_pairs,
+        .reserved = 0,
+    };
+    file.WriteObject(header);
+    LOG_INFO(Render, "Capturing {} frames of PM4 submissions to {}", num_frames, path.string());
+}
+
+Pm4Recorder::~Pm4Recorder() = default;
+
+void Pm4Recorder::RecordGfx(std::span<const u32> dcb, std::span<const u32> ccb) {
+    std::scoped_lock lk{mutex};
+    if (!IsRecording()) {
+        return;
+    }
+    AddRange(reinterpret_cast<VAddr>(dcb.data()), dcb.size_bytes());
+    AddRange(reinterpret_cast<VAddr>(ccb.data()), ccb.size_bytes());
+    ScanStream(dcb, false, 0);
+    ScanStream(ccb, false, 0);
+    WriteMemory();
+
+    const Pm4GfxRecord record = {
+        .dcb_address = reinterpret_cast<VAddr>(dcb.data()),
+        .ccb_address = reinterpret_cast<VAddr>(ccb.data()),
+        .dcb_dwords = static_cast<u32>(dcb.size()),
+        .ccb_dwords = static_cast<u32>(ccb.size()),
+    };
+    WriteRecord(Pm4RecordType::SubmitGfx, &record, sizeof(record));
+}
+
+void Pm4Recorder::RecordAsc(u32 gnm_vqid, u32 pipe_id, std::span<const u32> acb) {
+    std::scoped_lock lk{mutex};
+    if (!IsRecording()) {
+        return;
+    }
+    AddRange(reinterpret_cast<VAddr>(acb.data()), acb.size_bytes());
+    ScanStream(acb, true, 0);
+    WriteMemory();
+
+    const Pm4AscRecord record = {
+        .acb_address = reinterpret_cast<VAddr>(acb.data()),
+        .acb_dwords = static_cast<u32>(acb.size()),
+        .gnm_vqid = gnm_vqid,
+        .pipe_id = pipe_id,
+        .reserved = 0,
+    };
+    WriteRecord(Pm4RecordType::SubmitAsc, &record, sizeof(record));
+}
+
+void Pm4Recorder::RecordSubmitDone() {
+    std::scoped_lock lk{mutex};
+    if (!IsRecording()) {
+        return;
+    }
+    WriteRecord(Pm4RecordType::SubmitDone, nullptr, 0);
+    if (--frames_left == 0) {
+        file.Close();
+        LOG_INFO(Render, "PM4 capture of {} submissions written to {}", num_submits,
+                 path.string());
+    }
+}
+
+void Pm4Recorder::AddRange(VAddr address, u64 size) {
+    if (address == 0 || size == 0) {
+        return;
+    }
+    const VAddr start = Common::AlignDown(address, CapturePageSize);
+    const VAddr end = Common::AlignUp(address + size, CapturePageSize);
+    ranges += boost::icl::interval<VAddr>::right_open(start, end);
+}
+
+void Pm4Recorder::ScanStream(std::span<const u32> stream, bool is_compute, u32 depth) {
+    while (!stream.empty()) {
+        const auto* header = reinterpret_cast<const PM4Header*>(stream.data());
+        if (header->type == 2) {
+            stream = stream.subspan(1);
+            continue;
+        }
+        if (header->type != 3) {
+            return;
+        }
+        const u32 num_dwords = header->type3.NumWords() + 1;
+        if (num_dwords > stream.size()) {
+            // Packets split across the end of a compute ring are completed by the next submit
+            return;
+        }
+
+        switch (header->type3.opcode) {
+        case PM4ItOpcode::IndirectBuffer:
+        case PM4ItOpcode::IndirectBufferConst: {
+            const auto* indirect_buffer = reinterpret_cast<const PM4CmdIndirectBuffer*>(header);
+            const std::span<const u32> ib{indirect_buffer->Address<const u32>(),
+                                          indirect_buffer->ib_size};
+            AddRange(reinterpret_cast<VAddr>(ib.data()), ib.size_bytes());
+            if (depth < MaxIndirectDepth) {
+                ScanStream(ib, is_compute, depth + 1);
+            }
+            break;
+        }
+        case PM4ItOpcode::DumpConstRam: {
+            const auto* dump_const = reinterpret_cast<const PM4DumpConstRam*>(header);
+            AddRange(dump_const->Address<VAddr>(), dump_const->Size());
+            break;
+        }
+        case PM4ItOpcode::EventWrite: {
+            const auto* event = reinterpret_cast<const PM4CmdEventWrite*>(header);
+            if (!is_compute && event->event_index.Value() == EventIndex::ZpassDone) {
+                AddRange(event->Address<VAddr>(), num_counter_pairs * 2 * sizeof(u64));
+            }
+            break;
+        }
+        case PM4ItOpcode::EventWriteEos: {
+            const auto* event_eos = reinterpret_cast<const PM4CmdEventWriteEos*>(header);
+            AddRange(event_eos->Address<VAddr>(), sizeof(u32));
+            break;
+        }
+        case PM4ItOpcode::EventWriteEop: {
+            const auto* event_eop = reinterpret_cast<const PM4CmdEventWriteEop*>(header);
+            AddRange(reinterpret_cast<VAddr>(event_eop->Address<u64>()), sizeof(u64));
+            break;
+        }
+        case PM4ItOpcode::ReleaseMem: {
+            const auto* release_mem = reinterpret_cast<const PM4CmdReleaseMem*>(header);
+            AddRange(release_mem->Address<VAddr>(), sizeof(u64));
+            break;
+        }
+        case PM4ItOpcode::WriteData: {
+            const auto* write_data = reinterpret_cast<const PM4CmdWriteData*>(header);
+            AddRange(write_data->Address<VAddr>(), write_data->Size());
+            break;
+        }
+        case PM4ItOpcode::WaitRegMem: {
+            const auto* wait_reg_mem = reinterpret_cast<const PM4CmdWaitRegMem*>(header);
+            if (wait_reg_mem->mem_space.Value() == PM4CmdWaitRegMem::MemSpace::Memory) {
+                AddRange(wait_reg_mem->Address<VAddr>(), sizeof(u32));
+            }
+            break;
+        }
+        case PM4ItOpcode::MemSemaphore: {
+            const auto* mem_semaphore = reinterpret_cast<const PM4CmdMemSemaphore*>(header);
+            AddRange(mem_semaphore->Address<VAddr>(), sizeof(u64));
+            break;
+        }
+        case PM4ItOpcode::CondExec: {
+            const auto* cond_exec = reinterpret_cast<const PM4CmdCondExec*>(header);
+            AddRange(reinterpret_cast<VAddr>(cond_exec->Address()), sizeof(u32));
+            break;
+        }
+        default:
+            break;
+        }
+        stream = stream.subspan(num_dwords);
+    }
+}
+
+void Pm4Recorder::WriteRecord(Pm4RecordType type, const void* payload, u64 size) {
+    const Pm4RecordHeader header = {
+        .type = type,
+        .reserved = 0,
+        .size = size,
+    };
+    file.WriteObject(header);
+    if (size != 0) {
+        file.WriteRaw<u8>(payload, size);
+    }
+    if (type == Pm4RecordType::SubmitGfx || type == Pm4RecordType::SubmitAsc) {
+        ++num_submits;
+    }
+}
+
+void Pm4Recorder::WriteMemory() {
+    for (const auto& range : ranges) {
+        const Pm4MemoryRecord record = {
+            .address = range.lower(),
+            .size = range.upper() - range.lower(),
+        };
+        const Pm4RecordHeader header = {
+            .type = Pm4RecordType::Memory,
+            .reserved = 0,
+            .size = sizeof(record) + record.size,
+        };
+        file.WriteObject(header);
+        file.WriteObject(record);
+        file.WriteRaw<u8>(reinterpret_cast<const void*>(record.address), record.size);
+    }
+    ranges.clear();
+}
+
+bool Pm4Capture::Load(const std::filesystem::path& path) {
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render, "Failed to open PM4 capture {}", path.string());
+        return false;
+    }
+    Pm4CaptureHeader header{};
+    if (!file.ReadObject(header) || header.magic != Pm4CaptureMagic) {
+        LOG_ERROR(Render, "{} is not a PM4 capture", path.string());
+        return false;
+    }
+    if (header.version != Pm4CaptureVersion) {
+        LOG_ERROR(Render, "Unsupported PM4 capture version {}", header.version);
+        return false;
+    }
+    num_counter_pairs = header.num_counter_pairs;
+
+    std::vector<MemoryBlob> memory;
+    Pm4RecordHeader record{};
+    while (file.ReadObject(record)) {
+        switch (record.type) {
+        case Pm4RecordType::Memory: {
+            Pm4MemoryRecord memory_record{};
+            if (!file.ReadObject(memory_record) ||
+                record.size != sizeof(memory_record) + memory_record.size) {
+                LOG_ERROR(Render, "Truncated memory record in PM4 capture");
+                return false;
+            }
+            auto& blob = memory.emplace_back(memory_record.address);
+            blob.data.resize(memory_record.size);
+            if (file.ReadSpan<u8>(blob.data) != blob.data.size()) {
+                LOG_ERROR(Render, "Truncated memory record in PM4 capture");
+                return false;
+            }
+            break;
+        }
+        case Pm4RecordType::SubmitGfx:
+        case Pm4RecordType::SubmitAsc:
+        case Pm4RecordType::SubmitDone: {
+            auto& submit = submits.emplace_back();
+            submit.type = record.type;
+            submit.memory = std::move(memory);
+            memory.clear();
+            bool is_valid = true;
+            if (record.type == Pm4RecordType::SubmitGfx) {
+                is_valid = record.size == sizeof(submit.gfx) && file.ReadObject(submit.gfx);
+            } else if (record.type == Pm4RecordType::SubmitAsc) {
+                is_valid = record.size == sizeof(submit.asc) && file.ReadObject(submit.asc);
+            }
+            if (!is_valid) {
+                LOG_ERROR(Render, "Truncated submit record in PM4 capture");
+                return false;
+            }
+            break;
+        }
+        default:
+            LOG_ERROR(Render, "Unknown PM4 capture record type {}", static_cast<u32>(record.type));
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace AmdGpu
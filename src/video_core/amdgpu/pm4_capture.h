@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <vector>
+#include <boost/icl/interval_set.hpp>
+
+#include "common/io_file.h"
+#include "common/types.h"
+
+namespace AmdGpu {
+
+/**
+ * Command stream captures hold everything needed to drive Liverpool without the guest: the
+ * DCB/CCB/ACB streams in submission order, and before each submission a snapshot of the guest
+ * memory it references. That covers the streams themselves, indirect buffers and the labels,
+ * semaphores and fences packets read or write. Vertex, index and shader memory isn't captured,
+ * so replays run without a rasterizer.
+ */
+constexpr u32 Pm4CaptureMagic = 0x43344d50; // "PM4C"
+constexpr u32 Pm4CaptureVersion = 1;
+
+struct Pm4CaptureHeader {
+    u32 magic;
+    u32 version;
+    u32 num_counter_pairs;
+    u32 reserved;
+};
+
+enum class Pm4RecordType : u32 {
+    Memory = 0,
+    SubmitGfx = 1,
+    SubmitAsc = 2,
+    SubmitDone = 3,
+};
+
+struct Pm4RecordHeader {
+    Pm4RecordType type;
+    u32 reserved;
+    u64 size; ///< Size of the payload that follows
+};
+
+/// Followed by the captured bytes.
+struct Pm4MemoryRecord {
+    VAddr address;
+    u64 size;
+};
+
+struct Pm4GfxRecord {
+    VAddr dcb_address;
+    VAddr ccb_address;
+    u32 dcb_dwords;
+    u32 ccb_dwords;
+};
+
+struct Pm4AscRecord {
+    VAddr acb_address;
+    u32 acb_dwords;
+    u32 gnm_vqid;
+    u32 pipe_id;
+    u32 reserved;
+};
+
+/// Writes the submissions of a number of frames to a capture file.
+class Pm4Recorder {
+public:
+    explicit Pm4Recorder(const std::filesystem::path& path, u32 num_frames, u32 num_counter_pairs);
+    ~Pm4Recorder();
+
+    void RecordGfx(std::span<const u32> dcb, std::span<const u32> ccb);
+    void RecordAsc(u32 gnm_vqid, u32 pipe_id, std::span<const u32> acb);
+
+    /// Ends the current frame, the capture is closed once all frames are recorded.
+    void RecordSubmitDone();
+
+private:
+    bool IsRecording() const {
+        return file.IsOpen();
+    }
+
+    void AddRange(VAddr address, u64 size);
+    void ScanStream(std::span<const u32> stream, bool is_compute, u32 depth);
+    void WriteRecord(Pm4RecordType type, const void* payload, u64 size);
+    void WriteMemory();
+
+    std::mutex mutex;
+    Common::FS::IOFile file;
+    std::filesystem::path path;
+    u32 frames_left;
+    u32 num_counter_pairs;
+    u32 num_submits{};
+    boost::icl::interval_set<VAddr> ranges;
+};
+
+/// A capture loaded back for replay.
+struct Pm4Capture {
+    struct MemoryBlob {
+        VAddr address;
+        std::vector<u8> data;
+    };
+
+    struct Submit {
+        Pm4RecordType type;
+        Pm4GfxRecord gfx;
+        Pm4AscRecord asc;
+        std::vector<MemoryBlob> memory; ///< Restored right before submitting
+    };
+
+    u32 num_counter_pairs{};
+    std::vector<Submit> submits;
+
+    bool Load(const std::filesystem::path& path);
+};
+
+} // namespace AmdGpu
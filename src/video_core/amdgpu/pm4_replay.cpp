@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <boost/icl/interval_set.hpp>
+#include <fmt/format.h>
+#include <magic_enum/magic_enum.hpp>
+
+#include "common/logging/log.h"
+#include "core/emulator_settings.h"
+#include "video_core/amdgpu/liverpool.h"
+#include "video_core/amdgpu/pm4_capture.h"
+#include "video_core/amdgpu/pm4_opcodes.h"
+#include "video_core/amdgpu/pm4_replay.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace AmdGpu {
+
+/// Maps the captured ranges back at the addresses the packets reference.
+static bool MapCapturedMemory(const Pm4Capture& capture) {
+    boost::icl::interval_set<VAddr> ranges;
+    for (const auto& submit : capture.submits) {
+        for (const auto& blob : submit.memory) {
+            ranges += boost::icl::interval<VAddr>::right_open(blob.address,
+                                                              blob.address + blob.data.size());
+        }
+    }
+    for (const auto& range : ranges) {
+        auto* address = reinterpret_cast<void*>(range.lower());
+        const size_t size = range.upper() - range.lower();
+#ifdef _WIN32
+        void* ptr = VirtualAlloc(address, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        void* ptr =
+            mmap(address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            ptr = nullptr;
+        } else if (ptr != address) {
+            munmap(ptr, size);
+            ptr = nullptr;
+        }
+#endif
+        if (ptr != address) {
+            LOG_ERROR(Render, "Unable to map captured memory at {:#x} with size {:#x}",
+                      range.lower(), size);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool IsRegisterUpdate(u32 opcode) {
+    switch (static_cast<PM4ItOpcode>(opcode)) {
+    case PM4ItOpcode::SetConfigReg:
+    case PM4ItOpcode::SetContextReg:
+    case PM4ItOpcode::SetContextRegIndirect:
+    case PM4ItOpcode::SetShReg:
+    case PM4ItOpcode::SetShRegOffset:
+    case PM4ItOpcode::SetQueueReg:
+    case PM4ItOpcode::SetUconfigReg:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void PrintStats(const Pm4Stats& stats, u64 num_submits, u64 num_dwords, u64 wall_ns) {
+    struct Row {
+        const char* queue;
+        u32 opcode;
+        Pm4Stats::Opcode entry;
+    };
+    std::vector<Row> rows;
+    u64 num_packets = 0;
+    u64 num_reg_updates = 0;
+    u64 reg_update_ns = 0;
+    const auto add_rows = [&](const char* queue, const auto& table) {
+        for (u32 opcode = 0; opcode < table.size(); ++opcode) {
+            const auto& entry = table[opcode];
+            if (entry.count == 0) {
+                continue;
+            }
+            rows.push_back({queue, opcode, entry});
+            num_packets += entry.count;
+            if (IsRegisterUpdate(opcode)) {
+                num_reg_updates += entry.count;
+                reg_update_ns += entry.time_ns;
+            }
+        }
+    };
+    add_rows("gfx", stats.gfx);
+    add_rows("asc", stats.asc);
+    std::ranges::sort(rows, std::greater{}, [](const Row& row) { return row.entry.time_ns; });
+
+    const double wall_s = static_cast<double>(wall_ns) / 1e9;
+    fmt::print("Replayed {} submissions in {:.3f} ms\n", num_submits, wall_ns / 1e6);
+    fmt::print("  {:.2f} M submitted dwords/s, {:.2f} M packets/s\n", num_dwords / wall_s / 1e6,
+               num_packets / wall_s / 1e6);
+    fmt::print("  {} register update packets, {:.3f} ms\n", num_reg_updates, reg_update_ns / 1e6);
+    fmt::print("{:<6}{:<32}{:>12}{:>14}{:>12}\n", "queue", "opcode", "count", "total ms",
+               "avg ns");
+    for (const auto& row : rows) {
+        const std::string_view name = magic_enum::enum_name(static_cast<PM4ItOpcode>(row.opcode));
+        fmt::print("{:<6}{:<32}{:>12}{:>14.3f}{:>12}\n", row.queue,
+                   name.empty() ? fmt::format("{:#x}", row.opcode) : std::string{name},
+                   row.entry.count, row.entry.time_ns / 1e6, row.entry.time_ns / row.entry.count);
+    }
+}
+
+int ReplayPm4Capture(const std::filesystem::path& path, u32 iterations) {
+    Pm4Capture capture;
+    if (!capture.Load(path)) {
+        return 1;
+    }
+    if (!MapCapturedMemory(capture)) {
+        return 1;
+    }
+
+    // There is no guest, so keep Liverpool from asking it about the console model and from
+    // copying command buffers into space that is reserved only by the GnmDriver
+    EmulatorSettings.SetNeo(false);
+    EmulatorSettings.SetCopyGpuBuffers(false);
+    EmulatorSettings.SetPm4CaptureFrames(0);
+
+    Liverpool liverpool;
+    liverpool.EnableReplayMode(capture.num_counter_pairs);
+
+    u32 max_vqid = 0;
+    std::array<u32, Liverpool::NumTotalQueues> pipe_ids{};
+    for (const auto& submit : capture.submits) {
+        if (submit.type == Pm4RecordType::SubmitAsc) {
+            if (submit.asc.gnm_vqid == 0 || submit.asc.gnm_vqid >= Liverpool::NumTotalQueues) {
+                LOG_ERROR(Render, "Invalid compute queue {} in PM4 capture", submit.asc.gnm_vqid);
+                return 1;
+            }
+            max_vqid = std::max(max_vqid, submit.asc.gnm_vqid);
+            pipe_ids[submit.asc.gnm_vqid] = submit.asc.pipe_id;
+        }
+    }
+    // The rings are replayed from the captured submissions, only the read pointers are needed
+    constexpr u32 ReplayRingSizeDw = 0x10000;
+    std::array<u32, Liverpool::NumTotalQueues> read_ptrs{};
+    for (u32 gnm_vqid = 1; gnm_vqid <= max_vqid; ++gnm_vqid) {
+        liverpool.asc_queues.insert(VAddr{0}, &read_ptrs[gnm_vqid], ReplayRingSizeDw,
+                                    pipe_ids[gnm_vqid]);
+    }
+
+    Pm4Stats stats{};
+    liverpool.SetPm4Stats(&stats);
+
+    u64 num_submits = 0;
+    u64 num_dwords = 0;
+    u64 wall_ns = 0;
+    for (u32 iteration = 0; iteration < iterations; ++iteration) {
+        for (const auto& submit : capture.submits) {
+            for (const auto& blob : submit.memory) {
+                std::memcpy(reinterpret_cast<void*>(blob.address), blob.data.data(),
+                            blob.data.size());
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            switch (submit.type) {
+            case Pm4RecordType::SubmitGfx:
+                liverpool.SubmitGfx(
+                    {reinterpret_cast<const u32*>(submit.gfx.dcb_address), submit.gfx.dcb_dwords},
+                    {reinterpret_cast<const u32*>(submit.gfx.ccb_address), submit.gfx.ccb_dwords});
+                num_dwords += submit.gfx.dcb_dwords + submit.gfx.ccb_dwords;
+                ++num_submits;
+                break;
+            case Pm4RecordType::SubmitAsc:
+                liverpool.SubmitAsc(
+                    submit.asc.gnm_vqid,
+                    {reinterpret_cast<const u32*>(submit.asc.acb_address), submit.asc.acb_dwords});
+                num_dwords += submit.asc.acb_dwords;
+                ++num_submits;
+                break;
+            case Pm4RecordType::SubmitDone:
+                liverpool.SubmitDone();
+                break;
+            default:
+                break;
+            }
+            liverpool.WaitGpuIdle();
+            const auto end = std::chrono::steady_clock::now();
+            wall_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        }
+    }
+
+    liverpool.SetPm4Stats(nullptr);
+    PrintStats(stats, num_submits, num_dwords, wall_ns);
+    return 0;
+}
+
+} // namespace AmdGpu
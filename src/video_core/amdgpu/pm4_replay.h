@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+
+#include "common/types.h"
+
+namespace AmdGpu {
+
+/**
+ * Replays a PM4 capture through Liverpool without a guest or a rasterizer, and prints the time
+ * spent per packet opcode. Captured memory is mapped back at its original addresses, so this must
+ * run in a process that doesn't have the guest address space set up.
+ * @returns Zero on success, like a main function.
+ */
+int ReplayPm4Capture(const std::filesystem::path& path, u32 iterations);
+
+} // namespace AmdGpu
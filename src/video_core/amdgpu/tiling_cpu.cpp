@@ -0,0 +1,636 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "common/assert.h"
+#include "video_core/amdgpu/tiling_cpu.h"
+
+namespace AmdGpu {
+
+namespace {
+
+constexpr u32 MicroTileWidth = 8;
+constexpr u32 MicroTileHeight = 8;
+constexpr u32 PipeInterleaveBits = 8;
+constexpr u32 PipeInterleaveBytes = 1U << PipeInterleaveBits;
+constexpr u32 MaxChunks = 64;
+
+// Below this size, spinning up threads costs more than the conversion itself
+constexpr size_t ParallelThreshold = 1_MB;
+constexpr u32 MaxWorkers = 8;
+
+u32 Bit(u32 value, u32 bit) {
+    return (value >> bit) & 1;
+}
+
+/// Constants of a tiling configuration, which the compute shader receives as defines.
+struct Layout {
+    u32 bits;
+    u32 bytes;
+    u32 num_samples;
+    ArrayMode array_mode;
+    MicroTileMode micro_tile_mode;
+    u32 thickness;
+    bool is_macro_tiled;
+    bool is_prt;
+    bool is_2d;
+    bool is_3d;
+    bool has_split_rotation;
+    PipeConfig pipe_config;
+    u32 num_pipes;
+    u32 num_pipe_bits;
+    u32 bank_width;
+    u32 bank_height;
+    u32 num_banks;
+    u32 num_bank_bits;
+    u32 tile_split_bytes;
+    u32 macro_tile_aspect;
+    u32 micro_tile_bytes;
+    u32 bank_swizzle;
+
+    // Byte offset of the first sample of each texel within its micro tile, indexed by [z][y][x]
+    std::array<u32, 8 * MicroTileHeight * MicroTileWidth> element_offsets;
+
+    // Micro tiles are stored as runs of this many contiguous bytes, placed independently
+    u32 chunk_bytes;
+    u32 num_chunks;
+
+    // Each micro tile row is made of runs of texels contiguous in both layouts. Zero if texels
+    // aren't aligned to chunks, otherwise the rows are copied whole run by run.
+    struct Run {
+        u16 chunk;
+        u16 offset;
+    };
+    u32 run_bytes;
+    u32 num_runs;
+    std::array<Run, 8 * MicroTileHeight * MicroTileWidth> runs;
+};
+
+u32 PixelIndexWithinMicroTile(const Layout& layout, u32 x, u32 y, u32 z) {
+    const u32 x0 = Bit(x, 0), x1 = Bit(x, 1), x2 = Bit(x, 2);
+    const u32 y0 = Bit(y, 0), y1 = Bit(y, 1), y2 = Bit(y, 2);
+    const u32 z0 = Bit(z, 0), z1 = Bit(z, 1), z2 = Bit(z, 2);
+    u32 p0{}, p1{}, p2{}, p3{}, p4{}, p5{}, p6{}, p7{}, p8{};
+
+    switch (layout.micro_tile_mode) {
+    case MicroTileMode::Display:
+        switch (layout.bits) {
+        case 8:
+            p0 = x0, p1 = x1, p2 = x2, p3 = y1, p4 = y0, p5 = y2;
+            break;
+        case 16:
+            p0 = x0, p1 = x1, p2 = x2, p3 = y0, p4 = y1, p5 = y2;
+            break;
+        case 32:
+            p0 = x0, p1 = x1, p2 = y0, p3 = x2, p4 = y1, p5 = y2;
+            break;
+        case 64:
+            p0 = x0, p1 = y0, p2 = x1, p3 = x2, p4 = y1, p5 = y2;
+            break;
+        case 128:
+            p0 = y0, p1 = x0, p2 = x1, p3 = x2, p4 = y1, p5 = y2;
+            break;
+        default:
+            break;
+        }
+        break;
+    case MicroTileMode::Thin:
+    case MicroTileMode::Depth:
+        p0 = x0, p1 = y0, p2 = x1, p3 = y1, p4 = x2, p5 = y2;
+        break;
+    default:
+        switch (layout.bits) {
+        case 8:
+        case 16:
+            p0 = x0, p1 = y0, p2 = x1, p3 = y1, p4 = z0, p5 = z1;
+            break;
+        case 32:
+            p0 = x0, p1 = y0, p2 = x1, p3 = z0, p4 = y1, p5 = z1;
+            break;
+        case 64:
+        case 128:
+            p0 = x0, p1 = y0, p2 = z0, p3 = x1, p4 = y1, p5 = z1;
+            break;
+        default:
+            break;
+        }
+        p6 = x2;
+        p7 = y2;
+        if (layout.thickness == 8) {
+            p8 = z2;
+        }
+        break;
+    }
+    return p0 | (p1 << 1) | (p2 << 2) | (p3 << 3) | (p4 << 4) | (p5 << 5) | (p6 << 6) |
+           (p7 << 7) | (p8 << 8);
+}
+
+Layout MakeLayout(const TilingParams& params) {
+    Layout layout{};
+    layout.bits = params.num_bits;
+    layout.bytes = params.num_bits / 8;
+    layout.num_samples = params.num_samples;
+    layout.array_mode = params.array_mode;
+    layout.micro_tile_mode = GetMicroTileMode(params.tile_mode);
+    layout.thickness = GetMicroTileThickness(params.array_mode);
+    layout.is_macro_tiled = IsMacroTiled(params.array_mode);
+    layout.is_prt = IsPrt(params.array_mode);
+    layout.micro_tile_bytes = MicroTileWidth * MicroTileHeight * layout.thickness * layout.bits *
+                              layout.num_samples / 8;
+    layout.bank_swizzle = params.bank_swizzle;
+
+    switch (params.array_mode) {
+    case ArrayMode::Array2DTiledThin1:
+    case ArrayMode::Array2DTiledThick:
+    case ArrayMode::Array2DTiledXThick:
+        layout.is_2d = true;
+        break;
+    case ArrayMode::Array3DTiledThin1:
+    case ArrayMode::Array3DTiledThick:
+    case ArrayMode::Array3DTiledXThick:
+        layout.is_3d = true;
+        break;
+    default:
+        break;
+    }
+    switch (params.array_mode) {
+    case ArrayMode::Array2DTiledThin1:
+    case ArrayMode::Array3DTiledThin1:
+    case ArrayMode::ArrayPrt2DTiledThin1:
+    case ArrayMode::ArrayPrt3DTiledThin1:
+        layout.has_split_rotation = true;
+        break;
+    default:
+        break;
+    }
+
+    u32 tile_bytes = layout.micro_tile_bytes;
+    if (layout.is_macro_tiled) {
+        const auto macro_tile_mode =
+            CalculateMacrotileMode(params.tile_mode, params.num_bits, params.num_samples);
+        layout.pipe_config = GetPipeConfig(params.tile_mode);
+        layout.num_pipes = layout.pipe_config == PipeConfig::P2 ? 2 : 8;
+        layout.num_pipe_bits = layout.pipe_config == PipeConfig::P2 ? 1 : 3;
+        layout.bank_width = GetBankWidth(macro_tile_mode);
+        layout.bank_height = GetBankHeight(macro_tile_mode);
+        layout.num_banks = GetNumBanks(macro_tile_mode);
+        layout.num_bank_bits = std::bit_width(layout.num_banks) - 1;
+        layout.tile_split_bytes = CalculateTileSplit(params.tile_mode, params.array_mode,
+                                                     layout.micro_tile_mode, params.num_bits);
+        layout.macro_tile_aspect = GetMacrotileAspect(macro_tile_mode);
+        if (layout.micro_tile_bytes > layout.tile_split_bytes && layout.thickness == 1) {
+            tile_bytes = layout.tile_split_bytes;
+        }
+        // Pipe and bank bits are interleaved above the low address bits
+        tile_bytes = std::min(tile_bytes, PipeInterleaveBytes);
+    }
+
+    u32 max_offset = 0;
+    for (u32 z = 0; z < layout.thickness; ++z) {
+        for (u32 y = 0; y < MicroTileHeight; ++y) {
+            for (u32 x = 0; x < MicroTileWidth; ++x) {
+                const u32 pixel_index = PixelIndexWithinMicroTile(layout, x, y, z);
+                const u32 pixel_offset = layout.micro_tile_mode == MicroTileMode::Depth
+                                             ? pixel_index * layout.bits * layout.num_samples
+                                             : pixel_index * layout.bits;
+                const u32 offset = pixel_offset / 8;
+                layout.element_offsets[(z * MicroTileHeight + y) * MicroTileWidth + x] = offset;
+                max_offset = std::max(max_offset, offset);
+            }
+        }
+    }
+
+    layout.chunk_bytes = tile_bytes;
+    layout.num_chunks = max_offset / tile_bytes + 1;
+    if (!std::has_single_bit(layout.bytes) || !std::has_single_bit(tile_bytes) ||
+        tile_bytes < layout.bytes || layout.num_chunks > MaxChunks) {
+        return layout;
+    }
+
+    // Find the longest runs of texels, aligned to their length, that are contiguous in every row
+    const auto is_contiguous = [&](u32 run_texels) {
+        for (u32 row = 0; row < layout.thickness * MicroTileHeight; ++row) {
+            for (u32 x = 0; x < MicroTileWidth; x += run_texels) {
+                const u32* elements = &layout.element_offsets[row * MicroTileWidth + x];
+                if (elements[0] % tile_bytes + run_texels * layout.bytes > tile_bytes) {
+                    return false;
+                }
+                for (u32 i = 1; i < run_texels; ++i) {
+                    if (elements[i] != elements[0] + i * layout.bytes) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+    u32 run_texels = MicroTileWidth;
+    while (run_texels > 1 && !is_contiguous(run_texels)) {
+        run_texels /= 2;
+    }
+    layout.run_bytes = run_texels * layout.bytes;
+    layout.num_runs = MicroTileWidth / run_texels;
+    for (u32 row = 0; row < layout.thickness * MicroTileHeight; ++row) {
+        for (u32 run = 0; run < layout.num_runs; ++run) {
+            const u32 element = layout.element_offsets[row * MicroTileWidth + run * run_texels];
+            layout.runs[row * MicroTileWidth + run] = {
+                .chunk = static_cast<u16>(element / tile_bytes),
+                .offset = static_cast<u16>(element % tile_bytes),
+            };
+        }
+    }
+    return layout;
+}
+
+u32 PipeFromCoord(const Layout& layout, u32 x, u32 y, u32 slice) {
+    const u32 tx = x / MicroTileWidth;
+    const u32 ty = y / MicroTileHeight;
+    const u32 x3 = Bit(tx, 0), x4 = Bit(tx, 1), x5 = Bit(tx, 2);
+    const u32 y3 = Bit(ty, 0), y4 = Bit(ty, 1), y5 = Bit(ty, 2);
+    u32 p0{}, p1{}, p2{};
+
+    switch (layout.pipe_config) {
+    case PipeConfig::P2:
+        p0 = x3 ^ y3;
+        break;
+    case PipeConfig::P8_32x32_8x16:
+        p0 = x4 ^ y3 ^ x5;
+        p1 = x3 ^ y4;
+        p2 = x5 ^ y5;
+        break;
+    case PipeConfig::P8_32x32_16x16:
+        p0 = x3 ^ y3 ^ x4;
+        p1 = x4 ^ y4;
+        p2 = x5 ^ y5;
+        break;
+    default:
+        break;
+    }
+
+    u32 pipe_swizzle = 0;
+    if (layout.is_3d) {
+        pipe_swizzle += std::max(1U, layout.num_pipes / 2 - 1) * (slice / layout.thickness);
+    }
+    pipe_swizzle &= layout.num_pipes - 1;
+    return (p0 | (p1 << 1) | (p2 << 2)) ^ pipe_swizzle;
+}
+
+u32 BankFromCoord(const Layout& layout, u32 x, u32 y, u32 slice, u32 tile_split_slice) {
+    const u32 tx = x / MicroTileWidth / (layout.bank_width * layout.num_pipes);
+    const u32 ty = y / MicroTileHeight / layout.bank_height;
+    const u32 x3 = Bit(tx, 0), x4 = Bit(tx, 1), x5 = Bit(tx, 2), x6 = Bit(tx, 3);
+    const u32 y3 = Bit(ty, 0), y4 = Bit(ty, 1), y5 = Bit(ty, 2), y6 = Bit(ty, 3);
+    u32 b0{}, b1{}, b2{}, b3{};
+
+    switch (layout.num_banks) {
+    case 16:
+        b0 = x3 ^ y6;
+        b1 = x4 ^ y5 ^ y6;
+        b2 = x5 ^ y4;
+        b3 = x6 ^ y3;
+        break;
+    case 8:
+        b0 = x3 ^ y5;
+        b1 = x4 ^ y4 ^ y5;
+        b2 = x5 ^ y3;
+        break;
+    case 4:
+        b0 = x3 ^ y4;
+        b1 = x4 ^ y3;
+        break;
+    case 2:
+        b0 = x3 ^ y3;
+        break;
+    default:
+        break;
+    }
+
+    u32 slice_rotation = 0;
+    if (layout.is_2d) {
+        slice_rotation = (layout.num_banks / 2 - 1) * (slice / layout.thickness);
+    } else if (layout.is_3d) {
+        slice_rotation = std::max(1U, layout.num_pipes / 2 - 1) * (slice / layout.thickness) /
+                         layout.num_pipes;
+    }
+    u32 tile_split_rotation = 0;
+    if (layout.has_split_rotation) {
+        tile_split_rotation = (layout.num_banks / 2 + 1) * tile_split_slice;
+    }
+
+    u32 bank = b0 | (b1 << 1) | (b2 << 2) | (b3 << 3);
+    bank ^= layout.bank_swizzle + slice_rotation;
+    bank ^= tile_split_rotation;
+    return bank & (layout.num_banks - 1);
+}
+
+/// Returns the offset of the element at the given byte offset within the micro tile at x, y.
+u32 MicroTiledOffset(const Layout& layout, const TilingMip& mip, u32 x, u32 y, u32 slice,
+                     u32 element_offset) {
+    const u32 slice_bytes =
+        (mip.pitch * mip.height * layout.thickness * layout.bits * layout.num_samples + 7) / 8;
+    const u32 micro_tiles_per_row = mip.pitch / MicroTileWidth;
+    const u32 micro_tile_index_x = x / MicroTileWidth;
+    const u32 micro_tile_index_y = y / MicroTileHeight;
+    const u32 micro_tile_index_z = slice / layout.thickness;
+
+    const u32 slice_offset = micro_tile_index_z * slice_bytes;
+    const u32 micro_tile_offset =
+        (micro_tile_index_y * micro_tiles_per_row + micro_tile_index_x) * layout.micro_tile_bytes;
+    return slice_offset + micro_tile_offset + element_offset;
+}
+
+u32 MacroTiledOffset(const Layout& layout, const TilingMip& mip, u32 x, u32 y, u32 slice,
+                     u32 element_offset) {
+    u32 micro_tile_bytes = layout.micro_tile_bytes;
+    u32 slices_per_tile = 1;
+    u32 tile_split_slice = 0;
+    if (micro_tile_bytes > layout.tile_split_bytes && layout.thickness == 1) {
+        slices_per_tile = micro_tile_bytes / layout.tile_split_bytes;
+        tile_split_slice = element_offset / layout.tile_split_bytes;
+        element_offset %= layout.tile_split_bytes;
+        micro_tile_bytes = layout.tile_split_bytes;
+    }
+
+    const u32 macro_tile_pitch =
+        (MicroTileWidth * layout.bank_width * layout.num_pipes) * layout.macro_tile_aspect;
+    const u32 macro_tile_height =
+        (MicroTileHeight * layout.bank_height * layout.num_banks) / layout.macro_tile_aspect;
+    const u32 macro_tile_bytes = micro_tile_bytes * (macro_tile_pitch / MicroTileWidth) *
+                                 (macro_tile_height / MicroTileHeight) /
+                                 (layout.num_pipes * layout.num_banks);
+
+    const u32 macro_tiles_per_row = mip.pitch / macro_tile_pitch;
+    const u32 macro_tile_index_x = x / macro_tile_pitch;
+    const u32 macro_tile_index_y = y / macro_tile_height;
+    const u32 macro_tile_offset =
+        (macro_tile_index_y * macro_tiles_per_row + macro_tile_index_x) * macro_tile_bytes;
+    const u32 macro_tiles_per_slice = macro_tiles_per_row * (mip.height / macro_tile_height);
+
+    const u32 slice_bytes = macro_tiles_per_slice * macro_tile_bytes;
+    const u32 slice_offset =
+        slice_bytes * (tile_split_slice + slices_per_tile * (slice / layout.thickness));
+
+    const u32 tile_row_index = (y / MicroTileHeight) % layout.bank_height;
+    const u32 tile_column_index = ((x / MicroTileWidth) / layout.num_pipes) % layout.bank_width;
+    const u32 tile_index = tile_row_index * layout.bank_width + tile_column_index;
+    const u32 tile_offset = tile_index * micro_tile_bytes;
+
+    const u32 total_offset = slice_offset + macro_tile_offset + element_offset + tile_offset;
+
+    if (layout.is_prt) {
+        x %= macro_tile_pitch;
+        y %= macro_tile_height;
+    }
+
+    const u32 pipe = PipeFromCoord(layout, x, y, slice);
+    const u32 bank = BankFromCoord(layout, x, y, slice, tile_split_slice);
+
+    u32 addr = total_offset & (PipeInterleaveBytes - 1);
+    addr |= pipe << PipeInterleaveBits;
+    addr |= bank << (PipeInterleaveBits + layout.num_pipe_bits);
+    addr |= (total_offset >> PipeInterleaveBits)
+            << (PipeInterleaveBits + layout.num_pipe_bits + layout.num_bank_bits);
+    return addr;
+}
+
+u32 TiledOffset(const Layout& layout, const TilingMip& mip, u32 x, u32 y, u32 slice,
+                u32 element_offset) {
+    if (layout.is_macro_tiled) {
+        return MacroTiledOffset(layout, mip, x, y, slice, element_offset);
+    }
+    return MicroTiledOffset(layout, mip, x, y, slice, element_offset);
+}
+
+/// Tiled buffers are indexed in whole texels, so the offset is rounded down like the shader does.
+u32 TexelOffset(const Layout& layout, const TilingMip& mip, u32 x, u32 y, u32 slice,
+                u32 element_offset) {
+    const u32 offset = mip.offset + TiledOffset(layout, mip, x, y, slice, element_offset);
+    return offset / layout.bytes * layout.bytes;
+}
+
+/// Copies a run of texels that is contiguous on both sides.
+template <u32 RunBytes>
+void CopyRun(const u8* src, u8* dst) {
+#if defined(__AVX__)
+    if constexpr (RunBytes % 32 == 0) {
+        for (u32 i = 0; i < RunBytes; i += 32) {
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), data);
+        }
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    if constexpr (RunBytes % 16 == 0) {
+        for (u32 i = 0; i < RunBytes; i += 16) {
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), data);
+        }
+        return;
+    }
+#endif
+    std::memcpy(dst, src, RunBytes);
+}
+
+struct Surface {
+    u8* tiled;
+    size_t tiled_size;
+    u8* linear;
+    size_t linear_size;
+};
+
+/// Converts the texels of one row of micro tiles of a mip level slice. Rows of whole micro tiles
+/// are moved in runs of RunBytes, anything else goes texel by texel.
+template <u32 RunBytes, bool IsTiler>
+void ConvertTileRow(const Layout& layout, const TilingMip& mip, size_t linear_base, u32 slice,
+                    u32 tile_y, const Surface& surface) {
+    const u32 num_bytes = layout.bytes;
+    const u32 num_texels = mip.size / num_bytes;
+    const u32 slice_texels = mip.pitch * mip.height;
+    const u32 z = slice % layout.thickness;
+    const u32 y_begin = tile_y * MicroTileHeight;
+    const u32 y_end = std::min(y_begin + MicroTileHeight, mip.height);
+    const u8* linear_end = surface.linear + surface.linear_size;
+
+    std::array<u32, MaxChunks> chunk_offsets{};
+    for (u32 x_begin = 0; x_begin < mip.pitch; x_begin += MicroTileWidth) {
+        bool is_fast = RunBytes != 0 && x_begin + MicroTileWidth <= mip.pitch;
+        if (is_fast) {
+            for (u32 chunk = 0; chunk < layout.num_chunks; ++chunk) {
+                chunk_offsets[chunk] = mip.offset + TiledOffset(layout, mip, x_begin, y_begin,
+                                                                slice, chunk * layout.chunk_bytes);
+                is_fast &= size_t(chunk_offsets[chunk]) + layout.chunk_bytes <= surface.tiled_size;
+            }
+        }
+
+        for (u32 y = y_begin; y < y_end; ++y) {
+            const u32 row_texel = slice * slice_texels + y * mip.pitch + x_begin;
+            if (row_texel >= num_texels) {
+                return;
+            }
+            const u32 row = z * MicroTileHeight + y % MicroTileHeight;
+            u8* linear = surface.linear + linear_base + size_t(row_texel) * num_bytes;
+            const u32 row_width =
+                std::min({MicroTileWidth, mip.pitch - x_begin, num_texels - row_texel});
+            if constexpr (RunBytes != 0) {
+                if (is_fast && row_width == MicroTileWidth &&
+                    linear + MicroTileWidth * num_bytes <= linear_end) {
+                    const auto* runs = &layout.runs[row * MicroTileWidth];
+                    for (u32 run = 0; run < layout.num_runs; ++run) {
+                        u8* tiled = surface.tiled + chunk_offsets[runs[run].chunk] +
+                                    runs[run].offset;
+                        if constexpr (IsTiler) {
+                            CopyRun<RunBytes>(linear + run * RunBytes, tiled);
+                        } else {
+                            CopyRun<RunBytes>(tiled, linear + run * RunBytes);
+                        }
+                    }
+                    continue;
+                }
+            }
+            const u32* elements = &layout.element_offsets[row * MicroTileWidth];
+            for (u32 x = 0; x < row_width; ++x) {
+                const size_t tiled_offset =
+                    TexelOffset(layout, mip, x_begin + x, y, slice, elements[x]);
+                u8* linear_texel = linear + x * num_bytes;
+                if (tiled_offset + num_bytes > surface.tiled_size ||
+                    linear_texel + num_bytes > linear_end) {
+                    continue;
+                }
+                if constexpr (IsTiler) {
+                    std::memcpy(surface.tiled + tiled_offset, linear_texel, num_bytes);
+                } else {
+                    std::memcpy(linear_texel, surface.tiled + tiled_offset, num_bytes);
+                }
+            }
+        }
+    }
+}
+
+struct WorkItem {
+    u32 mip;
+    u32 slice;
+    u32 tile_y;
+};
+
+template <bool IsTiler>
+void Convert(const TilingParams& params, const Surface& surface) {
+    const Layout layout = MakeLayout(params);
+    ASSERT_MSG(layout.bytes != 0, "Invalid bits per pixel {}", params.num_bits);
+
+    std::vector<size_t> linear_bases;
+    std::vector<WorkItem> items;
+    size_t linear_base = 0;
+    for (u32 mip = 0; mip < params.mips.size(); ++mip) {
+        const auto& mip_info = params.mips[mip];
+        linear_bases.push_back(linear_base);
+        linear_base += mip_info.size;
+        const u32 slice_texels = mip_info.pitch * mip_info.height;
+        if (slice_texels == 0) {
+            continue;
+        }
+        const u32 num_slices = (mip_info.size / layout.bytes + slice_texels - 1) / slice_texels;
+        const u32 num_tile_rows = (mip_info.height + MicroTileHeight - 1) / MicroTileHeight;
+        for (u32 slice = 0; slice < num_slices; ++slice) {
+            for (u32 tile_y = 0; tile_y < num_tile_rows; ++tile_y) {
+                items.push_back({mip, slice, tile_y});
+            }
+        }
+    }
+
+    const auto convert = [&](const WorkItem& item) {
+        const auto& mip = params.mips[item.mip];
+        const size_t base = linear_bases[item.mip];
+        const auto convert_row = [&]<u32 RunBytes> {
+            ConvertTileRow<RunBytes, IsTiler>(layout, mip, base, item.slice, item.tile_y, surface);
+        };
+        switch (layout.run_bytes) {
+        case 1:
+            return convert_row.template operator()<1>();
+        case 2:
+            return convert_row.template operator()<2>();
+        case 4:
+            return convert_row.template operator()<4>();
+        case 8:
+            return convert_row.template operator()<8>();
+        case 16:
+            return convert_row.template operator()<16>();
+        case 32:
+            return convert_row.template operator()<32>();
+        case 64:
+            return convert_row.template operator()<64>();
+        case 128:
+            return convert_row.template operator()<128>();
+        default:
+            return convert_row.template operator()<0>();
+        }
+    };
+
+    const u32 num_workers =
+        linear_base < ParallelThreshold
+            ? 1
+            : std::min({std::thread::hardware_concurrency(), MaxWorkers,
+                        static_cast<u32>(items.size())});
+    if (num_workers <= 1) {
+        for (const auto& item : items) {
+            convert(item);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_item{};
+    const auto worker = [&] {
+        for (size_t i = next_item++; i < items.size(); i = next_item++) {
+            convert(items[i]);
+        }
+    };
+    std::vector<std::jthread> workers;
+    workers.reserve(num_workers - 1);
+    for (u32 i = 1; i < num_workers; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+}
+
+} // Anonymous namespace
+
+void DetileCpu(const TilingParams& params, std::span<const u8> tiled, std::span<u8> linear) {
+    // The tiled side is only read from
+    const Surface surface = {
+        .tiled = const_cast<u8*>(tiled.data()),
+        .tiled_size = tiled.size(),
+        .linear = linear.data(),
+        .linear_size = linear.size(),
+    };
+    Convert<false>(params, surface);
+}
+
+void TileCpu(const TilingParams& params, std::span<const u8> linear, std::span<u8> tiled) {
+    // The linear side is only read from
+    const Surface surface = {
+        .tiled = tiled.data(),
+        .tiled_size = tiled.size(),
+        .linear = const_cast<u8*>(linear.data()),
+        .linear_size = linear.size(),
+    };
+    Convert<true>(params, surface);
+}
+
+u32 GetTiledOffset(const TilingParams& params, const TilingMip& mip, u32 x, u32 y, u32 slice) {
+    const Layout layout = MakeLayout(params);
+    const u32 z = slice % layout.thickness;
+    const u32 element = layout.element_offsets[(z * MicroTileHeight + y % 8) * 8 + x % 8];
+    return TexelOffset(layout, mip, x, y, slice, element);
+}
+
+} // namespace AmdGpu
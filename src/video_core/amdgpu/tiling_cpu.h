@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <span>
+
+#include "common/types.h"
+#include "video_core/amdgpu/tiling.h"
+
+namespace AmdGpu {
+
+/// Layout of a mip level in the tiled surface. Matches ImageInfo::MipInfo.
+struct TilingMip {
+    u32 size;
+    u32 pitch;
+    u32 height;
+    u32 offset;
+};
+
+struct TilingParams {
+    TileMode tile_mode;
+    ArrayMode array_mode;
+    u32 num_bits;
+    u32 num_samples;
+    u32 bank_swizzle;
+    std::span<const TilingMip> mips;
+};
+
+/**
+ * CPU implementation of the tiling compute shader, producing the same layout. The linear side
+ * holds the mip levels back to back, each one as tightly packed rows of its pitch. Large
+ * surfaces are split across worker threads by micro tile rows.
+ */
+void DetileCpu(const TilingParams& params, std::span<const u8> tiled, std::span<u8> linear);
+
+void TileCpu(const TilingParams& params, std::span<const u8> linear, std::span<u8> tiled);
+
+/// Returns the byte offset of a texel within a tiled mip level.
+u32 GetTiledOffset(const TilingParams& params, const TilingMip& mip, u32 x, u32 y, u32 slice);
+
+} // namespace AmdGpu
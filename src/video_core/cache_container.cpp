@@ -0,0 +1,507 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <miniz.h>
+#include <xxhash.h>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/error.h"
+#include "common/logging/log.h"
+#include "video_core/cache_container.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace Storage {
+
+namespace {
+
+constexpr u32 ContainerMagic = 0x43505053; // SPPC
+constexpr u32 ContainerVersion = 1;
+
+// Payloads smaller than this are stored as is, as compression won't gain much on them.
+constexpr size_t MinCompressSize = 256;
+
+// Batches at least this large get their payloads compressed on several threads.
+constexpr size_t ParallelEncodeThreshold = 16;
+constexpr u32 MaxEncodeWorkers = 4;
+
+enum class Codec : u32 {
+    Stored,
+    Deflate,
+};
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u64 index_offset;
+    u64 index_checksum;
+    u32 index_count;
+    u32 reserved;
+};
+static_assert(sizeof(FileHeader) == 32);
+
+struct RecordHeader {
+    u64 key;
+    u64 checksum;
+    u32 type;
+    Codec codec;
+    u32 size;
+    u32 raw_size;
+};
+static_assert(sizeof(RecordHeader) == 32);
+
+struct IndexEntry {
+    u64 key;
+    u64 offset;
+    u32 type;
+    u32 reserved;
+};
+static_assert(sizeof(IndexEntry) == 24);
+
+// Records are kept 8-byte aligned so their payloads can be accessed in place.
+constexpr u64 RecordSize(u32 payload_size) {
+    return sizeof(RecordHeader) + Common::AlignUp(u64{payload_size}, 8);
+}
+
+constexpr std::array<u8, 8> Padding{};
+
+struct EncodedRecord {
+    RecordHeader header;
+    std::vector<u8> compressed;
+    std::span<const u8> payload;
+};
+
+void EncodeRecord(const CacheContainer::Blob& blob, EncodedRecord& out) {
+    const auto data = blob.data;
+    out.header = {
+        .key = blob.key,
+        .type = blob.type,
+        .codec = Codec::Stored,
+        .size = static_cast<u32>(data.size()),
+        .raw_size = static_cast<u32>(data.size()),
+    };
+    out.payload = data;
+
+    // Keep the compressed form only if it saves at least an eighth of the size
+    if (data.size() >= MinCompressSize) {
+        mz_ulong compressed_size = mz_compressBound(data.size());
+        out.compressed.resize(compressed_size);
+        if (mz_compress2(out.compressed.data(), &compressed_size, data.data(), data.size(),
+                         MZ_BEST_SPEED) == MZ_OK &&
+            compressed_size < data.size() - data.size() / 8) {
+            out.header.codec = Codec::Deflate;
+            out.header.size = static_cast<u32>(compressed_size);
+            out.payload = std::span{out.compressed.data(), compressed_size};
+        }
+    }
+    out.header.checksum = XXH3_64bits(out.payload.data(), out.payload.size());
+}
+
+} // Anonymous namespace
+
+CacheContainer::~CacheContainer() {
+    Close();
+}
+
+bool CacheContainer::Open(const std::filesystem::path& path) {
+    using namespace Common::FS;
+
+    Close();
+    file_path = path;
+
+    const auto create_new = [&] {
+        const FileHeader header = {
+            .magic = ContainerMagic,
+            .version = ContainerVersion,
+        };
+        const auto new_file = IOFile{path, FileAccessMode::Create};
+        return new_file.WriteObject(header);
+    };
+
+    std::error_code ec{};
+    if (std::filesystem::file_size(path, ec) < sizeof(FileHeader) || ec) {
+        if (!create_new()) {
+            LOG_ERROR(Render, "Failed to create cache container {}", path.string());
+            return false;
+        }
+    }
+
+    file.Open(path, FileAccessMode::ReadWrite, FileType::BinaryFile, FileShareFlag::ShareReadWrite);
+    if (!file.IsOpen() || !Map()) {
+        Close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const FileHeader*>(map_base);
+    if (header->magic != ContainerMagic || header->version != ContainerVersion) {
+        LOG_INFO(Render, "Cache container {} has an unsupported version, recreating",
+                 path.string());
+        Unmap();
+        file.Close();
+        if (!create_new()) {
+            return false;
+        }
+        file.Open(path, FileAccessMode::ReadWrite, FileType::BinaryFile,
+                  FileShareFlag::ShareReadWrite);
+        if (!file.IsOpen() || !Map()) {
+            Close();
+            return false;
+        }
+    }
+
+    index_valid = LoadIndex();
+    if (!index_valid) {
+        LOG_INFO(Render, "Cache container {} has no valid index, scanning records",
+                 path.string());
+        ScanRecords();
+    }
+
+    LOG_INFO(Render, "Opened cache container {} with {} entries", path.string(), entries.size());
+    return true;
+}
+
+void CacheContainer::Close() {
+    std::unique_lock lk{mutex};
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    if (!index_valid && !WriteIndex()) {
+        LOG_ERROR(Render, "Failed to write the index of cache container {}", file_path.string());
+    }
+
+    Unmap();
+    file.Close();
+    entries.clear();
+    data_end = 0;
+    index_valid = false;
+}
+
+bool CacheContainer::Map() {
+    map_size = file.GetSize();
+    if (map_size < sizeof(FileHeader)) {
+        return false;
+    }
+#ifdef _WIN32
+    const auto hfile = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.file)));
+    map_handle = CreateFileMappingW(hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!map_handle) {
+        LOG_ERROR(Render, "Failed to map cache container: {}", Common::GetLastErrorMsg());
+        return false;
+    }
+    map_base = static_cast<const u8*>(MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0));
+    if (!map_base) {
+        LOG_ERROR(Render, "Failed to map cache container: {}", Common::GetLastErrorMsg());
+        CloseHandle(map_handle);
+        map_handle = nullptr;
+        return false;
+    }
+#else
+    void* ptr = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fileno(file.file), 0);
+    if (ptr == MAP_FAILED) {
+        LOG_ERROR(Render, "Failed to map cache container: {}", Common::GetLastErrorMsg());
+        return false;
+    }
+    map_base = static_cast<const u8*>(ptr);
+#endif
+    return true;
+}
+
+void CacheContainer::Unmap() {
+    if (!map_base) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(map_base);
+    CloseHandle(map_handle);
+    map_handle = nullptr;
+#else
+    munmap(const_cast<u8*>(map_base), map_size);
+#endif
+    map_base = nullptr;
+    map_size = 0;
+}
+
+bool CacheContainer::LoadIndex() {
+    const auto* header = reinterpret_cast<const FileHeader*>(map_base);
+    const u64 index_size = u64{header->index_count} * sizeof(IndexEntry);
+    if (header->index_offset < sizeof(FileHeader) || header->index_offset > map_size ||
+        index_size > map_size - header->index_offset) {
+        return false;
+    }
+
+    const auto* index_data = map_base + header->index_offset;
+    if (XXH3_64bits(index_data, index_size) != header->index_checksum) {
+        return false;
+    }
+
+    const std::span index{reinterpret_cast<const IndexEntry*>(index_data), header->index_count};
+    entries.reserve(index.size());
+    for (const auto& entry : index) {
+        if (entry.offset + sizeof(RecordHeader) > header->index_offset) {
+            entries.clear();
+            return false;
+        }
+        entries[entry.key] = {entry.offset, entry.type};
+    }
+    data_end = header->index_offset;
+    return true;
+}
+
+void CacheContainer::ScanRecords() {
+    entries.clear();
+
+    u64 offset = sizeof(FileHeader);
+    while (offset + sizeof(RecordHeader) <= map_size) {
+        const auto* record = reinterpret_cast<const RecordHeader*>(map_base + offset);
+        const u64 record_size = RecordSize(record->size);
+        if (record_size > map_size - offset ||
+            XXH3_64bits(record + 1, record->size) != record->checksum) {
+            break;
+        }
+        entries[record->key] = {offset, record->type};
+        offset += record_size;
+    }
+
+    if (offset < map_size) {
+        LOG_WARNING(Render, "Ignoring {} trailing bytes of the cache container", map_size - offset);
+    }
+    data_end = offset;
+}
+
+bool CacheContainer::WriteIndex() {
+    std::vector<IndexEntry> index{};
+    index.reserve(entries.size());
+    for (const auto& [key, entry] : entries) {
+        index.push_back({.key = key, .offset = entry.offset, .type = entry.type});
+    }
+
+    const std::span index_bytes{reinterpret_cast<const u8*>(index.data()),
+                                index.size() * sizeof(IndexEntry)};
+    const FileHeader header = {
+        .magic = ContainerMagic,
+        .version = ContainerVersion,
+        .index_offset = data_end,
+        .index_checksum = XXH3_64bits(index_bytes.data(), index_bytes.size()),
+        .index_count = static_cast<u32>(index.size()),
+    };
+
+    // The index has to reach the disk before the header points to it
+    if (!file.Seek(static_cast<s64>(data_end)) ||
+        file.WriteSpan(index_bytes) != index_bytes.size() || !file.Commit()) {
+        return false;
+    }
+    if (!file.Seek(0) || !file.WriteObject(header) || !file.Flush()) {
+        return false;
+    }
+    index_valid = true;
+    return true;
+}
+
+std::span<const u8> CacheContainer::ReadEntry(u64 key, const Entry& entry,
+                                              std::vector<u8>& scratch) const {
+    if (entry.offset + sizeof(RecordHeader) > map_size) {
+        // Appended after the container was mapped
+        return {};
+    }
+
+    const auto* record = reinterpret_cast<const RecordHeader*>(map_base + entry.offset);
+    if (record->key != key || record->size > map_size - entry.offset - sizeof(RecordHeader)) {
+        return {};
+    }
+
+    const std::span payload{reinterpret_cast<const u8*>(record + 1), record->size};
+    if (XXH3_64bits(payload.data(), payload.size()) != record->checksum) {
+        LOG_WARNING(Render, "Cache entry {:#018x} is corrupted", key);
+        return {};
+    }
+
+    switch (record->codec) {
+    case Codec::Stored:
+        return payload;
+    case Codec::Deflate: {
+        scratch.resize(record->raw_size);
+        mz_ulong raw_size = record->raw_size;
+        if (mz_uncompress(scratch.data(), &raw_size, payload.data(), payload.size()) != MZ_OK ||
+            raw_size != record->raw_size) {
+            LOG_WARNING(Render, "Failed to decompress cache entry {:#018x}", key);
+            return {};
+        }
+        return scratch;
+    }
+    default:
+        LOG_WARNING(Render, "Cache entry {:#018x} has unknown codec {}", key,
+                    static_cast<u32>(record->codec));
+        return {};
+    }
+}
+
+std::span<const u8> CacheContainer::Read(u32 type, u64 key, std::vector<u8>& scratch) const {
+    std::shared_lock lk{mutex};
+    const auto it = entries.find(key);
+    if (it == entries.end() || it->second.type != type) {
+        return {};
+    }
+    return ReadEntry(key, it->second, scratch);
+}
+
+bool CacheContainer::Append(u32 type, u64 key, std::span<const u8> data) {
+    const Blob blob = {.type = type, .key = key, .data = data};
+    return AppendBatch(std::span{&blob, 1}) != 0;
+}
+
+u64 CacheContainer::AppendBatch(std::span<const Blob> blobs) {
+    if (blobs.empty()) {
+        return 0;
+    }
+
+    std::vector<EncodedRecord> records(blobs.size());
+    const u32 num_workers = std::min(std::max(std::thread::hardware_concurrency(), 1U),
+                                     MaxEncodeWorkers);
+    if (blobs.size() >= ParallelEncodeThreshold && num_workers > 1) {
+        std::atomic<size_t> next_blob{0};
+        const auto encode = [&] {
+            for (size_t i = next_blob++; i < blobs.size(); i = next_blob++) {
+                EncodeRecord(blobs[i], records[i]);
+            }
+        };
+        std::vector<std::jthread> workers{};
+        for (u32 i = 1; i < num_workers; ++i) {
+            workers.emplace_back(encode);
+        }
+        encode();
+    } else {
+        for (size_t i = 0; i < blobs.size(); ++i) {
+            EncodeRecord(blobs[i], records[i]);
+        }
+    }
+
+    std::vector<std::span<const u8>> buffers{};
+    buffers.reserve(records.size() * 3);
+    u64 batch_size = 0;
+    for (const auto& record : records) {
+        const u32 size = record.header.size;
+        const size_t padding_size = RecordSize(size) - sizeof(RecordHeader) - size;
+        buffers.emplace_back(reinterpret_cast<const u8*>(&record.header), sizeof(RecordHeader));
+        buffers.emplace_back(record.payload);
+        buffers.emplace_back(Padding.data(), padding_size);
+        batch_size += RecordSize(size);
+    }
+
+    std::unique_lock lk{mutex};
+    if (!file.IsOpen()) {
+        return 0;
+    }
+
+    if (index_valid) {
+        // The stored index goes stale with this append, so detach it from the header. If the
+        // emulator doesn't make it to Close, the next open will fall back to scanning records.
+        const FileHeader header = {
+            .magic = ContainerMagic,
+            .version = ContainerVersion,
+        };
+        if (!file.Seek(0) || !file.WriteObject(header) || !file.Flush()) {
+            return 0;
+        }
+        index_valid = false;
+    }
+
+    if (!WriteGather(buffers, data_end)) {
+        LOG_ERROR(Render, "Failed to append {} entries to the cache container", blobs.size());
+        return 0;
+    }
+
+    for (const auto& record : records) {
+        entries[record.header.key] = {data_end, record.header.type};
+        data_end += RecordSize(record.header.size);
+    }
+    return batch_size;
+}
+
+bool CacheContainer::WriteGather(std::span<const std::span<const u8>> buffers, u64 offset) {
+#ifdef _WIN32
+    // The stdio buffer merges the pieces into large writes
+    if (!file.Seek(static_cast<s64>(offset))) {
+        return false;
+    }
+    for (const auto& buffer : buffers) {
+        if (file.WriteSpan(buffer) != buffer.size()) {
+            return false;
+        }
+    }
+    return file.Flush();
+#else
+    // Bypass stdio so the whole batch goes out in as few syscalls as possible. Every other write
+    // seeks first, which resynchronizes the stream with the descriptor.
+    const int fd = fileno(file.file);
+    if (!file.Flush() || lseek(fd, static_cast<off_t>(offset), SEEK_SET) < 0) {
+        return false;
+    }
+
+    std::vector<iovec> iov{};
+    iov.reserve(buffers.size());
+    for (const auto& buffer : buffers) {
+        if (!buffer.empty()) {
+            iov.push_back({const_cast<u8*>(buffer.data()), buffer.size()});
+        }
+    }
+
+    size_t first = 0;
+    while (first < iov.size()) {
+        const int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+        const ssize_t written = writev(fd, iov.data() + first, count);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            LOG_ERROR(Render, "Failed to write to the cache container: {}",
+                      Common::GetLastErrorMsg());
+            return false;
+        }
+
+        // Skip the buffers that went out completely and trim a partially written one
+        size_t remaining = static_cast<size_t>(written);
+        while (first < iov.size() && remaining >= iov[first].iov_len) {
+            remaining -= iov[first].iov_len;
+            ++first;
+        }
+        if (remaining != 0) {
+            iov[first].iov_base = static_cast<u8*>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+    return true;
+#endif
+}
+
+void CacheContainer::ForEach(u32 type,
+                             const std::function<void(std::span<const u8> data)>& func) const {
+    std::shared_lock lk{mutex};
+    std::vector<u8> scratch{};
+    for (const auto& [key, entry] : entries) {
+        if (entry.type != type) {
+            continue;
+        }
+        const auto data = ReadEntry(key, entry, scratch);
+        if (!data.empty()) {
+            func(data);
+        }
+    }
+}
+
+} // namespace Storage
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <shared_mutex>
+#include <span>
+#include <vector>
+#include <tsl/robin_map.h>
+
+#include "common/io_file.h"
+#include "common/types.h"
+
+namespace Storage {
+
+/**
+ * Single-file, append-only container used by the archived pipeline cache.
+ *
+ * The file starts with a header followed by records. Each record carries its 64-bit key, blob
+ * type, codec and a checksum of the payload. On close, an index of all records is written after
+ * the last one and referenced from the header, so the next open doesn't need to walk the file.
+ * Before the first append, the header reference is cleared. If the index is missing or damaged,
+ * the records are scanned instead and everything past the first torn record is dropped.
+ *
+ * Records present at open time are read through a read-only file mapping. Records appended
+ * afterwards become readable once the container is reopened.
+ */
+class CacheContainer {
+public:
+    CacheContainer() = default;
+    ~CacheContainer();
+
+    CacheContainer(const CacheContainer&) = delete;
+    CacheContainer& operator=(const CacheContainer&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    /// Returns the payload of an entry. Stored entries are returned as a view into the mapping,
+    /// compressed ones are decoded into the scratch buffer. Returns an empty span on failure.
+    std::span<const u8> Read(u32 type, u64 key, std::vector<u8>& scratch) const;
+
+    struct Blob {
+        u32 type;
+        u64 key;
+        std::span<const u8> data;
+    };
+
+    /// Appends an entry, replacing any previous one with the same key on the next open.
+    bool Append(u32 type, u64 key, std::span<const u8> data);
+
+    /// Appends a batch of entries with a single gathered write. Large batches have their payloads
+    /// compressed in parallel. Returns the number of bytes written, or zero on failure.
+    u64 AppendBatch(std::span<const Blob> blobs);
+
+    void ForEach(u32 type, const std::function<void(std::span<const u8> data)>& func) const;
+
+private:
+    struct Entry {
+        u64 offset;
+        u32 type;
+    };
+
+    bool Map();
+    void Unmap();
+    bool LoadIndex();
+    void ScanRecords();
+    bool WriteIndex();
+    bool WriteGather(std::span<const std::span<const u8>> buffers, u64 offset);
+    std::span<const u8> ReadEntry(u64 key, const Entry& entry, std::vector<u8>& scratch) const;
+
+    mutable std::shared_mutex mutex;
+    Common::FS::IOFile file;
+    std::filesystem::path file_path;
+    tsl::robin_map<u64, Entry> entries;
+    const u8* map_base{};
+    size_t map_size{};
+#ifdef _WIN32
+    void* map_handle{};
+#endif
+    u64 data_end{};
+    bool index_valid{};
+};
+
+} // namespace Storage
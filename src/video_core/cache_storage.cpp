@@ -7,65 +7,52 @@
 #include "common/thread.h"
 #include "core/emulator_settings.h"
 
+#include "video_core/cache_container.h"
 #include "video_core/cache_storage.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
 
-#include <miniz.h>
+#include <xxhash.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
-#include <future>
 #include <mutex>
-#include <queue>
 
 namespace {
 
-std::mutex submit_mutex{};
-u32 num_requests{};
-std::condition_variable_any request_cv{};
-std::queue<std::packaged_task<void()>> req_queue{};
-std::mutex m_request{};
+struct PendingBlob {
+    Storage::BlobType type;
+    std::string name;
+    std::vector<u8> bytes;
+    std::vector<u32> words;
 
-mz_zip_archive zip_ar{};
-bool ar_is_read_only{true};
-
-} // namespace
-
-namespace Storage {
+    std::span<const u8> Data() const {
+        if (!words.empty()) {
+            return {reinterpret_cast<const u8*>(words.data()), words.size() * sizeof(u32)};
+        }
+        return bytes;
+    }
+};
 
-void ProcessIO(const std::stop_token& stoken) {
-    Common::SetCurrentThreadName("shadPS4:PipelineCacheIO");
+std::mutex queue_mutex{};
+std::condition_variable_any queue_cv{};
+std::vector<PendingBlob> pending_blobs{};
 
-    while (!stoken.stop_requested()) {
-        {
-            std::unique_lock lk{submit_mutex};
-            Common::CondvarWait(request_cv, lk, stoken, [&] { return num_requests; });
-        }
+std::atomic<u32> queue_depth{};
+std::atomic<u64> blobs_written{};
+std::atomic<u64> bytes_written{};
+std::atomic<u64> num_flushes{};
 
-        if (stoken.stop_requested()) {
-            break;
-        }
+Storage::CacheContainer container{};
 
-        while (num_requests) {
-            std::packaged_task<void()> request{};
-            {
-                std::scoped_lock lock{m_request};
-                if (req_queue.empty()) {
-                    continue;
-                }
-                request = std::move(req_queue.front());
-                req_queue.pop();
-            }
+} // namespace
 
-            if (request.valid()) {
-                request();
-                request.get_future().wait();
-            }
+namespace Storage {
 
-            --num_requests;
-        }
-    }
+/// Keys of the archived cache entries, derived from the blob name and type.
+u64 GetBlobKey(BlobType type, const std::string& name) {
+    return XXH3_64bits_withSeed(name.data(), name.size(), static_cast<u64>(type));
 }
 
 constexpr std::string GetBlobFileExtension(BlobType type) {
@@ -87,6 +74,58 @@ constexpr std::string GetBlobFileExtension(BlobType type) {
     }
 }
 
+static void FlushBatch(const std::filesystem::path& cache_path, std::vector<PendingBlob>& batch) {
+    u64 batch_bytes = 0;
+    if (EmulatorSettings.IsPipelineCacheArchived()) {
+        std::vector<CacheContainer::Blob> blobs{};
+        blobs.reserve(batch.size());
+        for (const auto& blob : batch) {
+            blobs.push_back({
+                .type = static_cast<u32>(blob.type),
+                .key = GetBlobKey(blob.type, blob.name),
+                .data = blob.Data(),
+            });
+        }
+        batch_bytes = container.AppendBatch(blobs);
+    } else {
+        using namespace Common::FS;
+        for (const auto& blob : batch) {
+            auto path = cache_path / blob.name;
+            path.replace_extension(GetBlobFileExtension(blob.type));
+            const auto file = IOFile{path, FileAccessMode::Create};
+            batch_bytes += file.WriteSpan(blob.Data());
+        }
+    }
+
+    blobs_written += batch.size();
+    bytes_written += batch_bytes;
+    ++num_flushes;
+    queue_depth -= static_cast<u32>(batch.size());
+    batch.clear();
+}
+
+void ProcessIO(const std::stop_token& stoken, const std::filesystem::path& cache_path) {
+    Common::SetCurrentThreadName("shadPS4:PipelineCacheIO");
+
+    // Everything queued since the last flush is written out together. Blobs still pending when
+    // a stop is requested are written before the thread exits.
+    std::vector<PendingBlob> batch{};
+    while (true) {
+        {
+            std::unique_lock lk{queue_mutex};
+            Common::CondvarWait(queue_cv, lk, stoken, [] { return !pending_blobs.empty(); });
+            batch.swap(pending_blobs);
+        }
+        if (batch.empty()) {
+            if (stoken.stop_requested()) {
+                break;
+            }
+            continue;
+        }
+        FlushBatch(cache_path, batch);
+    }
+}
+
 void DataBase::Open() {
     if (opened) {
         return;
@@ -96,18 +135,11 @@ void DataBase::Open() {
 
     using namespace Common::FS;
     if (EmulatorSettings.IsPipelineCacheArchived()) {
-        mz_zip_zero_struct(&zip_ar);
-
         cache_path = GetUserPath(PathType::CacheDir) /
-                     std::filesystem::path{game_info.GameSerial()}.replace_extension(".zip");
-
-        if (!mz_zip_reader_init_file(&zip_ar, cache_path.string().c_str(),
-                                     MZ_ZIP_FLAG_READ_ALLOW_WRITING) ||
-            !mz_zip_validate_archive(&zip_ar, 0)) {
-            LOG_INFO(Render, "Cache archive {} is not found or archive is corrupted",
-                     cache_path.string().c_str());
-            mz_zip_reader_end(&zip_ar);
-            mz_zip_writer_init_file(&zip_ar, cache_path.string().c_str(), 0);
+                     std::filesystem::path{game_info.GameSerial()}.replace_extension(".cache");
+        if (!container.Open(cache_path)) {
+            LOG_ERROR(Render, "Failed to open cache container {}", cache_path.string());
+            return;
         }
     } else {
         cache_path = GetUserPath(PathType::CacheDir) / game_info.GameSerial();
@@ -116,7 +148,7 @@ void DataBase::Open() {
         }
     }
 
-    io_worker = std::jthread{ProcessIO};
+    io_worker = std::jthread{ProcessIO, cache_path};
     opened = true;
 }
 
@@ -125,86 +157,71 @@ void DataBase::Close() {
         return;
     }
 
+    // The IO thread writes out the remaining blobs before exiting
     io_worker.request_stop();
     io_worker.join();
 
     if (EmulatorSettings.IsPipelineCacheArchived()) {
-        mz_zip_writer_finalize_archive(&zip_ar);
-        mz_zip_writer_end(&zip_ar);
+        container.Close();
     }
+    opened = false;
 
-    LOG_INFO(Render, "Cache dumped");
-}
-
-template <typename T>
-bool WriteVector(const BlobType type, std::filesystem::path&& path_, std::vector<T>&& v) {
-    {
-        auto request = std::packaged_task<void()>{[=]() {
-            auto path{path_};
-            path.replace_extension(GetBlobFileExtension(type));
-            if (EmulatorSettings.IsPipelineCacheArchived()) {
-                ASSERT_MSG(!ar_is_read_only,
-                           "The archive is read-only. Did you forget to call `FinishPreload`?");
-                if (!mz_zip_writer_add_mem(&zip_ar, path.string().c_str(), v.data(),
-                                           v.size() * sizeof(T), MZ_BEST_COMPRESSION)) {
-                    LOG_ERROR(Render, "Failed to add {} to the archive", path.string().c_str());
-                }
-            } else {
-                using namespace Common::FS;
-                const auto file = IOFile{path, FileAccessMode::Create};
-                file.Write(v);
-            }
-        }};
-        std::scoped_lock lock{m_request};
-        req_queue.emplace(std::move(request));
-    }
-
-    std::scoped_lock lk{submit_mutex};
-    ++num_requests;
-    request_cv.notify_one();
-    return true;
+    LOG_INFO(Render, "Cache dumped: {} blobs, {} KiB written in {} flushes", blobs_written.load(),
+             bytes_written.load() / 1024, num_flushes.load());
 }
 
 template <typename T>
 void LoadVector(BlobType type, std::filesystem::path& path, std::vector<T>& v) {
     using namespace Common::FS;
-    path.replace_extension(GetBlobFileExtension(type));
     if (EmulatorSettings.IsPipelineCacheArchived()) {
-        int index{-1};
-        index = mz_zip_reader_locate_file(&zip_ar, path.string().c_str(), nullptr, 0);
-        if (index < 0) {
-            LOG_WARNING(Render, "File {} is not found in the archive", path.string().c_str());
+        std::vector<u8> scratch{};
+        const auto data =
+            container.Read(static_cast<u32>(type), GetBlobKey(type, path.string()), scratch);
+        if (data.empty()) {
+            LOG_WARNING(Render, "Entry {} is not found in the cache", path.string());
             return;
         }
-        mz_zip_archive_file_stat stat{};
-        mz_zip_reader_file_stat(&zip_ar, index, &stat);
-        v.resize(stat.m_uncomp_size / sizeof(T));
-        mz_zip_reader_extract_to_mem(&zip_ar, index, v.data(), stat.m_uncomp_size, 0);
+        v.resize(data.size() / sizeof(T));
+        std::memcpy(v.data(), data.data(), v.size() * sizeof(T));
     } else {
+        path.replace_extension(GetBlobFileExtension(type));
         const auto file = IOFile{path, FileAccessMode::Read};
         v.resize(file.GetSize() / sizeof(T));
         file.Read(v);
     }
 }
 
+static bool Enqueue(PendingBlob&& blob) {
+    {
+        std::scoped_lock lk{queue_mutex};
+        pending_blobs.emplace_back(std::move(blob));
+        ++queue_depth;
+    }
+    queue_cv.notify_one();
+    return true;
+}
+
 bool DataBase::Save(BlobType type, const std::string& name, std::vector<u8>&& data) {
     if (!opened) {
         return false;
     }
-
-    auto path = EmulatorSettings.IsPipelineCacheArchived() ? std::filesystem::path{name}
-                                                           : cache_path / name;
-    return WriteVector(type, std::move(path), std::move(data));
+    return Enqueue({.type = type, .name = name, .bytes = std::move(data)});
 }
 
 bool DataBase::Save(BlobType type, const std::string& name, std::vector<u32>&& data) {
     if (!opened) {
         return false;
     }
+    return Enqueue({.type = type, .name = name, .words = std::move(data)});
+}
 
-    auto path = EmulatorSettings.IsPipelineCacheArchived() ? std::filesystem::path{name}
-                                                           : cache_path / name;
-    return WriteVector(type, std::move(path), std::move(data));
+DataBase::WriteStats DataBase::GetWriteStats() const {
+    return {
+        .queue_depth = queue_depth.load(std::memory_order_relaxed),
+        .blobs_written = blobs_written.load(std::memory_order_relaxed),
+        .bytes_written = bytes_written.load(std::memory_order_relaxed),
+        .num_flushes = num_flushes.load(std::memory_order_relaxed),
+    };
 }
 
 void DataBase::Load(BlobType type, const std::string& name, std::vector<u8>& data) {
@@ -227,22 +244,26 @@ void DataBase::Load(BlobType type, const std::string& name, std::vector<u32>& da
     return LoadVector(type, path, data);
 }
 
-void DataBase::ForEachBlob(BlobType type, const std::function<void(std::vector<u8>&& data)>& func) {
+std::span<const u8> DataBase::LoadView(BlobType type, const std::string& name,
+                                       std::vector<u8>& scratch) {
+    if (!opened) {
+        return {};
+    }
+
+    if (EmulatorSettings.IsPipelineCacheArchived()) {
+        return container.Read(static_cast<u32>(type), GetBlobKey(type, name), scratch);
+    }
+
+    auto path = cache_path / name;
+    LoadVector(type, path, scratch);
+    return scratch;
+}
+
+void DataBase::ForEachBlob(BlobType type,
+                           const std::function<void(std::span<const u8> data)>& func) {
     const auto& ext = GetBlobFileExtension(type);
     if (EmulatorSettings.IsPipelineCacheArchived()) {
-        const auto num_files = mz_zip_reader_get_num_files(&zip_ar);
-        for (int index = 0; index < num_files; ++index) {
-            std::array<char, MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE> file_name{};
-            file_name.fill(0);
-            mz_zip_reader_get_filename(&zip_ar, index, file_name.data(), file_name.size());
-            if (std::string{file_name.data()}.ends_with(ext)) {
-                mz_zip_archive_file_stat stat{};
-                mz_zip_reader_file_stat(&zip_ar, index, &stat);
-                std::vector<u8> data(stat.m_uncomp_size);
-                mz_zip_reader_extract_to_mem(&zip_ar, index, data.data(), data.size(), 0);
-                func(std::move(data));
-            }
-        }
+        container.ForEach(static_cast<u32>(type), func);
     } else {
         for (const auto& file_name : std::filesystem::directory_iterator{cache_path}) {
             if (file_name.path().extension().string().ends_with(ext)) {
@@ -251,18 +272,11 @@ void DataBase::ForEachBlob(BlobType type, const std::function<void(std::vector<u
                 if (file.IsOpen()) {
                     std::vector<u8> data(file.GetSize());
                     file.Read(data);
-                    func(std::move(data));
+                    func(data);
                 }
             }
         }
     }
 }
 
-void DataBase::FinishPreload() {
-    if (EmulatorSettings.IsPipelineCacheArchived()) {
-        mz_zip_writer_init_from_reader(&zip_ar, cache_path.string().c_str());
-        ar_is_read_only = false;
-    }
-}
-
 } // namespace Storage
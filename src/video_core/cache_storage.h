@@ -8,6 +8,7 @@
 #include "common/types.h"
 
 #include <functional>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -22,6 +23,13 @@ enum class BlobType : u32 {
 
 class DataBase {
 public:
+    struct WriteStats {
+        u32 queue_depth;
+        u64 blobs_written;
+        u64 bytes_written;
+        u64 num_flushes;
+    };
+
     static DataBase& Instance() {
         return *Common::Singleton<DataBase>::Instance();
     }
@@ -31,7 +39,6 @@ public:
     [[nodiscard]] bool IsOpened() const {
         return opened;
     }
-    void FinishPreload();
 
     bool Save(BlobType type, const std::string& name, std::vector<u8>&& data);
     bool Save(BlobType type, const std::string& name, std::vector<u32>&& data);
@@ -39,7 +46,15 @@ public:
     void Load(BlobType type, const std::string& name, std::vector<u8>& data);
     void Load(BlobType type, const std::string& name, std::vector<u32>& data);
 
-    void ForEachBlob(BlobType type, const std::function<void(std::vector<u8>&& data)>& func);
+    /// Returns the blob contents without copying them when the storage allows it, otherwise
+    /// they are loaded into the scratch buffer. Returns an empty span if the blob is missing.
+    std::span<const u8> LoadView(BlobType type, const std::string& name, std::vector<u8>& scratch);
+
+    void ForEachBlob(BlobType type, const std::function<void(std::span<const u8> data)>& func);
+
+    /// Saves are queued and written out in batches by the IO thread. These counters show how far
+    /// behind the writer is.
+    [[nodiscard]] WriteStats GetWriteStats() const;
 
 private:
     std::jthread io_worker{};
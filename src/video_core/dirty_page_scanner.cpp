@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/dirty_page_scanner.h"
+
+#ifdef __linux__
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <linux/userfaultfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "common/error.h"
+
+// Kernel headers older than 6.7 lack the PAGEMAP_SCAN interface
+#ifndef PAGEMAP_SCAN
+#define PAGE_IS_WRITTEN (1 << 1)
+#define PM_SCAN_WP_MATCHING (1 << 0)
+
+struct page_region {
+    __u64 start;
+    __u64 end;
+    __u64 categories;
+};
+
+struct pm_scan_arg {
+    __u64 size;
+    __u64 flags;
+    __u64 start;
+    __u64 end;
+    __u64 walk_end;
+    __u64 vec;
+    __u64 vec_len;
+    __u64 max_pages;
+    __u64 category_inverted;
+    __u64 category_mask;
+    __u64 category_anyof_mask;
+    __u64 return_mask;
+};
+
+#define PAGEMAP_SCAN _IOWR('f', 16, struct pm_scan_arg)
+#endif
+
+#ifndef UFFD_FEATURE_WP_UNPOPULATED
+#define UFFD_FEATURE_WP_UNPOPULATED (1 << 13)
+#endif
+#ifndef UFFD_FEATURE_WP_ASYNC
+#define UFFD_FEATURE_WP_ASYNC (1 << 15)
+#endif
+#endif
+
+namespace VideoCore {
+
+#ifdef __linux__
+
+DirtyPageScanner::DirtyPageScanner() {
+    uffd = static_cast<int>(
+        syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY));
+    if (uffd == -1) {
+        LOG_WARNING(Render, "Unable to create userfaultfd: {}", Common::GetLastErrorMsg());
+        return;
+    }
+    uffdio_api api{};
+    api.api = UFFD_API;
+    api.features =
+        UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED | UFFD_FEATURE_WP_HUGETLBFS_SHMEM;
+    if (ioctl(uffd, UFFDIO_API, &api) != 0) {
+        LOG_WARNING(Render, "Asynchronous userfaultfd write protection is not supported");
+        close(uffd);
+        uffd = -1;
+        return;
+    }
+    pagemap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (pagemap == -1) {
+        LOG_WARNING(Render, "Unable to open pagemap: {}", Common::GetLastErrorMsg());
+        return;
+    }
+
+    // A scan of nothing tells whether the ioctl exists at all
+    pm_scan_arg arg{};
+    arg.size = sizeof(arg);
+    if (ioctl(pagemap, PAGEMAP_SCAN, &arg) != 0) {
+        LOG_WARNING(Render, "PAGEMAP_SCAN is not supported: {}", Common::GetLastErrorMsg());
+        close(pagemap);
+        pagemap = -1;
+    }
+}
+
+DirtyPageScanner::~DirtyPageScanner() {
+    if (pagemap != -1) {
+        close(pagemap);
+    }
+    if (uffd != -1) {
+        close(uffd);
+    }
+}
+
+void DirtyPageScanner::Register(VAddr addr, u64 size) {
+    uffdio_register reg{};
+    reg.range.start = addr;
+    reg.range.len = size;
+    reg.mode = UFFDIO_REGISTER_MODE_WP;
+    const int ret = ioctl(uffd, UFFDIO_REGISTER, &reg);
+    ASSERT_MSG(ret != -1, "Uffdio register failed with error: {}", Common::GetLastErrorMsg());
+    WriteProtect(addr, size);
+}
+
+void DirtyPageScanner::Unregister(VAddr addr, u64 size) {
+    uffdio_range range{};
+    range.start = addr;
+    range.len = size;
+    const int ret = ioctl(uffd, UFFDIO_UNREGISTER, &range);
+    ASSERT_MSG(ret != -1, "Uffdio unregister failed with error: {}", Common::GetLastErrorMsg());
+}
+
+void DirtyPageScanner::WriteProtect(VAddr addr, u64 size) {
+    uffdio_writeprotect wp{};
+    wp.range.start = addr;
+    wp.range.len = size;
+    wp.mode = UFFDIO_WRITEPROTECT_MODE_WP;
+    const int ret = ioctl(uffd, UFFDIO_WRITEPROTECT, &wp);
+    ASSERT_MSG(ret != -1, "Uffdio writeprotect failed with error: {}", Common::GetLastErrorMsg());
+}
+
+std::span<const DirtyPageScanner::Range> DirtyPageScanner::Scan(VAddr addr, u64 size) {
+    constexpr size_t MaxRegions = 256;
+    std::array<page_region, MaxRegions> regions;
+
+    ranges.clear();
+    const VAddr end = addr + size;
+    while (addr < end) {
+        pm_scan_arg arg{};
+        arg.size = sizeof(arg);
+        arg.flags = PM_SCAN_WP_MATCHING;
+        arg.start = addr;
+        arg.end = end;
+        arg.vec = reinterpret_cast<u64>(regions.data());
+        arg.vec_len = regions.size();
+        arg.category_mask = PAGE_IS_WRITTEN;
+        arg.return_mask = PAGE_IS_WRITTEN;
+        const int num_regions = ioctl(pagemap, PAGEMAP_SCAN, &arg);
+        if (num_regions < 0) {
+            LOG_ERROR(Render, "PAGEMAP_SCAN failed with error: {}", Common::GetLastErrorMsg());
+            break;
+        }
+        for (int i = 0; i < num_regions; ++i) {
+            ranges.push_back({regions[i].start, regions[i].end - regions[i].start});
+        }
+        if (arg.walk_end <= addr) {
+            break;
+        }
+        addr = arg.walk_end;
+    }
+    return ranges;
+}
+
+bool DirtyPageScanner::IsFasterThanFaults() {
+    constexpr size_t PageSize = 4_KB;
+    constexpr size_t NumPages = 1024;
+    constexpr size_t Size = NumPages * PageSize;
+    auto* const scratch = static_cast<u8*>(
+        mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (scratch == MAP_FAILED) {
+        return false;
+    }
+    std::memset(scratch, 0, Size);
+    const auto addr = reinterpret_cast<VAddr>(scratch);
+
+    const auto fault_start = std::chrono::steady_clock::now();
+    for (size_t page = 0; page < NumPages; ++page) {
+        mprotect(scratch + page * PageSize, PageSize, PROT_READ);
+        mprotect(scratch + page * PageSize, PageSize, PROT_READ | PROT_WRITE);
+        scratch[page * PageSize] = 1;
+    }
+    const auto fault_end = std::chrono::steady_clock::now();
+
+    Register(addr, Size);
+    const auto scan_start = std::chrono::steady_clock::now();
+    for (size_t page = 0; page < NumPages; ++page) {
+        scratch[page * PageSize] = 2;
+    }
+    const auto written = Scan(addr, Size);
+    const auto scan_end = std::chrono::steady_clock::now();
+    const bool found_all = written.size() == 1 && written[0].size == Size;
+    Unregister(addr, Size);
+    munmap(scratch, Size);
+
+    const auto fault_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(fault_end - fault_start).count();
+    const auto scan_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(scan_end - scan_start).count();
+    LOG_INFO(Render, "Write tracking cost per page: faults {} ns, dirty page scan {} ns",
+             fault_ns / NumPages, scan_ns / NumPages);
+    if (!found_all) {
+        LOG_WARNING(Render, "Dirty page scan missed writes to scratch memory");
+        return false;
+    }
+    return scan_ns < fault_ns;
+}
+
+#else
+
+DirtyPageScanner::DirtyPageScanner() = default;
+
+DirtyPageScanner::~DirtyPageScanner() = default;
+
+void DirtyPageScanner::Register(VAddr addr, u64 size) {
+    UNREACHABLE();
+}
+
+void DirtyPageScanner::Unregister(VAddr addr, u64 size) {
+    UNREACHABLE();
+}
+
+void DirtyPageScanner::WriteProtect(VAddr addr, u64 size) {
+    UNREACHABLE();
+}
+
+std::span<const DirtyPageScanner::Range> DirtyPageScanner::Scan(VAddr addr, u64 size) {
+    UNREACHABLE();
+    return {};
+}
+
+bool DirtyPageScanner::IsFasterThanFaults() {
+    return false;
+}
+
+#endif
+
+} // namespace VideoCore
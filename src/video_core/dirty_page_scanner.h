@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+
+namespace VideoCore {
+
+/**
+ * Finds the pages written by the CPU without taking a signal per page. Ranges are registered for
+ * asynchronous userfaultfd write protection, where the kernel resolves write faults by itself and
+ * only remembers the page as written. The PAGEMAP_SCAN ioctl then reports the written pages and
+ * write protects them again in one atomic step, so no write can slip between the two.
+ *
+ * This needs Linux 6.7 or newer. The older soft-dirty bits are not used: clearing them is
+ * process wide and separate from reading them, so writes racing with a scan would be lost.
+ */
+class DirtyPageScanner {
+public:
+    struct Range {
+        VAddr addr;
+        u64 size;
+    };
+
+    explicit DirtyPageScanner();
+    ~DirtyPageScanner();
+
+    DirtyPageScanner(const DirtyPageScanner&) = delete;
+    DirtyPageScanner& operator=(const DirtyPageScanner&) = delete;
+
+    /// Returns true if the kernel supports everything needed for scanning.
+    [[nodiscard]] bool IsSupported() const {
+        return uffd != -1 && pagemap != -1;
+    }
+
+    /// Starts tracking writes to a range of memory. Pages start out as not written.
+    void Register(VAddr addr, u64 size);
+
+    /// Stops tracking writes to a range of memory.
+    void Unregister(VAddr addr, u64 size);
+
+    /// Marks a range of registered memory as not written.
+    void WriteProtect(VAddr addr, u64 size);
+
+    /// Returns the page ranges written since the previous scan and write protects them again.
+    /// The returned span is valid until the next scan.
+    std::span<const Range> Scan(VAddr addr, u64 size);
+
+    /**
+     * Compares the cost of both tracking backends on scratch memory: finding written pages with a
+     * scan, and the two protection changes a fault costs per page. The signal itself is not
+     * included, so the comparison favors faults. Returns true if scanning is cheaper.
+     */
+    bool IsFasterThanFaults();
+
+private:
+    int uffd = -1;
+    int pagemap = -1;
+    std::vector<Range> ranges;
+};
+
+} // namespace VideoCore
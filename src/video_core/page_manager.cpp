@@ -1,14 +1,20 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <bit>
+#include <chrono>
+#include <mutex>
 #include <boost/container/small_vector.hpp>
 #include "common/assert.h"
 #include "common/debug.h"
 #include "common/div_ceil.h"
 #include "common/range_lock.h"
 #include "common/signal_context.h"
+#include "core/debug_state.h"
+#include "core/emulator_settings.h"
 #include "core/memory.h"
 #include "core/signals.h"
+#include "video_core/dirty_page_scanner.h"
 #include "video_core/page_manager.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 
@@ -87,7 +93,10 @@ struct PageManager::Impl {
     static constexpr size_t ADDRESS_BITS = 40;
     static constexpr size_t NUM_ADDRESS_PAGES = 1ULL << (40 - PM_PAGE_BITS);
     static constexpr size_t NUM_ADDRESS_LOCKS = NUM_ADDRESS_PAGES / PAGES_PER_LOCK;
+    static constexpr size_t MAX_DEFERRED_RANGES = 64;
+    static constexpr u64 MAX_FAULT_WINDOW_PAGES = 256;
     inline static Vulkan::Rasterizer* rasterizer;
+    inline static Impl* instance;
 #ifdef ENABLE_USERFAULTFD
     Impl(Vulkan::Rasterizer* rasterizer_) {
         rasterizer = rasterizer_;
@@ -128,6 +137,7 @@ struct PageManager::Impl {
         wp.range.start = address;
         wp.range.len = size;
         wp.mode = allow_write ? 0 : UFFDIO_WRITEPROTECT_MODE_WP;
+        ++num_protect_calls;
         const int ret = ioctl(uffd, UFFDIO_WRITEPROTECT, &wp);
         ASSERT_MSG(ret != -1, "Uffdio writeprotect failed with error: {}",
                    Common::GetLastErrorMsg());
@@ -174,6 +184,7 @@ struct PageManager::Impl {
 
             // Notify rasterizer about the fault.
             const VAddr addr = msg.arg.pagefault.address;
+            ++num_write_faults;
             rasterizer->InvalidateMemory(addr, 1);
         }
     }
@@ -183,6 +194,18 @@ struct PageManager::Impl {
 #else
     Impl(Vulkan::Rasterizer* rasterizer_) {
         rasterizer = rasterizer_;
+        instance = this;
+
+        // Deferring the invalidation is only safe when it never has to flush GPU data first
+        if (EmulatorSettings.IsBatchWriteFaults()) {
+            batch_write_faults = EmulatorSettings.GetReadbacksMode() == GpuReadbacksMode::Disabled;
+            if (!batch_write_faults) {
+                LOG_WARNING(Render, "Write fault batching is not available with GPU readbacks");
+            }
+        }
+        if (EmulatorSettings.GetWriteTracking() != GpuWriteTracking::Faults) {
+            CreateScanner();
+        }
 
         // Should be called first.
         constexpr auto priority = std::numeric_limits<u32>::min();
@@ -190,34 +213,201 @@ struct PageManager::Impl {
                                                                   priority);
     }
 
+    /// Switches write tracking to dirty page scans if they are available and worth it.
+    void CreateScanner() {
+        // Like batched faults, scans find writes late and can't flush GPU data before them
+        if (EmulatorSettings.GetReadbacksMode() != GpuReadbacksMode::Disabled) {
+            LOG_WARNING(Render, "Dirty page scans are not available with GPU readbacks");
+            return;
+        }
+        auto new_scanner = std::make_unique<DirtyPageScanner>();
+        if (!new_scanner->IsSupported()) {
+            LOG_WARNING(Render, "Dirty page scans are not supported, tracking writes with faults");
+            return;
+        }
+        if (EmulatorSettings.GetWriteTracking() == GpuWriteTracking::Auto &&
+            !new_scanner->IsFasterThanFaults()) {
+            LOG_INFO(Render, "Tracking GPU memory writes with faults");
+            return;
+        }
+        LOG_INFO(Render, "Tracking GPU memory writes with dirty page scans");
+        scanner = std::move(new_scanner);
+    }
+
     void OnMap(VAddr address, size_t size) {
-        // No-op
+        if (scanner) {
+            scanner->Register(address, size);
+        }
     }
 
     void OnUnmap(VAddr address, size_t size) {
-        // No-op
+        if (scanner) {
+            scanner->Unregister(address, size);
+        }
     }
 
     void Protect(VAddr address, size_t size, Core::MemoryPermission perms) {
         RENDERER_TRACE;
+        if (scanner) {
+            // Written pages stay writable, unwatched ones are filtered out when scanning. Only
+            // clear what was written before the watch started.
+            if (False(perms & Core::MemoryPermission::Write)) {
+                ++num_protect_calls;
+                scanner->WriteProtect(address, size);
+            }
+            return;
+        }
         auto* memory = Core::Memory::Instance();
         auto& impl = memory->GetAddressSpace();
         ASSERT_MSG(perms != Core::MemoryPermission::Write,
                    "Attempted to protect region as write-only which is not a valid permission");
+        ++num_protect_calls;
         impl.Protect(address, size, perms);
     }
 
     static bool GuestFaultSignalHandler(void* context, void* fault_address) {
         const auto addr = reinterpret_cast<VAddr>(fault_address);
         if (Common::IsWriteError(context)) {
-            return rasterizer->InvalidateMemory(addr, 8);
+            if (instance->batch_write_faults && rasterizer->IsMapped(addr, 8)) {
+                ++instance->num_write_faults;
+                return instance->DeferWriteFault(addr) || rasterizer->InvalidateMemory(addr, 8);
+            }
+            const bool handled = rasterizer->InvalidateMemory(addr, 8);
+            instance->num_write_faults += handled;
+            return handled;
         } else {
             return rasterizer->ReadMemory(addr, 8);
         }
         return false;
     }
+
+    /**
+     * Unprotects a window of pages starting at a faulting write and records it for invalidation
+     * at the next submission. Each fault landing right past the previous window of the thread
+     * doubles the window, so streaming writes take a few faults per region instead of one per
+     * page. Returns false if the fault has to be handled right away.
+     */
+    bool DeferWriteFault(VAddr addr) {
+        thread_local u64 next_page{};
+        thread_local u64 window_pages{1};
+
+        const u64 page = addr >> PM_PAGE_BITS;
+        window_pages = page == next_page ? std::min(window_pages * 2, MAX_FAULT_WINDOW_PAGES) : 1;
+
+        // Keep the window within the region lock of the fault and within mapped GPU memory
+        const u64 lock_end = Common::AlignUp(page + 1, PAGES_PER_LOCK);
+        u64 num_pages = std::min(window_pages, lock_end - page);
+        if (num_pages > 1 &&
+            !rasterizer->IsMapped(page << PM_PAGE_BITS, num_pages << PM_PAGE_BITS)) {
+            num_pages = 1;
+        }
+        next_page = page + num_pages;
+
+        const VAddr window_addr = page << PM_PAGE_BITS;
+        const u64 window_size = num_pages << PM_PAGE_BITS;
+        std::scoped_lock lk{deferred_lock};
+        auto* const last = num_deferred_ranges > 0 ? &deferred_ranges[num_deferred_ranges - 1]
+                                                   : nullptr;
+        const bool extends_last = last && last->addr + last->size == window_addr;
+        if (!extends_last && num_deferred_ranges == MAX_DEFERRED_RANGES) {
+            return false;
+        }
+        {
+            std::scoped_lock page_lk{locks[page / PAGES_PER_LOCK]};
+            Protect(window_addr, window_size, Core::MemoryPermission::ReadWrite);
+        }
+        if (extends_last) {
+            last->size += window_size;
+        } else {
+            deferred_ranges[num_deferred_ranges++] = {window_addr, window_size};
+        }
+        return true;
+    }
 #endif
 
+    void FlushGuestWrites() {
+        if (scanner) {
+            ScanGuestWrites();
+        }
+        std::array<DeferredRange, MAX_DEFERRED_RANGES> ranges;
+        size_t num_ranges{};
+        {
+            std::scoped_lock lk{deferred_lock};
+            num_ranges = std::exchange(num_deferred_ranges, 0);
+            std::copy_n(deferred_ranges.begin(), num_ranges, ranges.begin());
+        }
+        for (size_t i = 0; i < num_ranges; ++i) {
+            rasterizer->InvalidateMemory(ranges[i].addr, ranges[i].size);
+        }
+    }
+
+    /**
+     * Finds the watched pages written since the last scan and invalidates them. Only regions with
+     * write watched pages are scanned, and pages written while unwatched are skipped.
+     */
+    void ScanGuestWrites() {
+        RENDERER_TRACE;
+        std::scoped_lock lk{scan_lock};
+        const auto start = std::chrono::steady_clock::now();
+        boost::container::small_vector<DeferredRange, 16> dirty_ranges;
+        u32 num_dirty = 0;
+        for (size_t word = 0; word < active_regions.size(); ++word) {
+            u64 bits = active_regions[word].load(std::memory_order_relaxed);
+            while (bits != 0) {
+                const size_t region = word * 64 + std::countr_zero(bits);
+                bits &= bits - 1;
+                const VAddr region_addr = (region * PAGES_PER_LOCK) << PM_PAGE_BITS;
+                const auto written = scanner->Scan(region_addr, PAGES_PER_LOCK << PM_PAGE_BITS);
+                if (written.empty()) {
+                    continue;
+                }
+                std::scoped_lock region_lk{locks[region]};
+                for (const auto& range : written) {
+                    const u64 page_end = (range.addr + range.size) >> PM_PAGE_BITS;
+                    for (u64 page = range.addr >> PM_PAGE_BITS; page != page_end; ++page) {
+                        if (cached_pages[page].num_write_watchers == 0) {
+                            continue;
+                        }
+                        const VAddr page_addr = page << PM_PAGE_BITS;
+                        if (!dirty_ranges.empty() &&
+                            dirty_ranges.back().addr + dirty_ranges.back().size == page_addr) {
+                            dirty_ranges.back().size += PM_PAGE_SIZE;
+                        } else {
+                            dirty_ranges.push_back({page_addr, PM_PAGE_SIZE});
+                        }
+                        ++num_dirty;
+                    }
+                }
+            }
+        }
+        for (const auto& range : dirty_ranges) {
+            rasterizer->InvalidateMemory(range.addr, range.size);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        num_scan_dirty += num_dirty;
+        scan_us += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+
+    void EndFrame() {
+        DebugState.page_write_faults = num_write_faults.exchange(0);
+        DebugState.page_protect_calls = num_protect_calls.exchange(0);
+        DebugState.page_scan_dirty = num_scan_dirty.exchange(0);
+        DebugState.page_scan_us = scan_us.exchange(0);
+    }
+
+    /// Keeps count of the write watched pages of each region for the regions to scan.
+    void UpdateActiveRegion(u64 page, bool track) {
+        const size_t region = page / PAGES_PER_LOCK;
+        const u64 region_bit = 1ULL << (region % 64);
+        if (track) {
+            if (num_watched_pages[region]++ == 0) {
+                active_regions[region / 64].fetch_or(region_bit, std::memory_order_relaxed);
+            }
+        } else if (--num_watched_pages[region] == 0) {
+            active_regions[region / 64].fetch_and(~region_bit, std::memory_order_relaxed);
+        }
+    }
+
     template <bool track, bool is_read>
     void UpdatePageWatchers(VAddr addr, u64 size) {
         RENDERER_TRACE;
@@ -259,18 +449,27 @@ struct PageManager::Impl {
 
             // Apply the change to the page state
             const u8 new_count = state.AddDelta<track ? 1 : -1, is_read>();
+            const bool transition = (new_count == 0 && !track) || (new_count == 1 && track);
 
             if (auto new_perms = state.Perms(); new_perms != perms) [[unlikely]] {
                 // If the protection changed add pending (un)protect action
                 release_pending();
                 perms = new_perms;
             } else if (range_bytes != 0) {
-                // If the protection did not change, extend the potential range
-                potential_range_bytes += PM_PAGE_SIZE;
+                // If the protection did not change, extend the potential range. Re-protecting an
+                // already watched page would clear its written bit before the scan sees it.
+                if (!is_read && scanner && !transition) {
+                    release_pending();
+                } else {
+                    potential_range_bytes += PM_PAGE_SIZE;
+                }
             }
 
             // Only start a new range if the page must be (un)protected
-            if ((new_count == 0 && !track) || (new_count == 1 && track)) {
+            if (transition) {
+                if (!is_read && scanner) {
+                    UpdateActiveRegion(page, track);
+                }
                 if (range_bytes == 0) {
                     // Start a new potential range
                     range_begin = page;
@@ -324,14 +523,21 @@ struct PageManager::Impl {
             // Apply the change to the page state
             const u8 new_count =
                 update ? state.AddDelta<track ? 1 : -1, is_read>() : state.AddDelta<0, is_read>();
+            const bool transition =
+                update && ((new_count == 0 && !track) || (new_count == 1 && track));
 
             if (auto new_perms = state.Perms(); new_perms != perms) [[unlikely]] {
                 // If the protection changed add pending (un)protect action
                 release_pending();
                 perms = new_perms;
             } else if (range_bytes != 0) {
-                // If the protection did not change, extend the potential range
-                potential_range_bytes += PM_PAGE_SIZE;
+                // If the protection did not change, extend the potential range. Skipped and
+                // already watched pages are left alone while scanning, see UpdatePageWatchers.
+                if (!is_read && scanner && !transition) {
+                    release_pending();
+                } else {
+                    potential_range_bytes += PM_PAGE_SIZE;
+                }
             }
 
             // If the page is not being updated, skip it
@@ -340,7 +546,10 @@ struct PageManager::Impl {
             }
 
             // If the page must be (un)protected
-            if ((new_count == 0 && !track) || (new_count == 1 && track)) {
+            if (transition) {
+                if (!is_read && scanner) {
+                    UpdateActiveRegion(base_page + page, track);
+                }
                 if (range_bytes == 0) {
                     // Start a new potential range
                     range_begin = base_page + page;
@@ -362,6 +571,24 @@ struct PageManager::Impl {
     using LockType = Common::SpinLock;
 #endif
     std::array<LockType, NUM_ADDRESS_LOCKS> locks{};
+
+    struct DeferredRange {
+        VAddr addr;
+        u64 size;
+    };
+    std::array<DeferredRange, MAX_DEFERRED_RANGES> deferred_ranges{};
+    size_t num_deferred_ranges{};
+    LockType deferred_lock;
+    bool batch_write_faults{};
+    std::atomic<u32> num_write_faults{};
+    std::atomic<u32> num_protect_calls{};
+
+    std::unique_ptr<DirtyPageScanner> scanner;
+    std::array<u16, NUM_ADDRESS_LOCKS> num_watched_pages{};
+    std::array<std::atomic<u64>, NUM_ADDRESS_LOCKS / 64> active_regions{};
+    std::mutex scan_lock;
+    std::atomic<u32> num_scan_dirty{};
+    std::atomic<u32> scan_us{};
 };
 
 PageManager::PageManager(Vulkan::Rasterizer* rasterizer_)
@@ -387,6 +614,14 @@ void PageManager::UpdatePageWatchersForRegion(VAddr base_addr, RegionBits& mask)
     impl->UpdatePageWatchersForRegion<track, is_read>(base_addr, mask);
 }
 
+void PageManager::FlushGuestWrites() const {
+    impl->FlushGuestWrites();
+}
+
+void PageManager::EndFrame() const {
+    impl->EndFrame();
+}
+
 template void PageManager::UpdatePageWatchers<true>(VAddr addr, u64 size) const;
 template void PageManager::UpdatePageWatchers<false>(VAddr addr, u64 size) const;
 template void PageManager::UpdatePageWatchersForRegion<true, true>(VAddr base_addr,
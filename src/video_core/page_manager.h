@@ -43,6 +43,14 @@ public:
     template <bool track, bool is_read = false>
     void UpdatePageWatchersForRegion(VAddr base_addr, RegionBits& mask) const;
 
+    /// Invalidates guest writes that were not handled when they happened, from batched write
+    /// faults or dirty page scans. Must be called before the GPU may read memory written by the
+    /// guest, i.e. on submissions and flips.
+    void FlushGuestWrites() const;
+
+    /// Publishes the fault counters of the frame that ended and starts counting the next one.
+    void EndFrame() const;
+
     /// Returns page aligned address.
     static constexpr VAddr GetPageAddr(VAddr addr) {
         return Common::AlignDown(addr, PM_PAGE_SIZE);
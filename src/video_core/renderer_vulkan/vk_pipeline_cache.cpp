@@ -10,6 +10,7 @@
 #include "core/emulator_settings.h"
 #include "shader_recompiler/backend/spirv/emit_spirv.h"
 #include "shader_recompiler/info.h"
+#include "shader_recompiler/pass_stats.h"
 #include "shader_recompiler/recompiler.h"
 #include "shader_recompiler/runtime_info.h"
 #include "video_core/amdgpu/liverpool.h"
@@ -27,6 +28,7 @@ using Shader::Output;
 using Shader::Stage;
 
 constexpr static auto SpirvVersion1_6 = 0x00010600U;
+constexpr static u32 MaxCompileWorkers = 4;
 
 constexpr static std::array DescriptorHeapSizes = {
     vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, 512},
@@ -307,17 +309,28 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
         .needs_clip_distance_emulation = instance.GetDriverID() == vk::DriverId::eNvidiaProprietary,
         .supports_shader_stencil_export = instance_.IsShaderStencilExportSupported(),
     };
-    WarmUp();
 
     auto [cache_result, cache] = instance.GetDevice().createPipelineCacheUnique({});
     ASSERT_MSG(cache_result == vk::Result::eSuccess, "Failed to create pipeline cache: {}",
                vk::to_string(cache_result));
     pipeline_cache = std::move(cache);
+
+    WarmUp();
 }
 
-PipelineCache::~PipelineCache() = default;
+PipelineCache::~PipelineCache() {
+    StopShaderCompileWorkers();
+    CancelWarmUp();
+    if (EmulatorSettings.IsShaderPassStats()) {
+        using namespace Common::FS;
+        Shader::WritePassStats(GetUserPath(PathType::ShaderDir) / "pass_stats.json");
+    }
+}
 
 const GraphicsPipeline* PipelineCache::GetGraphicsPipeline() {
+    if (warm_up && warm_up->is_done.load(std::memory_order_acquire)) {
+        FinishWarmUp();
+    }
     if (!RefreshGraphicsKey()) {
         return nullptr;
     }
@@ -348,6 +361,9 @@ const GraphicsPipeline* PipelineCache::GetGraphicsPipeline() {
 }
 
 const ComputePipeline* PipelineCache::GetComputePipeline() {
+    if (warm_up && warm_up->is_done.load(std::memory_order_acquire)) {
+        FinishWarmUp();
+    }
     if (!RefreshComputeKey()) {
         return nullptr;
     }
@@ -470,7 +486,11 @@ bool PipelineCache::RefreshGraphicsStages() {
     fetch_shader = std::nullopt;
 
     Shader::Backend::Bindings binding{};
+    bool is_pending = false;
     const auto bind_stage = [&](Shader::Stage stage_in, Shader::LogicalStage stage_out) -> bool {
+        if (is_pending) {
+            return false;
+        }
         const auto stage_in_idx = static_cast<u32>(stage_in);
         const auto stage_out_idx = static_cast<u32>(stage_out);
         if (!regs.stage_enable.IsStageEnabled(stage_in_idx)) {
@@ -491,6 +511,12 @@ bool PipelineCache::RefreshGraphicsStages() {
         std::tie(infos[stage_out_idx], modules[stage_out_idx], fetch_shader_,
                  key.stage_hashes[stage_out_idx]) =
             GetProgram(stage_in, stage_out, params, binding);
+        if (!modules[stage_out_idx]) {
+            // Still being translated. Bindings of the next stages depend on this one, so they
+            // are requested once it's done.
+            is_pending = true;
+            return false;
+        }
         if (fetch_shader_) {
             fetch_shader = fetch_shader_;
         }
@@ -500,6 +526,9 @@ bool PipelineCache::RefreshGraphicsStages() {
     infos.fill(nullptr);
     modules.fill(nullptr);
     const auto result = bind_stage(Stage::Fragment, LogicalStage::Fragment);
+    if (is_pending) {
+        return false;
+    }
     if (!result && regs.vs_output_control.clip_distance_enable &&
         profile.needs_clip_distance_emulation) {
         // TODO: need to implement a discard only fallback shader
@@ -573,6 +602,9 @@ bool PipelineCache::RefreshGraphicsStages() {
     default:
         UNREACHABLE_MSG("unhandled stage_en: {}", (u32)regs.stage_enable.raw);
     }
+    if (is_pending) {
+        return false;
+    }
 
     const auto* vs_info = infos[static_cast<u32>(Shader::LogicalStage::Vertex)];
     if (vs_info && fetch_shader && !instance.IsVertexInputDynamicState()) {
@@ -603,7 +635,8 @@ bool PipelineCache::RefreshComputeKey() {
 
 vk::ShaderModule PipelineCache::CompileModule(Shader::Info& info, Shader::RuntimeInfo& runtime_info,
                                               const std::span<const u32>& code, size_t perm_idx,
-                                              Shader::Backend::Bindings& binding) {
+                                              Shader::Backend::Bindings& binding,
+                                              Shader::Pools& pools) {
     LOG_INFO(Render_Vulkan, "Compiling {} shader {:#x} {}", info.stage, info.pgm_hash,
              perm_idx != 0 ? "(permutation)" : "");
     DumpShader(code, info.pgm_hash, info.stage, perm_idx, "bin");
@@ -629,7 +662,8 @@ vk::ShaderModule PipelineCache::CompileModule(Shader::Info& info, Shader::Runtim
     Vulkan::SetObjectName(instance.GetDevice(), module, name);
     if (EmulatorSettings.IsShaderCollect()) {
         DebugState.CollectShader(name, info.l_stage, module, spv, code,
-                                 patch ? *patch : std::span<const u32>{}, is_patched);
+                                 patch ? *patch : std::span<const u32>{}, is_patched,
+                                 ir_program.pass_stats);
     }
     return module;
 }
@@ -638,12 +672,31 @@ PipelineCache::Result PipelineCache::GetProgram(Stage stage, LogicalStage l_stag
                                                 const Shader::ShaderParams& params,
                                                 Shader::Backend::Bindings& binding) {
     auto runtime_info = BuildRuntimeInfo(stage, l_stage);
+    const bool is_async = IsAsyncCompile(l_stage);
+    if (is_async && !program_cache.contains(params.hash)) {
+        const auto job = CompileShaderAsync(stage, l_stage, params, runtime_info, binding, 0);
+        if (!job) {
+            return {};
+        }
+        auto program = std::make_unique<Program>(stage, l_stage, params);
+        program->info = std::move(job->info);
+        auto spec = Shader::StageSpecialization(program->info, job->runtime_info, profile,
+                                                job->binding);
+        const auto perm_hash = HashCombine(params.hash, 0);
+
+        RegisterShaderMeta(program->info, spec.fetch_shader_data, spec, perm_hash, 0);
+        program->AddPermut(job->module, std::move(spec));
+        program_cache.emplace(params.hash, std::move(program));
+        // The lookup below refreshes the user data and picks the permutation
+    }
+
     auto [it_pgm, new_program] = program_cache.try_emplace(params.hash);
     if (new_program) {
         it_pgm.value() = std::make_unique<Program>(stage, l_stage, params);
         auto& program = it_pgm.value();
         auto start = binding;
-        const auto module = CompileModule(program->info, runtime_info, params.code, 0, binding);
+        const auto module =
+            CompileModule(program->info, runtime_info, params.code, 0, binding, pools);
         auto spec = Shader::StageSpecialization(program->info, runtime_info, profile, start);
         const auto perm_hash = HashCombine(params.hash, 0);
 
@@ -665,23 +718,123 @@ PipelineCache::Result PipelineCache::GetProgram(Stage stage, LogicalStage l_stag
 
     vk::ShaderModule module{};
 
-    const auto it = std::ranges::find(program->modules, spec, &Program::Module::spec);
+    auto it = std::ranges::find(program->modules, spec, &Program::Module::spec);
+    if (it == program->modules.end() && is_async) {
+        // Reserve the permutation index, the module is filled in once translated
+        program->AddPermut(vk::ShaderModule{}, std::move(spec));
+        it = std::prev(program->modules.end());
+    }
     if (it == program->modules.end()) {
         auto new_info = Shader::Info(stage, l_stage, params);
-        module = CompileModule(new_info, runtime_info, params.code, perm_idx, binding);
+        module = CompileModule(new_info, runtime_info, params.code, perm_idx, binding, pools);
 
         RegisterShaderMeta(info, spec.fetch_shader_data, spec, perm_hash, perm_idx);
         program->AddPermut(module, std::move(spec));
     } else {
-        info.AddBindings(binding);
-        module = it->module;
         perm_idx = std::distance(program->modules.begin(), it);
         perm_hash = HashCombine(params.hash, perm_idx);
+        if (!it->module) {
+            const auto job =
+                CompileShaderAsync(stage, l_stage, params, runtime_info, binding, perm_idx);
+            if (!job) {
+                return {};
+            }
+            it->module = job->module;
+            RegisterShaderMeta(info, it->spec.fetch_shader_data, it->spec, perm_hash, perm_idx);
+        }
+        info.AddBindings(binding);
+        module = it->module;
     }
     return std::make_tuple(&program->info, module,
                            program->modules[perm_idx].spec.fetch_shader_data, perm_hash);
 }
 
+bool PipelineCache::IsAsyncCompile(LogicalStage l_stage) const {
+    // Skipping a dispatch could leave data the guest reads back unwritten, so compute shaders are
+    // always compiled in place. The shader debugger tracks modules as they are created.
+    return EmulatorSettings.IsAsyncShaderCompile() && l_stage != LogicalStage::Compute &&
+           !EmulatorSettings.IsShaderCollect();
+}
+
+std::shared_ptr<PipelineCache::ShaderCompileJob> PipelineCache::CompileShaderAsync(
+    Stage stage, LogicalStage l_stage, const Shader::ShaderParams& params,
+    const Shader::RuntimeInfo& runtime_info, const Shader::Backend::Bindings& binding,
+    size_t perm_idx) {
+    const auto perm_hash = HashCombine(params.hash, perm_idx);
+    if (const auto it = pending_compiles.find(perm_hash); it != pending_compiles.end()) {
+        if (!it->second->is_done.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        auto job = std::move(it.value());
+        pending_compiles.erase(it);
+        return job;
+    }
+
+    auto job = std::make_shared<ShaderCompileJob>();
+    std::ranges::copy(params.user_data, job->user_data.begin());
+    job->code.assign(params.code.begin(), params.code.end());
+    job->info = Shader::Info(stage, l_stage,
+                             Shader::ShaderParams{job->user_data, job->code, params.hash});
+    job->info.pgm_base = params.Base();
+    job->runtime_info = runtime_info;
+    job->binding = binding;
+    job->perm_idx = perm_idx;
+    pending_compiles.emplace(perm_hash, job);
+
+    if (compile_workers.empty()) {
+        const u32 num_workers =
+            std::clamp<u32>(std::thread::hardware_concurrency() / 4, 1u, MaxCompileWorkers);
+        compile_workers.reserve(num_workers);
+        for (u32 i = 0; i < num_workers; ++i) {
+            compile_workers.emplace_back(
+                [this](const std::stop_token& stoken) { ShaderCompileWorker(stoken); });
+        }
+    }
+    {
+        std::scoped_lock lk{compile_mutex};
+        compile_queue.push_back(std::move(job));
+    }
+    compile_cv.notify_one();
+    return nullptr;
+}
+
+void PipelineCache::ShaderCompileWorker(const std::stop_token& stoken) {
+    Common::SetCurrentThreadName("shadPS4:ShaderCompile");
+
+    // IR allocations are recycled between the programs translated by this worker
+    Shader::Pools worker_pools;
+    while (!stoken.stop_requested()) {
+        std::shared_ptr<ShaderCompileJob> job;
+        {
+            std::unique_lock lk{compile_mutex};
+            Common::CondvarWait(compile_cv, lk, stoken, [&] { return !compile_queue.empty(); });
+            if (stoken.stop_requested()) {
+                break;
+            }
+            job = std::move(compile_queue.front());
+            compile_queue.pop_front();
+        }
+        auto binding = job->binding;
+        job->module = CompileModule(job->info, job->runtime_info, job->code, job->perm_idx,
+                                    binding, worker_pools);
+        job->is_done.store(true, std::memory_order_release);
+    }
+}
+
+void PipelineCache::StopShaderCompileWorkers() {
+    for (auto& worker : compile_workers) {
+        worker.request_stop();
+    }
+    compile_workers.clear();
+    compile_queue.clear();
+    for (const auto& [_, job] : pending_compiles) {
+        if (job->is_done) {
+            instance.GetDevice().destroyShaderModule(job->module);
+        }
+    }
+    pending_compiles.clear();
+}
+
 std::optional<vk::ShaderModule> PipelineCache::ReplaceShader(vk::ShaderModule module,
                                                              std::span<const u32> spv_code) {
     std::optional<vk::ShaderModule> new_module{};
@@ -3,8 +3,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <variant>
 #include <tsl/robin_map.h>
+#include "common/polyfill_thread.h"
 #include "shader_recompiler/profile.h"
 #include "shader_recompiler/recompiler.h"
 #include "shader_recompiler/specialization.h"
@@ -72,9 +78,16 @@ public:
     void WarmUp();
     void Sync();
 
-    bool LoadComputePipeline(Serialization::Archive& ar);
-    bool LoadGraphicsPipeline(Serialization::Archive& ar);
-    bool LoadPipelineStage(Serialization::Archive& ar, size_t stage);
+    /// Returns true while cached pipelines are still being loaded in the background.
+    [[nodiscard]] bool IsWarmingUp() const {
+        return warm_up != nullptr;
+    }
+
+    /// Returns the number of processed and total cached pipelines of the ongoing warm-up.
+    [[nodiscard]] std::pair<u32, u32> GetWarmUpProgress() const;
+
+    /// Stops the warm-up workers, discarding the pipelines which were not integrated yet.
+    void CancelWarmUp();
 
     const GraphicsPipeline* GetGraphicsPipeline();
 
@@ -96,6 +109,64 @@ public:
     }
 
 private:
+    struct PreloadedStage {
+        const Shader::Info* info{};
+        vk::ShaderModule module{};
+        std::optional<Shader::Gcn::FetchShaderData> fetch_shader{};
+    };
+
+    struct WarmUpState {
+        std::vector<std::vector<u8>> blobs;
+        std::atomic<u32> next_blob{};
+        std::atomic<u32> num_processed{};
+        std::atomic<u32> num_loaded{};
+        std::atomic<u32> num_active_workers{};
+        std::atomic<bool> is_done{};
+
+        // Stages are shared between pipelines, the first worker to request one loads it while
+        // the others wait on its future.
+        std::mutex stage_mutex;
+        tsl::robin_map<u64, std::shared_future<PreloadedStage>> stages;
+        tsl::robin_map<size_t, std::unique_ptr<Program>> programs;
+
+        std::mutex pipeline_mutex;
+        std::vector<std::pair<GraphicsPipelineKey, std::unique_ptr<GraphicsPipeline>>>
+            graphics_pipelines;
+        std::vector<std::pair<ComputePipelineKey, std::unique_ptr<ComputePipeline>>>
+            compute_pipelines;
+
+        std::vector<std::jthread> workers;
+    };
+
+    /// Translation of a shader permutation running on a compile worker. The job owns copies of
+    /// the guest code and user data, so the command processor can move on while it's in flight.
+    struct ShaderCompileJob {
+        Shader::Info info;
+        Shader::RuntimeInfo runtime_info;
+        Shader::Backend::Bindings binding;
+        std::array<u32, Shader::ShaderParams::NumShaderUserData> user_data;
+        std::vector<u32> code;
+        size_t perm_idx;
+        vk::ShaderModule module{};
+        std::atomic<bool> is_done{};
+    };
+
+    [[nodiscard]] bool IsAsyncCompile(Shader::LogicalStage l_stage) const;
+    std::shared_ptr<ShaderCompileJob> CompileShaderAsync(Shader::Stage stage,
+                                                         Shader::LogicalStage l_stage,
+                                                         const Shader::ShaderParams& params,
+                                                         const Shader::RuntimeInfo& runtime_info,
+                                                         const Shader::Backend::Bindings& binding,
+                                                         size_t perm_idx);
+    void ShaderCompileWorker(const std::stop_token& stoken);
+    void StopShaderCompileWorkers();
+
+    void WarmUpWorker(const std::stop_token& stoken, WarmUpState& state);
+    void FinishWarmUp();
+    bool LoadComputePipeline(Serialization::Archive& ar, WarmUpState& state);
+    bool LoadGraphicsPipeline(Serialization::Archive& ar, WarmUpState& state);
+    PreloadedStage LoadPipelineStage(u64 perm_hash, WarmUpState& state);
+
     bool RefreshGraphicsKey();
     bool RefreshGraphicsStages();
     bool RefreshComputeKey();
@@ -106,7 +177,7 @@ private:
                                                    std::string_view ext);
     vk::ShaderModule CompileModule(Shader::Info& info, Shader::RuntimeInfo& runtime_info,
                                    const std::span<const u32>& code, size_t perm_idx,
-                                   Shader::Backend::Bindings& binding);
+                                   Shader::Backend::Bindings& binding, Shader::Pools& pools);
     const Shader::RuntimeInfo& BuildRuntimeInfo(Shader::Stage stage, Shader::LogicalStage l_stage);
 
     [[nodiscard]] bool IsPipelineCacheDirty() const {
@@ -132,6 +203,17 @@ private:
     GraphicsPipelineKey graphics_key{};
     ComputePipelineKey compute_key{};
     u32 num_new_pipelines{}; // new pipelines added to the cache since the game start
+    std::unique_ptr<WarmUpState> warm_up;
+    // Preloaded programs superseded by ones compiled while the warm-up was still in progress.
+    // They are kept alive as the preloaded pipelines still reference their info.
+    std::vector<std::unique_ptr<Program>> retired_programs;
+
+    // Asynchronous shader compilation, each worker translates with its own pools
+    std::mutex compile_mutex;
+    std::condition_variable_any compile_cv;
+    std::deque<std::shared_ptr<ShaderCompileJob>> compile_queue;
+    tsl::robin_map<u64, std::shared_ptr<ShaderCompileJob>> pending_compiles;
+    std::vector<std::jthread> compile_workers;
 
     // Only if Config::collectShadersForDebug()
     tsl::robin_map<vk::ShaderModule,
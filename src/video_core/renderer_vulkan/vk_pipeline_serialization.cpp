@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2025-2026 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "common/boot_timeline.h"
 #include "common/serdes.h"
+#include "common/thread.h"
 #include "core/emulator_settings.h"
 #include "shader_recompiler/frontend/fetch_shader.h"
 #include "shader_recompiler/info.h"
@@ -140,35 +142,24 @@ bool ComputePipeline::SerializationSupport::Deserialize(Serialization::Archive&
     return true;
 }
 
-bool PipelineCache::LoadComputePipeline(Serialization::Archive& ar) {
-    compute_key.Deserialize(ar);
+bool PipelineCache::LoadComputePipeline(Serialization::Archive& ar, WarmUpState& state) {
+    ComputePipelineKey key{};
+    key.Deserialize(ar);
 
     ComputePipeline::SerializationSupport sdata{};
     sdata.Deserialize(ar);
 
-    std::vector<u8> meta_blob;
-    Storage::DataBase::Instance().Load(Storage::BlobType::ShaderMeta,
-                                       fmt::format("{:#018x}", compute_key.value), meta_blob);
-    if (meta_blob.empty()) {
+    const auto stage = LoadPipelineStage(key.value, state);
+    if (!stage.info) {
         return false;
     }
 
-    Serialization::Archive meta_ar{std::move(meta_blob)};
-
-    if (!LoadPipelineStage(meta_ar, 0)) {
-        return false;
-    }
-
-    const auto [it, is_new] = compute_pipelines.try_emplace(compute_key);
-    ASSERT(is_new);
-
-    it.value() =
+    auto pipeline =
         std::make_unique<ComputePipeline>(instance, scheduler, desc_heap, profile, *pipeline_cache,
-                                          compute_key, *infos[0], modules[0], sdata, true);
-
-    infos.fill(nullptr);
-    modules.fill(nullptr);
+                                          key, *stage.info, stage.module, sdata, true);
 
+    std::scoped_lock lk{state.pipeline_mutex};
+    state.compute_pipelines.emplace_back(key, std::move(pipeline));
     return true;
 }
 
@@ -208,90 +199,120 @@ bool GraphicsPipeline::SerializationSupport::Deserialize(Serialization::Archive&
     return true;
 }
 
-bool PipelineCache::LoadGraphicsPipeline(Serialization::Archive& ar) {
-    graphics_key.Deserialize(ar);
+bool PipelineCache::LoadGraphicsPipeline(Serialization::Archive& ar, WarmUpState& state) {
+    GraphicsPipelineKey key{};
+    key.Deserialize(ar);
 
     GraphicsPipeline::SerializationSupport sdata{};
     sdata.Deserialize(ar);
 
+    std::array<const Shader::Info*, MaxShaderStages> stage_infos{};
+    std::array<vk::ShaderModule, MaxShaderStages> stage_modules{};
+    std::optional<Shader::Gcn::FetchShaderData> stage_fetch_shader{};
     for (int stage_idx = 0; stage_idx < MaxShaderStages; ++stage_idx) {
-        const auto& hash = graphics_key.stage_hashes[stage_idx];
+        const auto& hash = key.stage_hashes[stage_idx];
         if (!hash) {
             continue;
         }
 
-        std::vector<u8> meta_blob;
-        Storage::DataBase::Instance().Load(Storage::BlobType::ShaderMeta,
-                                           fmt::format("{:#018x}", hash), meta_blob);
-        if (meta_blob.empty()) {
+        const auto stage = LoadPipelineStage(hash, state);
+        if (!stage.info) {
             return false;
         }
 
-        Serialization::Archive meta_ar{std::move(meta_blob)};
-
-        if (!LoadPipelineStage(meta_ar, stage_idx)) {
-            return false;
+        stage_infos[stage_idx] = stage.info;
+        stage_modules[stage_idx] = stage.module;
+        if (stage.fetch_shader) {
+            stage_fetch_shader = stage.fetch_shader;
         }
     }
 
-    const auto [it, is_new] = graphics_pipelines.try_emplace(graphics_key);
-    ASSERT(is_new);
-
-    it.value() = std::make_unique<GraphicsPipeline>(
-        instance, scheduler, desc_heap, profile, graphics_key, *pipeline_cache, infos,
-        runtime_infos, fetch_shader, modules, sdata, true);
-
-    infos.fill(nullptr);
-    modules.fill(nullptr);
-    fetch_shader.reset();
+    // Runtime info is not accessed by pipelines created in preloading mode
+    static const std::array<Shader::RuntimeInfo, MaxShaderStages> stage_runtime_infos{};
+    auto pipeline = std::make_unique<GraphicsPipeline>(
+        instance, scheduler, desc_heap, profile, key, *pipeline_cache, stage_infos,
+        stage_runtime_infos, stage_fetch_shader, stage_modules, sdata, true);
 
+    std::scoped_lock lk{state.pipeline_mutex};
+    state.graphics_pipelines.emplace_back(key, std::move(pipeline));
     return true;
 }
 
-bool PipelineCache::LoadPipelineStage(Serialization::Archive& ar, size_t stage) {
-    auto program = std::make_unique<Program>();
-    Shader::StageSpecialization spec{};
-    spec.info = &program->info;
-    size_t perm_idx{};
-    if (!LoadShaderMeta(ar, program->info, fetch_shader, spec, perm_idx)) {
-        return false;
+PipelineCache::PreloadedStage PipelineCache::LoadPipelineStage(u64 perm_hash,
+                                                               WarmUpState& state) {
+    std::promise<PreloadedStage> promise{};
+    {
+        std::unique_lock lk{state.stage_mutex};
+        const auto [it, is_new] = state.stages.try_emplace(perm_hash);
+        if (!is_new) {
+            const auto future = it->second;
+            lk.unlock();
+            return future.get();
+        }
+        it.value() = promise.get_future().share();
     }
 
-    std::vector<u32> spv{};
-    Storage::DataBase::Instance().Load(Storage::BlobType::ShaderBinary,
-                                       fmt::format("{:#018x}_{}", program->info.pgm_hash, perm_idx),
-                                       spv);
-    if (spv.empty()) {
-        return false;
-    }
+    const auto load_stage = [&]() -> PreloadedStage {
+        std::vector<u8> scratch;
+        const auto meta_blob = Storage::DataBase::Instance().LoadView(
+            Storage::BlobType::ShaderMeta, fmt::format("{:#018x}", perm_hash), scratch);
+        if (meta_blob.empty()) {
+            return {};
+        }
 
-    // Permutation hash depends on shader variation index. To prevent collisions, we need insert it
-    // at the exact position rather than append
+        Serialization::Archive meta_ar{std::vector<u8>{meta_blob.begin(), meta_blob.end()}};
 
-    vk::ShaderModule module{};
+        PreloadedStage stage{};
+        auto program = std::make_unique<Program>();
+        Shader::StageSpecialization spec{};
+        size_t perm_idx{};
+        if (!LoadShaderMeta(meta_ar, program->info, stage.fetch_shader, spec, perm_idx)) {
+            return {};
+        }
 
-    auto [it_pgm, new_program] = program_cache.try_emplace(program->info.pgm_hash);
-    if (new_program) {
-        module = CompileSPV(spv, instance.GetDevice());
-        it_pgm.value() = std::move(program);
-    } else {
-        const auto& it = std::ranges::find(it_pgm.value()->modules, spec, &Program::Module::spec);
-        if (it != it_pgm.value()->modules.end()) {
-            // If the permutation is already preloaded, make sure it has the same permutation index
-            const auto idx = std::distance(it_pgm.value()->modules.begin(), it);
-            ASSERT_MSG(perm_idx == idx, "Permutation {} is already inserted at {}! ({}_{:x})",
-                       perm_idx, idx, program->info.stage, program->info.pgm_hash);
-            module = it->module;
-        } else {
-            module = CompileSPV(spv, instance.GetDevice());
+        // SPIR-V is compiled straight from the cache storage, which keeps it 4-byte aligned
+        const auto spv = Storage::DataBase::Instance().LoadView(
+            Storage::BlobType::ShaderBinary,
+            fmt::format("{:#018x}_{}", program->info.pgm_hash, perm_idx), scratch);
+        if (spv.empty()) {
+            return {};
         }
-    }
-    it_pgm.value()->InsertPermut(module, std::move(spec), perm_idx);
 
-    infos[stage] = &it_pgm.value()->info;
-    modules[stage] = module;
+        stage.module = CompileSPV(
+            {reinterpret_cast<const u32*>(spv.data()), spv.size() / sizeof(u32)},
+            instance.GetDevice());
 
-    return true;
+        // Permutation hash depends on shader variation index. To prevent collisions, we need
+        // insert it at the exact position rather than append
+        std::scoped_lock lk{state.stage_mutex};
+        auto [it_pgm, new_program] = state.programs.try_emplace(program->info.pgm_hash);
+        if (new_program) {
+            it_pgm.value() = std::move(program);
+        }
+        spec.info = &it_pgm.value()->info;
+        if (!new_program) {
+            const auto& modules = it_pgm.value()->modules;
+            const auto it = std::ranges::find(modules, spec, &Program::Module::spec);
+            if (it != modules.end()) {
+                // If the permutation is already preloaded, make sure it has the same permutation
+                // index
+                const auto idx = std::distance(modules.begin(), it);
+                ASSERT_MSG(perm_idx == idx, "Permutation {} is already inserted at {}! ({}_{:x})",
+                           perm_idx, idx, it_pgm.value()->info.stage,
+                           it_pgm.value()->info.pgm_hash);
+                instance.GetDevice().destroyShaderModule(stage.module);
+                stage.module = it->module;
+            }
+        }
+        it_pgm.value()->InsertPermut(stage.module, std::move(spec), perm_idx);
+
+        stage.info = &it_pgm.value()->info;
+        return stage;
+    };
+
+    auto stage = load_stage();
+    promise.set_value(stage);
+    return stage;
 }
 
 void PipelineCache::WarmUp() {
@@ -299,14 +320,13 @@ void PipelineCache::WarmUp() {
         return;
     }
 
+    const Common::BootTimeline::Scope phase{"Pipeline cache warm-up"};
     Storage::DataBase::Instance().Open();
 
     // Check if cache is compatible
     std::vector<u8> profile_data{};
     Storage::DataBase::Instance().Load(Storage::BlobType::ShaderProfile, "profile", profile_data);
     if (profile_data.empty()) {
-        Storage::DataBase::Instance().FinishPreload();
-
         profile_data.resize(sizeof(profile));
         std::memcpy(profile_data.data(), &profile, sizeof(profile));
         Storage::DataBase::Instance().Save(Storage::BlobType::ShaderProfile, "profile",
@@ -319,47 +339,132 @@ void PipelineCache::WarmUp() {
         return;
     }
 
-    u32 num_pipelines{};
-    u32 num_total_pipelines{};
-
+    warm_up = std::make_unique<WarmUpState>();
     Storage::DataBase::Instance().ForEachBlob(
-        Storage::BlobType::PipelineKey, [&](std::vector<u8>&& data) {
-            ++num_total_pipelines;
+        Storage::BlobType::PipelineKey,
+        [&](std::span<const u8> data) { warm_up->blobs.emplace_back(data.begin(), data.end()); });
+
+    const u32 num_workers = std::clamp<u32>(std::thread::hardware_concurrency(), 1u, 16u);
+    LOG_INFO(Render, "Preloading {} pipelines using {} workers", warm_up->blobs.size(),
+             num_workers);
+
+    warm_up->num_active_workers = num_workers;
+    warm_up->workers.reserve(num_workers);
+    for (u32 i = 0; i < num_workers; ++i) {
+        warm_up->workers.emplace_back(
+            [this, &state = *warm_up](const std::stop_token& stoken) {
+                WarmUpWorker(stoken, state);
+            });
+    }
 
-            Serialization::Archive ar{std::move(data)};
-            Serialization::Reader pldata{ar};
+    if (EmulatorSettings.IsPipelineCacheBackgroundLoad()) {
+        // Loaded pipelines will be picked up by the first pipeline request after completion
+        return;
+    }
 
-            u32 version{};
-            pldata.Read(version);
-            if (version != Serialization::PipelineKeyVersion) {
-                return;
-            }
+    for (auto& worker : warm_up->workers) {
+        worker.join();
+    }
+    FinishWarmUp();
+}
+
+void PipelineCache::WarmUpWorker(const std::stop_token& stoken, WarmUpState& state) {
+    Common::SetCurrentThreadName("shadPS4:PipelinePreload");
+    const Common::BootTimeline::Scope phase{"Preload pipelines"};
 
+    const u32 num_blobs = static_cast<u32>(state.blobs.size());
+    const u32 report_step = std::max(num_blobs / 10, 1u);
+    while (!stoken.stop_requested()) {
+        const u32 blob_idx = state.next_blob.fetch_add(1, std::memory_order_relaxed);
+        if (blob_idx >= num_blobs) {
+            break;
+        }
+
+        Serialization::Archive ar{std::move(state.blobs[blob_idx])};
+        Serialization::Reader pldata{ar};
+
+        bool result{};
+        u32 version{};
+        pldata.Read(version);
+        if (version == Serialization::PipelineKeyVersion) {
             u32 is_compute{};
             pldata.Read(is_compute);
 
-            bool result{};
             if (is_compute) {
-                result = LoadComputePipeline(ar);
+                result = LoadComputePipeline(ar, state);
             } else {
-                result = LoadGraphicsPipeline(ar);
+                result = LoadGraphicsPipeline(ar, state);
             }
+        }
 
-            if (result) {
-                ++num_pipelines;
-            }
-        });
+        if (result) {
+            state.num_loaded.fetch_add(1, std::memory_order_relaxed);
+        }
+        const u32 num_processed = state.num_processed.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (num_processed % report_step == 0) {
+            LOG_INFO(Render, "Preloading pipelines: {}/{}", num_processed, num_blobs);
+        }
+    }
+
+    if (state.num_active_workers.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+        !stoken.stop_requested()) {
+        state.is_done.store(true, std::memory_order_release);
+    }
+}
+
+void PipelineCache::FinishWarmUp() {
+    auto state = std::move(warm_up);
+    state->workers.clear();
 
+    for (auto& [pgm_hash, program] : state->programs) {
+        const auto [it, is_new] = program_cache.try_emplace(pgm_hash);
+        if (is_new) {
+            it.value() = std::move(program);
+        } else {
+            retired_programs.emplace_back(std::move(program));
+        }
+    }
+    for (auto& [key, pipeline] : state->compute_pipelines) {
+        compute_pipelines.try_emplace(key, std::move(pipeline));
+    }
+    for (auto& [key, pipeline] : state->graphics_pipelines) {
+        graphics_pipelines.try_emplace(key, std::move(pipeline));
+    }
+
+    const u32 num_pipelines = state->num_loaded;
+    const u32 num_total_pipelines = static_cast<u32>(state->blobs.size());
     LOG_INFO(Render, "Preloaded {} pipelines", num_pipelines);
     if (num_total_pipelines > num_pipelines) {
         LOG_WARNING(Render, "{} stale pipelines were found. Consider re-generating the cache",
                     num_total_pipelines - num_pipelines);
     }
+}
+
+std::pair<u32, u32> PipelineCache::GetWarmUpProgress() const {
+    if (!warm_up) {
+        return {0, 0};
+    }
+    return {warm_up->num_processed.load(std::memory_order_relaxed),
+            static_cast<u32>(warm_up->blobs.size())};
+}
+
+void PipelineCache::CancelWarmUp() {
+    if (!warm_up) {
+        return;
+    }
+
+    for (auto& worker : warm_up->workers) {
+        worker.request_stop();
+    }
+    warm_up->workers.clear();
 
-    Storage::DataBase::Instance().FinishPreload();
+    LOG_INFO(Render, "Pipeline preload cancelled after {}/{} pipelines",
+             warm_up->num_processed.load(), warm_up->blobs.size());
+    warm_up.reset();
 }
 
 void PipelineCache::Sync() {
+    CancelWarmUp();
     Storage::DataBase::Instance().Close();
 }
 
@@ -377,6 +377,7 @@ void Rasterizer::OnSubmit() {
     texture_cache.ProcessDownloadImages();
     texture_cache.RunGarbageCollector();
     buffer_cache.RunGarbageCollector();
+    page_manager.EndFrame();
 }
 
 bool Rasterizer::BindResources(const Pipeline* pipeline) {
@@ -1043,6 +1044,10 @@ bool Rasterizer::InvalidateMemory(VAddr addr, u64 size) {
     return true;
 }
 
+void Rasterizer::FlushGuestWrites() {
+    page_manager.FlushGuestWrites();
+}
+
 bool Rasterizer::ReadMemory(VAddr addr, u64 size) {
     if (!IsMapped(addr, size)) {
         // Not GPU mapped memory, can skip invalidation logic entirely.
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include "common/logging/deferred_log.h"
+#include "common/logging/log.h"
+
+using namespace Common::Log;
+
+namespace {
+
+constexpr LogSite TestSite = {
+    .class_index = Class::ClassIndex(Class::Log),
+    .file = __FILE__,
+    .line = __LINE__,
+    .function = "Test",
+    .format = "{}",
+};
+
+class CaptureSink final : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::vector<std::string> messages;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        messages.emplace_back(msg.payload.data(), msg.payload.size());
+    }
+
+    void flush_() override {}
+};
+
+class DeferredLog : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto& logger = ALL_LOGGERS[TestSite.class_index];
+        saved_logger = logger;
+        logger = std::make_shared<spdlog::logger>("deferred_test", sink);
+    }
+
+    void TearDown() override {
+        Deferred::Drain();
+        ALL_LOGGERS[TestSite.class_index] = saved_logger;
+    }
+
+    void ExpectMessages(const std::vector<std::string>& expected) {
+        ASSERT_EQ(sink->messages.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_TRUE(sink->messages[i].ends_with(": " + expected[i]))
+                << sink->messages[i] << " should end with " << expected[i];
+        }
+        sink->messages.clear();
+    }
+
+    std::shared_ptr<CaptureSink> sink = std::make_shared<CaptureSink>();
+    std::shared_ptr<spdlog::logger> saved_logger;
+};
+
+} // Anonymous namespace
+
+TEST_F(DeferredLog, DecodesRecordsInOrder) {
+    Deferred::PushRecord(TestSite, spdlog::level::info, std::string{"first"});
+    Deferred::PushRecord(TestSite, spdlog::level::info, 42);
+    Deferred::PushText(TestSite, spdlog::level::info, "third");
+    Deferred::Drain();
+    ExpectMessages({"first", "42", "third"});
+}
+
+TEST_F(DeferredLog, WrapsAroundTheBuffer) {
+    // Records of varying size end at varying offsets, so wrapping the buffer many times ends
+    // both in tails that take a padding header and in tails too short to hold one.
+    std::mt19937 rng{7};
+    size_t written = 0;
+    std::vector<std::string> expected;
+    while (written < 32_MB) {
+        for (u32 i = 0; i < 64; i++) {
+            std::string text(rng() % 256, 'a' + static_cast<char>(expected.size() % 26));
+            text += std::to_string(expected.size());
+            written += text.size();
+            Deferred::PushRecord(TestSite, spdlog::level::info, text);
+            expected.push_back(std::move(text));
+        }
+        Deferred::Drain();
+        ExpectMessages(expected);
+        expected.clear();
+    }
+}
+
+TEST_F(DeferredLog, DropsRecordsWhenFull) {
+    const std::string text(1000, 'x');
+    u32 num_pushed = 0;
+    for (; num_pushed < 2048; num_pushed++) {
+        Deferred::PushRecord(TestSite, spdlog::level::info, text);
+    }
+    Deferred::Drain();
+    ASSERT_FALSE(sink->messages.empty());
+    const std::string& report = sink->messages.back();
+    const size_t num_delivered = sink->messages.size() - 1;
+    EXPECT_LT(num_delivered, num_pushed);
+    EXPECT_TRUE(report.ends_with(
+        fmt::format("Dropped {} records, the buffer of this thread was full",
+                    num_pushed - num_delivered)))
+        << report;
+    sink->messages.clear();
+
+    // The buffer is usable again once drained
+    Deferred::PushRecord(TestSite, spdlog::level::info, std::string{"after"});
+    Deferred::Drain();
+    ExpectMessages({"after"});
+}
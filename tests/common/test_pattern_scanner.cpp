@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/pattern_scanner.h"
+#include "common/types.h"
+
+using namespace Common;
+
+namespace {
+
+/// A signature with its parsed form, where -1 stands for a wildcard.
+struct Signature {
+    std::string text;
+    std::vector<int> bytes;
+};
+
+std::vector<u8> RandomImage(size_t size, u32 seed) {
+    // Skew towards zero bytes, like the padding and immediates of real executables
+    std::mt19937 rng{seed};
+    std::vector<u8> image(size);
+    std::ranges::generate(image, [&] { return rng() % 4 == 0 ? u8{0} : static_cast<u8>(rng()); });
+    return image;
+}
+
+/// Builds a signature from the image bytes at offset. Some bytes become wildcards and some are
+/// changed, so not every signature has a match.
+Signature MakeSignature(std::span<const u8> image, size_t offset, size_t length,
+                        std::mt19937& rng) {
+    Signature signature;
+    for (size_t i = 0; i < length; ++i) {
+        const bool wildcard = rng() % 5 == 0;
+        int value = image[offset + i];
+        if (!wildcard && rng() % 16 == 0) {
+            value = static_cast<int>(rng() % 256);
+        }
+        char token[4];
+        std::snprintf(token, sizeof(token), wildcard ? "??" : "%02X", value);
+        signature.text += (i == 0 ? "" : " ") + std::string(token);
+        signature.bytes.push_back(wildcard ? -1 : value);
+    }
+    return signature;
+}
+
+size_t ScanReference(const Signature& signature, std::span<const u8> image) {
+    const auto& bytes = signature.bytes;
+    for (size_t i = 0; i + bytes.size() <= image.size(); ++i) {
+        bool found = true;
+        for (size_t j = 0; j < bytes.size() && found; ++j) {
+            found = bytes[j] < 0 || image[i + j] == bytes[j];
+        }
+        if (found) {
+            return i;
+        }
+    }
+    return PatternScanner::NotFound;
+}
+
+} // Anonymous namespace
+
+TEST(PatternScanner, ParsesSignatures) {
+    PatternScanner scanner;
+    EXPECT_EQ(scanner.AddPattern("48 8B ?? ? e8"), 0U);
+    EXPECT_EQ(scanner.PatternSize(0), 5U);
+    EXPECT_EQ(scanner.AddPattern("  90  "), 1U);
+    EXPECT_FALSE(scanner.AddPattern(""));
+    EXPECT_FALSE(scanner.AddPattern("   "));
+    EXPECT_FALSE(scanner.AddPattern("488B"));
+    EXPECT_FALSE(scanner.AddPattern("48 G1"));
+    EXPECT_FALSE(scanner.AddPattern("48 ???"));
+    EXPECT_EQ(scanner.NumPatterns(), 2U);
+}
+
+TEST(PatternScanner, FindsFirstMatch) {
+    const std::vector<u8> image = {0x00, 0x48, 0x8B, 0x05, 0x48, 0x8B, 0x0D, 0xE8, 0x48, 0x8B};
+    PatternScanner scanner;
+    scanner.AddPattern("48 8B");
+    scanner.AddPattern("48 8B 0D");
+    scanner.AddPattern("48 ?? ?? E8");
+    scanner.AddPattern("E8 48 8B 00");
+    scanner.AddPattern("8B");
+    const auto results = scanner.Scan(image);
+    EXPECT_EQ(results[0], 1U);
+    EXPECT_EQ(results[1], 4U);
+    EXPECT_EQ(results[2], 4U);
+    EXPECT_EQ(results[3], PatternScanner::NotFound);
+    EXPECT_EQ(results[4], 2U);
+}
+
+TEST(PatternScanner, MatchesAtImageEdges) {
+    const std::vector<u8> image = {0xAA, 0x01, 0x02, 0x03, 0xBB};
+    PatternScanner scanner;
+    scanner.AddPattern("AA 01");
+    scanner.AddPattern("03 BB");
+    scanner.AddPattern("BB");
+    scanner.AddPattern("03 BB ??");
+    scanner.AddPattern("?? ??");
+    const auto results = scanner.Scan(image);
+    EXPECT_EQ(results[0], 0U);
+    EXPECT_EQ(results[1], 3U);
+    EXPECT_EQ(results[2], 4U);
+    EXPECT_EQ(results[3], PatternScanner::NotFound);
+    EXPECT_EQ(results[4], 0U);
+    EXPECT_TRUE(scanner.MatchesAt(1, image, 3));
+    EXPECT_FALSE(scanner.MatchesAt(1, image, 4));
+    EXPECT_FALSE(scanner.MatchesAt(3, image, 3));
+}
+
+TEST(PatternScanner, MatchesReference) {
+    // Covers the vector prefilter with few patterns and the plain filter with many. The image
+    // still spans several 1 MB thread chunks.
+    const auto image = RandomImage(2_MB + 17, 1);
+    std::mt19937 rng{2};
+    for (const u32 num_patterns : {1U, 8U, 64U, 200U}) {
+        PatternScanner scanner;
+        std::vector<Signature> signatures;
+        std::vector<size_t> expected;
+        for (u32 i = 0; i < num_patterns; ++i) {
+            const size_t length = 1 + rng() % 24;
+            const size_t offset = rng() % (image.size() - length);
+            signatures.push_back(MakeSignature(image, offset, length, rng));
+            expected.push_back(ScanReference(signatures.back(), image));
+            ASSERT_TRUE(scanner.AddPattern(signatures.back().text));
+        }
+        for (const u32 num_threads : {1U, 4U}) {
+            const auto results = scanner.Scan(image, num_threads);
+            for (u32 i = 0; i < num_patterns; ++i) {
+                EXPECT_EQ(results[i], expected[i])
+                    << signatures[i].text << " with " << num_threads << " threads";
+            }
+        }
+    }
+}
+
+TEST(PatternScanner, MatchesAcrossChunkBoundaries) {
+    // Place matches so they straddle the boundaries between thread chunks
+    auto image = RandomImage(4_MB, 3);
+    const std::vector<u8> needle = {0xDE, 0xAD, 0xBE, 0xEF, 0x13, 0x37};
+    std::ranges::replace(image, u8{0xDE}, u8{0xDF});
+    std::ranges::copy(needle, image.begin() + 2_MB - 3);
+    std::ranges::copy(needle, image.begin() + 3_MB - 1);
+    PatternScanner scanner;
+    scanner.AddPattern("DE AD BE EF 13 37");
+    scanner.AddPattern("?? ?? DE ?? BE");
+    EXPECT_EQ(scanner.Scan(image, 4)[0], 2_MB - 3);
+    EXPECT_EQ(scanner.Scan(image, 4)[1], 2_MB - 5);
+    std::ranges::copy(std::vector<u8>(needle.size(), 0), image.begin() + 2_MB - 3);
+    EXPECT_EQ(scanner.Scan(image, 4)[0], 3_MB - 1);
+}
+
+// Compares a batched scan against scanning every pattern on its own. Run with
+// --gtest_also_run_disabled_tests
+TEST(PatternScannerBenchmark, DISABLED_Scan) {
+    const auto image = RandomImage(64_MB, 4);
+    std::mt19937 rng{5};
+    for (const u32 num_patterns : {1U, 16U, 256U}) {
+        PatternScanner scanner;
+        std::vector<PatternScanner> single(num_patterns);
+        for (u32 i = 0; i < num_patterns; ++i) {
+            const size_t length = 12 + rng() % 20;
+            const size_t offset = rng() % (image.size() - length);
+            const auto signature = MakeSignature(image, offset, length, rng);
+            scanner.AddPattern(signature.text);
+            single[i].AddPattern(signature.text);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& pattern : single) {
+            pattern.Scan(image, 1);
+        }
+        const std::chrono::duration<double, std::milli> separate =
+            std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        scanner.Scan(image, 1);
+        const std::chrono::duration<double, std::milli> batched =
+            std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        scanner.Scan(image);
+        const std::chrono::duration<double, std::milli> parallel =
+            std::chrono::steady_clock::now() - start;
+        std::printf("%3u patterns: %8.1f ms separate, %6.1f ms batched, %6.1f ms parallel\n",
+                    num_patterns, separate.count(), batched.count(), parallel.count());
+    }
+}
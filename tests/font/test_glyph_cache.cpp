@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/libraries/font/glyph_cache.h"
+
+using namespace Libraries::Font::Internal;
+
+namespace {
+
+int library_a;
+int library_b;
+int face_a;
+int face_b;
+
+GlyphCacheKey MakeKey(const void* face, u32 glyph_index, s64 size = 20 * 64,
+                      const void* library = &library_a) {
+    return {
+        .library = library,
+        .face = face,
+        .glyph_index = glyph_index,
+        .load_flags = 0,
+        .face_scale = false,
+        .size_x = size,
+        .size_y = size,
+        .delta_x = 0,
+        .delta_y = 0,
+        .shift_x = 0,
+        .shift_y = 0,
+    };
+}
+
+RasterizedGlyph MakeGlyph(s32 width, s32 rows, u8 fill) {
+    RasterizedGlyph glyph{};
+    glyph.metrics.width = width;
+    glyph.metrics.rows = rows;
+    glyph.metrics.left = 1;
+    glyph.metrics.top = rows;
+    glyph.metrics.hori_advance = (width + 2) * 64;
+    glyph.bitmap.assign(static_cast<size_t>(width) * rows, fill);
+    return glyph;
+}
+
+bool Contains(GlyphCache& cache, const GlyphCacheKey& key) {
+    RasterizedGlyph out;
+    return cache.Lookup(key, out);
+}
+
+} // Anonymous namespace
+
+TEST(GlyphCache, ReturnsInsertedGlyph) {
+    GlyphCache cache;
+    RasterizedGlyph out;
+    EXPECT_FALSE(cache.Lookup(MakeKey(&face_a, 7), out));
+
+    cache.Insert(MakeKey(&face_a, 7), MakeGlyph(9, 12, 0xAB));
+    ASSERT_TRUE(cache.Lookup(MakeKey(&face_a, 7), out));
+    EXPECT_EQ(out.metrics.width, 9);
+    EXPECT_EQ(out.metrics.rows, 12);
+    EXPECT_EQ(out.metrics.hori_advance, 11 * 64);
+    EXPECT_EQ(out.bitmap, std::vector<u8>(9 * 12, 0xAB));
+
+    // Anything that changes the rendering is part of the key
+    EXPECT_FALSE(Contains(cache, MakeKey(&face_b, 7)));
+    EXPECT_FALSE(Contains(cache, MakeKey(&face_a, 7, 21 * 64)));
+    auto shifted = MakeKey(&face_a, 7);
+    shifted.delta_x = 32;
+    EXPECT_FALSE(Contains(cache, shifted));
+
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 4U);
+    EXPECT_EQ(stats.num_glyphs, 1U);
+    EXPECT_EQ(stats.used_bytes, 128U);
+}
+
+TEST(GlyphCache, CachesEmptyGlyphs) {
+    GlyphCache cache;
+    cache.Insert(MakeKey(&face_a, 3), MakeGlyph(0, 0, 0));
+    RasterizedGlyph out = MakeGlyph(4, 4, 1);
+    ASSERT_TRUE(cache.Lookup(MakeKey(&face_a, 3), out));
+    EXPECT_TRUE(out.bitmap.empty());
+    EXPECT_EQ(cache.GetStats().used_bytes, 0U);
+}
+
+TEST(GlyphCache, EvictsLeastRecentlyUsed) {
+    // One slab holds four 16 KiB blocks
+    GlyphCache cache{GlyphCache::SlabSize};
+    for (u32 i = 0; i < 4; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(128, 128, static_cast<u8>(i)));
+    }
+    EXPECT_TRUE(Contains(cache, MakeKey(&face_a, 0)));
+    cache.Insert(MakeKey(&face_a, 4), MakeGlyph(128, 128, 4));
+
+    EXPECT_TRUE(Contains(cache, MakeKey(&face_a, 0)));
+    EXPECT_FALSE(Contains(cache, MakeKey(&face_a, 1)));
+    EXPECT_TRUE(Contains(cache, MakeKey(&face_a, 2)));
+    EXPECT_TRUE(Contains(cache, MakeKey(&face_a, 3)));
+    RasterizedGlyph out;
+    ASSERT_TRUE(cache.Lookup(MakeKey(&face_a, 4), out));
+    EXPECT_EQ(out.bitmap, std::vector<u8>(128 * 128, 4));
+    EXPECT_EQ(cache.GetStats().evictions, 1U);
+}
+
+TEST(GlyphCache, ReusesSlabsForOtherSizes) {
+    GlyphCache cache{2 * GlyphCache::SlabSize};
+    for (u32 i = 0; i < 1024; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(8, 8, 1));
+    }
+    EXPECT_EQ(cache.GetStats().used_bytes, GlyphCache::SlabSize);
+
+    // The second slab is free, then the small glyphs have to make room in the first
+    cache.Insert(MakeKey(&face_b, 0), MakeGlyph(256, 256, 2));
+    cache.Insert(MakeKey(&face_b, 1), MakeGlyph(200, 200, 3));
+    EXPECT_TRUE(Contains(cache, MakeKey(&face_b, 0)));
+    EXPECT_TRUE(Contains(cache, MakeKey(&face_b, 1)));
+    EXPECT_FALSE(Contains(cache, MakeKey(&face_a, 1023)));
+
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(stats.num_glyphs, 2U);
+    EXPECT_EQ(stats.evictions, 1024U);
+    EXPECT_EQ(stats.used_bytes, 2 * GlyphCache::SlabSize);
+}
+
+TEST(GlyphCache, SkipsGlyphsLargerThanASlab) {
+    GlyphCache cache;
+    cache.Insert(MakeKey(&face_a, 1), MakeGlyph(300, 300, 1));
+    EXPECT_FALSE(Contains(cache, MakeKey(&face_a, 1)));
+    EXPECT_EQ(cache.GetStats().uncached, 1U);
+
+    GlyphCache disabled{0};
+    disabled.Insert(MakeKey(&face_a, 1), MakeGlyph(4, 4, 1));
+    EXPECT_FALSE(Contains(disabled, MakeKey(&face_a, 1)));
+}
+
+TEST(GlyphCache, ErasesGlyphsOfAFace) {
+    GlyphCache cache;
+    for (u32 i = 0; i < 8; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(10, 10, 1));
+        cache.Insert(MakeKey(&face_b, i), MakeGlyph(10, 10, 2));
+    }
+    cache.EraseFace(&face_a);
+    for (u32 i = 0; i < 8; i++) {
+        EXPECT_FALSE(Contains(cache, MakeKey(&face_a, i)));
+        EXPECT_TRUE(Contains(cache, MakeKey(&face_b, i)));
+    }
+    EXPECT_EQ(cache.GetStats().num_glyphs, 8U);
+
+    cache.Clear();
+    EXPECT_EQ(cache.GetStats().num_glyphs, 0U);
+    EXPECT_EQ(cache.GetStats().used_bytes, 0U);
+}
+
+TEST(GlyphCache, ErasesGlyphsOfALibrary) {
+    GlyphCache cache;
+    for (u32 i = 0; i < 8; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(10, 10, 1));
+        cache.Insert(MakeKey(&face_b, i, 20 * 64, &library_b), MakeGlyph(10, 10, 2));
+    }
+    cache.EraseLibrary(&library_a);
+    for (u32 i = 0; i < 8; i++) {
+        EXPECT_FALSE(Contains(cache, MakeKey(&face_a, i)));
+        EXPECT_TRUE(Contains(cache, MakeKey(&face_b, i, 20 * 64, &library_b)));
+    }
+    EXPECT_EQ(cache.GetStats().num_glyphs, 8U);
+    EXPECT_EQ(cache.GetStats().capacity, GlyphCache::DefaultCapacity);
+}
+
+TEST(GlyphCache, LimitsLibrariesToTheirCapacity) {
+    GlyphCache cache;
+    for (u32 i = 0; i < 8; i++) {
+        cache.Insert(MakeKey(&face_b, i, 20 * 64, &library_b), MakeGlyph(10, 10, 2));
+    }
+    // 10x10 glyphs take 128 byte blocks, so 32 of them fit in 4 KB
+    cache.SetLibraryCapacity(&library_a, 4_KB);
+    for (u32 i = 0; i < 40; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(10, 10, 1));
+    }
+    for (u32 i = 0; i < 40; i++) {
+        EXPECT_EQ(Contains(cache, MakeKey(&face_a, i)), i >= 8) << i;
+    }
+    for (u32 i = 0; i < 8; i++) {
+        EXPECT_TRUE(Contains(cache, MakeKey(&face_b, i, 20 * 64, &library_b))) << i;
+    }
+    EXPECT_EQ(cache.GetStats().evictions, 8U);
+    EXPECT_EQ(cache.GetStats().capacity, GlyphCache::DefaultCapacity);
+
+    // Glyphs larger than the whole budget are not cached
+    cache.Insert(MakeKey(&face_a, 100), MakeGlyph(80, 80, 1));
+    EXPECT_FALSE(Contains(cache, MakeKey(&face_a, 100)));
+    EXPECT_EQ(cache.GetStats().uncached, 1U);
+
+    // Erased glyphs give their room back to the library
+    cache.EraseFace(&face_a);
+    for (u32 i = 0; i < 32; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(10, 10, 1));
+    }
+    EXPECT_EQ(cache.GetStats().evictions, 8U);
+
+    cache.RemoveLibrary(&library_a);
+    EXPECT_EQ(cache.GetStats().num_glyphs, 8U);
+    for (u32 i = 0; i < 40; i++) {
+        cache.Insert(MakeKey(&face_a, i), MakeGlyph(10, 10, 1));
+    }
+    EXPECT_EQ(cache.GetStats().num_glyphs, 48U);
+    EXPECT_EQ(cache.GetStats().evictions, 8U);
+}
@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: Copyright 2026 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/types.h"
+#include "video_core/amdgpu/tiling_cpu.h"
+
+using namespace AmdGpu;
+
+namespace {
+
+struct GoldenOffset {
+    u32 x;
+    u32 y;
+    u32 slice;
+    u32 offset;
+};
+
+struct TilingCase {
+    TileMode tile_mode;
+    u32 num_bits;
+    u32 width;
+    u32 height;
+    u32 num_slices;
+    /// Byte offsets of a few texels, computed by evaluating tiling.comp by hand with the defines
+    /// TileManager compiles it with for this mode.
+    std::vector<GoldenOffset> golden;
+};
+
+struct Surface {
+    std::vector<TilingMip> mips;
+    TilingParams params;
+    size_t linear_size;
+    size_t tiled_size;
+};
+
+Surface MakeSurface(const TilingCase& test_case, u32 num_levels = 1) {
+    Surface surface{};
+    u32 offset = 0;
+    for (u32 level = 0; level < num_levels; ++level) {
+        const u32 pitch = std::max(test_case.width >> level, 8U);
+        const u32 height = std::max(test_case.height >> level, 8U);
+        const u32 size = pitch * height * test_case.num_slices * test_case.num_bits / 8;
+        surface.mips.push_back({size, pitch, height, offset});
+        offset += size;
+    }
+    surface.params = {
+        .tile_mode = test_case.tile_mode,
+        .array_mode = GetArrayMode(test_case.tile_mode),
+        .num_bits = test_case.num_bits,
+        .num_samples = 1,
+        .bank_swizzle = 0,
+        .mips = surface.mips,
+    };
+    surface.linear_size = offset;
+    surface.tiled_size = offset;
+    return surface;
+}
+
+std::vector<u8> RandomBytes(size_t size, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u8> bytes(size);
+    std::ranges::generate(bytes, [&] { return static_cast<u8>(rng()); });
+    return bytes;
+}
+
+/// Detiles texel by texel, the way the compute shader does. Texels outside of the tiled buffer are
+/// left cleared.
+std::vector<u8> DetileReference(const Surface& surface, const std::vector<u8>& tiled) {
+    const u32 bytes = surface.params.num_bits / 8;
+    std::vector<u8> linear(surface.linear_size);
+    size_t linear_offset = 0;
+    for (const auto& mip : surface.mips) {
+        for (u32 texel = 0; texel < mip.size / bytes; ++texel) {
+            const u32 x = texel % mip.pitch;
+            const u32 y = (texel / mip.pitch) % mip.height;
+            const u32 slice = texel / (mip.pitch * mip.height);
+            const u32 offset = GetTiledOffset(surface.params, mip, x, y, slice);
+            if (offset + bytes <= tiled.size()) {
+                std::copy_n(tiled.begin() + offset, bytes, linear.begin() + linear_offset);
+            }
+            linear_offset += bytes;
+        }
+    }
+    return linear;
+}
+
+class TilingCpu : public ::testing::TestWithParam<TilingCase> {};
+
+} // Anonymous namespace
+
+TEST(TilingCpuAddress, ThinMicroTileOrder) {
+    // Thin micro tiles interleave x and y bits, starting with x
+    const TilingMip mip = {8 * 8 * 4, 8, 8, 0};
+    const TilingParams params = {
+        .tile_mode = TileMode::Thin1DThin,
+        .array_mode = ArrayMode::Array1DTiledThin1,
+        .num_bits = 32,
+        .num_samples = 1,
+        .bank_swizzle = 0,
+        .mips = {&mip, 1},
+    };
+    EXPECT_EQ(GetTiledOffset(params, mip, 0, 0, 0), 0U);
+    EXPECT_EQ(GetTiledOffset(params, mip, 1, 0, 0), 4U);
+    EXPECT_EQ(GetTiledOffset(params, mip, 0, 1, 0), 8U);
+    EXPECT_EQ(GetTiledOffset(params, mip, 1, 1, 0), 12U);
+    EXPECT_EQ(GetTiledOffset(params, mip, 2, 0, 0), 16U);
+    EXPECT_EQ(GetTiledOffset(params, mip, 7, 7, 0), 252U);
+}
+
+TEST_P(TilingCpu, GoldenOffsets) {
+    // The reference detiler below is built on GetTiledOffset, so pin it to the shader first
+    const auto surface = MakeSurface(GetParam());
+    for (const auto& golden : GetParam().golden) {
+        EXPECT_EQ(GetTiledOffset(surface.params, surface.mips[0], golden.x, golden.y, golden.slice),
+                  golden.offset)
+            << "at " << golden.x << "," << golden.y << "," << golden.slice;
+    }
+}
+
+TEST_P(TilingCpu, MatchesReference) {
+    const auto surface = MakeSurface(GetParam());
+    const auto tiled = RandomBytes(surface.tiled_size, 1);
+    std::vector<u8> linear(surface.linear_size);
+    DetileCpu(surface.params, tiled, linear);
+    EXPECT_EQ(linear, DetileReference(surface, tiled));
+}
+
+TEST_P(TilingCpu, RoundTrip) {
+    const auto surface = MakeSurface(GetParam());
+    const auto linear = RandomBytes(surface.linear_size, 2);
+    std::vector<u8> tiled(surface.tiled_size);
+    std::vector<u8> result(surface.linear_size);
+    TileCpu(surface.params, linear, tiled);
+    DetileCpu(surface.params, tiled, result);
+    EXPECT_EQ(linear, result);
+}
+
+TEST_P(TilingCpu, MipChain) {
+    const auto surface = MakeSurface(GetParam(), 4);
+    const auto tiled = RandomBytes(surface.tiled_size, 3);
+    std::vector<u8> linear(surface.linear_size);
+    DetileCpu(surface.params, tiled, linear);
+    EXPECT_EQ(linear, DetileReference(surface, tiled));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Modes, TilingCpu,
+    ::testing::Values(
+        TilingCase{TileMode::Thin1DThin, 8, 256, 256, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 1}, {0, 1, 0, 2}, {5, 3, 0, 27}, {9, 0, 0, 65},
+                    {0, 9, 0, 2050}, {77, 45, 0, 10867}, {131, 139, 0, 35855},
+                    {255, 255, 0, 65535}}},
+        TilingCase{TileMode::Thin1DThin, 32, 256, 256, 2,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 108}, {9, 0, 0, 260},
+                    {0, 9, 0, 8200}, {77, 45, 1, 305612}, {131, 139, 1, 405564},
+                    {255, 255, 1, 524284}}},
+        TilingCase{TileMode::Display1DThin, 16, 256, 256, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 2}, {0, 1, 0, 16}, {5, 3, 0, 58}, {9, 0, 0, 130},
+                    {0, 9, 0, 4112}, {77, 45, 0, 21722}, {131, 139, 0, 71734},
+                    {255, 255, 0, 131070}}},
+        TilingCase{TileMode::Depth1DThin, 32, 256, 256, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 108}, {9, 0, 0, 260},
+                    {0, 9, 0, 8200}, {77, 45, 0, 43468}, {131, 139, 0, 143420},
+                    {255, 255, 0, 262140}}},
+        TilingCase{TileMode::Thick1DThick, 32, 128, 128, 8,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 332}, {9, 0, 0, 1028},
+                    {0, 9, 0, 16392}, {77, 45, 7, 354220}, {67, 75, 4, 417884},
+                    {127, 127, 7, 524284}}},
+        TilingCase{TileMode::Thin2DThin, 8, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 1}, {0, 1, 0, 2}, {5, 3, 0, 27}, {9, 0, 0, 257},
+                    {0, 9, 0, 322}, {77, 45, 0, 19571}, {259, 267, 0, 178511},
+                    {511, 511, 0, 250367}}},
+        TilingCase{TileMode::Thin2DThin, 16, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 2}, {0, 1, 0, 4}, {5, 3, 0, 54}, {9, 0, 0, 258},
+                    {0, 9, 0, 388}, {77, 45, 0, 11494}, {259, 267, 0, 336286},
+                    {511, 511, 0, 512510}}},
+        TilingCase{TileMode::Thin2DThin, 32, 512, 512, 2,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 108}, {9, 0, 0, 260},
+                    {0, 9, 0, 16648}, {77, 45, 1, 1074380}, {259, 267, 1, 1661244},
+                    {511, 511, 1, 2091516}}},
+        TilingCase{TileMode::Thin2DThin, 64, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 8}, {0, 1, 0, 16}, {5, 3, 0, 216}, {9, 0, 0, 264},
+                    {0, 9, 0, 16656}, {77, 45, 0, 56472}, {259, 267, 0, 1204600},
+                    {511, 511, 0, 2085368}}},
+        TilingCase{TileMode::Thin2DThin, 128, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 16}, {0, 1, 0, 32}, {5, 3, 0, 16560}, {9, 0, 0, 272},
+                    {0, 9, 0, 8480}, {77, 45, 0, 128048}, {259, 267, 0, 2359792},
+                    {511, 511, 0, 4182512}}},
+        TilingCase{TileMode::Display2DThin, 32, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 16}, {5, 3, 0, 116}, {9, 0, 0, 260},
+                    {0, 9, 0, 16656}, {77, 45, 0, 23732}, {259, 267, 0, 614748},
+                    {511, 511, 0, 1036796}}},
+        TilingCase{TileMode::Depth2DThin64, 32, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 280620}, {9, 0, 0, 260},
+                    {0, 9, 0, 328}, {77, 45, 0, 791628}, {259, 267, 0, 178556},
+                    {511, 511, 0, 1018364}}},
+        TilingCase{TileMode::Thin3DThin, 32, 512, 512, 4,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 108}, {9, 0, 0, 516},
+                    {0, 9, 0, 16648}, {77, 45, 3, 3167948}, {259, 267, 2, 2713404},
+                    {511, 511, 3, 4184316}}},
+        TilingCase{TileMode::Thick2DThick, 32, 256, 256, 8,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 16460}, {9, 0, 0, 260},
+                    {0, 9, 0, 8456}, {77, 45, 7, 1174700}, {131, 139, 4, 1714524},
+                    {255, 255, 7, 2091516}}},
+        TilingCase{TileMode::Thin2DThinPrt, 32, 512, 512, 1,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 108}, {9, 0, 0, 260},
+                    {0, 9, 0, 33032}, {77, 45, 0, 44236}, {259, 267, 0, 688444},
+                    {511, 511, 0, 1047036}}},
+        TilingCase{TileMode::Thin2DThin, 32, 1024, 1024, 2,
+                   {{0, 0, 0, 0}, {1, 0, 0, 4}, {0, 1, 0, 8}, {5, 3, 0, 108}, {9, 0, 0, 260},
+                    {0, 9, 0, 16648}, {77, 45, 1, 4220108}, {515, 523, 1, 6437180},
+                    {1023, 1023, 1, 8366588}}}));
+
+// Measures detiling throughput. Run with --gtest_also_run_disabled_tests
+TEST(TilingCpuBenchmark, DISABLED_Detile) {
+    const auto surface = MakeSurface({TileMode::Thin2DThin, 32, 4096, 4096, 1, {}});
+    const auto tiled = RandomBytes(surface.tiled_size, 4);
+    std::vector<u8> linear(surface.linear_size);
+    constexpr u32 NumIterations = 20;
+    const auto start = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < NumIterations; ++i) {
+        DetileCpu(surface.params, tiled, linear);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double bytes = static_cast<double>(surface.linear_size) * NumIterations;
+    std::printf("Detiled %.1f MiB/s\n", bytes / elapsed.count() / (1024.0 * 1024.0));
+}